@@ -2772,6 +2772,28 @@ if (TRACE_GET_OBJECT_FILTER(STREAMBUFFER, xStreamBuffer) & CurrentFilterMask) \
 
 #endif /* (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) */
 
+/* A task held back by its budget is shown as suspended until its budget is
+replenished. A demoted task is shown by the priority change instead. */
+#undef traceTASK_BUDGET_EXHAUSTED
+#define traceTASK_BUDGET_EXHAUSTED( pxTCB ) \
+	do \
+	{ \
+		if ((pxTCB)->ucBudgetAction == (uint8_t)eBudgetSuspend) \
+		{ \
+			traceTASK_SUSPEND(pxTCB) \
+		} \
+	} while (0)
+
+#undef traceTASK_BUDGET_REPLENISHED
+#define traceTASK_BUDGET_REPLENISHED( pxTCB ) \
+	do \
+	{ \
+		if ((pxTCB)->ucBudgetAction == (uint8_t)eBudgetSuspend) \
+		{ \
+			traceTASK_RESUME_FROM_ISR(pxTCB) \
+		} \
+	} while (0)
+
 #else /* (TRC_USE_TRACEALYZER_RECORDER == 1) */
 	
 /* When recorder is disabled */
@@ -665,6 +665,38 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MULTI_WAIT == 1 )
+
+/* For internal use only - place a list item of the calling task on the list of
+ * tasks waiting for bits, for xMultiWaitForObjects().  The bits are never
+ * cleared on exit. */
+    void vEventGroupPlaceMultiWaitItem( EventGroupHandle_t xEventGroup,
+                                        ListItem_t * const pxListItem,
+                                        const EventBits_t uxBitsToWaitFor,
+                                        const BaseType_t xWaitForAllBits )
+    {
+        EventGroup_t * pxEventBits = xEventGroup;
+        EventBits_t uxControlBits = 0;
+
+        configASSERT( xEventGroup );
+        configASSERT( ( uxBitsToWaitFor & eventEVENT_BITS_CONTROL_BYTES ) == 0 );
+        configASSERT( uxBitsToWaitFor != 0 );
+
+        if( xWaitForAllBits != pdFALSE )
+        {
+            uxControlBits |= eventWAIT_FOR_ALL_BITS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        vTaskPlaceMultiWaitItemOnUnorderedEventList( &( pxEventBits->xTasksWaitingForBits ), pxListItem, ( uxBitsToWaitFor | uxControlBits ) );
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
 /* For internal use only - execute a 'set bits' command that was pended from
  * an interrupt. */
 void vEventGroupSetBitsCallback( void * pvEventGroup,
@@ -59,6 +59,12 @@
 /* Basic FreeRTOS definitions. */
 #include "projdefs.h"
 
+/* Must be defaulted before the port layer is included, as ports that support
+ * more than one core use it. */
+#ifndef configNUMBER_OF_CORES
+    #define configNUMBER_OF_CORES    1
+#endif
+
 /* Definitions specific to the port being used. */
 #include "portable.h"
 
@@ -540,6 +546,18 @@
     #define traceTASK_DELAY_UNTIL( x )
 #endif
 
+#ifndef traceTASK_DEADLINE_MISSED
+    #define traceTASK_DEADLINE_MISSED( pxTCB )
+#endif
+
+#ifndef traceTASK_BUDGET_EXHAUSTED
+    #define traceTASK_BUDGET_EXHAUSTED( pxTCB )
+#endif
+
+#ifndef traceTASK_BUDGET_REPLENISHED
+    #define traceTASK_BUDGET_REPLENISHED( pxTCB )
+#endif
+
 #ifndef traceTASK_DELAY
     #define traceTASK_DELAY()
 #endif
@@ -716,6 +734,10 @@
     #define traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer )
 #endif
 
+#ifndef traceBLOCKING_ON_MULTI_WAIT
+    #define traceBLOCKING_ON_MULTI_WAIT( uxObjectCount )
+#endif
+
 #ifndef traceSTREAM_BUFFER_RECEIVE
     #define traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xReceivedLength )
 #endif
@@ -750,6 +772,14 @@
     #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
 #endif
 
+#ifndef configRUN_TIME_COUNTER_TYPE
+
+/* Defaults to uint32_t for backward compatibility.  A counter of 10us units
+ * wraps after less than 12 hours in 32 bits, so it can be set to uint64_t in
+ * FreeRTOSConfig.h for long runs. */
+    #define configRUN_TIME_COUNTER_TYPE    uint32_t
+#endif
+
 #ifndef configUSE_MALLOC_FAILED_HOOK
     #define configUSE_MALLOC_FAILED_HOOK    0
 #endif
@@ -766,12 +796,25 @@
     #define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )
 #endif
 
+/* Called on each pass of the idle task's loop, for ports that must act on
+ * the idle task reaching that point rather than at a time decided by the
+ * hardware. */
+#ifndef portIDLE_TASK_POLL
+    #define portIDLE_TASK_POLL()
+#endif
+
+/* The shortest idle period, in ticks, that the port can suppress the tick for.
+ * Ports that reprogram a hardware timer need at least two tick periods. */
+#ifndef portMIN_EXPECTED_IDLE_TIME
+    #define portMIN_EXPECTED_IDLE_TIME    2
+#endif
+
 #ifndef configEXPECTED_IDLE_TIME_BEFORE_SLEEP
-    #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    2
+    #define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    portMIN_EXPECTED_IDLE_TIME
 #endif
 
-#if configEXPECTED_IDLE_TIME_BEFORE_SLEEP < 2
-    #error configEXPECTED_IDLE_TIME_BEFORE_SLEEP must not be less than 2
+#if configEXPECTED_IDLE_TIME_BEFORE_SLEEP < portMIN_EXPECTED_IDLE_TIME
+    #error configEXPECTED_IDLE_TIME_BEFORE_SLEEP must not be less than portMIN_EXPECTED_IDLE_TIME
 #endif
 
 #ifndef configUSE_TICKLESS_IDLE
@@ -810,6 +853,56 @@
     #define configUSE_TIME_SLICING    1
 #endif
 
+#ifndef configUSE_TIME_SLICE_QUANTA
+    #define configUSE_TIME_SLICE_QUANTA    0
+#endif
+
+/* The time slice, in ticks, of every priority until it is changed with
+ * vTaskSetTimeSliceTicks(). */
+#ifndef configTIME_SLICE_TICKS
+    #define configTIME_SLICE_TICKS    1
+#endif
+
+#ifndef configUSE_DELAYED_TASK_WHEEL
+    #define configUSE_DELAYED_TASK_WHEEL    0
+#endif
+
+#ifndef configUSE_EDF_SCHEDULING
+    #define configUSE_EDF_SCHEDULING    0
+#endif
+
+#ifndef configEDF_TASK_PRIORITY
+    #define configEDF_TASK_PRIORITY    ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef configUSE_TASK_BUDGETS
+    #define configUSE_TASK_BUDGETS    0
+#endif
+
+#ifndef configUSE_TASK_POOLS
+    #define configUSE_TASK_POOLS    0
+#endif
+
+/* How many tasks along a chain of blocked mutex holders a task that blocks on
+ * a mutex can raise to its own priority.  1 raises only the holder of the mutex
+ * the task blocks on. */
+#ifndef configPRIORITY_INHERITANCE_CHAIN_LENGTH
+    #define configPRIORITY_INHERITANCE_CHAIN_LENGTH    1
+#endif
+
+#ifndef configUSE_MUTEX_PRIORITY_CEILING
+    #define configUSE_MUTEX_PRIORITY_CEILING    0
+#endif
+
+#ifndef configUSE_MULTI_WAIT
+    #define configUSE_MULTI_WAIT    0
+#endif
+
+/* The task notification index the job system blocks on, see jobs.h. */
+#ifndef configJOBS_NOTIFICATION_INDEX
+    #define configJOBS_NOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
 #ifndef configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS
     #define configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS    0
 #endif
@@ -842,6 +935,10 @@
     #define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
 #endif
 
+#ifndef configUSE_CORE_AFFINITY
+    #define configUSE_CORE_AFFINITY    0
+#endif
+
 #ifndef configAPPLICATION_ALLOCATED_HEAP
     #define configAPPLICATION_ALLOCATED_HEAP    0
 #endif
@@ -876,6 +973,11 @@
     #define configSUPPORT_DYNAMIC_ALLOCATION    1
 #endif
 
+#ifndef configSTACK_ALLOCATION_FROM_SEPARATE_HEAP
+    /* Defaults to 0 for backward compatibility. */
+    #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP    0
+#endif
+
 #ifndef configSTACK_DEPTH_TYPE
 
 /* Defaults to uint16_t for backward compatibility, but can be overridden
@@ -898,6 +1000,84 @@
     #endif /* INCLUDE_vTaskSuspend */
 #endif /* configUSE_TICKLESS_IDLE */
 
+#if ( configNUMBER_OF_CORES > 1 )
+    #ifndef portGET_CORE_ID
+        #error portGET_CORE_ID() must be defined by ports that support more than one core.
+    #endif
+
+    #ifndef portYIELD_CORE
+        #error portYIELD_CORE() must be defined by ports that support more than one core.
+    #endif
+
+    #if !defined( portGET_TASK_LOCK ) || !defined( portRELEASE_TASK_LOCK )
+        #error portGET_TASK_LOCK() and portRELEASE_TASK_LOCK() must be defined by ports that support more than one core.
+    #endif
+
+    #if !defined( portSET_INTERRUPT_MASK ) || !defined( portCLEAR_INTERRUPT_MASK )
+        #error portSET_INTERRUPT_MASK() and portCLEAR_INTERRUPT_MASK() must be defined by ports that support more than one core.
+    #endif
+
+    #if ( configUSE_TICKLESS_IDLE != 0 )
+        #error configUSE_TICKLESS_IDLE must be 0 when configNUMBER_OF_CORES is greater than 1.
+    #endif
+
+    #if ( configSUPPORT_DYNAMIC_ALLOCATION == 0 )
+        #error configSUPPORT_DYNAMIC_ALLOCATION must be 1 when configNUMBER_OF_CORES is greater than 1, as the idle tasks of the other cores are allocated dynamically.
+    #endif
+#endif /* configNUMBER_OF_CORES */
+
+#if ( ( configUSE_CORE_AFFINITY == 1 ) && ( configNUMBER_OF_CORES == 1 ) )
+    #error configUSE_CORE_AFFINITY can only be 1 when configNUMBER_OF_CORES is greater than 1.
+#endif
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configUSE_EDF_SCHEDULING can only be 1 when configNUMBER_OF_CORES is 1.
+    #endif
+
+    #if ( ( configEDF_TASK_PRIORITY < 1 ) || ( configEDF_TASK_PRIORITY >= configMAX_PRIORITIES ) )
+        #error configEDF_TASK_PRIORITY must be above the idle priority and below configMAX_PRIORITIES.
+    #endif
+#endif
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+    #if ( configNUMBER_OF_CORES > 1 )
+        #error configUSE_TASK_BUDGETS can only be 1 when configNUMBER_OF_CORES is 1.
+    #endif
+
+    #if ( configGENERATE_RUN_TIME_STATS != 1 )
+        #error configGENERATE_RUN_TIME_STATS must be set to 1 to use task budgets, as budgets are charged from the run time counter.
+    #endif
+
+    #if ( configUSE_MUTEXES != 1 )
+        #error configUSE_MUTEXES must be set to 1 to use task budgets, as a demoted task keeps its own priority in uxBasePriority.
+    #endif
+#endif
+
+#if ( ( configUSE_TIME_SLICE_QUANTA == 1 ) && ( ( configUSE_PREEMPTION != 1 ) || ( configUSE_TIME_SLICING != 1 ) ) )
+    #error configUSE_PREEMPTION and configUSE_TIME_SLICING must be set to 1 to use time slice quanta, as without them the tick does not time slice.
+#endif
+
+#if ( configTIME_SLICE_TICKS < 1 )
+    #error configTIME_SLICE_TICKS must be at least 1.
+#endif
+
+#if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH < 1 )
+    #error configPRIORITY_INHERITANCE_CHAIN_LENGTH must be at least 1.
+#endif
+
+#if ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configUSE_MUTEXES != 1 ) )
+    #error configUSE_MUTEXES must be set to 1 to use priority ceiling mutexes.
+#endif
+
+#if ( ( configUSE_MULTI_WAIT == 1 ) && ( configUSE_TASK_NOTIFICATIONS != 1 ) )
+    #error configUSE_TASK_NOTIFICATIONS must be set to 1 to use xMultiWaitForObjects(), as a task waiting on a stream buffer or notification is woken through its notifications.
+#endif
+
+#if ( ( configUSE_TASK_POOLS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION != 1 ) )
+    #error configSUPPORT_DYNAMIC_ALLOCATION must be set to 1 to use task pools, as the memory of a pool is allocated when the pool is created.
+#endif
+
 #if ( ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 0 ) )
     #error configSUPPORT_STATIC_ALLOCATION and configSUPPORT_DYNAMIC_ALLOCATION cannot both be 0, but can both be 1.
 #endif
@@ -1159,9 +1339,13 @@ typedef struct xSTATIC_TCB
     #endif
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy10[ 2 ];
+        StaticListItem_t xDummy11;
     #endif
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxDummy12[ 2 ];
+        #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+            void * pxDummy13;
+        #endif
     #endif
     #if ( configUSE_APPLICATION_TASK_TAG == 1 )
         void * pxDummy14;
@@ -1170,7 +1354,9 @@ typedef struct xSTATIC_TCB
         void * pvDummy15[ configNUM_THREAD_LOCAL_STORAGE_POINTERS ];
     #endif
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        uint32_t ulDummy16;
+        configRUN_TIME_COUNTER_TYPE ulDummy16[ 3 ];
+        uint32_t ulDummy34[ 5 ];
+        BaseType_t xDummy35;
     #endif
     #if ( configUSE_NEWLIB_REENTRANT == 1 )
         struct  _reent xDummy17;
@@ -1189,6 +1375,33 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configNUMBER_OF_CORES > 1 )
+        BaseType_t xDummy23;
+        UBaseType_t uxDummy24;
+    #endif
+    #if ( configUSE_CORE_AFFINITY == 1 )
+        UBaseType_t uxDummy25;
+    #endif
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        TickType_t xDummy26[ 4 ];
+        UBaseType_t uxDummy27;
+    #endif
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulDummy28[ 2 ];
+        TickType_t xDummy29[ 2 ];
+        UBaseType_t uxDummy30[ 2 ];
+        BaseType_t xDummy31;
+        void * pxDummy32;
+        uint8_t ucDummy33;
+    #endif
+    #if ( configUSE_TASK_POOLS == 1 )
+        void * pxDummy36;
+    #endif
+    #if ( configUSE_MULTI_WAIT == 1 )
+        void * pxDummy37;
+        UBaseType_t uxDummy38;
+        uint8_t ucDummy39;
+    #endif
 } StaticTask_t;
 
 /*
@@ -1215,6 +1428,10 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy2;
     } u;
 
+    #if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+        UBaseType_t uxDummy10;
+    #endif
+
     StaticList_t xDummy3[ 2 ];
     UBaseType_t uxDummy4[ 3 ];
     uint8_t ucDummy5[ 2 ];
@@ -758,6 +758,10 @@ void vEventGroupSetBitsCallback( void * pvEventGroup,
                                  const uint32_t ulBitsToSet ) PRIVILEGED_FUNCTION;
 void vEventGroupClearBitsCallback( void * pvEventGroup,
                                    const uint32_t ulBitsToClear ) PRIVILEGED_FUNCTION;
+void vEventGroupPlaceMultiWaitItem( EventGroupHandle_t xEventGroup,
+                                    ListItem_t * const pxListItem,
+                                    const EventBits_t uxBitsToWaitFor,
+                                    const BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
 
 
 #if ( configUSE_TRACE_FACILITY == 1 )
@@ -0,0 +1,231 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include jobs.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A job system runs many small jobs on a fixed set of worker tasks.  Each
+ * worker has a deque of jobs: a job submitted by a worker goes on the worker's
+ * own deque, from which the worker takes the job it submitted last, and a
+ * worker with nothing to do steals the oldest job from the deque of another
+ * worker.  Submitting a job does not allocate memory, and only wakes a worker
+ * if one is waiting for work.
+ *
+ * A job can have a parent, which does not finish until all of its children
+ * have finished, so vJobWait() on a parent waits for a whole tree of jobs.  A
+ * task that waits for a job runs other jobs while it waits, and otherwise
+ * blocks on a task notification.
+ *
+ * With a single core only one worker task is created, whatever the number
+ * asked for, as more workers could not run at once and would only add context
+ * switches.  The jobs then run to completion one after the other in that
+ * worker, or in a task that waits for them.
+ *
+ * \defgroup Jobs Jobs
+ */
+
+/**
+ * jobs.h
+ *
+ * Type by which job systems are referenced.  xJobSystemCreate() returns a
+ * JobSystemHandle_t that is then passed to the other job functions.
+ *
+ * \defgroup JobSystemHandle_t JobSystemHandle_t
+ * \ingroup Jobs
+ */
+struct JobSystemDef_t;
+typedef struct JobSystemDef_t * JobSystemHandle_t;
+
+/*
+ * Defines the prototype to which job functions must conform.  Unlike a task
+ * function a job function returns, and the job has finished once it has
+ * returned and all its children have finished.
+ */
+typedef void (* JobFunction_t)( void * pvParameter );
+
+/*
+ * A job.  The memory of a job is provided by the application, and must remain
+ * valid until the job has finished.  The members are only for use by jobs.c,
+ * and are set by vJobInit().
+ */
+typedef struct xJOB
+{
+    JobFunction_t pxJobCode;              /* The function the job runs. */
+    void * pvParameter;                   /* Passed to pxJobCode. */
+    struct xJOB * pxParent;               /* The job that waits for this one to finish, or NULL. */
+    volatile UBaseType_t uxUnfinished;    /* 1 until the job has run, plus the number of its children that have not finished. */
+    TaskHandle_t xWaitingTask;            /* The task blocked in vJobWait() for the job, if any. */
+} Job_t;
+
+/**
+ * jobs.h
+ * <pre>
+ * JobSystemHandle_t xJobSystemCreate( UBaseType_t uxWorkers,
+ *                                     UBaseType_t uxJobsPerWorker,
+ *                                     configSTACK_DEPTH_TYPE usStackDepth,
+ *                                     UBaseType_t uxPriority );
+ * </pre>
+ *
+ * Create a job system and its worker tasks.  configSUPPORT_DYNAMIC_ALLOCATION
+ * must be set to 1 in FreeRTOSConfig.h for this function to be available.
+ *
+ * The workers block on notification index configJOBS_NOTIFICATION_INDEX when
+ * they have no work, and a task waiting in vJobWait() blocks on the same index,
+ * so the index must not be used for anything else by those tasks.
+ *
+ * @param uxWorkers The number of worker tasks.  Typically one per core - with
+ * a single core one worker is created whatever the value.
+ *
+ * @param uxJobsPerWorker The number of jobs the deque of each worker holds.  A
+ * job submitted when every deque it can go on is full is run at once by the
+ * submitting task.
+ *
+ * @param usStackDepth The stack depth of each worker, which has to hold the
+ * deepest job function.
+ *
+ * @param uxPriority The priority of the workers.
+ *
+ * @return The job system, or NULL if the memory or the tasks could not be
+ * created.
+ *
+ * \defgroup xJobSystemCreate xJobSystemCreate
+ * \ingroup Jobs
+ */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+    JobSystemHandle_t xJobSystemCreate( UBaseType_t uxWorkers,
+                                        UBaseType_t uxJobsPerWorker,
+                                        configSTACK_DEPTH_TYPE usStackDepth,
+                                        UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * jobs.h
+ * <pre>
+ * void vJobInit( Job_t *pxJob,
+ *                JobFunction_t pxJobCode,
+ *                void *pvParameter,
+ *                Job_t *pxParent );
+ * </pre>
+ *
+ * Initialise a job before it is submitted.
+ *
+ * @param pxJob The job.
+ *
+ * @param pxJobCode The function the job runs.
+ *
+ * @param pvParameter Passed to pxJobCode.
+ *
+ * @param pxParent NULL, or a job that then does not finish until this one has.
+ * The parent must not have finished when vJobInit() is called, so the children
+ * of a job are initialised either by the job itself or before it is submitted.
+ *
+ * \defgroup vJobInit vJobInit
+ * \ingroup Jobs
+ */
+void vJobInit( Job_t * pxJob,
+               JobFunction_t pxJobCode,
+               void * pvParameter,
+               Job_t * pxParent ) PRIVILEGED_FUNCTION;
+
+/**
+ * jobs.h
+ * <pre>
+ * void vJobSubmit( JobSystemHandle_t xJobSystem, Job_t *pxJob );
+ * </pre>
+ *
+ * Submit an initialised job to run on a worker.  A job submitted by a worker,
+ * so by another job, goes on that worker's deque.  A job submitted by any other
+ * task goes on the deques of the workers in turn.  There is no order between
+ * the jobs.
+ *
+ * @param xJobSystem The job system.
+ *
+ * @param pxJob The job, initialised by vJobInit().
+ *
+ * \defgroup vJobSubmit vJobSubmit
+ * \ingroup Jobs
+ */
+void vJobSubmit( JobSystemHandle_t xJobSystem,
+                 Job_t * pxJob ) PRIVILEGED_FUNCTION;
+
+/**
+ * jobs.h
+ * <pre>
+ * void vJobWait( JobSystemHandle_t xJobSystem, Job_t *pxJob );
+ * </pre>
+ *
+ * Wait for a job and all its children to finish.  While it waits the calling
+ * task runs the jobs waiting in the deques, so a job that waits for its
+ * children does not hold up its worker, and on a single core the waiting task
+ * runs the jobs itself without a context switch.  Once there is no job to run
+ * the calling task blocks until the job finishes.  Only one task can wait for a
+ * job.
+ *
+ * @param xJobSystem The job system the job was submitted to.
+ *
+ * @param pxJob The job.
+ *
+ * \defgroup vJobWait vJobWait
+ * \ingroup Jobs
+ */
+void vJobWait( JobSystemHandle_t xJobSystem,
+               Job_t * pxJob ) PRIVILEGED_FUNCTION;
+
+/**
+ * jobs.h
+ * <pre>
+ * BaseType_t xJobIsFinished( const Job_t *pxJob );
+ * </pre>
+ *
+ * @return pdTRUE if the job and all its children have finished, otherwise
+ * pdFALSE.
+ *
+ * \defgroup xJobIsFinished xJobIsFinished
+ * \ingroup Jobs
+ */
+BaseType_t xJobIsFinished( const Job_t * pxJob ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* JOBS_H */
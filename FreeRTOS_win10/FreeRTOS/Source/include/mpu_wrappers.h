@@ -177,7 +177,7 @@
 #else /* portUSING_MPU_WRAPPERS */
 
     #define PRIVILEGED_FUNCTION
-    #define PRIVILEGED_DATA
+    #define PRIVILEGED_DATA    portKERNEL_INSTANCE_DATA
     #define FREERTOS_SYSTEM_CALL
     #define portUSING_MPU_WRAPPERS    0
 
@@ -0,0 +1,240 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MULTI_WAIT_H
+#define MULTI_WAIT_H
+
+#ifndef INC_FREERTOS_H
+    #error "include FreeRTOS.h" must appear in source files before "include multiwait.h"
+#endif
+
+/* FreeRTOS includes. */
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+#include "stream_buffer.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * xMultiWaitForObjects() blocks the calling task on several kernel objects of
+ * different types at once - queues and semaphores, event group bits, stream
+ * and message buffers, and the task's own notifications - until one of them
+ * is ready, and returns the index of that object.  The task is placed on the
+ * wait list of each object directly, with a list item of its own for each
+ * object, so unlike a queue set nothing is copied to an intermediate queue
+ * when an object is written to.
+ *
+ * Waiting does not take anything from the object that is ready: the task
+ * reads it afterwards with a block time of 0, as after a queue set returns a
+ * member.  Another task could read the object first, in which case the read
+ * fails and the task can wait again.
+ *
+ * configUSE_MULTI_WAIT must be set to 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * \defgroup MultiWait MultiWait
+ */
+
+/* Returned by xMultiWaitForObjects() if no object became ready within the
+ * block time. */
+#define multiwaitTIMED_OUT    ( ( BaseType_t ) -1 )
+
+/*
+ * The kinds of object xMultiWaitForObjects() can wait on.
+ */
+typedef enum
+{
+    eMultiWaitQueue = 0,     /* A queue holding data, or a semaphore or mutex that can be taken. */
+    eMultiWaitEventBits,     /* Bits set in an event group. */
+    eMultiWaitStreamBuffer,  /* A stream buffer or message buffer holding data. */
+    eMultiWaitNotification   /* A notification pending for the calling task. */
+} eMultiWaitObjectType;
+
+/*
+ * One object to wait on.  The memory is provided by the application, and the
+ * members are set by the vMultiWaitInit...() functions.  xListItem is used by
+ * the kernel while the task waits.
+ */
+typedef struct xMULTI_WAIT_OBJECT
+{
+    eMultiWaitObjectType eObjectType;  /* The kind of object. */
+    void * pvObject;                   /* The handle of the object, or NULL for a notification. */
+    EventBits_t uxBitsToWaitFor;       /* The event group bits to wait for. */
+    BaseType_t xWaitForAllBits;        /* pdTRUE to wait for all of uxBitsToWaitFor, pdFALSE for any of them. */
+    UBaseType_t uxIndexToWaitOn;       /* The index of the notification to wait for. */
+    ListItem_t xListItem;              /* Places the task on the wait list of a queue or event group. */
+} MultiWaitObject_t;
+
+/**
+ * multiwait.h
+ * <pre>
+ * void vMultiWaitInitQueue( MultiWaitObject_t *pxObject, QueueHandle_t xQueue );
+ * </pre>
+ *
+ * Set pxObject to wait for xQueue to hold data.  xQueue can also be a
+ * semaphore, which is ready when it can be taken, or a mutex, although the
+ * holder of a mutex does not inherit the priority of a task that waits for it
+ * this way.
+ *
+ * \defgroup vMultiWaitInitQueue vMultiWaitInitQueue
+ * \ingroup MultiWait
+ */
+void vMultiWaitInitQueue( MultiWaitObject_t * pxObject,
+                          QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * multiwait.h
+ * <pre>
+ * void vMultiWaitInitEventBits( MultiWaitObject_t *pxObject,
+ *                               EventGroupHandle_t xEventGroup,
+ *                               EventBits_t uxBitsToWaitFor,
+ *                               BaseType_t xWaitForAllBits );
+ * </pre>
+ *
+ * Set pxObject to wait for bits in xEventGroup, as xEventGroupWaitBits() with
+ * xClearOnExit set to pdFALSE.  The bits are not cleared when the task is
+ * woken; the task clears them itself if it needs to.
+ *
+ * \defgroup vMultiWaitInitEventBits vMultiWaitInitEventBits
+ * \ingroup MultiWait
+ */
+void vMultiWaitInitEventBits( MultiWaitObject_t * pxObject,
+                              EventGroupHandle_t xEventGroup,
+                              EventBits_t uxBitsToWaitFor,
+                              BaseType_t xWaitForAllBits ) PRIVILEGED_FUNCTION;
+
+/**
+ * multiwait.h
+ * <pre>
+ * void vMultiWaitInitStreamBuffer( MultiWaitObject_t *pxObject, StreamBufferHandle_t xStreamBuffer );
+ * </pre>
+ *
+ * Set pxObject to wait for xStreamBuffer, which can also be a message buffer,
+ * to hold data.  As when a task blocks in xStreamBufferReceive(), the task is
+ * woken through notification index 0, so the task must not also wait on that
+ * index for anything else.
+ *
+ * \defgroup vMultiWaitInitStreamBuffer vMultiWaitInitStreamBuffer
+ * \ingroup MultiWait
+ */
+void vMultiWaitInitStreamBuffer( MultiWaitObject_t * pxObject,
+                                 StreamBufferHandle_t xStreamBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * multiwait.h
+ * <pre>
+ * void vMultiWaitInitNotification( MultiWaitObject_t *pxObject, UBaseType_t uxIndexToWaitOn );
+ * </pre>
+ *
+ * Set pxObject to wait for a notification to be pending at index
+ * uxIndexToWaitOn of the calling task's notification array.  The notification
+ * is left pending, to be received with ulTaskNotifyTakeIndexed() or
+ * xTaskNotifyWaitIndexed().
+ *
+ * \defgroup vMultiWaitInitNotification vMultiWaitInitNotification
+ * \ingroup MultiWait
+ */
+void vMultiWaitInitNotification( MultiWaitObject_t * pxObject,
+                                 UBaseType_t uxIndexToWaitOn ) PRIVILEGED_FUNCTION;
+
+/**
+ * multiwait.h
+ * <pre>
+ * BaseType_t xMultiWaitForObjects( MultiWaitObject_t *pxObjects,
+ *                                  UBaseType_t uxObjectCount,
+ *                                  TickType_t xTicksToWait );
+ * </pre>
+ *
+ * Block the calling task until one of the objects in the pxObjects array is
+ * ready, or xTicksToWait ticks have passed.  If more than one object is ready
+ * the one with the lowest index is returned, so objects earlier in the array
+ * take precedence.
+ *
+ * The objects are checked, and the task is placed on the wait list of each of
+ * them, in a single critical section, so the time interrupts are masked grows
+ * with the length of the array.  A stream or message buffer can only have one
+ * task waiting to receive from it, whether in xStreamBufferReceive() or here.
+ *
+ * @param pxObjects The objects to wait on, set with the vMultiWaitInit...()
+ * functions.  The array must remain valid until the function returns.
+ *
+ * @param uxObjectCount The number of objects in pxObjects.
+ *
+ * @param xTicksToWait The maximum time to wait for an object to be ready.
+ * portMAX_DELAY waits indefinitely if INCLUDE_vTaskSuspend is set to 1.
+ *
+ * @return The index in pxObjects of the object that is ready, or
+ * multiwaitTIMED_OUT if none was ready within xTicksToWait.
+ *
+ * Example usage:
+ * <pre>
+ * void vGatewayTask( void * pvParameters )
+ * {
+ * MultiWaitObject_t xObjects[ 3 ];
+ * BaseType_t xIndex;
+ *
+ *  vMultiWaitInitQueue( &( xObjects[ 0 ] ), xCommandQueue );
+ *  vMultiWaitInitStreamBuffer( &( xObjects[ 1 ] ), xUartStream );
+ *  vMultiWaitInitEventBits( &( xObjects[ 2 ] ), xLinkEvents, LINK_DOWN_BIT, pdFALSE );
+ *
+ *  for( ;; )
+ *  {
+ *      xIndex = xMultiWaitForObjects( xObjects, 3, portMAX_DELAY );
+ *
+ *      if( xIndex == 0 )
+ *      {
+ *          // Read the command with xQueueReceive( xCommandQueue, &xCommand, 0 ).
+ *      }
+ *      else if( xIndex == 1 )
+ *      {
+ *          // Read the bytes with xStreamBufferReceive( xUartStream, ucBuffer, sizeof( ucBuffer ), 0 ).
+ *      }
+ *      else if( xIndex == 2 )
+ *      {
+ *          // Handle the link going down, then xEventGroupClearBits( xLinkEvents, LINK_DOWN_BIT ).
+ *      }
+ *  }
+ * }
+ * </pre>
+ * \defgroup xMultiWaitForObjects xMultiWaitForObjects
+ * \ingroup MultiWait
+ */
+BaseType_t xMultiWaitForObjects( MultiWaitObject_t * pxObjects,
+                                 UBaseType_t uxObjectCount,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MULTI_WAIT_H */
@@ -91,6 +91,14 @@
     #define portARCH_NAME    NULL
 #endif
 
+/* Storage qualifier given to the kernel's own state through PRIVILEGED_DATA
+ * when the port does not use the MPU wrappers.  A port that runs more than one
+ * instance of the kernel in a process can define it to make that state thread
+ * local. */
+#ifndef portKERNEL_INSTANCE_DATA
+    #define portKERNEL_INSTANCE_DATA
+#endif
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     extern "C" {
@@ -179,6 +187,20 @@ void vPortInitialiseBlocks( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 size_t xPortGetMinimumEverFreeHeapSize( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Map to the routines that allocate and free task stacks.  A port that
+ * provides its own stack memory (for example to place guard pages around
+ * each stack) sets configSTACK_ALLOCATION_FROM_SEPARATE_HEAP to 1 and
+ * implements them, otherwise stacks come from the FreeRTOS heap.
+ */
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+    void * pvPortMallocStack( size_t xSize ) PRIVILEGED_FUNCTION;
+    void vPortFreeStack( void * pv ) PRIVILEGED_FUNCTION;
+#else
+    #define pvPortMallocStack    pvPortMalloc
+    #define vPortFreeStack       vPortFree
+#endif
+
 /*
  * Setup the hardware ready for the scheduler to take control.  This generally
  * sets up a tick interrupt and sets timers for the correct tick frequency.
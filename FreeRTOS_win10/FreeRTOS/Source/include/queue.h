@@ -1454,6 +1454,11 @@ BaseType_t xQueueCRReceive( QueueHandle_t xQueue,
 QueueHandle_t xQueueCreateMutex( const uint8_t ucQueueType ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateMutexStatic( const uint8_t ucQueueType,
                                        StaticQueue_t * pxStaticQueue ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateMutexWithCeiling( const uint8_t ucQueueType,
+                                            const UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+QueueHandle_t xQueueCreateMutexWithCeilingStatic( const uint8_t ucQueueType,
+                                                  const UBaseType_t uxCeilingPriority,
+                                                  StaticQueue_t * pxStaticQueue ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateCountingSemaphore( const UBaseType_t uxMaxCount,
                                              const UBaseType_t uxInitialCount ) PRIVILEGED_FUNCTION;
 QueueHandle_t xQueueCreateCountingSemaphoreStatic( const UBaseType_t uxMaxCount,
@@ -1699,6 +1704,8 @@ QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet )
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue,
                                      TickType_t xTicksToWait,
                                      const BaseType_t xWaitIndefinitely ) PRIVILEGED_FUNCTION;
+void vQueuePlaceMultiWaitItem( QueueHandle_t xQueue,
+                               ListItem_t * const pxListItem ) PRIVILEGED_FUNCTION;
 BaseType_t xQueueGenericReset( QueueHandle_t xQueue,
                                BaseType_t xNewQueue ) PRIVILEGED_FUNCTION;
 void vQueueSetQueueNumber( QueueHandle_t xQueue,
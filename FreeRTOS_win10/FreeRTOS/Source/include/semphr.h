@@ -796,6 +796,72 @@ typedef QueueHandle_t SemaphoreHandle_t;
     #define xSemaphoreCreateMutexStatic( pxMutexBuffer )    xQueueCreateMutexStatic( queueQUEUE_TYPE_MUTEX, ( pxMutexBuffer ) )
 #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+/**
+ * semphr. h
+ * <pre>
+ * SemaphoreHandle_t xSemaphoreCreateMutexWithCeiling( UBaseType_t uxCeilingPriority );
+ * </pre>
+ *
+ * Only available when configUSE_MUTEX_PRIORITY_CEILING is set to 1.
+ *
+ * Creates a mutex that uses the immediate priority ceiling protocol instead of
+ * priority inheritance.  A task that takes the mutex is raised to
+ * uxCeilingPriority straight away, and returns to its own priority when it has
+ * given back every mutex it holds, as it would after inheriting a priority.
+ * While the holder runs at the ceiling no other task that uses the mutex can
+ * preempt it, so on a single core the mutex is normally free whenever a task
+ * tries to take it, and a task that does find it held (because the holder
+ * blocked while holding it) does not raise the holder or record anything.
+ *
+ * The ceiling must be at least the priority of every task that takes the
+ * mutex, which is checked by configASSERT() when the mutex is taken.
+ *
+ * Mutexes created using this function are used with xSemaphoreTake() and
+ * xSemaphoreGive(), as mutexes created by xSemaphoreCreateMutex().
+ *
+ * @param uxCeilingPriority The priority a task holding the mutex runs at.
+ * Must be greater than 0 and less than configMAX_PRIORITIES.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * mutex is returned.  If there was not enough heap to allocate the mutex data
+ * structures then NULL is returned.
+ *
+ * Example usage:
+ * <pre>
+ * // Both tasks that use the bus run at priority 2 or below.
+ * SemaphoreHandle_t xBusMutex = xSemaphoreCreateMutexWithCeiling( 2 );
+ * </pre>
+ * \defgroup xSemaphoreCreateMutexWithCeiling xSemaphoreCreateMutexWithCeiling
+ * \ingroup Semaphores
+ */
+#if ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    #define xSemaphoreCreateMutexWithCeiling( uxCeilingPriority )    xQueueCreateMutexWithCeiling( queueQUEUE_TYPE_MUTEX, ( uxCeilingPriority ) )
+#endif
+
+/**
+ * semphr. h
+ * <pre>
+ * SemaphoreHandle_t xSemaphoreCreateMutexWithCeilingStatic( UBaseType_t uxCeilingPriority,
+ *                                                           StaticSemaphore_t *pxMutexBuffer );
+ * </pre>
+ *
+ * As xSemaphoreCreateMutexWithCeiling(), but the memory for the mutex is
+ * provided by the application writer, as for xSemaphoreCreateMutexStatic().
+ *
+ * @param uxCeilingPriority The priority a task holding the mutex runs at.
+ *
+ * @param pxMutexBuffer Must point to a variable of type StaticSemaphore_t,
+ * which will be used to hold the mutex's data structure.
+ *
+ * @return If the mutex was successfully created then a handle to the created
+ * mutex is returned.  If pxMutexBuffer was NULL then NULL is returned.
+ * \defgroup xSemaphoreCreateMutexWithCeilingStatic xSemaphoreCreateMutexWithCeilingStatic
+ * \ingroup Semaphores
+ */
+#if ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+    #define xSemaphoreCreateMutexWithCeilingStatic( uxCeilingPriority, pxMutexBuffer )    xQueueCreateMutexWithCeilingStatic( queueQUEUE_TYPE_MUTEX, ( uxCeilingPriority ), ( pxMutexBuffer ) )
+#endif
+
 
 /**
  * semphr. h
@@ -77,6 +77,18 @@
 struct tskTaskControlBlock;     /* The old naming convention is used to prevent breaking kernel aware debuggers. */
 typedef struct tskTaskControlBlock * TaskHandle_t;
 
+/**
+ * task. h
+ *
+ * Type by which task pools are referenced.  xTaskPoolCreate() returns a
+ * TaskPoolHandle_t, which is then passed to xTaskCreateFromPool().
+ *
+ * \defgroup TaskPoolHandle_t TaskPoolHandle_t
+ * \ingroup Tasks
+ */
+struct tskTaskPool;
+typedef struct tskTaskPool * TaskPoolHandle_t;
+
 /*
  * Defines the prototype to which the application task hook function must
  * conform.
@@ -104,6 +116,14 @@ typedef enum
     eSetValueWithoutOverwrite     /* Set the task's notification value if the previous value has been read by the task. */
 } eNotifyAction;
 
+/* Actions taken by the kernel when a task uses up its CPU budget, see
+ * vTaskSetBudget(). */
+typedef enum
+{
+    eBudgetDemote = 0, /* Lower the task's priority until its budget is replenished. */
+    eBudgetSuspend     /* Do not let the task run again until its budget is replenished. */
+} eBudgetAction;
+
 /*
  * Used internally only.
  */
@@ -150,11 +170,28 @@ typedef struct xTASK_STATUS
     eTaskState eCurrentState;                        /* The state in which the task existed when the structure was populated. */
     UBaseType_t uxCurrentPriority;                   /* The priority at which the task was running (may be inherited) when the structure was populated. */
     UBaseType_t uxBasePriority;                      /* The priority to which the task will return if the task's current priority has been inherited to avoid unbounded priority inversion when obtaining a mutex.  Only valid if configUSE_MUTEXES is defined as 1 in FreeRTOSConfig.h. */
-    uint32_t ulRunTimeCounter;                       /* The total run time allocated to the task so far, as defined by the run time stats clock.  See https://www.FreeRTOS.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
+    configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;    /* The total run time allocated to the task so far, as defined by the run time stats clock.  See https://www.FreeRTOS.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
     StackType_t * pxStackBase;                       /* Points to the lowest address of the task's stack area. */
     configSTACK_DEPTH_TYPE usStackHighWaterMark;     /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
+    UBaseType_t uxDeadlineMisses;                    /* The number of jobs of the task that completed after their deadline.  Only valid for a task created by xTaskCreateWithDeadline() when configUSE_EDF_SCHEDULING is defined as 1 in FreeRTOSConfig.h. */
+    UBaseType_t uxBudgetOverruns;                    /* The number of budget periods in which the task used up its CPU budget.  Only valid when configUSE_TASK_BUDGETS is defined as 1 in FreeRTOSConfig.h. */
+    uint32_t ulSwitchesIn;                           /* The number of times the task has been switched in.  This and the members below are only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
+    uint32_t ulPreemptions;                          /* The number of times the task was switched out while it could still run - because it was preempted, its time slice ended or it yielded. */
+    uint32_t ulWakeups;                              /* The number of times the task was switched in after being made ready from another state, over which the wake latencies below are measured. */
+    uint32_t ulMinWakeLatency;                       /* The shortest, average and longest time from the task being made ready to it being switched in, in the units of the run time stats clock. */
+    uint32_t ulAvgWakeLatency;
+    uint32_t ulMaxWakeLatency;
 } TaskStatus_t;
 
+/* Used with uxTaskGetNextTaskStates() to visit the tasks a few at a time.  The
+ * members are only for use by the kernel. */
+typedef struct xTASK_STATE_CURSOR
+{
+    void * pvNextTask;             /* The task to visit next, while uxTaskListVersion still matches. */
+    UBaseType_t uxNextTaskNumber;  /* The lowest task number still to be visited. */
+    UBaseType_t uxTaskListVersion; /* Tasks created or deleted since the cursor was moved change the version. */
+} TaskStateCursor_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -163,6 +200,12 @@ typedef enum
     eNoTasksWaitingTimeout     /* No tasks are waiting for a timeout so it is safe to enter a sleep mode that can only be exited by an external interrupt. */
 } eSleepModeStatus;
 
+/**
+ * The largest number of bytes xTaskSerialiseTaskStatus() writes for one task -
+ * 13 numbers of up to 10 bytes each, the state, and the name and its length.
+ */
+#define tskSERIALISED_TASK_STATUS_MAX_LENGTH    ( ( 13U * 10U ) + 2U + ( size_t ) configMAX_TASK_NAME_LEN )
+
 /**
  * Defines the priority used by the idle task.  This must not be modified.
  *
@@ -170,6 +213,14 @@ typedef enum
  */
 #define tskIDLE_PRIORITY    ( ( UBaseType_t ) 0U )
 
+/**
+ * The core affinity mask of a task that can run on any core - see
+ * vTaskCoreAffinitySet().
+ *
+ * \ingroup TaskUtils
+ */
+#define tskNO_AFFINITY      ( ( UBaseType_t ) -1 )
+
 /**
  * task. h
  *
@@ -345,6 +396,148 @@ typedef enum
                             TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
 #endif
 
+/**
+ * task. h
+ * <pre>
+ * BaseType_t xTaskCreateWithDeadline( TaskFunction_t pvTaskCode,
+ *                                     const char * const pcName,
+ *                                     configSTACK_DEPTH_TYPE usStackDepth,
+ *                                     void *pvParameters,
+ *                                     TickType_t xRelativeDeadline,
+ *                                     TickType_t xPeriod,
+ *                                     TaskHandle_t *pxCreatedTask );
+ * </pre>
+ *
+ * configUSE_EDF_SCHEDULING and configSUPPORT_DYNAMIC_ALLOCATION must both be
+ * defined as 1 in FreeRTOSConfig.h for this function to be available.
+ *
+ * Create a task that is scheduled by earliest deadline first.  The task runs
+ * at priority configEDF_TASK_PRIORITY, so it is selected ahead of the tasks of
+ * lower priority and behind the tasks of higher priority as normal, but among
+ * the ready tasks of priority configEDF_TASK_PRIORITY the one with the earliest
+ * absolute deadline runs.
+ *
+ * The task is periodic: its first job is released when it is created and the
+ * next one xPeriod ticks later, each job having to complete within
+ * xRelativeDeadline ticks of its release.  The task completes a job by calling
+ * vTaskWaitForNextPeriod().  A job that completes after its deadline is counted
+ * in the uxDeadlineMisses member of the task's TaskStatus_t.
+ *
+ * Tasks created by xTaskCreate() at priority configEDF_TASK_PRIORITY, and
+ * tasks that inherit that priority from a mutex, have no deadline and are
+ * selected before the tasks that do.
+ *
+ * @param xRelativeDeadline The time, in ticks, within which each job must
+ * complete after its release.  Must be greater than zero.
+ *
+ * @param xPeriod The time, in ticks, between the releases of the task's jobs.
+ * Must be greater than zero.
+ *
+ * The other parameters and the return value are as for xTaskCreate().
+ *
+ * \defgroup xTaskCreateWithDeadline xTaskCreateWithDeadline
+ * \ingroup Tasks
+ */
+#if ( ( configUSE_EDF_SCHEDULING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+    BaseType_t xTaskCreateWithDeadline( TaskFunction_t pxTaskCode,
+                                        const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                        const configSTACK_DEPTH_TYPE usStackDepth,
+                                        void * const pvParameters,
+                                        TickType_t xRelativeDeadline,
+                                        TickType_t xPeriod,
+                                        TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>
+ * TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTasks,
+ *                                   configSTACK_DEPTH_TYPE usStackDepth );
+ * </pre>
+ *
+ * configUSE_TASK_POOLS must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Create a pool of uxTasks task slots, each with a TCB and a stack of
+ * usStackDepth words.  The memory for every slot is allocated here, so
+ * xTaskCreateFromPool() takes a free slot without calling pvPortMalloc(), and
+ * deleting the task returns the slot to the pool rather than freeing it.  The
+ * time taken to create and delete a task from a pool does not depend on the
+ * state of the heap.  A pool is never deleted.
+ *
+ * @param uxTasks The number of slots in the pool, so the most tasks created
+ * from the pool that can exist at once.
+ *
+ * @param usStackDepth The stack depth of every slot, as the usStackDepth
+ * parameter of xTaskCreate().
+ *
+ * @return The handle of the pool, or NULL if there was not the memory for it.
+ *
+ * \defgroup xTaskPoolCreate xTaskPoolCreate
+ * \ingroup Tasks
+ */
+#if ( configUSE_TASK_POOLS == 1 )
+    TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTasks,
+                                      configSTACK_DEPTH_TYPE usStackDepth ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>
+ * BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xPool,
+ *                                 TaskFunction_t pvTaskCode,
+ *                                 const char * const pcName,
+ *                                 void *pvParameters,
+ *                                 UBaseType_t uxPriority,
+ *                                 TaskHandle_t *pxCreatedTask );
+ * </pre>
+ *
+ * configUSE_TASK_POOLS must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Create a task as xTaskCreate(), but in a free slot of xPool, with the stack
+ * depth the pool was created with.  A slot is taken in constant time and the
+ * stack of the slot is not filled with tskSTACK_FILL_BYTE here - it was filled
+ * when the pool was created, and the part a task used is filled again when the
+ * task is deleted and its slot returned.
+ *
+ * @param xPool The pool to create the task from.
+ *
+ * The other parameters are as for xTaskCreate().
+ *
+ * @return pdPASS if the task was created, or
+ * errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY if every slot of the pool is in use.
+ *
+ * \defgroup xTaskCreateFromPool xTaskCreateFromPool
+ * \ingroup Tasks
+ */
+#if ( configUSE_TASK_POOLS == 1 )
+    BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xPool,
+                                    TaskFunction_t pxTaskCode,
+                                    const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                    void * const pvParameters,
+                                    UBaseType_t uxPriority,
+                                    TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>UBaseType_t uxTaskPoolGetFreeSlots( TaskPoolHandle_t xPool );</pre>
+ *
+ * configUSE_TASK_POOLS must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @return The number of slots of xPool not in use.  A deleted task's slot is
+ * only free once the task has been cleaned up, which is done by the idle task
+ * if the task deleted itself.
+ *
+ * \defgroup uxTaskPoolGetFreeSlots uxTaskPoolGetFreeSlots
+ * \ingroup Tasks
+ */
+#if ( configUSE_TASK_POOLS == 1 )
+    UBaseType_t uxTaskPoolGetFreeSlots( TaskPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * <pre>
@@ -840,6 +1033,42 @@ void vTaskDelay( const TickType_t xTicksToDelay ) PRIVILEGED_FUNCTION;
 void vTaskDelayUntil( TickType_t * const pxPreviousWakeTime,
                       const TickType_t xTimeIncrement ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>
+ * void vTaskWaitForNextPeriod( void );
+ * </pre>
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Called by a task created with xTaskCreateWithDeadline() when it has
+ * completed its current job.  Counts a deadline miss if the job completed
+ * after its deadline, then blocks the task until its next job is released.
+ * If that release time has already passed, because the job overran, the task
+ * carries straight on with the next job, which is ordered by its own deadline.
+ *
+ * Example usage:
+ * <pre>
+ * void vControlLoop( void * pvParameters )
+ * {
+ *   for( ;; )
+ *   {
+ *       vReadSensorsAndUpdateOutputs();
+ *       vTaskWaitForNextPeriod();
+ *   }
+ * }
+ *
+ * // A 10 tick control loop that has to complete within 4 ticks of each release.
+ * xTaskCreateWithDeadline( vControlLoop, "CTRL", STACK_SIZE, NULL, 4, 10, NULL );
+ * </pre>
+ * \defgroup vTaskWaitForNextPeriod vTaskWaitForNextPeriod
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_EDF_SCHEDULING == 1 )
+    void vTaskWaitForNextPeriod( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * <pre>
@@ -1057,6 +1286,167 @@ void vTaskGetInfo( TaskHandle_t xTask,
 void vTaskPrioritySet( TaskHandle_t xTask,
                        UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>
+ * void vTaskSetBudget( TaskHandle_t xTask, configRUN_TIME_COUNTER_TYPE ulBudget, TickType_t xPeriod, eBudgetAction eAction, UBaseType_t uxDemotedPriority );
+ * </pre>
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * Limit the processor time a task can use in each period of xPeriod ticks.
+ * The time a task runs is charged against its budget each time it is switched
+ * out, as measured by the run time stats counter, and the tick interrupt
+ * switches a task out when its budget runs out.  A task that has used up its
+ * budget is either demoted or suspended until the start of the next period,
+ * so a task that runs away cannot starve the tasks of lower priority.
+ *
+ * A demoted task that holds a mutex still inherits the priority of the tasks
+ * waiting for the mutex.  A suspended one does not run, even to release the
+ * mutex, until its budget is replenished.
+ *
+ * @param xTask Handle of the task whose budget is being set.  Passing a NULL
+ * handle sets the budget of the calling task.
+ *
+ * @param ulBudget The run time, in units of the run time stats counter, the
+ * task can use in each period.  Passing 0 removes the task's budget.
+ *
+ * @param xPeriod The period, in ticks, at which the budget is replenished.
+ * The first period starts when vTaskSetBudget() is called.
+ *
+ * @param eAction eBudgetDemote to lower the priority of the task to
+ * uxDemotedPriority when it uses up its budget, or eBudgetSuspend to not run
+ * the task at all.
+ *
+ * @param uxDemotedPriority The priority of the task while it is demoted.
+ * Not used when eAction is eBudgetSuspend.
+ *
+ * Example usage:
+ * <pre>
+ * void vAFunction( void )
+ * {
+ * TaskHandle_t xHandle;
+ *
+ *   // Create a task, storing the handle.
+ *   xTaskCreate( vTaskCode, "NAME", STACK_SIZE, NULL, tskIDLE_PRIORITY + 3, &xHandle );
+ *
+ *   // Let the task use at most 2ms in every 10ms (the run time counter
+ *   // counts in 10us units here), and drop it to the idle priority if it
+ *   // uses more.
+ *   vTaskSetBudget( xHandle, 200, pdMS_TO_TICKS( 10 ), eBudgetDemote, tskIDLE_PRIORITY );
+ * }
+ * </pre>
+ * \defgroup vTaskSetBudget vTaskSetBudget
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_TASK_BUDGETS == 1 )
+    void vTaskSetBudget( TaskHandle_t xTask,
+                         configRUN_TIME_COUNTER_TYPE ulBudget,
+                         TickType_t xPeriod,
+                         eBudgetAction eAction,
+                         UBaseType_t uxDemotedPriority ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>
+ * void vTaskSetTimeSliceTicks( UBaseType_t uxPriority, TickType_t xTicks );
+ * </pre>
+ *
+ * configUSE_TIME_SLICE_QUANTA must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * Set the time slice of the tasks of one priority.  When time slicing, the
+ * tick interrupt only switches from a task to another ready task of the same
+ * priority once the task has run for xTicks ticks since it was switched in,
+ * so CPU bound tasks of the same priority take longer turns.  A task still
+ * gives up the processor at once when it blocks, yields, or a task of higher
+ * priority becomes ready.  Every priority starts with a time slice of
+ * configTIME_SLICE_TICKS.
+ *
+ * The tasks of configEDF_TASK_PRIORITY, when configUSE_EDF_SCHEDULING is 1,
+ * are not time sliced, so their time slice is not used.
+ *
+ * @param uxPriority The priority whose time slice is being set.
+ *
+ * @param xTicks The time slice in ticks.  Passing 0 sets the time slice back
+ * to configTIME_SLICE_TICKS.
+ *
+ * Example usage:
+ * <pre>
+ * void vAFunction( void )
+ * {
+ *   // The batch tasks at priority 1 each run for 20ms at a time rather than
+ *   // for a single tick.
+ *   vTaskSetTimeSliceTicks( tskIDLE_PRIORITY + 1, pdMS_TO_TICKS( 20 ) );
+ * }
+ * </pre>
+ * \defgroup vTaskSetTimeSliceTicks vTaskSetTimeSliceTicks
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_TIME_SLICE_QUANTA == 1 )
+    void vTaskSetTimeSliceTicks( UBaseType_t uxPriority,
+                                 TickType_t xTicks ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>
+ * TickType_t xTaskGetTimeSliceTicks( UBaseType_t uxPriority );
+ * </pre>
+ *
+ * configUSE_TIME_SLICE_QUANTA must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * @param uxPriority The priority whose time slice is returned.
+ *
+ * @return The time slice, in ticks, of the tasks of priority uxPriority - see
+ * vTaskSetTimeSliceTicks().
+ *
+ * \defgroup xTaskGetTimeSliceTicks xTaskGetTimeSliceTicks
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_TIME_SLICE_QUANTA == 1 )
+    TickType_t xTaskGetTimeSliceTicks( UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <pre>
+ * BaseType_t xTaskYieldIfPeerReady( void );
+ * </pre>
+ *
+ * configUSE_TIME_SLICE_QUANTA must be defined as 1 for this function to be
+ * available.  See the configuration section for more information.
+ *
+ * Yield to another ready task of the same priority as the calling task, if
+ * there is one that is not already running.  Unlike taskYIELD(), no context
+ * switch takes place when there is none, so a CPU bound task can call it often
+ * to give its peers a turn without paying for a switch each time it is alone.
+ *
+ * @return pdTRUE if the calling task yielded, otherwise pdFALSE.
+ *
+ * Example usage:
+ * <pre>
+ * void vBatchTask( void * pvParameters )
+ * {
+ *   for( ;; )
+ *   {
+ *       vProcessBlock();
+ *
+ *       // Let the other batch tasks have a turn between blocks.
+ *       xTaskYieldIfPeerReady();
+ *   }
+ * }
+ * </pre>
+ * \defgroup xTaskYieldIfPeerReady xTaskYieldIfPeerReady
+ * \ingroup SchedulerControl
+ */
+#if ( configUSE_TIME_SLICE_QUANTA == 1 )
+    BaseType_t xTaskYieldIfPeerReady( void ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * task. h
  * <pre>
@@ -1655,6 +2045,66 @@ BaseType_t xTaskCallApplicationTaskHook( TaskHandle_t xTask,
  */
 TaskHandle_t xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * xTaskGetIdleTaskHandleForCore() is only available if
+ * INCLUDE_xTaskGetIdleTaskHandle is set to 1 and configNUMBER_OF_CORES is
+ * greater than 1 in FreeRTOSConfig.h.
+ *
+ * Returns the handle of the idle task created for core xCoreID.  Idle tasks
+ * are not tied to the core they were created for - each core runs whichever
+ * idle task is not running elsewhere when it has nothing else to do.
+ * xTaskGetIdleTaskHandle() returns the idle task created for core 0.
+ */
+#if ( configNUMBER_OF_CORES > 1 )
+    TaskHandle_t xTaskGetIdleTaskHandleForCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <PRE>void vTaskCoreAffinitySet( const TaskHandle_t xTask, UBaseType_t uxCoreAffinityMask );</PRE>
+ *
+ * configUSE_CORE_AFFINITY must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available, which requires configNUMBER_OF_CORES to be
+ * greater than 1.
+ *
+ * Sets the cores a task is allowed to run on.  Bit n of uxCoreAffinityMask
+ * is set if the task can run on core n, so ( 1 << 0 ) pins the task to core 0
+ * and tskNO_AFFINITY, the affinity every task is created with, lets the task
+ * run on any core.  If the task is running on a core it is no longer allowed
+ * to run on then that core is switched to another task.
+ *
+ * @param xTask The handle of the task, or NULL to set the affinity of the
+ * calling task.
+ *
+ * @param uxCoreAffinityMask The cores the task can run on.  At least one of
+ * the bits 0 to ( configNUMBER_OF_CORES - 1 ) must be set.
+ *
+ * \defgroup vTaskCoreAffinitySet vTaskCoreAffinitySet
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_CORE_AFFINITY == 1 )
+    void vTaskCoreAffinitySet( const TaskHandle_t xTask,
+                               UBaseType_t uxCoreAffinityMask ) PRIVILEGED_FUNCTION;
+#endif
+
+/**
+ * task. h
+ * <PRE>UBaseType_t vTaskCoreAffinityGet( const TaskHandle_t xTask );</PRE>
+ *
+ * configUSE_CORE_AFFINITY must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xTask The handle of the task, or NULL to query the calling task.
+ *
+ * @return The core affinity mask of the task, see vTaskCoreAffinitySet().
+ *
+ * \defgroup vTaskCoreAffinityGet vTaskCoreAffinityGet
+ * \ingroup TaskCtrl
+ */
+#if ( configUSE_CORE_AFFINITY == 1 )
+    UBaseType_t vTaskCoreAffinityGet( const TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * configUSE_TRACE_FACILITY must be defined as 1 in FreeRTOSConfig.h for
  * uxTaskGetSystemState() to be available.
@@ -1683,6 +2133,8 @@ TaskHandle_t xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
  * total run time (as defined by the run time stats clock, see
  * https://www.FreeRTOS.org/rtos-run-time-stats.html) since the target booted.
  * pulTotalRunTime can be set to NULL to omit the total run time information.
+ * The run times are of type configRUN_TIME_COUNTER_TYPE, which can be set to
+ * uint64_t in FreeRTOSConfig.h so they do not wrap in long runs.
  *
  * @return The number of TaskStatus_t structures that were populated by
  * uxTaskGetSystemState().  This should equal the number returned by the
@@ -1698,7 +2150,7 @@ TaskHandle_t xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
  *  {
  *  TaskStatus_t *pxTaskStatusArray;
  *  volatile UBaseType_t uxArraySize, x;
- *  uint32_t ulTotalRunTime, ulStatsAsPercentage;
+ *  configRUN_TIME_COUNTER_TYPE ulTotalRunTime, ulStatsAsPercentage;
  *
  *      // Make sure the write buffer does not contain a string.
  * pcWriteBuffer = 0x00;
@@ -1754,7 +2206,118 @@ TaskHandle_t xTaskGetIdleTaskHandle( void ) PRIVILEGED_FUNCTION;
  */
 UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
                                   const UBaseType_t uxArraySize,
-                                  uint32_t * const pulTotalRunTime ) PRIVILEGED_FUNCTION;
+                                  configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>void vTaskInitStateCursor( TaskStateCursor_t * pxCursor );</PRE>
+ * <PRE>UBaseType_t uxTaskGetNextTaskStates( TaskStateCursor_t * pxCursor, TaskStatus_t * pxTaskStatusArray, UBaseType_t uxArraySize, BaseType_t xGetFreeStackSpace );</PRE>
+ *
+ * configUSE_TRACE_FACILITY must be defined as 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * uxTaskGetSystemState() holds the scheduler suspended while it visits every
+ * task, and needs an array large enough for all of them.  These functions
+ * instead visit the tasks in the order they were created, up to uxArraySize at
+ * a time, and the scheduler runs between the calls.  vTaskInitStateCursor()
+ * starts a walk over the tasks, and each call to uxTaskGetNextTaskStates() fills
+ * in a TaskStatus_t structure for each of the next uxArraySize tasks and moves
+ * the cursor past them.  A task that is deleted before it is reached is not
+ * visited, and one created during the walk is visited if it is created before
+ * the walk ends.  No task is visited twice.
+ *
+ * @param pxCursor The cursor, initialised by vTaskInitStateCursor().
+ *
+ * @param pxTaskStatusArray An array of uxArraySize TaskStatus_t structures.
+ *
+ * @param uxArraySize The most tasks to visit in this call, which bounds the time
+ * the scheduler is suspended for.
+ *
+ * @param xGetFreeStackSpace As vTaskGetInfo() - pdFALSE skips the stack high
+ * water mark, which takes a scan of each stack.
+ *
+ * @return The number of TaskStatus_t structures filled in.  0 means every task
+ * has been visited.
+ *
+ * Example usage:
+ * <pre>
+ *  TaskStateCursor_t xCursor;
+ *  TaskStatus_t xStatus[ 4 ];
+ *  UBaseType_t x, uxCount;
+ *
+ *      vTaskInitStateCursor( &xCursor );
+ *
+ *      while( ( uxCount = uxTaskGetNextTaskStates( &xCursor, xStatus, 4, pdTRUE ) ) > 0 )
+ *      {
+ *          for( x = 0; x < uxCount; x++ )
+ *          {
+ *              // Report xStatus[ x ].
+ *          }
+ *      }
+ * </pre>
+ *
+ * \defgroup uxTaskGetNextTaskStates uxTaskGetNextTaskStates
+ * \ingroup TaskUtils
+ */
+void vTaskInitStateCursor( TaskStateCursor_t * pxCursor ) PRIVILEGED_FUNCTION;
+UBaseType_t uxTaskGetNextTaskStates( TaskStateCursor_t * pxCursor,
+                                     TaskStatus_t * pxTaskStatusArray,
+                                     UBaseType_t uxArraySize,
+                                     BaseType_t xGetFreeStackSpace ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>size_t xTaskSerialiseTaskStatus( const TaskStatus_t * pxTaskStatus, uint8_t * pucBuffer, size_t xBufferLength );</PRE>
+ * <PRE>size_t xTaskSerialiseNextTaskStates( TaskStateCursor_t * pxCursor, uint8_t * pucBuffer, size_t xBufferLength );</PRE>
+ *
+ * configUSE_TRACE_FACILITY must be defined as 1 in FreeRTOSConfig.h for these
+ * functions to be available.
+ *
+ * Write the state of tasks in a compact binary form, for a monitoring task to
+ * send off the target in place of the text written by vTaskList() and
+ * vTaskGetRunTimeStats().  Each task is written as the following fields, where
+ * a number is written 7 bits at a time, least significant first, with the top
+ * bit of every byte but the last set (unsigned LEB128):
+ *
+ *  number   xTaskNumber
+ *  byte     eCurrentState
+ *  number   uxCurrentPriority
+ *  number   uxBasePriority
+ *  number   usStackHighWaterMark
+ *  number   ulRunTimeCounter
+ *  number   ulSwitchesIn
+ *  number   ulPreemptions
+ *  number   ulWakeups
+ *  number   ulMinWakeLatency
+ *  number   ulAvgWakeLatency
+ *  number   ulMaxWakeLatency
+ *  number   uxDeadlineMisses
+ *  number   uxBudgetOverruns
+ *  byte     The length of the task name, followed by the name itself without
+ *           a terminating null.
+ *
+ * A task takes no more than tskSERIALISED_TASK_STATUS_MAX_LENGTH bytes, and
+ * typically around 20 bytes plus its name.
+ *
+ * xTaskSerialiseTaskStatus() writes one TaskStatus_t structure.
+ * xTaskSerialiseNextTaskStates() writes the states of as many of the tasks not
+ * yet visited by pxCursor as fit in the buffer, one task at a time as
+ * uxTaskGetNextTaskStates(), and moves the cursor past them.
+ *
+ * @return The number of bytes written.  xTaskSerialiseTaskStatus() returns 0
+ * if the task does not fit in the buffer.  xTaskSerialiseNextTaskStates()
+ * returns 0 once every task has been visited, provided the buffer is at least
+ * tskSERIALISED_TASK_STATUS_MAX_LENGTH bytes long.
+ *
+ * \defgroup xTaskSerialiseTaskStatus xTaskSerialiseTaskStatus
+ * \ingroup TaskUtils
+ */
+size_t xTaskSerialiseTaskStatus( const TaskStatus_t * pxTaskStatus,
+                                 uint8_t * pucBuffer,
+                                 size_t xBufferLength ) PRIVILEGED_FUNCTION;
+size_t xTaskSerialiseNextTaskStates( TaskStateCursor_t * pxCursor,
+                                     uint8_t * pucBuffer,
+                                     size_t xBufferLength ) PRIVILEGED_FUNCTION;
 
 /**
  * task. h
@@ -1764,8 +2327,9 @@ UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
  * both be defined as 1 for this function to be available.  See the
  * configuration section of the FreeRTOS.org website for more information.
  *
- * NOTE 1: This function will disable interrupts for its duration.  It is
- * not intended for normal application runtime use but as a debug aid.
+ * NOTE 1: This function suspends the scheduler each time it fetches the
+ * state of the next few tasks.  It is not intended for normal application
+ * runtime use but as a debug aid.
  *
  * Lists all the current tasks, along with their current state and stack
  * usage high water mark.
@@ -1778,9 +2342,9 @@ UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
  * This function is provided for convenience only, and is used by many of the
  * demo applications.  Do not consider it to be part of the scheduler.
  *
- * vTaskList() calls uxTaskGetSystemState(), then formats part of the
- * uxTaskGetSystemState() output into a human readable table that displays task
- * names, states and stack usage.
+ * vTaskList() calls uxTaskGetNextTaskStates(), then formats part of the
+ * uxTaskGetNextTaskStates() output into a human readable table that displays
+ * task names, states and stack usage.
  *
  * vTaskList() has a dependency on the sprintf() C library function that might
  * bloat the code size, use a lot of stack, and provide different results on
@@ -1789,9 +2353,9 @@ UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
  * FreeRTOS/Demo sub-directories in a file called printf-stdarg.c (note
  * printf-stdarg.c does not provide a full snprintf() implementation!).
  *
- * It is recommended that production systems call uxTaskGetSystemState()
- * directly to get access to raw stats data, rather than indirectly through a
- * call to vTaskList().
+ * It is recommended that production systems call uxTaskGetNextTaskStates() or
+ * xTaskSerialiseNextTaskStates() directly to get access to raw stats data,
+ * rather than indirectly through a call to vTaskList().
  *
  * @param pcWriteBuffer A buffer into which the above mentioned details
  * will be written, in ASCII form.  This buffer is assumed to be large
@@ -1815,8 +2379,9 @@ void vTaskList( char * pcWriteBuffer ) PRIVILEGED_FUNCTION;     /*lint !e971 Unq
  * value respectively.  The counter should be at least 10 times the frequency of
  * the tick count.
  *
- * NOTE 1: This function will disable interrupts for its duration.  It is
- * not intended for normal application runtime use but as a debug aid.
+ * NOTE 1: This function suspends the scheduler each time it fetches the
+ * state of the next few tasks.  It is not intended for normal application
+ * runtime use but as a debug aid.
  *
  * Setting configGENERATE_RUN_TIME_STATS to 1 will result in a total
  * accumulated execution time being stored for each task.  The resolution
@@ -1831,10 +2396,10 @@ void vTaskList( char * pcWriteBuffer ) PRIVILEGED_FUNCTION;     /*lint !e971 Unq
  * This function is provided for convenience only, and is used by many of the
  * demo applications.  Do not consider it to be part of the scheduler.
  *
- * vTaskGetRunTimeStats() calls uxTaskGetSystemState(), then formats part of the
- * uxTaskGetSystemState() output into a human readable table that displays the
- * amount of time each task has spent in the Running state in both absolute and
- * percentage terms.
+ * vTaskGetRunTimeStats() calls uxTaskGetNextTaskStates(), then formats part of
+ * the uxTaskGetNextTaskStates() output into a human readable table that
+ * displays the amount of time each task has spent in the Running state in both
+ * absolute and percentage terms.
  *
  * vTaskGetRunTimeStats() has a dependency on the sprintf() C library function
  * that might bloat the code size, use a lot of stack, and provide different
@@ -1843,9 +2408,9 @@ void vTaskList( char * pcWriteBuffer ) PRIVILEGED_FUNCTION;     /*lint !e971 Unq
  * FreeRTOS/Demo sub-directories in a file called printf-stdarg.c (note
  * printf-stdarg.c does not provide a full snprintf() implementation!).
  *
- * It is recommended that production systems call uxTaskGetSystemState() directly
- * to get access to raw stats data, rather than indirectly through a call to
- * vTaskGetRunTimeStats().
+ * It is recommended that production systems call uxTaskGetNextTaskStates() or
+ * xTaskSerialiseNextTaskStates() directly to get access to raw stats data,
+ * rather than indirectly through a call to vTaskGetRunTimeStats().
  *
  * @param pcWriteBuffer A buffer into which the execution times will be
  * written, in ASCII form.  This buffer is assumed to be large enough to
@@ -1859,7 +2424,7 @@ void vTaskGetRunTimeStats( char * pcWriteBuffer ) PRIVILEGED_FUNCTION;     /*lin
 
 /**
  * task. h
- * <PRE>uint32_t ulTaskGetIdleRunTimeCounter( void );</PRE>
+ * <PRE>configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void );</PRE>
  *
  * configGENERATE_RUN_TIME_STATS and configUSE_STATS_FORMATTING_FUNCTIONS
  * must both be defined as 1 for this function to be available.  The application
@@ -1885,7 +2450,33 @@ void vTaskGetRunTimeStats( char * pcWriteBuffer ) PRIVILEGED_FUNCTION;     /*lin
  * \defgroup ulTaskGetIdleRunTimeCounter ulTaskGetIdleRunTimeCounter
  * \ingroup TaskUtils
  */
-uint32_t ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
+configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>configRUN_TIME_COUNTER_TYPE ulTaskGetCoreRunTimeCounter( BaseType_t xCoreID );</PRE>
+ * <PRE>configRUN_TIME_COUNTER_TYPE ulTaskGetCoreIdleRunTimeCounter( BaseType_t xCoreID );</PRE>
+ *
+ * configGENERATE_RUN_TIME_STATS must be defined as 1, and
+ * configNUMBER_OF_CORES must be greater than 1, for these functions to be
+ * available.
+ *
+ * The run time of each task is the sum of the time it ran on every core.
+ * These functions instead return how one core spent its time, in the same
+ * units - ulTaskGetCoreRunTimeCounter() the time core xCoreID spent running
+ * tasks other than the idle tasks, and ulTaskGetCoreIdleRunTimeCounter() the
+ * time it spent running an idle task.  Both include the time the task that
+ * is running on the core now has been running since it was switched in.
+ * With ulTaskGetIdleRunTimeCounter(), which returns the total of all the
+ * idle tasks, they show how evenly the work was spread over the cores.
+ *
+ * \defgroup ulTaskGetCoreRunTimeCounter ulTaskGetCoreRunTimeCounter
+ * \ingroup TaskUtils
+ */
+#if ( configNUMBER_OF_CORES > 1 )
+    configRUN_TIME_COUNTER_TYPE ulTaskGetCoreRunTimeCounter( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+    configRUN_TIME_COUNTER_TYPE ulTaskGetCoreIdleRunTimeCounter( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#endif
 
 /**
  * task. h
@@ -2454,6 +3045,104 @@ void vTaskGenericNotifyGiveFromISR( TaskHandle_t xTaskToNotify,
 #define vTaskNotifyGiveIndexedFromISR( xTaskToNotify, uxIndexToNotify, pxHigherPriorityTaskWoken ) \
     vTaskGenericNotifyGiveFromISR( ( xTaskToNotify ), ( uxIndexToNotify ), ( pxHigherPriorityTaskWoken ) );
 
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotifyMultipleIndexed( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
+ * <PRE>BaseType_t xTaskNotifyMultiple( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
+ * <PRE>BaseType_t xTaskNotifyGiveMultipleIndexed( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, UBaseType_t uxIndexToNotify );</PRE>
+ * <PRE>BaseType_t xTaskNotifyGiveMultiple( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify );</PRE>
+ *
+ * Send the same notification to each task in an array, as a broadcast.
+ *
+ * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for these
+ * functions to be available.
+ *
+ * Each task is notified exactly as by xTaskNotifyIndexed(), or by
+ * xTaskNotifyGiveIndexed() for the Give versions, but all the tasks are
+ * notified in a single critical section, and whether a context switch is
+ * needed is decided once, after the last task has been notified.  So notifying
+ * many tasks takes one critical section rather than one for each task, and
+ * causes at most one context switch on the calling core - to the highest
+ * priority task unblocked - rather than possibly switching to each task in turn
+ * before the next one is notified.
+ *
+ * The array is walked in order with interrupts masked, so the time interrupts
+ * are masked grows with the number of tasks notified.
+ *
+ * @param pxTasksToNotify An array of the handles of the tasks to notify.
+ *
+ * @param uxTasksToNotify The number of handles in the array.
+ *
+ * @param uxIndexToNotify The index within each task's array of notification
+ * values to which the notification is sent.  uxIndexToNotify must be less than
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES.  xTaskNotifyMultiple() and
+ * xTaskNotifyGiveMultiple() do not have this parameter and always send
+ * notifications to index 0.
+ *
+ * @param ulValue Data sent with the notification, used as by
+ * xTaskNotifyIndexed().
+ *
+ * @param eAction How the notification updates the notification value of each
+ * task, as for xTaskNotifyIndexed().
+ *
+ * @return pdFAIL if eAction is eSetValueWithoutOverwrite and the value could
+ * not be written to at least one of the tasks, which all the other tasks are
+ * still notified of.  Otherwise pdPASS.
+ *
+ * \defgroup xTaskNotifyMultipleIndexed xTaskNotifyMultipleIndexed
+ * \ingroup TaskNotifications
+ */
+BaseType_t xTaskGenericNotifyMultiple( const TaskHandle_t * pxTasksToNotify,
+                                       UBaseType_t uxTasksToNotify,
+                                       UBaseType_t uxIndexToNotify,
+                                       uint32_t ulValue,
+                                       eNotifyAction eAction ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyMultiple( pxTasksToNotify, uxTasksToNotify, ulValue, eAction ) \
+    xTaskGenericNotifyMultiple( ( pxTasksToNotify ), ( uxTasksToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ) )
+#define xTaskNotifyMultipleIndexed( pxTasksToNotify, uxTasksToNotify, uxIndexToNotify, ulValue, eAction ) \
+    xTaskGenericNotifyMultiple( ( pxTasksToNotify ), ( uxTasksToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ) )
+#define xTaskNotifyGiveMultiple( pxTasksToNotify, uxTasksToNotify ) \
+    xTaskGenericNotifyMultiple( ( pxTasksToNotify ), ( uxTasksToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( 0 ), eIncrement )
+#define xTaskNotifyGiveMultipleIndexed( pxTasksToNotify, uxTasksToNotify, uxIndexToNotify ) \
+    xTaskGenericNotifyMultiple( ( pxTasksToNotify ), ( uxTasksToNotify ), ( uxIndexToNotify ), ( 0 ), eIncrement )
+
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotifyMultipleIndexedFromISR( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, UBaseType_t uxIndexToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>BaseType_t xTaskNotifyMultipleFromISR( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>void vTaskNotifyGiveMultipleIndexedFromISR( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, UBaseType_t uxIndexToNotify, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ * <PRE>void vTaskNotifyGiveMultipleFromISR( const TaskHandle_t *pxTasksToNotify, UBaseType_t uxTasksToNotify, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ *
+ * Versions of xTaskNotifyMultipleIndexed() and xTaskNotifyGiveMultipleIndexed()
+ * that can be called from an interrupt service routine (ISR).  All the tasks
+ * are notified with interrupts masked once.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if notifying the tasks
+ * unblocked at least one task with a priority higher than the currently
+ * running task, in which case a single context switch should be requested
+ * before the interrupt is exited.
+ *
+ * The other parameters and the return value are as for
+ * xTaskNotifyMultipleIndexed().
+ *
+ * \defgroup xTaskNotifyMultipleIndexedFromISR xTaskNotifyMultipleIndexedFromISR
+ * \ingroup TaskNotifications
+ */
+BaseType_t xTaskGenericNotifyMultipleFromISR( const TaskHandle_t * pxTasksToNotify,
+                                              UBaseType_t uxTasksToNotify,
+                                              UBaseType_t uxIndexToNotify,
+                                              uint32_t ulValue,
+                                              eNotifyAction eAction,
+                                              BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyMultipleFromISR( pxTasksToNotify, uxTasksToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) \
+    xTaskGenericNotifyMultipleFromISR( ( pxTasksToNotify ), ( uxTasksToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( ulValue ), ( eAction ), ( pxHigherPriorityTaskWoken ) )
+#define xTaskNotifyMultipleIndexedFromISR( pxTasksToNotify, uxTasksToNotify, uxIndexToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) \
+    xTaskGenericNotifyMultipleFromISR( ( pxTasksToNotify ), ( uxTasksToNotify ), ( uxIndexToNotify ), ( ulValue ), ( eAction ), ( pxHigherPriorityTaskWoken ) )
+#define vTaskNotifyGiveMultipleFromISR( pxTasksToNotify, uxTasksToNotify, pxHigherPriorityTaskWoken ) \
+    ( void ) xTaskGenericNotifyMultipleFromISR( ( pxTasksToNotify ), ( uxTasksToNotify ), ( tskDEFAULT_INDEX_TO_NOTIFY ), ( 0 ), eIncrement, ( pxHigherPriorityTaskWoken ) )
+#define vTaskNotifyGiveMultipleIndexedFromISR( pxTasksToNotify, uxTasksToNotify, uxIndexToNotify, pxHigherPriorityTaskWoken ) \
+    ( void ) xTaskGenericNotifyMultipleFromISR( ( pxTasksToNotify ), ( uxTasksToNotify ), ( uxIndexToNotify ), ( 0 ), eIncrement, ( pxHigherPriorityTaskWoken ) )
+
 /**
  * task. h
  * <pre>
@@ -2928,9 +3617,16 @@ void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
  * AN INTERFACE WHICH IS FOR THE EXCLUSIVE USE OF THE SCHEDULER.
  *
  * Sets the pointer to the current TCB to the TCB of the highest priority task
- * that is ready to run.
- */
-portDONT_DISCARD void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
+ * that is ready to run.  When configNUMBER_OF_CORES is greater than 1 it
+ * selects the task for core xCoreID, and the port must call it with both the
+ * task lock and the interrupt (ISR) lock held, and with portGET_CORE_ID()
+ * returning xCoreID.
+ */
+#if ( configNUMBER_OF_CORES == 1 )
+    portDONT_DISCARD void vTaskSwitchContext( void ) PRIVILEGED_FUNCTION;
+#else
+    portDONT_DISCARD void vTaskSwitchContext( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+#endif
 
 /*
  * THESE FUNCTIONS MUST NOT BE USED FROM APPLICATION CODE.  THEY ARE USED BY
@@ -2978,6 +3674,38 @@ BaseType_t xTaskPriorityDisinherit( TaskHandle_t const pxMutexHolder ) PRIVILEGE
 void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder,
                                           UBaseType_t uxHighestPriorityWaitingTask ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Return the priority of the highest priority task
+ * blocked on pxEventList by its own event list item, or tskIDLE_PRIORITY if
+ * there is none.  List items placed on the list by xMultiWaitForObjects() are
+ * skipped, as waiting on a mutex that way does not cause priority inheritance.
+ * Must be called from a critical section.
+ */
+UBaseType_t uxTaskGetHighestWaitingPriority( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Record where the holder of the mutex the calling task
+ * is about to block on is stored, so that priority inheritance can follow the
+ * chain from this task to the task holding that mutex, or NULL once the task
+ * is no longer waiting for the mutex.  Only available when
+ * configPRIORITY_INHERITANCE_CHAIN_LENGTH is greater than 1.
+ */
+void vTaskSetBlockingMutex( TaskHandle_t * const pxMutexHolder ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Returns pdTRUE if the base priority of the calling
+ * task is above the priority ceiling of a mutex it is about to take, otherwise
+ * pdFALSE.
+ */
+BaseType_t xTaskPriorityAboveCeiling( UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+
+/*
+ * For internal use only.  Raise the calling task, which has just taken a mutex
+ * with a priority ceiling, to the ceiling priority.  The task returns to its
+ * base priority through xTaskPriorityDisinherit() once it holds no mutexes.
+ */
+void vTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority ) PRIVILEGED_FUNCTION;
+
 /*
  * Get the uxTCBNumber assigned to the task referenced by the xTask parameter.
  */
@@ -2990,6 +3718,13 @@ UBaseType_t uxTaskGetTaskNumber( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 void vTaskSetTaskNumber( TaskHandle_t xTask,
                          const UBaseType_t uxHandle ) PRIVILEGED_FUNCTION;
 
+/*
+ * Get the number the kernel gave the task referenced by the xTask parameter
+ * when it was created.  Tasks are numbered from 1 in the order they are
+ * created, and unlike uxTaskNumber the number cannot be changed by trace code.
+ */
+UBaseType_t uxTaskGetTCBNumber( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /*
  * Only available when configUSE_TICKLESS_IDLE is set to 1.
  * If tickless mode is being used, or a low power mode is implemented, then
@@ -3028,6 +3763,33 @@ TaskHandle_t pvTaskIncrementMutexHeldCount( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskInternalSetTimeOutState( TimeOut_t * const pxTimeOut ) PRIVILEGED_FUNCTION;
 
+/*
+ * For internal use only.  Used by xMultiWaitForObjects(), see multiwait.h.
+ * THESE FUNCTIONS MUST BE CALLED WITH INTERRUPTS DISABLED AND THE SCHEDULER
+ * SUSPENDED.
+ *
+ * vTaskPlaceMultiWaitItemOnEventList() and
+ * vTaskPlaceMultiWaitItemOnUnorderedEventList() place a list item of the
+ * calling task on an event list, as vTaskPlaceOnEventList() and
+ * vTaskPlaceOnUnorderedEventList() place the task's own event list item, but
+ * without blocking the task.  vTaskMultiWaitBlock() then blocks the task on all
+ * of pxObjects, until the first of them wakes it or xTicksToWait passes, and
+ * vTaskMultiWaitEnd() removes the task from the event lists that still hold it
+ * once it runs again.  xTaskMultiWaitNotificationPending() returns pdTRUE if
+ * the calling task has a notification pending at uxIndexToWaitOn.
+ */
+struct xMULTI_WAIT_OBJECT;
+void vTaskPlaceMultiWaitItemOnEventList( List_t * const pxEventList,
+                                         ListItem_t * const pxEventListItem ) PRIVILEGED_FUNCTION;
+void vTaskPlaceMultiWaitItemOnUnorderedEventList( List_t * pxEventList,
+                                                  ListItem_t * const pxEventListItem,
+                                                  const TickType_t xItemValue ) PRIVILEGED_FUNCTION;
+BaseType_t xTaskMultiWaitNotificationPending( UBaseType_t uxIndexToWaitOn ) PRIVILEGED_FUNCTION;
+void vTaskMultiWaitBlock( struct xMULTI_WAIT_OBJECT * const pxObjects,
+                          const UBaseType_t uxObjectCount,
+                          const TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+void vTaskMultiWaitEnd( void ) PRIVILEGED_FUNCTION;
+
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
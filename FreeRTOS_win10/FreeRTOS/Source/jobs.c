@@ -0,0 +1,577 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "jobs.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include dynamic memory allocation, as the job system and its workers are
+ * allocated from the FreeRTOS heap. */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    #if ( configUSE_TASK_NOTIFICATIONS != 1 )
+        #error configUSE_TASK_NOTIFICATIONS must be set to 1 in FreeRTOSConfig.h to use the job system.
+    #endif
+
+    #if ( configJOBS_NOTIFICATION_INDEX >= configTASK_NOTIFICATION_ARRAY_ENTRIES )
+        #error configJOBS_NOTIFICATION_INDEX must be less than configTASK_NOTIFICATION_ARRAY_ENTRIES.
+    #endif
+
+/* A worker and its deque of jobs.  The deque is a ring buffer holding uxCount
+ * jobs from index uxHead.  The worker takes jobs from the tail, so the job it
+ * submitted last, while the other workers steal from the head. */
+    typedef struct JobWorkerDef_t
+    {
+        Job_t ** ppxJobs;                      /*< The ring buffer of the deque. */
+        UBaseType_t uxHead;                    /*< The index of the oldest job in the deque. */
+        UBaseType_t uxCount;                   /*< The number of jobs in the deque. */
+        TaskHandle_t xTask;                    /*< The worker task. */
+        BaseType_t xSleeping;                  /*< pdTRUE while the worker is blocked, or about to block, with no job to run. */
+        struct JobSystemDef_t * pxJobSystem;   /*< The job system the worker belongs to. */
+    } JobWorker_t;
+
+    typedef struct JobSystemDef_t
+    {
+        JobWorker_t * pxWorkers;               /*< The workers, allocated after the job system. */
+        UBaseType_t uxWorkers;                 /*< The number of workers. */
+        UBaseType_t uxJobsPerWorker;           /*< The length of the deque of each worker. */
+        UBaseType_t uxNextWorker;              /*< The worker jobs submitted by other tasks go to next, and the first deque they steal from. */
+    } JobSystem_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The function implemented by each worker task.
+ */
+    static portTASK_FUNCTION_PROTO( prvJobWorkerTask, pvParameters ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the worker the calling task is, or NULL if it is not a worker of the
+ * job system.
+ */
+    static JobWorker_t * prvGetCurrentWorker( const JobSystem_t * pxJobSystem ) PRIVILEGED_FUNCTION;
+
+/*
+ * Take a job to run, from the deque of pxWorker if pxWorker is not NULL, or
+ * else from the deque of any worker.  NULL is returned if there is no job to
+ * run, or pxAwaited is not NULL and has finished.  When NULL is returned and
+ * *pxBlock is set to pdTRUE the caller must block on its notification, as it
+ * has recorded that it is sleeping or waiting for pxAwaited in the same
+ * critical section in which it found no job, so cannot miss its wake up.
+ */
+    static Job_t * prvTakeJob( JobSystem_t * pxJobSystem,
+                               JobWorker_t * pxWorker,
+                               Job_t * pxAwaited,
+                               BaseType_t * pxBlock ) PRIVILEGED_FUNCTION;
+
+/*
+ * Run a job and then mark it as run.
+ */
+    static void prvRunJob( Job_t * pxJob ) PRIVILEGED_FUNCTION;
+
+/*
+ * Decrement the count of unfinished work of a job, and of its parent in turn
+ * each time the count reaches 0, notifying the task waiting for each job that
+ * finishes.
+ */
+    static void prvFinishJob( Job_t * pxJob ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    JobSystemHandle_t xJobSystemCreate( UBaseType_t uxWorkers,
+                                        UBaseType_t uxJobsPerWorker,
+                                        configSTACK_DEPTH_TYPE usStackDepth,
+                                        UBaseType_t uxPriority )
+    {
+        JobSystem_t * pxJobSystem;
+        Job_t ** ppxJobs;
+        UBaseType_t uxWorker;
+        BaseType_t xResult = pdPASS;
+
+        configASSERT( uxWorkers > ( UBaseType_t ) 0U );
+        configASSERT( uxJobsPerWorker > ( UBaseType_t ) 0U );
+
+        #if ( configNUMBER_OF_CORES == 1 )
+            {
+                /* Only one worker can run at a time, so further workers would
+                 * only add context switches between jobs.  A single worker runs
+                 * the jobs to completion one after the other. */
+                uxWorkers = ( UBaseType_t ) 1U;
+            }
+        #endif
+
+        /* The job system, its workers and their deques are allocated in one
+         * block.  The deques follow the workers, and pointers need no stricter
+         * alignment than the structures before them. */
+        pxJobSystem = ( JobSystem_t * ) pvPortMalloc( sizeof( JobSystem_t ) +
+                                                      ( uxWorkers * sizeof( JobWorker_t ) ) +
+                                                      ( uxWorkers * uxJobsPerWorker * sizeof( Job_t * ) ) ); /*lint !e9087 !e9079 Casting from void * to the structure type is safe as the memory is allocated for it. */
+
+        if( pxJobSystem != NULL )
+        {
+            pxJobSystem->pxWorkers = ( JobWorker_t * ) &( pxJobSystem[ 1 ] ); /*lint !e9087 !e9079 The workers follow the job system. */
+            pxJobSystem->uxWorkers = uxWorkers;
+            pxJobSystem->uxJobsPerWorker = uxJobsPerWorker;
+            pxJobSystem->uxNextWorker = ( UBaseType_t ) 0U;
+
+            ppxJobs = ( Job_t ** ) &( pxJobSystem->pxWorkers[ uxWorkers ] ); /*lint !e9087 !e9079 The deques follow the workers. */
+
+            /* Every worker must be initialised before any worker task runs, as
+             * the workers look into each other's deques. */
+            for( uxWorker = ( UBaseType_t ) 0U; uxWorker < uxWorkers; uxWorker++ )
+            {
+                pxJobSystem->pxWorkers[ uxWorker ].ppxJobs = &( ppxJobs[ uxWorker * uxJobsPerWorker ] );
+                pxJobSystem->pxWorkers[ uxWorker ].uxHead = ( UBaseType_t ) 0U;
+                pxJobSystem->pxWorkers[ uxWorker ].uxCount = ( UBaseType_t ) 0U;
+                pxJobSystem->pxWorkers[ uxWorker ].xTask = NULL;
+                pxJobSystem->pxWorkers[ uxWorker ].xSleeping = pdFALSE;
+                pxJobSystem->pxWorkers[ uxWorker ].pxJobSystem = pxJobSystem;
+            }
+
+            for( uxWorker = ( UBaseType_t ) 0U; uxWorker < uxWorkers; uxWorker++ )
+            {
+                xResult = xTaskCreate( prvJobWorkerTask,
+                                       "Job",
+                                       usStackDepth,
+                                       ( void * ) &( pxJobSystem->pxWorkers[ uxWorker ] ),
+                                       uxPriority,
+                                       &( pxJobSystem->pxWorkers[ uxWorker ].xTask ) );
+
+                if( xResult != pdPASS )
+                {
+                    break;
+                }
+            }
+
+            if( xResult != pdPASS )
+            {
+                /* No job has been submitted yet, so the workers created so far
+                 * are idle and can be deleted with the job system. */
+                for( uxWorker = ( UBaseType_t ) 0U; uxWorker < uxWorkers; uxWorker++ )
+                {
+                    if( pxJobSystem->pxWorkers[ uxWorker ].xTask != NULL )
+                    {
+                        vTaskDelete( pxJobSystem->pxWorkers[ uxWorker ].xTask );
+                    }
+                }
+
+                vPortFree( pxJobSystem );
+                pxJobSystem = NULL;
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxJobSystem;
+    }
+/*-----------------------------------------------------------*/
+
+    void vJobInit( Job_t * pxJob,
+                   JobFunction_t pxJobCode,
+                   void * pvParameter,
+                   Job_t * pxParent )
+    {
+        configASSERT( pxJob );
+        configASSERT( pxJobCode );
+
+        pxJob->pxJobCode = pxJobCode;
+        pxJob->pvParameter = pvParameter;
+        pxJob->pxParent = pxParent;
+        pxJob->uxUnfinished = ( UBaseType_t ) 1U;
+        pxJob->xWaitingTask = NULL;
+
+        if( pxParent != NULL )
+        {
+            taskENTER_CRITICAL();
+            {
+                /* A parent that has finished may already have been waited
+                 * for, so can no longer gain children. */
+                configASSERT( pxParent->uxUnfinished > ( UBaseType_t ) 0U );
+                ( pxParent->uxUnfinished )++;
+            }
+            taskEXIT_CRITICAL();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vJobSubmit( JobSystemHandle_t xJobSystem,
+                     Job_t * pxJob )
+    {
+        JobSystem_t * pxJobSystem = xJobSystem;
+        JobWorker_t * pxWorker;
+        JobWorker_t * pxCurrentWorker;
+        TaskHandle_t xTaskToWake = NULL;
+        UBaseType_t uxWorker;
+        BaseType_t xQueued = pdFALSE;
+
+        configASSERT( pxJobSystem );
+        configASSERT( pxJob );
+
+        pxCurrentWorker = prvGetCurrentWorker( pxJobSystem );
+
+        taskENTER_CRITICAL();
+        {
+            if( pxCurrentWorker != NULL )
+            {
+                /* A job submitted by a job goes on the submitting worker's own
+                 * deque, where it is likely to run next, on the same core as
+                 * the job that prepared its data. */
+                if( pxCurrentWorker->uxCount < pxJobSystem->uxJobsPerWorker )
+                {
+                    pxCurrentWorker->ppxJobs[ ( pxCurrentWorker->uxHead + pxCurrentWorker->uxCount ) % pxJobSystem->uxJobsPerWorker ] = pxJob;
+                    ( pxCurrentWorker->uxCount )++;
+                    xQueued = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* Jobs from other tasks are spread over the workers in turn. */
+                for( uxWorker = ( UBaseType_t ) 0U; uxWorker < pxJobSystem->uxWorkers; uxWorker++ )
+                {
+                    pxWorker = &( pxJobSystem->pxWorkers[ pxJobSystem->uxNextWorker ] );
+                    pxJobSystem->uxNextWorker = ( pxJobSystem->uxNextWorker + ( UBaseType_t ) 1U ) % pxJobSystem->uxWorkers;
+
+                    if( pxWorker->uxCount < pxJobSystem->uxJobsPerWorker )
+                    {
+                        pxWorker->ppxJobs[ ( pxWorker->uxHead + pxWorker->uxCount ) % pxJobSystem->uxJobsPerWorker ] = pxJob;
+                        ( pxWorker->uxCount )++;
+                        xQueued = pdTRUE;
+                        break;
+                    }
+                }
+            }
+
+            if( xQueued != pdFALSE )
+            {
+                /* Wake one worker that has run out of jobs, which will find
+                 * this one either in its own deque or by stealing it. */
+                for( uxWorker = ( UBaseType_t ) 0U; uxWorker < pxJobSystem->uxWorkers; uxWorker++ )
+                {
+                    pxWorker = &( pxJobSystem->pxWorkers[ uxWorker ] );
+
+                    if( ( pxWorker->xSleeping != pdFALSE ) && ( pxWorker != pxCurrentWorker ) )
+                    {
+                        pxWorker->xSleeping = pdFALSE;
+                        xTaskToWake = pxWorker->xTask;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xQueued == pdFALSE )
+        {
+            /* Every deque the job could go on is full, so rather than wait for
+             * space the job is run now by the submitting task. */
+            prvRunJob( pxJob );
+        }
+        else if( xTaskToWake != NULL )
+        {
+            ( void ) xTaskNotifyGiveIndexed( xTaskToWake, configJOBS_NOTIFICATION_INDEX );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    void vJobWait( JobSystemHandle_t xJobSystem,
+                   Job_t * pxJob )
+    {
+        JobSystem_t * pxJobSystem = xJobSystem;
+        JobWorker_t * pxCurrentWorker;
+        Job_t * pxJobToRun;
+        BaseType_t xBlock;
+
+        configASSERT( pxJobSystem );
+        configASSERT( pxJob );
+
+        pxCurrentWorker = prvGetCurrentWorker( pxJobSystem );
+
+        for( ; ; )
+        {
+            pxJobToRun = prvTakeJob( pxJobSystem, pxCurrentWorker, pxJob, &xBlock );
+
+            if( pxJobToRun != NULL )
+            {
+                /* Help rather than wait while there are jobs to run, which
+                 * may well be the children of the job being waited for. */
+                prvRunJob( pxJobToRun );
+            }
+            else if( xBlock != pdFALSE )
+            {
+                /* Woken either by the job finishing or, when the calling task
+                 * is a worker, by a job being submitted.  Both are checked
+                 * again on the next pass. */
+                ( void ) ulTaskNotifyTakeIndexed( configJOBS_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xJobIsFinished( const Job_t * pxJob )
+    {
+        BaseType_t xReturn;
+
+        configASSERT( pxJob );
+
+        if( pxJob->uxUnfinished == ( UBaseType_t ) 0U )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static portTASK_FUNCTION( prvJobWorkerTask, pvParameters )
+    {
+        JobWorker_t * pxWorker = ( JobWorker_t * ) pvParameters;
+        Job_t * pxJob;
+        BaseType_t xBlock;
+
+        for( ; ; )
+        {
+            pxJob = prvTakeJob( pxWorker->pxJobSystem, pxWorker, NULL, &xBlock );
+
+            if( pxJob != NULL )
+            {
+                prvRunJob( pxJob );
+            }
+            else
+            {
+                /* There is no job in any deque, and the worker has marked
+                 * itself as sleeping, so the next vJobSubmit() wakes it. */
+                ( void ) ulTaskNotifyTakeIndexed( configJOBS_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY );
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static JobWorker_t * prvGetCurrentWorker( const JobSystem_t * pxJobSystem )
+    {
+        TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+        JobWorker_t * pxWorker = NULL;
+        UBaseType_t uxWorker;
+
+        /* There are about as many workers as cores, so a search is quicker
+         * than anything that would have to be kept in the task itself. */
+        for( uxWorker = ( UBaseType_t ) 0U; uxWorker < pxJobSystem->uxWorkers; uxWorker++ )
+        {
+            if( pxJobSystem->pxWorkers[ uxWorker ].xTask == xCurrentTask )
+            {
+                pxWorker = &( pxJobSystem->pxWorkers[ uxWorker ] );
+                break;
+            }
+        }
+
+        return pxWorker;
+    }
+/*-----------------------------------------------------------*/
+
+    static Job_t * prvTakeJob( JobSystem_t * pxJobSystem,
+                               JobWorker_t * pxWorker,
+                               Job_t * pxAwaited,
+                               BaseType_t * pxBlock )
+    {
+        Job_t * pxJob = NULL;
+        JobWorker_t * pxVictim;
+        UBaseType_t uxWorker, uxVictim;
+
+        *pxBlock = pdFALSE;
+
+        taskENTER_CRITICAL();
+        {
+            if( pxWorker != NULL )
+            {
+                pxWorker->xSleeping = pdFALSE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ( pxAwaited != NULL ) && ( pxAwaited->uxUnfinished == ( UBaseType_t ) 0U ) )
+            {
+                /* The awaited job has finished, so there is nothing to do. */
+            }
+            else if( ( pxWorker != NULL ) && ( pxWorker->uxCount > ( UBaseType_t ) 0U ) )
+            {
+                /* Take the job the worker submitted last from its own deque. */
+                ( pxWorker->uxCount )--;
+                pxJob = pxWorker->ppxJobs[ ( pxWorker->uxHead + pxWorker->uxCount ) % pxJobSystem->uxJobsPerWorker ];
+            }
+            else
+            {
+                /* Steal the oldest job of another worker, starting with a
+                 * different worker each time so the deques are emptied evenly. */
+                uxVictim = pxJobSystem->uxNextWorker;
+
+                for( uxWorker = ( UBaseType_t ) 0U; uxWorker < pxJobSystem->uxWorkers; uxWorker++ )
+                {
+                    pxVictim = &( pxJobSystem->pxWorkers[ uxVictim ] );
+                    uxVictim = ( uxVictim + ( UBaseType_t ) 1U ) % pxJobSystem->uxWorkers;
+
+                    if( pxVictim->uxCount > ( UBaseType_t ) 0U )
+                    {
+                        pxJob = pxVictim->ppxJobs[ pxVictim->uxHead ];
+                        pxVictim->uxHead = ( pxVictim->uxHead + ( UBaseType_t ) 1U ) % pxJobSystem->uxJobsPerWorker;
+                        ( pxVictim->uxCount )--;
+                        pxJobSystem->uxNextWorker = uxVictim;
+                        break;
+                    }
+                }
+
+                if( pxJob == NULL )
+                {
+                    /* Record that the caller is about to block while still in
+                     * the critical section, so a job submitted or finished
+                     * from now on notifies it. */
+                    if( pxWorker != NULL )
+                    {
+                        pxWorker->xSleeping = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( pxAwaited != NULL )
+                    {
+                        pxAwaited->xWaitingTask = xTaskGetCurrentTaskHandle();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    *pxBlock = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return pxJob;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRunJob( Job_t * pxJob )
+    {
+        pxJob->pxJobCode( pxJob->pvParameter );
+        prvFinishJob( pxJob );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvFinishJob( Job_t * pxJob )
+    {
+        Job_t * pxParent;
+        TaskHandle_t xTaskToNotify;
+
+        while( pxJob != NULL )
+        {
+            pxParent = NULL;
+            xTaskToNotify = NULL;
+
+            taskENTER_CRITICAL();
+            {
+                configASSERT( pxJob->uxUnfinished > ( UBaseType_t ) 0U );
+                ( pxJob->uxUnfinished )--;
+
+                if( pxJob->uxUnfinished == ( UBaseType_t ) 0U )
+                {
+                    /* Once finished the job may be reused or freed by the task
+                     * that waits for it, so nothing is read from it after the
+                     * critical section. */
+                    pxParent = pxJob->pxParent;
+                    xTaskToNotify = pxJob->xWaitingTask;
+                    pxJob->xWaitingTask = NULL;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xTaskToNotify != NULL )
+            {
+                ( void ) xTaskNotifyGiveIndexed( xTaskToNotify, configJOBS_NOTIFICATION_INDEX );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxJob = pxParent;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
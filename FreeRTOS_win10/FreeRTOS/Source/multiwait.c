@@ -0,0 +1,350 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "event_groups.h"
+#include "stream_buffer.h"
+#include "multiwait.h"
+
+/* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
+ * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
+ * for the header files above, but not in this file, in order to generate the
+ * correct privileged Vs unprivileged linkage and placement. */
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE /*lint !e961 !e750 !e9021 See comment above. */
+
+/* This entire source file will be skipped if the application is not configured
+ * to include xMultiWaitForObjects(). */
+#if ( configUSE_MULTI_WAIT == 1 )
+
+/*
+ * Returns the index of the first object in pxObjects that is ready, or
+ * multiwaitTIMED_OUT if none of them are.  Called from a critical section.
+ */
+    static BaseType_t prvFindReadyObject( const MultiWaitObject_t * const pxObjects,
+                                          UBaseType_t uxObjectCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Places the calling task on the wait list of each object in pxObjects, then
+ * blocks it for up to xTicksToWait.  Called from a critical section with the
+ * scheduler suspended.
+ */
+    static void prvBlockOnObjects( MultiWaitObject_t * const pxObjects,
+                                   UBaseType_t uxObjectCount,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the calling task from the wait lists it is still on once it has
+ * been woken.  Called from a critical section with the scheduler suspended.
+ */
+    static void prvEndWait( MultiWaitObject_t * const pxObjects,
+                            UBaseType_t uxObjectCount ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+    void vMultiWaitInitQueue( MultiWaitObject_t * pxObject,
+                              QueueHandle_t xQueue )
+    {
+        configASSERT( pxObject );
+        configASSERT( xQueue );
+
+        pxObject->eObjectType = eMultiWaitQueue;
+        pxObject->pvObject = xQueue;
+        pxObject->uxBitsToWaitFor = 0;
+        pxObject->xWaitForAllBits = pdFALSE;
+        pxObject->uxIndexToWaitOn = 0;
+        vListInitialiseItem( &( pxObject->xListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    void vMultiWaitInitEventBits( MultiWaitObject_t * pxObject,
+                                  EventGroupHandle_t xEventGroup,
+                                  EventBits_t uxBitsToWaitFor,
+                                  BaseType_t xWaitForAllBits )
+    {
+        configASSERT( pxObject );
+        configASSERT( xEventGroup );
+        configASSERT( uxBitsToWaitFor != 0 );
+
+        pxObject->eObjectType = eMultiWaitEventBits;
+        pxObject->pvObject = xEventGroup;
+        pxObject->uxBitsToWaitFor = uxBitsToWaitFor;
+        pxObject->xWaitForAllBits = xWaitForAllBits;
+        pxObject->uxIndexToWaitOn = 0;
+        vListInitialiseItem( &( pxObject->xListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    void vMultiWaitInitStreamBuffer( MultiWaitObject_t * pxObject,
+                                     StreamBufferHandle_t xStreamBuffer )
+    {
+        configASSERT( pxObject );
+        configASSERT( xStreamBuffer );
+
+        pxObject->eObjectType = eMultiWaitStreamBuffer;
+        pxObject->pvObject = xStreamBuffer;
+        pxObject->uxBitsToWaitFor = 0;
+        pxObject->xWaitForAllBits = pdFALSE;
+        pxObject->uxIndexToWaitOn = tskDEFAULT_INDEX_TO_NOTIFY;
+        vListInitialiseItem( &( pxObject->xListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    void vMultiWaitInitNotification( MultiWaitObject_t * pxObject,
+                                     UBaseType_t uxIndexToWaitOn )
+    {
+        configASSERT( pxObject );
+        configASSERT( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+        pxObject->eObjectType = eMultiWaitNotification;
+        pxObject->pvObject = NULL;
+        pxObject->uxBitsToWaitFor = 0;
+        pxObject->xWaitForAllBits = pdFALSE;
+        pxObject->uxIndexToWaitOn = uxIndexToWaitOn;
+        vListInitialiseItem( &( pxObject->xListItem ) );
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xMultiWaitForObjects( MultiWaitObject_t * pxObjects,
+                                     UBaseType_t uxObjectCount,
+                                     TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn;
+        BaseType_t xEntryTimeSet = pdFALSE;
+        BaseType_t xBlocked = pdFALSE;
+        TimeOut_t xTimeOut;
+
+        configASSERT( pxObjects );
+        configASSERT( uxObjectCount > ( UBaseType_t ) 0 );
+
+        #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+            {
+                configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+            }
+        #endif
+
+        /*lint -save -e904 This function relaxes the coding standard somewhat to
+         * allow return statements within the function itself.  This is done in the
+         * interest of execution time efficiency. */
+        for( ; ; )
+        {
+            /* The scheduler is suspended as well as interrupts being masked
+             * so that no task can have any of the objects locked while the
+             * task is placed on their wait lists. */
+            vTaskSuspendAll();
+            taskENTER_CRITICAL();
+            {
+                if( xBlocked != pdFALSE )
+                {
+                    prvEndWait( pxObjects, uxObjectCount );
+                    xBlocked = pdFALSE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = prvFindReadyObject( pxObjects, uxObjectCount );
+
+                if( ( xReturn == multiwaitTIMED_OUT ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+                {
+                    if( xEntryTimeSet == pdFALSE )
+                    {
+                        vTaskInternalSetTimeOutState( &xTimeOut );
+                        xEntryTimeSet = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    /* xTaskCheckForTimeOut() also reports an aborted wait as a
+                     * time out. */
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+                    {
+                        prvBlockOnObjects( pxObjects, uxObjectCount, xTicksToWait );
+                        xBlocked = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xBlocked == pdFALSE )
+            {
+                ( void ) xTaskResumeAll();
+                return xReturn;
+            }
+            else if( xTaskResumeAll() == pdFALSE )
+            {
+                portYIELD_WITHIN_API();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* The task has been woken by one of the objects, a time out or
+             * xTaskAbortDelay().  Go round again to find out which. */
+        } /*lint -restore */
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvFindReadyObject( const MultiWaitObject_t * const pxObjects,
+                                          UBaseType_t uxObjectCount )
+    {
+        BaseType_t xReturn = multiwaitTIMED_OUT;
+        BaseType_t xReady;
+        EventBits_t uxBitsSet;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0; ( uxIndex < uxObjectCount ) && ( xReturn == multiwaitTIMED_OUT ); uxIndex++ )
+        {
+            switch( pxObjects[ uxIndex ].eObjectType )
+            {
+                case eMultiWaitQueue:
+                    xReady = ( uxQueueMessagesWaitingFromISR( ( QueueHandle_t ) pxObjects[ uxIndex ].pvObject ) > ( UBaseType_t ) 0 ) ? pdTRUE : pdFALSE;
+                    break;
+
+                case eMultiWaitEventBits:
+                    uxBitsSet = xEventGroupGetBitsFromISR( ( EventGroupHandle_t ) pxObjects[ uxIndex ].pvObject ) & pxObjects[ uxIndex ].uxBitsToWaitFor;
+
+                    if( pxObjects[ uxIndex ].xWaitForAllBits == pdFALSE )
+                    {
+                        xReady = ( uxBitsSet != ( EventBits_t ) 0 ) ? pdTRUE : pdFALSE;
+                    }
+                    else
+                    {
+                        xReady = ( uxBitsSet == pxObjects[ uxIndex ].uxBitsToWaitFor ) ? pdTRUE : pdFALSE;
+                    }
+
+                    break;
+
+                case eMultiWaitStreamBuffer:
+                    xReady = ( xStreamBufferIsEmpty( ( StreamBufferHandle_t ) pxObjects[ uxIndex ].pvObject ) == pdFALSE ) ? pdTRUE : pdFALSE;
+                    break;
+
+                case eMultiWaitNotification:
+                    xReady = xTaskMultiWaitNotificationPending( pxObjects[ uxIndex ].uxIndexToWaitOn );
+                    break;
+
+                default:
+
+                    /* The object was not set with a vMultiWaitInit...()
+                     * function. */
+                    configASSERT( pdFALSE );
+                    xReady = pdFALSE;
+                    break;
+            }
+
+            if( xReady != pdFALSE )
+            {
+                xReturn = ( BaseType_t ) uxIndex;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvBlockOnObjects( MultiWaitObject_t * const pxObjects,
+                                   UBaseType_t uxObjectCount,
+                                   TickType_t xTicksToWait )
+    {
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0; uxIndex < uxObjectCount; uxIndex++ )
+        {
+            switch( pxObjects[ uxIndex ].eObjectType )
+            {
+                case eMultiWaitQueue:
+                    vQueuePlaceMultiWaitItem( ( QueueHandle_t ) pxObjects[ uxIndex ].pvObject, &( pxObjects[ uxIndex ].xListItem ) );
+                    break;
+
+                case eMultiWaitEventBits:
+                    vEventGroupPlaceMultiWaitItem( ( EventGroupHandle_t ) pxObjects[ uxIndex ].pvObject, &( pxObjects[ uxIndex ].xListItem ), pxObjects[ uxIndex ].uxBitsToWaitFor, pxObjects[ uxIndex ].xWaitForAllBits );
+                    break;
+
+                case eMultiWaitStreamBuffer:
+                    vStreamBufferPlaceMultiWaitReceiver( ( StreamBufferHandle_t ) pxObjects[ uxIndex ].pvObject );
+                    break;
+
+                default:
+
+                    /* Notifications are waited for by vTaskMultiWaitBlock(). */
+                    break;
+            }
+        }
+
+        traceBLOCKING_ON_MULTI_WAIT( uxObjectCount );
+        vTaskMultiWaitBlock( pxObjects, uxObjectCount, xTicksToWait );
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvEndWait( MultiWaitObject_t * const pxObjects,
+                            UBaseType_t uxObjectCount )
+    {
+        UBaseType_t uxIndex;
+
+        vTaskMultiWaitEnd();
+
+        for( uxIndex = 0; uxIndex < uxObjectCount; uxIndex++ )
+        {
+            if( pxObjects[ uxIndex ].eObjectType == eMultiWaitStreamBuffer )
+            {
+                vStreamBufferRemoveMultiWaitReceiver( ( StreamBufferHandle_t ) pxObjects[ uxIndex ].pvObject );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_MULTI_WAIT */
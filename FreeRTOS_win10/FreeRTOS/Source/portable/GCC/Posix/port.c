@@ -0,0 +1,4126 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Linux/POSIX simulator port.  Two engines are provided, selected by
+ * configSIMULATOR_USE_FIBERS:
+ *
+ * configSIMULATOR_USE_FIBERS == 0 (the default) follows the design of the
+ * Windows port in portable/MSVC-MingW: each task runs in its own host thread, a
+ * tick thread simulates the timer peripheral, and the thread that calls
+ * vTaskStartScheduler() becomes the simulated interrupt handler.  Only the
+ * host primitives differ - a futex (or, if
+ * configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS is 0, a pthread mutex) and
+ * semaphores replace the Windows lock and events, and a signal replaces
+ * SuspendThread().  Interrupts are pended with an atomic fetch-or and the lock
+ * is only held to model (simulated) interrupts being disabled, so raising an
+ * interrupt or yielding does not need to obtain it.
+ *
+ * configSIMULATOR_USE_FIBERS == 1 runs every task, and every simulated
+ * interrupt, on the single host thread that calls vTaskStartScheduler().  Each
+ * task executes on its own FreeRTOS allocated stack, and a context switch is a
+ * few instructions that save the callee saved registers and swap the stack
+ * pointer, so the cost of a switch is close to that of a real target rather
+ * than that of a host thread handoff.  Other host threads, such as the tick
+ * thread, raise interrupts by sending a signal to the simulated CPU thread, so
+ * the signal handler runs on the interrupted task's stack just as a real
+ * interrupt would.  Only x86_64 hosts are supported.
+ *
+ * The fiber engine can also record a run and replay it
+ * (configSIMULATOR_RECORD_REPLAY).  Then the only thing that differs from one
+ * run to the next is when the interrupts raised by other host threads arrive,
+ * so those interrupts are not delivered by the signal.  They are held until
+ * the running task next reaches a delivery point - the exit from its outermost
+ * critical section, the restoring of an unmasked interrupt mask, a yield, or a
+ * pass of the idle loop - and are logged with the number of delivery points
+ * passed since the previous log entry.  A replay ignores the interrupts raised
+ * by other host threads and delivers the logged interrupts at the same
+ * delivery points instead, so the tasks see the same interleaving.  A task
+ * that does not call the API is not interrupted until it does.
+ *
+ * The fiber engine can also run several independent instances of the kernel
+ * in one process (configSIMULATOR_KERNEL_INSTANCES).  Every variable of the
+ * kernel, the heap and the port is then thread local, so each host thread
+ * that starts a scheduler is the simulated CPU of a kernel of its own.  An
+ * instance has no tick thread - a timer signals the instance's thread
+ * directly - and a host thread that raises an interrupt in an instance sets
+ * the interrupt's bit in the instance's handle and signals the instance's
+ * thread, whose signal handler sets it pending.
+ *
+ * With either engine each task executes on the stack the kernel allocated for
+ * it, so the stack depth passed to xTaskCreate() is the stack the task really
+ * has and uxTaskGetStackHighWaterMark() measures what the task really used.
+ * Unless configSTACK_ALLOCATION_FROM_SEPARATE_HEAP is set to 0 the stacks are
+ * mapped by pvPortMallocStack() with an inaccessible guard region below them,
+ * so an overflow faults on the instruction that causes it and the SIGSEGV
+ * handler calls vApplicationStackOverflowHook() for the running task.
+ */
+
+/* Required for sem_clockwait(). */
+#define _GNU_SOURCE
+
+/* Standard includes. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <ucontext.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/* Scheduler includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Only defined by newer C libraries, although the kernel has always
+supported SIGEV_THREAD_ID. */
+#ifndef sigev_notify_thread_id
+	#define sigev_notify_thread_id			_sigev_un._tid
+#endif
+
+#define portMAX_INTERRUPTS				( ( uint32_t ) configSIMULATOR_INTERRUPT_LINES )
+#define portNO_CRITICAL_NESTING 		( ( uint32_t ) 0 )
+
+/* The pending interrupts of each priority level are held in a bitmap of this
+many 32-bit words. */
+#define portINTERRUPT_WORDS				( ( portMAX_INTERRUPTS + 31UL ) / 32UL )
+
+/* Interrupt priorities run from 0, the highest, to
+configKERNEL_INTERRUPT_PRIORITY, the lowest. */
+#define portINTERRUPT_PRIORITY_LEVELS	( ( uint32_t ) configKERNEL_INTERRUPT_PRIORITY + 1UL )
+
+/* The priority of code that is not an interrupt handler, which is below that
+of every interrupt.  Also used as the value of ulInterruptMask when no
+interrupts are masked. */
+#define portTASK_LEVEL_PRIORITY			portINTERRUPT_PRIORITY_LEVELS
+#define portINTERRUPTS_UNMASKED			portINTERRUPT_PRIORITY_LEVELS
+
+/* Returned by prvTakeNextInterrupt() when no interrupt can be taken. */
+#define portNO_INTERRUPT				( 0xffffffffUL )
+
+#if( configKERNEL_INTERRUPT_PRIORITY > 31 )
+	#error configKERNEL_INTERRUPT_PRIORITY must be between 0 and 31 - the priority levels that have a pending interrupt are held in a 32-bit word.
+#endif
+
+#if( configMAX_SYSCALL_INTERRUPT_PRIORITY > configKERNEL_INTERRUPT_PRIORITY )
+	#error configMAX_SYSCALL_INTERRUPT_PRIORITY must not be a lower priority (higher number) than configKERNEL_INTERRUPT_PRIORITY.
+#endif
+
+#if( configSIMULATOR_INTERRUPT_LINES < 2 )
+	#error configSIMULATOR_INTERRUPT_LINES must be at least 2, for the yield and tick interrupts.
+#endif
+
+#define portNANOSECONDS_PER_SECOND		( 1000000000ULL )
+
+#if( configSIMULATOR_VIRTUAL_TIME == 0 )
+
+#if( configSIMULATOR_KERNEL_INSTANCES == 0 )
+
+/*
+ * Created as a separate host thread, this function sleeps until absolute
+ * deadlines on the monotonic clock to simulate a tick interrupt being
+ * generated on an embedded target.  The host does not always run the thread
+ * on time, so each wake counts how many tick periods have really elapsed and
+ * any ticks that were missed are delivered together.
+ */
+static void *prvSimulatedPeripheralTimer( void *pvParameter );
+
+#endif
+
+/*
+ * Returns the time in nanoseconds since an arbitrary start point, from the
+ * host monotonic clock.
+ */
+static uint64_t prvGetMonotonicTime( void );
+
+/*
+ * Converts a time in nanoseconds to the number of tick periods it contains.
+ */
+static uint64_t prvTimeToTick( uint64_t ullTime );
+
+#endif
+
+/*
+ * Creates the thread that executes prvSimulatedPeripheralTimer().
+ */
+static BaseType_t prvStartSimulatedPeripheralTimer( void );
+
+/*
+ * Process all the simulated interrupts - each represented by a bit in the
+ * ulPendingInterrupts bitmap of its priority level - and perform any context
+ * switch they require.
+ */
+static void prvProcessSimulatedInterrupts( void );
+
+/*
+ * Marks a simulated interrupt as pending.  Lock free, so can be called from
+ * any thread.
+ */
+static void prvPendInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Clears the pending bit of, and returns the number of, the highest priority
+ * pending interrupt whose priority is above (numerically below)
+ * ulPriorityLimit.  Interrupts of equal priority are taken lowest number
+ * first.  Returns portNO_INTERRUPT if there is no such interrupt.
+ */
+static uint32_t prvTakeNextInterrupt( uint32_t ulPriorityLimit );
+
+/*
+ * Runs the handler of every pending interrupt that has a higher priority than
+ * the code running on the calling thread, and is not masked, highest priority
+ * first.  Sets xSwitchRequired if a handler requests a context switch, but
+ * does not perform the switch.  A higher priority interrupt raised while a
+ * handler is running interrupts it by calling this function again.
+ */
+static void prvRunPendingInterrupts( void );
+
+/*
+ * Interrupt handlers used by the kernel itself.  These are executed from the
+ * simulated interrupt handler thread.
+ */
+static uint32_t prvProcessYieldInterrupt( void );
+static uint32_t prvProcessTickInterrupt( void );
+
+/* The size of the alternate signal stack of each thread that runs tasks. */
+#define portALTERNATE_SIGNAL_STACK_SIZE	( ( size_t ) ( 64 * 1024 ) )
+
+/*
+ * Give the calling host thread an alternate signal stack, for the signals
+ * whose frames must not be pushed onto a task stack.  Called by every thread
+ * that runs tasks.
+ */
+static void prvSetAlternateSignalStack( void );
+
+#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+
+/* The size of the inaccessible region mapped below each task stack.  A task
+that overflows its stack by less than this faults on the guard rather than
+writing to whatever memory is below it - it is much larger than a page so a
+large local array does not step over it. */
+#define portSTACK_GUARD_SIZE			( ( size_t ) ( 64 * 1024 ) )
+
+/* Each stack mapped by pvPortMallocStack() holds the guard region, then the
+stack, then this record of the mapping, where an overflow of the stack cannot
+reach it.  The records are linked together so the SIGSEGV handler can tell a
+fault on a guard region from any other fault. */
+typedef struct xSTACK_MAPPING
+{
+	struct xSTACK_MAPPING *pxNext;
+
+	/* The start of the mapping, which is the start of the guard region. */
+	uint8_t *pucMapping;
+	size_t xMappingSize;
+
+	/* The stack itself, as returned by pvPortMallocStack(). */
+	void *pvStack;
+} StackMapping_t;
+
+/* The stacks mapped by pvPortMallocStack() and not yet freed.  Only changed
+from inside a critical section, but read without one by the SIGSEGV handler. */
+static portKERNEL_INSTANCE_DATA StackMapping_t * volatile pxStackMappings = NULL;
+
+/*
+ * Returns pdTRUE if pucAddress is in the guard region below a task stack, or
+ * within xAllowance bytes above it.
+ */
+static BaseType_t prvIsInStackGuard( const uint8_t *pucAddress, size_t xAllowance );
+
+/*
+ * Handler for SIGSEGV.  Calls vApplicationStackOverflowHook() if the fault is
+ * a task overflowing its stack, then lets the fault terminate the process.
+ */
+static void prvStackGuardSignalHandler( int iSignal, siginfo_t *pxInfo, void *pvContext );
+
+/*
+ * Install prvStackGuardSignalHandler().
+ */
+static BaseType_t prvInstallStackGuardHandler( void );
+
+#endif /* configSTACK_ALLOCATION_FROM_SEPARATE_HEAP */
+
+/*
+ * Exiting a critical section will cause the calling task to block on yield
+ * event to wait for an interrupt to process if an interrupt was pended while
+ * inside the critical section.  This variable protects against a recursive
+ * attempt to obtain the interrupt lock if a critical section is used inside
+ * an interrupt handler itself.
+ */
+portKERNEL_INSTANCE_DATA volatile BaseType_t xInsideInterrupt = pdFALSE;
+
+#if ( configSIMULATOR_USE_FIBERS == 1 )
+
+/* The signal the tick thread, and any other host thread that raises a
+simulated interrupt, sends to the thread that runs the tasks. */
+#define portINTERRUPT_SIGNAL			SIGUSR1
+
+/* The initial MXCSR and x87 control word values of a new task, which are the
+values the host process starts with. */
+#define portINITIAL_MXCSR				( 0x1f80UL )
+#define portINITIAL_FPU_CONTROL_WORD	( 0x037fUL )
+
+#if !defined( __x86_64__ )
+	#error The fiber engine of the GCC/Posix port is only implemented for x86_64 hosts.  Set configSIMULATOR_USE_FIBERS to 0 to use the thread per task engine.
+#endif
+
+/*
+ * Saves the callee saved registers of the running task on its own stack,
+ * stores the resulting stack pointer in *ppvOldTopOfStack, then restores the
+ * registers saved on, and returns into, the stack at pvNewTopOfStack.  Passing
+ * the address of a TCB as ppvOldTopOfStack saves the stack pointer in the
+ * pxTopOfStack member of the TCB, just as a port for real hardware does.
+ */
+void vPortSwitchFiber( void **ppvOldTopOfStack, void *pvNewTopOfStack );
+
+/*
+ * The address a new task's stack returns to the first time the task is
+ * switched in.  Calls prvFiberTaskEntry() with the task function and its
+ * parameter, which pxPortInitialiseStack() leaves in callee saved registers.
+ */
+void vPortStartFiber( void );
+
+/*
+ * The C entry point of every task.
+ */
+static void prvFiberTaskEntry( TaskFunction_t pxCode, void *pvParameters );
+
+/*
+ * Handler for portINTERRUPT_SIGNAL.  Executes on the stack of whichever task
+ * is running, just like a real interrupt, and processes the pending simulated
+ * interrupts unless they are (simulated) disabled.
+ */
+static void prvInterruptSignalHandler( int iSignal );
+
+__asm__(
+	"	.text											\n"
+	"	.globl	vPortSwitchFiber						\n"
+	"	.hidden	vPortSwitchFiber						\n"
+	"	.type	vPortSwitchFiber, @function				\n"
+	"vPortSwitchFiber:									\n"
+	"	pushq	%rbp									\n"
+	"	pushq	%rbx									\n"
+	"	pushq	%r12									\n"
+	"	pushq	%r13									\n"
+	"	pushq	%r14									\n"
+	"	pushq	%r15									\n"
+	"	subq	$8, %rsp								\n"
+	"	stmxcsr	(%rsp)									\n"
+	"	fnstcw	4(%rsp)									\n"
+	"	movq	%rsp, (%rdi)							\n" /* Save the old task's stack pointer. */
+	"	movq	%rsi, %rsp								\n" /* Move to the new task's stack. */
+	"	ldmxcsr	(%rsp)									\n"
+	"	fldcw	4(%rsp)									\n"
+	"	addq	$8, %rsp								\n"
+	"	popq	%r15									\n"
+	"	popq	%r14									\n"
+	"	popq	%r13									\n"
+	"	popq	%r12									\n"
+	"	popq	%rbx									\n"
+	"	popq	%rbp									\n"
+	"	ret												\n"
+	"	.size	vPortSwitchFiber, .-vPortSwitchFiber	\n"
+	"													\n"
+	"	.globl	vPortStartFiber							\n"
+	"	.hidden	vPortStartFiber							\n"
+	"	.type	vPortStartFiber, @function				\n"
+	"vPortStartFiber:									\n"
+	"	movq	%r12, %rdi								\n" /* The task function. */
+	"	movq	%r13, %rsi								\n" /* The task parameter. */
+	"	callq	*%r14									\n" /* prvFiberTaskEntry(), which does not return. */
+	"	ud2												\n"
+	"	.size	vPortStartFiber, .-vPortStartFiber		\n"
+);
+
+/* The thread that executes all the tasks and simulated interrupts - the
+simulated CPU. */
+static portKERNEL_INSTANCE_DATA pthread_t xSimulatedCPUThread;
+
+/* Where the stack pointer of the thread that started the scheduler is saved
+when it switches to the first task.  It is only switched back to when the
+scheduler of a kernel instance ends. */
+static portKERNEL_INSTANCE_DATA void *pvSchedulerTopOfStack = NULL;
+
+#if( configSIMULATOR_RECORD_REPLAY != 0 )
+
+	/* The events in a record/replay log. */
+	#define portRECORD_NONE				( 0U )	/* Only moves the delivery point on, for a gap too long for ulPointDelta. */
+	#define portRECORD_TICKS			( 1U )	/* ulValue tick periods were delivered. */
+	#define portRECORD_INTERRUPT		( 2U )	/* Interrupt number ulValue was delivered. */
+	#define portRECORD_SWITCH			( 3U )	/* vTaskSwitchContext() selected the task numbered ulValue. */
+
+	/* The number of records written to, or read from, the log at a time. */
+	#define portRECORD_BUFFER_LENGTH	( 4096U )
+
+	#define portRECORD_MAGIC			"FRRR"
+	#define portRECORD_VERSION			( 1UL )
+
+	/* The start of a log, which a replay checks was recorded with the same
+	tick rate and number of interrupts. */
+	typedef struct xRECORD_HEADER
+	{
+		char cMagic[ 4 ];
+		uint32_t ulVersion;
+		uint32_t ulTickRateHz;
+		uint32_t ulInterruptLines;
+	} RecordHeader_t;
+
+	/* One logged event.  ulPointDelta is the number of delivery points the
+	simulated CPU passed since the previous event.  The tick count and the
+	number of the task that was running are not needed to replay the event,
+	but let a replay stop as soon as it no longer matches the recording. */
+	typedef struct xRECORD
+	{
+		uint32_t ulPointDelta;
+		uint32_t ulTickCount;
+		uint16_t usTaskNumber;
+		uint16_t usEvent;
+		uint32_t ulValue;
+	} Record_t;
+
+	/* The log, and the records waiting to be written to it or read from it
+	but not yet replayed. */
+	static int iRecordFile = -1;
+	static Record_t xRecords[ portRECORD_BUFFER_LENGTH ];
+	static uint32_t ulRecordCount = 0UL;
+
+	/* The number of delivery points passed, and the delivery point of the
+	last record written or of the next record to replay. */
+	static uint64_t ullDeliveryPoints = 0ULL;
+	static uint64_t ullRecordPoint = 0ULL;
+
+	/* Interrupts raised by other host threads that are waiting for the next
+	delivery point.  xInterruptsStaged is set after any bit, so a delivery
+	point with nothing to deliver only reads one variable.  Staged ticks are
+	counted in ulTicksToProcess as usual. */
+	static volatile uint32_t ulStagedInterrupts[ portINTERRUPT_WORDS ] = { 0UL };
+	static volatile BaseType_t xInterruptsStaged = pdFALSE;
+
+	/* The tick periods delivered at the last delivery point, which are the
+	only ticks the tick interrupt handler processes. */
+	static uint32_t ulTicksDelivered = 0UL;
+
+	/*
+	 * Called each time the running task reaches a delivery point.  Delivers,
+	 * by setting them pending, the interrupts that are to be taken there.
+	 */
+	static void prvDeliveryPoint( void );
+
+	/*
+	 * Called from vPortGenerateSimulatedInterrupt() in place of sending the
+	 * interrupt signal, by host threads other than the simulated CPU.
+	 */
+	static void prvStageInterrupt( uint32_t ulInterruptNumber );
+
+	/*
+	 * Sets the staged interrupts pending, logging each one when recording.
+	 */
+	static void prvLatchInterrupts( void );
+
+	/*
+	 * Logs, or when replaying checks against the log, the task that
+	 * vTaskSwitchContext() selected to replace pvOldTCB.
+	 */
+	static void prvRecordSwitch( void *pvOldTCB );
+
+	/*
+	 * Opens the log and, when replaying, reads the first record.
+	 */
+	static BaseType_t prvOpenRecordReplay( void );
+
+	#if( configSIMULATOR_RECORD_REPLAY == 1 )
+
+		/*
+		 * Adds a record to the buffer, writing the buffer to the log first if
+		 * it is full.
+		 */
+		static void prvWriteRecord( void *pvTask, uint16_t usEvent, uint32_t ulValue );
+
+	#else
+
+		/* The next record to replay, or NULL once every record has been
+		replayed, and its position in xRecords. */
+		static const Record_t *pxReplayRecord = NULL;
+		static uint32_t ulNextRecord = 0UL;
+
+		/* Set once the whole log has been replayed, after which interrupts
+		raised by other host threads are delivered at delivery points without
+		being logged. */
+		static volatile BaseType_t xReplayComplete = pdFALSE;
+
+		/*
+		 * Moves pxReplayRecord, and ullRecordPoint, on to the next record.
+		 */
+		static void prvReadNextRecord( void );
+
+		/*
+		 * Delivers the records logged at the current delivery point.
+		 */
+		static void prvReplayInterrupts( void );
+
+		/*
+		 * Checks the record about to be replayed is the event the replay is
+		 * about to deliver or make, logged with the tick count and running
+		 * task of the replay.
+		 */
+		static void prvCheckRecord( const Record_t *pxRecord, uint16_t usEvent, void *pvTask, uint32_t ulValue );
+
+	#endif
+
+#endif /* configSIMULATOR_RECORD_REPLAY */
+
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+
+	/* A host thread that runs an instance of the kernel.  Everything else
+	about the instance is thread local to that thread. */
+	typedef struct xKERNEL_INSTANCE
+	{
+		pthread_t xThread;
+		void (*pxInstanceMain)( void * );
+		void *pvParameter;
+
+		/* Interrupts raised in the instance by other host threads, which
+		cannot reach the thread local ulPendingInterrupts of the instance.
+		Bits are set with an atomic fetch-or and the instance's thread takes
+		them all at once in its interrupt signal handler. */
+		volatile uint32_t ulRaisedInterrupts[ portINTERRUPT_WORDS ];
+	} KernelInstance_t;
+
+	/* The instance the calling thread runs, or is bound to. */
+	static __thread KernelInstance_t *pxThisKernelInstance = NULL;
+
+	/* The timer that signals the instance's thread once per tick period, the
+	time it was started and the tick periods delivered since. */
+	static portKERNEL_INSTANCE_DATA timer_t xTickTimer;
+	static portKERNEL_INSTANCE_DATA uint64_t ullTickTimerStart = 0ULL;
+	static portKERNEL_INSTANCE_DATA uint64_t ullTickTimerTicks = 0ULL;
+
+	/*
+	 * The entry point of a thread created by xPortCreateKernelInstance().
+	 */
+	static void *prvKernelInstanceThread( void *pvParameter );
+
+	/*
+	 * Called from vPortGenerateSimulatedInterrupt() by a thread that does not
+	 * run an instance.  Raises the interrupt in the instance the thread is
+	 * bound to.
+	 */
+	static void prvRaiseInKernelInstance( uint32_t ulInterruptNumber );
+
+	/*
+	 * Called by the interrupt signal handler.  Sets pending the interrupts
+	 * raised by other threads, and a tick interrupt for every tick period
+	 * that has elapsed since the last one was delivered.
+	 */
+	static void prvTakeRaisedInterrupts( void );
+
+#endif /* configSIMULATOR_KERNEL_INSTANCES */
+
+#else /* configSIMULATOR_USE_FIBERS */
+
+/* The signal sent to a task thread to suspend it asynchronously, which is
+the equivalent of the SuspendThread() call made by the Windows port. */
+#define portSUSPEND_SIGNAL				SIGUSR1
+
+/* The signal sent to the simulated interrupt thread when an interrupt is
+raised that must interrupt whatever that thread is doing - see
+vPortGenerateSimulatedInterrupt(). */
+#define portINTERRUPT_SIGNAL			SIGUSR2
+
+/* Returned by uxPortSetInterruptMask() when it is called from a thread other
+than the simulated interrupt thread, which masks interrupts by entering a
+critical section instead. */
+#define portCRITICAL_SECTION_MASK		( ( UBaseType_t ) 0xffffffffUL )
+
+/*
+ * The entry point of every host thread that runs tasks.  The thread runs one
+ * task at a time, waiting to be selected by the scheduler before calling the
+ * task function, and returns to the pool of parked threads when the task is
+ * deleted.
+ */
+static void *prvTaskThreadEntry( void *pvParameter );
+
+/*
+ * Where a task thread starts executing on the task's own stack, to call the
+ * task function.
+ */
+static void prvTaskStackEntry( void );
+
+/*
+ * Create a host thread to run tasks, which waits on its yield event until it
+ * is given one.
+ */
+static struct xHOST_THREAD *prvCreateHostThread( void );
+
+/*
+ * Take a parked host thread from the pool, creating the pool the first time it
+ * is used and a new thread if the pool is empty.
+ */
+static struct xHOST_THREAD *prvTakeHostThread( void );
+
+/*
+ * Send the calling thread back to the pool by jumping to the recycle context
+ * saved by prvTaskThreadEntry(), abandoning the frames of the task it was
+ * running.  Does not return.
+ */
+static void prvRecycleThread( struct xHOST_THREAD *pxHostThread );
+
+/*
+ * Wait on the yield event of the calling thread until the task it runs is
+ * selected to run.  Does not return if the task is deleted in the meantime -
+ * the thread goes back to the pool instead.
+ */
+static void prvWaitForYieldEvent( void );
+
+/*
+ * Handler for portSUSPEND_SIGNAL.  Executes in the context of the task thread
+ * being switched out, acknowledges the suspension, then waits until the
+ * thread is selected to run again.
+ */
+static void prvSuspendSignalHandler( int iSignal );
+
+/*
+ * Stop the thread of a task that the scheduler has just switched out.  If the
+ * task blocked or yielded its thread is already waiting on its yield event,
+ * otherwise the thread is sent the suspend signal.
+ */
+static void prvSwitchOutThread( void *pvOldCurrentTCB );
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Switch the tasks of the cores that have requested a context switch, if
+	 * the task lock can be taken.
+	 */
+	static void prvSwitchCores( void );
+
+#endif
+
+/*
+ * Handler for portINTERRUPT_SIGNAL.  Executes on the simulated interrupt
+ * thread and runs the pending interrupts that can interrupt the code the
+ * thread was executing.
+ */
+static void prvInterruptSignalHandler( int iSignal );
+
+/* A host thread that runs tasks.  Host threads are not created and destroyed
+with the tasks they run - a thread whose task is deleted goes back to a pool
+of parked threads, and is given the next task that is created, so creating a
+task does not normally create a thread, and deleting one never has to wait
+for a thread to exit. */
+typedef struct xHOST_THREAD
+{
+	pthread_t xThread;
+
+	/* Semaphore the thread blocks on whenever it is not the running task, or
+	has no task to run.  Equivalent to the Windows port's pvYieldEvent
+	combined with the SuspendThread()/ResumeThread() pair. */
+	sem_t xYieldEvent;
+
+	/* The state of the task the thread runs, or NULL while the thread is in
+	the pool. */
+	struct xTHREAD_STATE * volatile pxThreadState;
+
+	/* Set by vPortDeleteThread() to send the thread back to the pool the next
+	time it returns from xYieldEvent, rather than letting it run. */
+	volatile BaseType_t xRecycle;
+
+	/* Where the thread jumps to when its task is deleted, abandoning the
+	task's frames, and the flag that tells the code after getcontext() that
+	it has been reached by the jump.  setcontext() is used rather than
+	siglongjmp() as the jump is from the task's stack to the thread's own
+	stack, which the _FORTIFY_SOURCE checks of longjmp() reject. */
+	ucontext_t xRecycleContext;
+	volatile BaseType_t xRecycling;
+
+	/* The next thread in the pool. */
+	struct xHOST_THREAD *pxNext;
+} HostThread_t;
+
+/* The top of the task stack holds a ThreadState_t structure that maps the
+task handle to the host thread that executes the task.  Unlike the Windows port
+the rest of the stack is the stack the thread executes the task on. */
+typedef struct xTHREAD_STATE
+{
+	/* The thread that executes the task. */
+	HostThread_t *pxHostThread;
+
+	/* The lowest address of the task's stack. */
+	StackType_t *pxEndOfStack;
+
+	/* The task function and its parameter, passed to the thread when the task
+	starts. */
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+	/* Set when the thread is, or is about to be, blocked on its yield event,
+	so the simulated interrupt handler knows it has to post the event before
+	the thread can run.  Only ever set with a compare and swap - by the thread
+	itself when it yields, or by the simulated interrupt handler when it
+	switches the thread out asynchronously - so the thread never waits for
+	both, and only ever cleared by the simulated interrupt handler. */
+	volatile BaseType_t xWaiting;
+
+	/* pdFALSE once the task has been deleted and its thread has gone, or is
+	about to go, back to the pool, so no attempt is made to signal or resume
+	the thread on behalf of the task again. */
+	volatile BaseType_t xThreadValid;
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The core the task last ran on, set by the simulated interrupt
+		handler before the task is resumed on a core, so it only changes
+		while the task is not running. */
+		volatile BaseType_t xCoreID;
+	#endif
+} ThreadState_t;
+
+/* Host threads that have no task to run, parked on their yield events, and
+the number of host threads that have been created.  Both are protected by
+xHostThreadPoolMutex. */
+static HostThread_t *pxHostThreadPool = NULL;
+static uint32_t ulHostThreadsCreated = 0UL;
+static pthread_mutex_t xHostThreadPoolMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Posted by a host thread once it is back in the pool after its task was
+deleted by another task, so the pool cannot grow just because the deleting
+task runs ahead of the threads it is recycling. */
+static sem_t xRecycleAcknowledged;
+
+/* The thread that calls vTaskStartScheduler(), which becomes the simulated
+interrupt processing thread. */
+static pthread_t xSimulatedInterruptThread;
+
+/* Posted to inform the simulated interrupt processing thread that an interrupt
+is pending.  Posted once for each interrupt raised, so the thread can find
+there is nothing left to process when it wakes. */
+static sem_t xInterruptEvent;
+
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+
+	/* The values of xInterruptLock.ulState.  ulState is the futex word, so
+	must be a 32-bit value. */
+	#define portLOCK_FREE					( 0UL )
+	#define portLOCK_HELD					( 1UL )
+	#define portLOCK_CONTENDED				( 2UL )
+
+	/* The number of times a thread that finds the lock held checks whether it
+	has been released before parking in the kernel.  The lock is only held for
+	short periods, by threads that are normally running on other cores. */
+	#define portLOCK_SPIN_COUNT				( 100UL )
+
+	#if defined( __x86_64__ ) || defined( __i386__ )
+		#define portSPIN_WAIT_HINT()		__builtin_ia32_pause()
+	#elif defined( __aarch64__ )
+		#define portSPIN_WAIT_HINT()		__asm__ volatile( "yield" )
+	#else
+		#define portSPIN_WAIT_HINT()
+	#endif
+
+	/* A recursive lock that is taken and released without a system call when
+	it is not contended, and parks the calling thread on a futex when it is
+	still held after a short spin. */
+	typedef struct
+	{
+		volatile uint32_t ulState;
+		volatile pthread_t xOwner;
+		uint32_t ulRecursion;
+	} InterruptLock_t;
+
+	/* Held by a task for the whole of a critical section, and by the simulated
+	interrupt processing thread while it processes interrupts.  Holding it is
+	the simulated equivalent of having interrupts disabled. */
+	static InterruptLock_t xInterruptLock = { portLOCK_FREE, ( pthread_t ) 0, 0UL };
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The kernel's task lock - see vPortGetTaskLock(). */
+		static InterruptLock_t xTaskLock = { portLOCK_FREE, ( pthread_t ) 0, 0UL };
+	#endif
+
+	/*
+	 * Obtain and release a lock.  Both can be nested by the thread that holds
+	 * the lock.
+	 */
+	static void prvTakeLock( InterruptLock_t *pxLock );
+	static void prvGiveLock( InterruptLock_t *pxLock );
+
+#else
+
+	/* Recursive mutex held by a task for the whole of a critical section, and
+	by the simulated interrupt processing thread while it processes interrupts.
+	Holding it is the simulated equivalent of having interrupts disabled. */
+	static pthread_mutex_t xInterruptEventMutex;
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The kernel's task lock - see vPortGetTaskLock(). */
+		static pthread_mutex_t xTaskLockMutex = PTHREAD_MUTEX_INITIALIZER;
+	#endif
+
+#endif /* configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS */
+
+/*
+ * Obtain and release the lock that models (simulated) interrupts being
+ * disabled.  Both can be nested.
+ */
+static void prvLockInterrupts( void );
+static void prvUnlockInterrupts( void );
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Take the task lock for the simulated interrupt thread, which switches
+	 * the tasks of a core while holding it, without waiting for it.  Returns
+	 * pdFALSE if a task holds the lock.
+	 */
+	static BaseType_t prvTryLockTasks( void );
+	static void prvUnlockTasks( void );
+
+	/* The number of times the calling task thread has taken the task lock
+	without releasing it.  The lock itself is only taken when this is 0. */
+	static __thread uint32_t ulTaskLockNesting = 0UL;
+
+	/* One bit for each core whose task must be switched out - set when a
+	core yields or is asked to yield by another core, and cleared when the
+	simulated interrupt handler performs the switch.  A core whose bit is set
+	when the handler cannot take the task lock keeps its bit, and the switch
+	is made once the task that holds the lock releases it. */
+	static volatile uint32_t ulYieldRequestCores = 0UL;
+
+	/* The core the simulated interrupt thread is acting for - the core whose
+	context switch it is performing, otherwise 0, as the thread also runs the
+	interrupt handlers of core 0. */
+	static volatile BaseType_t xInterruptCoreID = 0;
+
+#endif /* configNUMBER_OF_CORES */
+
+/* Posted by prvSuspendSignalHandler() once the thread being switched out has
+stopped executing task code - the equivalent of the GetThreadContext() call the
+Windows port uses to make SuspendThread() synchronous. */
+static sem_t xSuspendAcknowledged;
+
+/* The HostThread_t of the calling thread, or NULL if the calling thread is not
+a task thread. */
+static __thread HostThread_t *pxHostThreadOfThisThread = NULL;
+
+/* The ThreadState_t of the task executed by the calling host thread, or NULL if
+the calling thread is not running a task.  The task is assigned to the thread
+before the thread is first resumed, so this is valid as soon as the task can
+be switched out. */
+#define portTHREAD_STATE_OF_THIS_THREAD()	( ( pxHostThreadOfThisThread != NULL ) ? pxHostThreadOfThisThread->pxThreadState : NULL )
+
+/* The critical nesting count of the calling host thread.  Tasks are never
+switched out while they are in a critical section, so this is the same as the
+count of the task the thread runs, but a task can read its own count without
+holding the interrupt lock while the simulated interrupt handler is changing
+the count of its own thread.  Task threads start outside of a critical
+section. */
+static __thread uint32_t ulCriticalNesting = 0UL;
+
+#endif /* configSIMULATOR_USE_FIBERS */
+
+/* Simulated interrupts waiting to be processed.  Each priority level has a
+bitmap with one bit per interrupt, and ulPendingPriorities has one bit per
+priority level that may have an interrupt pending, so the highest priority
+pending interrupt is found with two find-first-set operations whatever the
+number of interrupts.  Bits are set with an atomic fetch-or, and cleared with
+an atomic fetch-and as each interrupt is taken, so no lock is needed to pend an
+interrupt. */
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulPendingInterrupts[ portINTERRUPT_PRIORITY_LEVELS ][ portINTERRUPT_WORDS ] = { { 0UL } };
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulPendingPriorities = 0UL;
+
+/* The priority of each interrupt.  All interrupts start at the kernel
+interrupt priority, the lowest, so they neither interrupt each other nor run
+inside a critical section unless vPortSetInterruptPriority() says otherwise. */
+static portKERNEL_INSTANCE_DATA uint8_t ucInterruptPriority[ portMAX_INTERRUPTS ] = { [ 0 ... ( portMAX_INTERRUPTS - 1UL ) ] = configKERNEL_INTERRUPT_PRIORITY };
+
+/* The priority of the code executing on the thread that runs the simulated
+interrupt handlers - portTASK_LEVEL_PRIORITY when it is not running a
+handler.  Only interrupts with a higher priority can interrupt it. */
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulActivePriority = portTASK_LEVEL_PRIORITY;
+
+/* The simulated equivalent of the BASEPRI register of a Cortex-M: interrupts
+with this or a lower priority (a number greater than or equal to this) are
+masked.  Set to configMAX_SYSCALL_INTERRUPT_PRIORITY by critical sections and
+portSET_INTERRUPT_MASK_FROM_ISR(), and to portINTERRUPTS_UNMASKED when nothing
+is masked. */
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulInterruptMask = portINTERRUPTS_UNMASKED;
+
+/* Set by prvRunPendingInterrupts() when a handler requests a context switch,
+and cleared when the switch is performed - the simulated equivalent of pending
+PendSV. */
+static portKERNEL_INSTANCE_DATA volatile BaseType_t xSwitchRequired = pdFALSE;
+
+#if ( configSIMULATOR_USE_FIBERS == 1 )
+
+	/* The critical nesting count for the currently executing task.  This is
+	initialised to a non-zero value so interrupts do not become enabled during
+	the initialisation phase.  As each task has its own critical nesting value
+	ulCriticalNesting will get set to zero when the first task runs.  This
+	initialisation is probably not critical in this simulated environment as
+	the simulated interrupt handlers do not get created until the FreeRTOS
+	scheduler is started anyway. */
+	static portKERNEL_INSTANCE_DATA volatile uint32_t ulCriticalNesting = 9999UL;
+
+#endif
+
+/* Tick periods that have elapsed but have not yet been processed by the tick
+interrupt handler.  Incremented by the tick thread and cleared by the handler,
+so normally 1 each time the tick interrupt executes. */
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulTicksToProcess = 0UL;
+
+/* The total number of ticks that the host did not run the tick thread in time
+to generate, and were therefore delivered late in a batch.  Read by
+ulPortGetMissedTickCount(). */
+static portKERNEL_INSTANCE_DATA volatile uint32_t ulMissedTicks = 0UL;
+
+/* Posted to wake the tick thread before the deadline it is waiting for - only
+used to start and end tickless idle periods. */
+static portKERNEL_INSTANCE_DATA sem_t xTickTimerEvent;
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/* The states of a tickless idle period.  The idle task requests the
+	period, the tick thread stops generating ticks and sleeps for the period,
+	then reports the number of tick periods that elapsed while it slept. */
+	#define portTICKLESS_IDLE_INACTIVE		( 0UL )
+	#define portTICKLESS_IDLE_REQUESTED		( 1UL )
+	#define portTICKLESS_IDLE_SLEEPING		( 2UL )
+
+	static volatile uint32_t ulTicklessIdleState = portTICKLESS_IDLE_INACTIVE;
+
+	/* The maximum number of ticks the tick thread can suppress, as passed to
+	vPortSuppressTicksAndSleep(). */
+	static TickType_t xTicklessIdleTime = 0;
+
+	/* Set when a simulated interrupt is raised during a tickless idle period,
+	to end the period early - the simulated equivalent of an interrupt waking
+	the processor from sleep. */
+	static volatile BaseType_t xTicklessIdleAbort = pdFALSE;
+
+	/* The tick periods that elapsed while the tick thread was sleeping, and
+	the semaphore posted when the value is available. */
+	static TickType_t xTicklessIdleElapsed = 0;
+	static sem_t xTicklessIdleComplete;
+
+	/* The number of ticks suppressed per second, measured each time the
+	tick count passes a second boundary.  Returned by
+	ulPortGetSuppressedTicksPerSecond(). */
+	static volatile uint32_t ulSuppressedTicksPerSecond = 0UL;
+
+	/*
+	 * Ends a tickless idle period early, if one is in progress, because a
+	 * simulated interrupt has been raised.  Can be called from any thread, and
+	 * from the interrupt signal handler.
+	 */
+	static void prvAbortTicklessIdle( void );
+
+	#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+		/*
+		 * Called by vPortSuppressTicksAndSleep() in place of sleeping.  Moves
+		 * virtual time on to the time the next task unblocks.
+		 */
+		static void prvAdvanceVirtualTime( TickType_t xExpectedIdleTime );
+
+		/*
+		 * Steps the tick count to the period before the next unblock time, then
+		 * raises a tick interrupt that delivers ulTicksToDeliver periods.
+		 */
+		static void prvJumpVirtualTime( TickType_t xExpectedIdleTime, uint32_t ulTicksToDeliver );
+
+	#endif
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+	/* The number of tick periods of virtual time that have passed since the
+	scheduler started - the tick count, without the wrap around of a 32-bit
+	TickType_t.  Only the thread that updates the tick count writes it. */
+	static volatile uint64_t ullVirtualTicks = 0ULL;
+
+#endif /* configSIMULATOR_VIRTUAL_TIME */
+
+/* Handlers for all the simulated software interrupts.  The first two positions
+are used for the Yield and Tick interrupts so are handled slightly differently,
+all the other interrupts can be user defined. */
+static portKERNEL_INSTANCE_DATA uint32_t (*ulIsrHandler[ portMAX_INTERRUPTS ])( void ) = { 0 };
+
+#if( configNUMBER_OF_CORES == 1 )
+	/* Pointer to the TCB of the currently executing task. */
+	extern portKERNEL_INSTANCE_DATA void * volatile pxCurrentTCB;
+#else
+	/* Pointers to the TCB of the task executing on each core. */
+	extern portKERNEL_INSTANCE_DATA void * volatile pxCurrentTCBs[ configNUMBER_OF_CORES ];
+#endif
+
+/* Used to ensure nothing is processed during the startup sequence. */
+static portKERNEL_INSTANCE_DATA BaseType_t xPortRunning = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_VIRTUAL_TIME == 0 )
+
+static uint64_t prvGetMonotonicTime( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+	return ( ( uint64_t ) xNow.tv_sec * portNANOSECONDS_PER_SECOND ) + ( uint64_t ) xNow.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvTimeToTick( uint64_t ullTime )
+{
+	/* The number of whole tick periods in ullTime nanoseconds. */
+	return ( ( ullTime / portNANOSECONDS_PER_SECOND ) * configTICK_RATE_HZ ) + ( ( ( ullTime % portNANOSECONDS_PER_SECOND ) * configTICK_RATE_HZ ) / portNANOSECONDS_PER_SECOND );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_VIRTUAL_TIME */
+
+static uint64_t prvTickToTime( uint64_t ullTick )
+{
+	/* Split the calculation so the intermediate values cannot overflow. */
+	return ( ( ullTick / configTICK_RATE_HZ ) * portNANOSECONDS_PER_SECOND ) + ( ( ( ullTick % configTICK_RATE_HZ ) * portNANOSECONDS_PER_SECOND ) / configTICK_RATE_HZ );
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_VIRTUAL_TIME == 0 ) && ( configSIMULATOR_KERNEL_INSTANCES == 0 )
+
+static void *prvSimulatedPeripheralTimer( void *pvParameter )
+{
+uint64_t ullStartTime, ullNextTickTime, ullTicksGenerated = 0ULL, ullTicksElapsed, ullTicksToWait;
+struct timespec xNextTick;
+#if( configUSE_TICKLESS_IDLE == 1 )
+	uint32_t ulTicklessIdleSleeping, ulSuppressedTicks = 0UL, ulSuppressedTicksAtLastSecond = 0UL;
+	uint64_t ullSecond = 0ULL;
+#endif
+
+	/* Just to prevent compiler warnings. */
+	( void ) pvParameter;
+
+	ullStartTime = prvGetMonotonicTime();
+
+	for( ;; )
+	{
+		ullTicksToWait = 1ULL;
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			/* If the idle task has requested a tickless idle period then sleep
+			for the whole period instead of generating ticks.  The period ends
+			early if a simulated interrupt is raised - including one raised
+			before the request was seen. */
+			ulTicklessIdleSleeping = pdFALSE;
+
+			if( ulTicklessIdleState == portTICKLESS_IDLE_REQUESTED )
+			{
+				ulTicklessIdleSleeping = pdTRUE;
+				ulTicklessIdleState = portTICKLESS_IDLE_SLEEPING;
+
+				/* Discard wakes left over from earlier periods - the abort
+				flag records any that are still relevant. */
+				while( sem_trywait( &xTickTimerEvent ) == 0 )
+				{
+				}
+
+				if( __atomic_load_n( &xTicklessIdleAbort, __ATOMIC_SEQ_CST ) == pdFALSE )
+				{
+					ullTicksToWait = ( uint64_t ) xTicklessIdleTime;
+				}
+				else
+				{
+					ullTicksToWait = 0ULL;
+				}
+			}
+		}
+		#endif /* configUSE_TICKLESS_IDLE */
+
+		/* Wait until the deadline of the next tick.  The deadline is calculated
+		from the time the timer started, not from the time this thread last
+		woke, so neither late wakes nor the rounding of the tick period to
+		whole nanoseconds cause the tick rate to drift.  xTickTimerEvent is
+		only posted to start or end a tickless idle period. */
+		if( ullTicksToWait > 0ULL )
+		{
+			ullNextTickTime = ullStartTime + prvTickToTime( ullTicksGenerated + ullTicksToWait );
+			xNextTick.tv_sec = ( time_t ) ( ullNextTickTime / portNANOSECONDS_PER_SECOND );
+			xNextTick.tv_nsec = ( long ) ( ullNextTickTime % portNANOSECONDS_PER_SECOND );
+
+			while( ( sem_clockwait( &xTickTimerEvent, CLOCK_MONOTONIC, &xNextTick ) != 0 ) && ( errno == EINTR ) )
+			{
+				/* Interrupted by a signal, just wait again. */
+			}
+		}
+
+		/* The host may not have run this thread at the deadline, and the wait
+		may have ended early, so work out how many tick periods have really
+		elapsed since the timer started. */
+		ullTicksElapsed = prvTimeToTick( prvGetMonotonicTime() - ullStartTime );
+
+		if( ullTicksElapsed < ullTicksGenerated )
+		{
+			ullTicksElapsed = ullTicksGenerated;
+		}
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			if( ulTicklessIdleSleeping != pdFALSE )
+			{
+				/* Hand the elapsed tick periods to the idle task, which steps
+				the tick count forward by them, instead of generating them. */
+				xTicklessIdleElapsed = ( TickType_t ) ( ullTicksElapsed - ullTicksGenerated );
+
+				/* The last period is delivered as a tick interrupt, see
+				vPortSuppressTicksAndSleep(). */
+				if( xTicklessIdleElapsed < xTicklessIdleTime )
+				{
+					ulSuppressedTicks += ( uint32_t ) xTicklessIdleElapsed;
+				}
+				else
+				{
+					ulSuppressedTicks += ( uint32_t ) ( xTicklessIdleTime - 1 );
+				}
+				ullTicksGenerated = ullTicksElapsed;
+				sem_post( &xTicklessIdleComplete );
+			}
+
+			/* Each time a second boundary is passed record how many ticks
+			were suppressed per second since the last boundary. */
+			if( ( ullTicksElapsed / configTICK_RATE_HZ ) != ullSecond )
+			{
+				ulSuppressedTicksPerSecond = ( ulSuppressedTicks - ulSuppressedTicksAtLastSecond ) / ( uint32_t ) ( ( ullTicksElapsed / configTICK_RATE_HZ ) - ullSecond );
+				ulSuppressedTicksAtLastSecond = ulSuppressedTicks;
+				ullSecond = ullTicksElapsed / configTICK_RATE_HZ;
+			}
+		}
+		#endif /* configUSE_TICKLESS_IDLE */
+
+		if( ullTicksElapsed > ullTicksGenerated )
+		{
+			if( ( ullTicksElapsed - ullTicksGenerated ) > 1ULL )
+			{
+				__atomic_fetch_add( &ulMissedTicks, ( uint32_t ) ( ullTicksElapsed - ullTicksGenerated - 1ULL ), __ATOMIC_RELAXED );
+			}
+
+			__atomic_fetch_add( &ulTicksToProcess, ( uint32_t ) ( ullTicksElapsed - ullTicksGenerated ), __ATOMIC_ACQ_REL );
+			ullTicksGenerated = ullTicksElapsed;
+
+			/* The timer has expired, generate the simulated tick event. */
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+	}
+
+	/* Should never reach here. */
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_VIRTUAL_TIME, configSIMULATOR_KERNEL_INSTANCES */
+
+static uint32_t prvProcessYieldInterrupt( void )
+{
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* The cores to switch are marked in ulYieldRequestCores, and a yield
+		is not a request to switch core 0 in particular. */
+		return pdFALSE;
+	}
+	#else
+	{
+		/* Always return true as this is a yield. */
+		return pdTRUE;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessTickInterrupt( void )
+{
+uint32_t ulSwitchRequired = pdFALSE, ulTicks;
+UBaseType_t uxSavedInterruptStatus;
+
+	configASSERT( xPortRunning );
+
+	/* Take every tick generated since the handler last executed.  This is
+	zero if the ticks were already taken by the previous execution of the
+	handler, which can happen because pending interrupts are not counted. */
+	#if( configSIMULATOR_RECORD_REPLAY != 0 )
+	{
+		/* Only the ticks delivered at a delivery point, which the tick thread
+		may have added to since. */
+		ulTicks = ulTicksDelivered;
+		ulTicksDelivered = 0UL;
+	}
+	#else
+	{
+		ulTicks = __atomic_exchange_n( &ulTicksToProcess, 0UL, __ATOMIC_ACQ_REL );
+	}
+	#endif
+
+	/* Normally there is one tick to process, but if the host fell behind
+	then the ticks that were missed are delivered here in one batch rather
+	than being lost.  This is what xTaskCatchUpTicks() does, but that cannot
+	be called from a simulated interrupt as vTaskSuspendAll() waits for
+	xInsideInterrupt to be cleared.  Interrupts that can use the FreeRTOS API
+	are masked while the tick count is incremented, as the SysTick handler of
+	a Cortex-M port does, so a higher priority interrupt cannot interrupt it. */
+	uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+	{
+		#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+		{
+			__atomic_store_n( &ullVirtualTicks, ullVirtualTicks + ulTicks, __ATOMIC_RELAXED );
+		}
+		#endif
+
+		while( ulTicks > 0UL )
+		{
+			if( xTaskIncrementTick() != pdFALSE )
+			{
+				ulSwitchRequired = pdTRUE;
+			}
+
+			ulTicks--;
+		}
+	}
+	portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+	return ulSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+static void prvPendInterrupt( uint32_t ulInterruptNumber )
+{
+uint32_t ulPriority = ucInterruptPriority[ ulInterruptNumber ];
+
+	/* The interrupt's own bit is set before the bit of its priority level, so
+	a thread that sees the level bit always finds the interrupt. */
+	__atomic_fetch_or( &( ulPendingInterrupts[ ulPriority ][ ulInterruptNumber / 32UL ] ), ( 1UL << ( ulInterruptNumber % 32UL ) ), __ATOMIC_SEQ_CST );
+	__atomic_fetch_or( &ulPendingPriorities, ( 1UL << ulPriority ), __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvTakeNextInterrupt( uint32_t ulPriorityLimit )
+{
+uint32_t ulPriorities, ulPriority, ulWord, ulBits, ulBit, ulReturn = portNO_INTERRUPT;
+BaseType_t xFound;
+
+	/* Only consider the priority levels above the limit. */
+	ulPriorities = __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) & ( uint32_t ) ( ( 1ULL << ulPriorityLimit ) - 1ULL );
+
+	while( ( ulPriorities != 0UL ) && ( ulReturn == portNO_INTERRUPT ) )
+	{
+		ulPriority = ( uint32_t ) __builtin_ctz( ulPriorities );
+		xFound = pdFALSE;
+
+		for( ulWord = 0UL; ( ulWord < portINTERRUPT_WORDS ) && ( ulReturn == portNO_INTERRUPT ); ulWord++ )
+		{
+			ulBits = __atomic_load_n( &( ulPendingInterrupts[ ulPriority ][ ulWord ] ), __ATOMIC_SEQ_CST );
+
+			while( ulBits != 0UL )
+			{
+				xFound = pdTRUE;
+				ulBit = 1UL << __builtin_ctz( ulBits );
+
+				/* Only one thread takes interrupts, but it can be interrupted
+				by a higher priority interrupt that takes the same bit, so
+				check the bit was still set when it was cleared. */
+				if( ( __atomic_fetch_and( &( ulPendingInterrupts[ ulPriority ][ ulWord ] ), ~ulBit, __ATOMIC_SEQ_CST ) & ulBit ) != 0UL )
+				{
+					ulReturn = ( ulWord * 32UL ) + ( uint32_t ) __builtin_ctz( ulBits );
+					break;
+				}
+
+				ulBits &= ~ulBit;
+			}
+		}
+
+		if( ( ulReturn == portNO_INTERRUPT ) && ( xFound == pdFALSE ) )
+		{
+			/* Nothing is pending at this level, so clear its bit.  An interrupt
+			pended after the bitmap was read may have set the level bit before
+			it was cleared, so read the bitmap again and restore the level bit
+			if that happened. */
+			__atomic_fetch_and( &ulPendingPriorities, ~( 1UL << ulPriority ), __ATOMIC_SEQ_CST );
+
+			for( ulWord = 0UL; ulWord < portINTERRUPT_WORDS; ulWord++ )
+			{
+				if( __atomic_load_n( &( ulPendingInterrupts[ ulPriority ][ ulWord ] ), __ATOMIC_SEQ_CST ) != 0UL )
+				{
+					__atomic_fetch_or( &ulPendingPriorities, ( 1UL << ulPriority ), __ATOMIC_SEQ_CST );
+					xFound = pdTRUE;
+					break;
+				}
+			}
+		}
+
+		if( xFound == pdFALSE )
+		{
+			ulPriorities &= ~( 1UL << ulPriority );
+		}
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunPendingInterrupts( void )
+{
+uint32_t ulInterruptNumber, ulPriority, ulPreviousPriority, ulPreviousMask, ulLimit;
+BaseType_t xPreviousInsideInterrupt;
+
+	/* The priority of the code that was interrupted - task code, a lower
+	priority interrupt, or the context switch. */
+	ulPreviousPriority = ulActivePriority;
+	xPreviousInsideInterrupt = xInsideInterrupt;
+
+	for( ;; )
+	{
+		ulLimit = ( ulInterruptMask < ulPreviousPriority ) ? ulInterruptMask : ulPreviousPriority;
+		ulInterruptNumber = prvTakeNextInterrupt( ulLimit );
+
+		if( ulInterruptNumber == portNO_INTERRUPT )
+		{
+			break;
+		}
+
+		ulPreviousMask = ulInterruptMask;
+		ulPriority = ( uint32_t ) ucInterruptPriority[ ulInterruptNumber ];
+		__atomic_store_n( &ulActivePriority, ulPriority, __ATOMIC_SEQ_CST );
+		xInsideInterrupt = pdTRUE;
+
+		/* An interrupt of a higher priority than this one that was raised
+		before ulActivePriority was updated may not have interrupted this
+		thread, so run it first. */
+		if( ( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) & ( ( 1UL << ulPriority ) - 1UL ) ) != 0UL )
+		{
+			prvRunPendingInterrupts();
+		}
+
+		if( ulIsrHandler[ ulInterruptNumber ] != NULL )
+		{
+			/* Run the actual handler.  Handlers return pdTRUE if they
+			necessitate a context switch. */
+			if( ulIsrHandler[ ulInterruptNumber ]() != pdFALSE )
+			{
+				xSwitchRequired = pdTRUE;
+			}
+		}
+
+		/* Like an exception return, restore the priority and mask of the code
+		that was interrupted. */
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		ulInterruptMask = ulPreviousMask;
+		__atomic_store_n( &ulActivePriority, ulPreviousPriority, __ATOMIC_SEQ_CST );
+		xInsideInterrupt = xPreviousInsideInterrupt;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority )
+{
+	/* The yield and tick interrupts stay at the lowest priority, as the
+	context switch must not interrupt an interrupt handler. */
+	configASSERT( ulInterruptNumber > portINTERRUPT_TICK );
+	configASSERT( ulPriority < portINTERRUPT_PRIORITY_LEVELS );
+
+	if( ( ulInterruptNumber > portINTERRUPT_TICK ) && ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( ulPriority < portINTERRUPT_PRIORITY_LEVELS ) )
+	{
+		ucInterruptPriority[ ulInterruptNumber ] = ( uint8_t ) ulPriority;
+	}
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetMissedTickCount( void )
+{
+	return ulMissedTicks;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvStartSimulatedPeripheralTimer( void )
+{
+pthread_t xTimerThread;
+BaseType_t xReturn = pdPASS;
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	struct sigevent xTimerEvent;
+	struct itimerspec xTimerPeriod;
+#endif
+
+	if( sem_init( &xTickTimerEvent, 0, 0 ) != 0 )
+	{
+		xReturn = pdFAIL;
+	}
+
+	#if( configUSE_TICKLESS_IDLE == 1 )
+	{
+		if( sem_init( &xTicklessIdleComplete, 0, 0 ) != 0 )
+		{
+			xReturn = pdFAIL;
+		}
+	}
+	#endif
+
+	/* In virtual time the tick is only advanced by the idle task, see
+	vPortSuppressTicksAndSleep(), so the timer peripheral is not needed. */
+	#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	{
+		/* A kernel instance has no tick thread, as its tick count can only be
+		reached from its own thread.  Instead a timer sends the interrupt
+		signal to the thread once per tick period, and the signal handler
+		works out from the clock how many periods have elapsed, just as the
+		tick thread does. */
+		( void ) xTimerThread;
+		memset( &xTimerEvent, 0x00, sizeof( xTimerEvent ) );
+		xTimerEvent.sigev_notify = SIGEV_THREAD_ID;
+		xTimerEvent.sigev_signo = portINTERRUPT_SIGNAL;
+		xTimerEvent.sigev_notify_thread_id = ( pid_t ) syscall( SYS_gettid );
+
+		xTimerPeriod.it_value.tv_sec = ( time_t ) ( prvTickToTime( 1ULL ) / portNANOSECONDS_PER_SECOND );
+		xTimerPeriod.it_value.tv_nsec = ( long ) ( prvTickToTime( 1ULL ) % portNANOSECONDS_PER_SECOND );
+		xTimerPeriod.it_interval = xTimerPeriod.it_value;
+
+		if( ( xReturn == pdPASS ) && ( timer_create( CLOCK_MONOTONIC, &xTimerEvent, &xTickTimer ) == 0 ) )
+		{
+			ullTickTimerStart = prvGetMonotonicTime();
+
+			if( timer_settime( xTickTimer, 0, &xTimerPeriod, NULL ) != 0 )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+		else
+		{
+			xReturn = pdFAIL;
+		}
+	}
+	#elif( configSIMULATOR_VIRTUAL_TIME == 0 )
+	{
+		if( xReturn == pdPASS )
+		{
+			if( pthread_create( &xTimerThread, NULL, prvSimulatedPeripheralTimer, NULL ) != 0 )
+			{
+				xReturn = pdFAIL;
+			}
+		}
+	}
+	#else
+	{
+		( void ) xTimerThread;
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	TickType_t xTicksToStep, xTicksToDeliver = 0;
+
+		/* Called by the idle task with the scheduler suspended.  Disable
+		(simulated) interrupts, as the port for a real target would while it
+		reprograms the tick timer, then check a task has not been made ready
+		since the scheduler was suspended. */
+		portDISABLE_INTERRUPTS();
+
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+		{
+			prvAdvanceVirtualTime( xExpectedIdleTime );
+			portENABLE_INTERRUPTS();
+			return;
+		}
+		#endif
+
+		/* Ask the tick thread to stop generating ticks and sleep instead.
+		Storing the state before reading ulPendingPriorities, while
+		vPortGenerateSimulatedInterrupt() sets ulPendingPriorities before
+		reading the state, ensures an interrupt raised at the same time is
+		seen by one side or the other. */
+		xTicklessIdleTime = xExpectedIdleTime;
+		xTicklessIdleAbort = pdFALSE;
+		__atomic_store_n( &ulTicklessIdleState, portTICKLESS_IDLE_REQUESTED, __ATOMIC_SEQ_CST );
+
+		if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) != 0UL )
+		{
+			xTicklessIdleAbort = pdTRUE;
+		}
+
+		sem_post( &xTickTimerEvent );
+
+		/* Sleep until the tick thread wakes.  Simulated interrupts are enabled
+		while sleeping so they can execute, and end the sleep, but they cannot
+		cause a context switch as the scheduler is suspended. */
+		portENABLE_INTERRUPTS();
+
+		while( sem_wait( &xTicklessIdleComplete ) != 0 )
+		{
+			/* Interrupted by a signal, just wait again. */
+		}
+
+		portDISABLE_INTERRUPTS();
+		__atomic_store_n( &ulTicklessIdleState, portTICKLESS_IDLE_INACTIVE, __ATOMIC_SEQ_CST );
+
+		/* Step the tick count forward by the tick periods that elapsed.  The
+		tick count must not be stepped to or beyond the time the next task
+		unblocks, so the last period (and any overrun) is delivered as a tick
+		interrupt instead, which unblocks the task as normal. */
+		xTicksToStep = xTicklessIdleElapsed;
+
+		if( xTicksToStep >= xExpectedIdleTime )
+		{
+			xTicksToDeliver = xTicksToStep - ( xExpectedIdleTime - 1 );
+			xTicksToStep = xExpectedIdleTime - 1;
+		}
+
+		if( xTicksToStep > 0 )
+		{
+			vTaskStepTick( xTicksToStep );
+		}
+
+		if( xTicksToDeliver > 0 )
+		{
+			__atomic_fetch_add( &ulTicksToProcess, ( uint32_t ) xTicksToDeliver, __ATOMIC_ACQ_REL );
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+
+		portENABLE_INTERRUPTS();
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+		static void prvJumpVirtualTime( TickType_t xExpectedIdleTime, uint32_t ulTicksToDeliver )
+		{
+			if( xExpectedIdleTime > 1 )
+			{
+				vTaskStepTick( xExpectedIdleTime - 1 );
+				__atomic_store_n( &ullVirtualTicks, ullVirtualTicks + ( uint64_t ) ( xExpectedIdleTime - 1 ), __ATOMIC_RELAXED );
+			}
+
+			__atomic_fetch_add( &ulTicksToProcess, ulTicksToDeliver, __ATOMIC_ACQ_REL );
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+		/*-----------------------------------------------------------*/
+
+		static void prvAdvanceVirtualTime( TickType_t xExpectedIdleTime )
+		{
+			/* An interrupt raised by another host thread, a simulated peripheral
+			for example, executes before time moves on. */
+			if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) != 0UL )
+			{
+				return;
+			}
+
+			if( ( TickType_t ) ( xTaskGetTickCount() + xExpectedIdleTime ) != portMAX_DELAY )
+			{
+				/* Every task is blocked, so nothing happens before the next task
+				unblocks - jump straight to that time.  The tick count is
+				stepped to the period before, and the last period is delivered
+				as a tick interrupt, which unblocks the task as normal. */
+				prvJumpVirtualTime( xExpectedIdleTime, 1UL );
+			}
+			else if( eTaskConfirmSleepModeStatus() != eNoTasksWaitingTimeout )
+			{
+				/* The next unblock time is also portMAX_DELAY when the tasks that
+				wait for a time only wake after the tick count wraps.  Once the
+				tick count reaches portMAX_DELAY the idle task expects no idle
+				time, so would never come back here - deliver the wrap in the
+				same batch.  A task that waits for the tick count portMAX_DELAY
+				itself is therefore woken one tick late. */
+				prvJumpVirtualTime( xExpectedIdleTime, 2UL );
+			}
+			else
+			{
+				/* The next unblock time is portMAX_DELAY when no task is
+				waiting for a time, only for an event, so only an interrupt
+				from outside the simulation can unblock one.  Wait for
+				it without moving time on.  The request is stored before
+				ulPendingPriorities is read, as in vPortSuppressTicksAndSleep(),
+				so an interrupt raised at the same time is not missed. */
+				xTicklessIdleAbort = pdFALSE;
+				__atomic_store_n( &ulTicklessIdleState, portTICKLESS_IDLE_SLEEPING, __ATOMIC_SEQ_CST );
+
+				if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) == 0UL )
+				{
+					portENABLE_INTERRUPTS();
+
+					while( __atomic_load_n( &xTicklessIdleAbort, __ATOMIC_SEQ_CST ) == pdFALSE )
+					{
+						( void ) sem_wait( &xTickTimerEvent );
+					}
+
+					portDISABLE_INTERRUPTS();
+				}
+
+				__atomic_store_n( &ulTicklessIdleState, portTICKLESS_IDLE_INACTIVE, __ATOMIC_SEQ_CST );
+			}
+		}
+		/*-----------------------------------------------------------*/
+
+		uint64_t ullPortGetVirtualTime( void )
+		{
+			return prvTickToTime( __atomic_load_n( &ullVirtualTicks, __ATOMIC_RELAXED ) );
+		}
+		/*-----------------------------------------------------------*/
+
+	#endif /* configSIMULATOR_VIRTUAL_TIME */
+
+	static void prvAbortTicklessIdle( void )
+	{
+		if( __atomic_load_n( &ulTicklessIdleState, __ATOMIC_SEQ_CST ) != portTICKLESS_IDLE_INACTIVE )
+		{
+			/* sem_post() is async-signal-safe, so this can be used from the
+			interrupt signal handler of the fiber engine. */
+			__atomic_store_n( &xTicklessIdleAbort, pdTRUE, __ATOMIC_SEQ_CST );
+			sem_post( &xTickTimerEvent );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	uint32_t ulPortGetSuppressedTicksPerSecond( void )
+	{
+		return ulSuppressedTicksPerSecond;
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	void *pvEndingTaskTopOfStack;
+	sigset_t xSignals;
+#endif
+
+	#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	{
+		/* Only this instance ends.  Stop its tick and its interrupts, then
+		return to the stack xPortStartScheduler() was called on, so
+		vTaskStartScheduler() returns.  The task that ended the scheduler is
+		never switched back to. */
+		timer_delete( xTickTimer );
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+		xPortRunning = pdFALSE;
+
+		vPortSwitchFiber( &pvEndingTaskTopOfStack, pvSchedulerTopOfStack );
+	}
+	#else
+	{
+		exit( 0 );
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvSetAlternateSignalStack( void )
+{
+stack_t xAlternateStack;
+int iResult;
+
+	/* The thread never exits, so the stack is never freed. */
+	xAlternateStack.ss_sp = malloc( portALTERNATE_SIGNAL_STACK_SIZE );
+	xAlternateStack.ss_size = portALTERNATE_SIGNAL_STACK_SIZE;
+	xAlternateStack.ss_flags = 0;
+	configASSERT( xAlternateStack.ss_sp );
+
+	iResult = sigaltstack( &xAlternateStack, NULL );
+	configASSERT( iResult == 0 );
+	( void ) iResult;
+}
+/*-----------------------------------------------------------*/
+
+#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+
+void *pvPortMallocStack( size_t xSize )
+{
+StackMapping_t *pxMapping;
+uint8_t *pucMapping;
+size_t xPageSize, xStackSize, xMappingSize;
+
+	/* The stack starts at the top of the guard region, which is below it as
+	the stack grows down, and the record of the mapping follows the stack.
+	Only the guard region has to start on a page boundary, but the whole
+	mapping is a number of pages. */
+	xPageSize = ( size_t ) sysconf( _SC_PAGESIZE );
+	xStackSize = ( xSize + ( sizeof( void * ) - 1U ) ) & ~( sizeof( void * ) - 1U );
+	xMappingSize = portSTACK_GUARD_SIZE + xStackSize + sizeof( StackMapping_t );
+	xMappingSize = ( xMappingSize + ( xPageSize - 1U ) ) & ~( xPageSize - 1U );
+
+	pucMapping = ( uint8_t * ) mmap( NULL, xMappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+
+	if( pucMapping == ( uint8_t * ) MAP_FAILED )
+	{
+		return NULL;
+	}
+
+	if( mprotect( pucMapping, portSTACK_GUARD_SIZE, PROT_NONE ) != 0 )
+	{
+		munmap( pucMapping, xMappingSize );
+		return NULL;
+	}
+
+	pxMapping = ( StackMapping_t * ) ( pucMapping + portSTACK_GUARD_SIZE + xStackSize );
+	pxMapping->pucMapping = pucMapping;
+	pxMapping->xMappingSize = xMappingSize;
+	pxMapping->pvStack = pucMapping + portSTACK_GUARD_SIZE;
+
+	portENTER_CRITICAL();
+	{
+		pxMapping->pxNext = pxStackMappings;
+		pxStackMappings = pxMapping;
+	}
+	portEXIT_CRITICAL();
+
+	return pxMapping->pvStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFreeStack( void *pv )
+{
+StackMapping_t *pxMapping, * volatile *ppxLink;
+uint8_t *pucMapping = NULL;
+size_t xMappingSize = 0U;
+
+	if( pv == NULL )
+	{
+		return;
+	}
+
+	portENTER_CRITICAL();
+	{
+		for( ppxLink = &pxStackMappings; *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNext ) )
+		{
+			pxMapping = *ppxLink;
+
+			if( pxMapping->pvStack == pv )
+			{
+				*ppxLink = pxMapping->pxNext;
+				pucMapping = pxMapping->pucMapping;
+				xMappingSize = pxMapping->xMappingSize;
+				break;
+			}
+		}
+	}
+	portEXIT_CRITICAL();
+
+	/* The record is inside the mapping, so is unmapped with the stack. */
+	configASSERT( pucMapping );
+
+	if( pucMapping != NULL )
+	{
+		munmap( pucMapping, xMappingSize );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvIsInStackGuard( const uint8_t *pucAddress, size_t xAllowance )
+{
+StackMapping_t *pxMapping;
+
+	for( pxMapping = pxStackMappings; pxMapping != NULL; pxMapping = pxMapping->pxNext )
+	{
+		if( ( pucAddress >= pxMapping->pucMapping ) && ( pucAddress < ( pxMapping->pucMapping + portSTACK_GUARD_SIZE + xAllowance ) ) )
+		{
+			return pdTRUE;
+		}
+	}
+
+	return pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvStackGuardSignalHandler( int iSignal, siginfo_t *pxInfo, void *pvContext )
+{
+BaseType_t xOverflow;
+
+	xOverflow = prvIsInStackGuard( ( const uint8_t * ) pxInfo->si_addr, 0U );
+
+	#if( configSIMULATOR_USE_FIBERS == 1 )
+	{
+		/* The signal frame of a simulated interrupt is pushed onto the task
+		stack.  If it does not fit the host raises SIGSEGV without a fault
+		address, so look at the stack pointer of the interrupted code
+		instead. */
+		if( ( xOverflow == pdFALSE ) && ( pxInfo->si_code == SI_KERNEL ) )
+		{
+			xOverflow = prvIsInStackGuard( ( const uint8_t * ) ( ( ucontext_t * ) pvContext )->uc_mcontext.gregs[ REG_RSP ], portSTACK_GUARD_SIZE );
+		}
+	}
+	#else
+	{
+		( void ) pvContext;
+	}
+	#endif
+
+	if( xOverflow != pdFALSE )
+	{
+		#if( configCHECK_FOR_STACK_OVERFLOW > 0 )
+		{
+			vApplicationStackOverflowHook( xTaskGetCurrentTaskHandle(), pcTaskGetName( NULL ) );
+		}
+		#else
+		{
+			static const char pcMessage[] = "Task stack overflow.\n";
+
+			( void ) write( STDERR_FILENO, pcMessage, sizeof( pcMessage ) - 1U );
+		}
+		#endif
+	}
+
+	/* Not a stack overflow, or the hook returned.  Restore the default action
+	so the fault terminates the process just as it would have done without
+	this handler - the signal is delivered again when the handler returns. */
+	signal( iSignal, SIG_DFL );
+	raise( iSignal );
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvInstallStackGuardHandler( void )
+{
+struct sigaction xGuardAction;
+
+	/* The handler runs on the alternate signal stack of the faulting thread,
+	as the task stack is exhausted. */
+	sigemptyset( &( xGuardAction.sa_mask ) );
+	xGuardAction.sa_flags = SA_SIGINFO | SA_ONSTACK;
+	xGuardAction.sa_sigaction = prvStackGuardSignalHandler;
+
+	return ( sigaction( SIGSEGV, &xGuardAction, NULL ) == 0 ) ? pdPASS : pdFAIL;
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSTACK_ALLOCATION_FROM_SEPARATE_HEAP */
+
+#if ( configSIMULATOR_USE_FIBERS == 1 )
+
+static void prvFiberTaskEntry( TaskFunction_t pxCode, void *pvParameters )
+{
+	/* The task was switched in by prvProcessSimulatedInterrupts(), running
+	either in another task or in the thread that started the scheduler, so
+	complete the interrupt processing that switched it in - exactly what a
+	task that was switched in part way through prvProcessSimulatedInterrupts()
+	does when vPortSwitchFiber() returns. */
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	ulInterruptMask = portINTERRUPTS_UNMASKED;
+	ulActivePriority = portTASK_LEVEL_PRIORITY;
+	xInsideInterrupt = pdFALSE;
+	prvProcessSimulatedInterrupts();
+
+	pxCode( pvParameters );
+
+	/* Tasks must not return from their implementing function, but if one does
+	then delete it. */
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+StackType_t *pxStack;
+
+	/* The end of the stack is only needed by the thread per task engine. */
+	( void ) pxEndOfStack;
+
+	/* Unlike the thread per task engine the task stack is used as a real
+	stack, so build the frame that vPortSwitchFiber() expects to find when it
+	switches to the task for the first time.  The kernel has already aligned
+	pxTopOfStack to portBYTE_ALIGNMENT - align it to the 16 bytes the x86_64
+	ABI requires, and leave two words above the frame so the stack pointer is
+	16 byte aligned when vPortStartFiber() calls prvFiberTaskEntry(). */
+	pxStack = ( StackType_t * ) ( ( ( portPOINTER_SIZE_TYPE ) pxTopOfStack ) & ~( ( portPOINTER_SIZE_TYPE ) 0x0f ) );
+	pxStack -= 2;
+
+	*( --pxStack ) = ( StackType_t ) vPortStartFiber;		/* Return address. */
+	*( --pxStack ) = 0;										/* RBP. */
+	*( --pxStack ) = 0;										/* RBX. */
+	*( --pxStack ) = ( StackType_t ) pxCode;				/* R12. */
+	*( --pxStack ) = ( StackType_t ) pvParameters;			/* R13. */
+	*( --pxStack ) = ( StackType_t ) prvFiberTaskEntry;		/* R14. */
+	*( --pxStack ) = 0;										/* R15. */
+	*( --pxStack ) = ( portINITIAL_FPU_CONTROL_WORD << 32UL ) | portINITIAL_MXCSR;
+
+	return pxStack;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetHostThreadCount( void )
+{
+	/* Every task runs on the thread that started the scheduler. */
+	return 0UL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+struct sigaction xInterruptAction;
+sigset_t xSignals;
+int32_t lSuccess = pdPASS;
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	stack_t xAlternateStack;
+	#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+		StackMapping_t *pxMapping;
+	#endif
+#endif
+
+	#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	{
+		/* The thread that called main() runs an instance without having been
+		created by xPortCreateKernelInstance(), so give it a handle here.  A
+		thread bound to another instance cannot run one itself. */
+		if( pxThisKernelInstance == NULL )
+		{
+			pxThisKernelInstance = ( KernelInstance_t * ) calloc( 1, sizeof( KernelInstance_t ) );
+			configASSERT( pxThisKernelInstance );
+			pxThisKernelInstance->xThread = pthread_self();
+		}
+
+		configASSERT( pthread_equal( pxThisKernelInstance->xThread, pthread_self() ) != 0 );
+	}
+	#endif
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* This thread becomes the simulated CPU that runs every task.  It is
+	treated as being inside the context switch, with interrupts masked, until
+	the first task is switched in, so a tick that occurs before then is held
+	pending. */
+	xSimulatedCPUThread = pthread_self();
+	ulCriticalNesting = portNO_CRITICAL_NESTING;
+	ulActivePriority = configKERNEL_INTERRUPT_PRIORITY;
+	ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+	xInsideInterrupt = pdTRUE;
+	xPortRunning = pdTRUE;
+
+	/* Install the handler that delivers interrupts raised by other host
+	threads.  SA_NODEFER is used so the signal is never left blocked when the
+	handler switches to a different task, and so a higher priority interrupt
+	can interrupt a handler - prvRunPendingInterrupts() only runs interrupts
+	of a higher priority than the code that was interrupted. */
+	sigemptyset( &( xInterruptAction.sa_mask ) );
+	xInterruptAction.sa_flags = SA_RESTART | SA_NODEFER;
+	xInterruptAction.sa_handler = prvInterruptSignalHandler;
+	if( sigaction( portINTERRUPT_SIGNAL, &xInterruptAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	/* A task that overflows its stack faults with its stack exhausted, so the
+	SIGSEGV handler runs on an alternate signal stack. */
+	prvSetAlternateSignalStack();
+
+	#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+	{
+		if( prvInstallStackGuardHandler() != pdPASS )
+		{
+			lSuccess = pdFAIL;
+		}
+	}
+	#endif
+
+	if( lSuccess == pdPASS )
+	{
+		/* Start the thread that simulates the timer peripheral to generate
+		tick interrupts.  It must not receive the interrupt signal itself. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+		if( prvStartSimulatedPeripheralTimer() != pdPASS )
+		{
+			lSuccess = pdFAIL;
+		}
+
+		pthread_sigmask( SIG_UNBLOCK, &xSignals, NULL );
+	}
+
+	#if( configSIMULATOR_RECORD_REPLAY != 0 )
+	{
+		if( ( lSuccess == pdPASS ) && ( prvOpenRecordReplay() != pdPASS ) )
+		{
+			lSuccess = pdFAIL;
+		}
+	}
+	#endif
+
+	if( lSuccess == pdPASS )
+	{
+		/* Start the first task.  This thread's own stack is not used again
+		unless the scheduler of a kernel instance ends. */
+		vPortSwitchFiber( &pvSchedulerTopOfStack, *( void ** ) pxCurrentTCB );
+
+		#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+		{
+			/* vPortEndScheduler() switched back, and no task will run again.
+			The heap and the rest of the instance's state are thread local so
+			are freed when the thread ends, but the task stacks and the
+			alternate signal stack are not. */
+			#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+			{
+				while( pxStackMappings != NULL )
+				{
+					pxMapping = pxStackMappings;
+					pxStackMappings = pxMapping->pxNext;
+					munmap( pxMapping->pucMapping, pxMapping->xMappingSize );
+				}
+			}
+			#endif
+
+			if( sigaltstack( NULL, &xAlternateStack ) == 0 )
+			{
+				xAlternateStack.ss_flags = SS_DISABLE;
+				if( sigaltstack( &xAlternateStack, NULL ) == 0 )
+				{
+					free( xAlternateStack.ss_sp );
+				}
+			}
+		}
+		#endif
+	}
+
+	/* Would not expect to return from vPortSwitchFiber() unless the scheduler
+	of a kernel instance has ended. */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_RECORD_REPLAY != 0 )
+
+static BaseType_t prvOpenRecordReplay( void )
+{
+RecordHeader_t xHeader, xExpected;
+BaseType_t xReturn = pdFAIL;
+
+	memset( &xExpected, 0x00, sizeof( xExpected ) );
+	memcpy( xExpected.cMagic, portRECORD_MAGIC, sizeof( xExpected.cMagic ) );
+	xExpected.ulVersion = portRECORD_VERSION;
+	xExpected.ulTickRateHz = configTICK_RATE_HZ;
+	xExpected.ulInterruptLines = portMAX_INTERRUPTS;
+
+	#if( configSIMULATOR_RECORD_REPLAY == 1 )
+	{
+		iRecordFile = open( configSIMULATOR_RECORD_REPLAY_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+
+		if( iRecordFile >= 0 )
+		{
+			if( ( write( iRecordFile, &xExpected, sizeof( xExpected ) ) == ( ssize_t ) sizeof( xExpected ) ) && ( atexit( vPortFlushRecording ) == 0 ) )
+			{
+				xReturn = pdPASS;
+			}
+		}
+
+		( void ) xHeader;
+	}
+	#else
+	{
+		iRecordFile = open( configSIMULATOR_RECORD_REPLAY_FILE, O_RDONLY | O_CLOEXEC );
+
+		if( iRecordFile >= 0 )
+		{
+			if( ( read( iRecordFile, &xHeader, sizeof( xHeader ) ) == ( ssize_t ) sizeof( xHeader ) ) && ( memcmp( &xHeader, &xExpected, sizeof( xHeader ) ) == 0 ) )
+			{
+				xReturn = pdPASS;
+				prvReadNextRecord();
+			}
+		}
+	}
+	#endif
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+static void prvDeliveryPoint( void )
+{
+	ullDeliveryPoints++;
+
+	#if( configSIMULATOR_RECORD_REPLAY == 1 )
+	{
+		if( __atomic_load_n( &xInterruptsStaged, __ATOMIC_ACQUIRE ) != pdFALSE )
+		{
+			prvLatchInterrupts();
+		}
+	}
+	#else
+	{
+		if( xReplayComplete == pdFALSE )
+		{
+			prvReplayInterrupts();
+		}
+		else if( __atomic_load_n( &xInterruptsStaged, __ATOMIC_ACQUIRE ) != pdFALSE )
+		{
+			prvLatchInterrupts();
+		}
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvStageInterrupt( uint32_t ulInterruptNumber )
+{
+	#if( configSIMULATOR_RECORD_REPLAY == 2 )
+	{
+		/* The log says when the interrupts were raised. */
+		if( __atomic_load_n( &xReplayComplete, __ATOMIC_ACQUIRE ) == pdFALSE )
+		{
+			return;
+		}
+	}
+	#endif
+
+	__atomic_fetch_or( &( ulStagedInterrupts[ ulInterruptNumber / 32UL ] ), ( 1UL << ( ulInterruptNumber % 32UL ) ), __ATOMIC_SEQ_CST );
+	__atomic_store_n( &xInterruptsStaged, pdTRUE, __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+static void prvLatchInterrupts( void )
+{
+uint32_t ulWord, ulBits, ulInterruptNumber, ulTicks;
+
+	/* The flag is cleared before the bits are taken, so an interrupt staged
+	after its bit was taken sets the flag again. */
+	__atomic_store_n( &xInterruptsStaged, pdFALSE, __ATOMIC_SEQ_CST );
+
+	/* Ticks are counted rather than staged, so the tick interrupt's bit is
+	ignored - if the count is zero its ticks were taken at an earlier
+	delivery point. */
+	ulTicks = __atomic_exchange_n( &ulTicksToProcess, 0UL, __ATOMIC_ACQ_REL );
+
+	if( ulTicks > 0UL )
+	{
+		#if( configSIMULATOR_RECORD_REPLAY == 1 )
+		{
+			prvWriteRecord( pxCurrentTCB, portRECORD_TICKS, ulTicks );
+		}
+		#endif
+
+		ulTicksDelivered += ulTicks;
+		prvPendInterrupt( portINTERRUPT_TICK );
+	}
+
+	for( ulWord = 0UL; ulWord < portINTERRUPT_WORDS; ulWord++ )
+	{
+		ulBits = __atomic_exchange_n( &( ulStagedInterrupts[ ulWord ] ), 0UL, __ATOMIC_SEQ_CST );
+
+		if( ulWord == ( portINTERRUPT_TICK / 32UL ) )
+		{
+			ulBits &= ~( 1UL << ( portINTERRUPT_TICK % 32UL ) );
+		}
+
+		while( ulBits != 0UL )
+		{
+			ulInterruptNumber = ( ulWord * 32UL ) + ( uint32_t ) __builtin_ctz( ulBits );
+			ulBits &= ulBits - 1UL;
+
+			#if( configSIMULATOR_RECORD_REPLAY == 1 )
+			{
+				prvWriteRecord( pxCurrentTCB, portRECORD_INTERRUPT, ulInterruptNumber );
+			}
+			#endif
+
+			prvPendInterrupt( ulInterruptNumber );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_RECORD_REPLAY == 1 )
+
+	static void prvWriteRecord( void *pvTask, uint16_t usEvent, uint32_t ulValue )
+	{
+	Record_t *pxRecord;
+	uint64_t ullPointDelta = ullDeliveryPoints - ullRecordPoint;
+	BaseType_t xWritten = pdFALSE;
+
+		while( xWritten == pdFALSE )
+		{
+			if( ulRecordCount == portRECORD_BUFFER_LENGTH )
+			{
+				vPortFlushRecording();
+			}
+
+			pxRecord = &( xRecords[ ulRecordCount ] );
+			ulRecordCount++;
+
+			pxRecord->ulTickCount = ( uint32_t ) xTaskGetTickCount();
+			pxRecord->usTaskNumber = ( uint16_t ) uxTaskGetTCBNumber( ( TaskHandle_t ) pvTask );
+
+			if( ullPointDelta > UINT32_MAX )
+			{
+				/* Too long a gap for one record, so bridge it. */
+				pxRecord->ulPointDelta = UINT32_MAX;
+				pxRecord->usEvent = portRECORD_NONE;
+				pxRecord->ulValue = 0UL;
+				ullPointDelta -= UINT32_MAX;
+			}
+			else
+			{
+				pxRecord->ulPointDelta = ( uint32_t ) ullPointDelta;
+				pxRecord->usEvent = usEvent;
+				pxRecord->ulValue = ulValue;
+				xWritten = pdTRUE;
+			}
+		}
+
+		ullRecordPoint = ullDeliveryPoints;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvRecordSwitch( void *pvOldTCB )
+	{
+		prvWriteRecord( pvOldTCB, portRECORD_SWITCH, ( uint32_t ) uxTaskGetTCBNumber( ( TaskHandle_t ) pxCurrentTCB ) );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortFlushRecording( void )
+	{
+	size_t xLength = ulRecordCount * sizeof( Record_t ), xWritten = 0;
+	ssize_t xResult;
+
+		/* Only the simulated CPU thread writes records, so only it may call
+		this function.  If the log cannot be written, for example because the
+		disk is full, the records are dropped rather than stop the
+		simulation. */
+		if( iRecordFile >= 0 )
+		{
+			while( xWritten < xLength )
+			{
+				xResult = write( iRecordFile, ( ( uint8_t * ) xRecords ) + xWritten, xLength - xWritten );
+
+				if( xResult > 0 )
+				{
+					xWritten += ( size_t ) xResult;
+				}
+				else if( errno != EINTR )
+				{
+					break;
+				}
+			}
+		}
+
+		ulRecordCount = 0UL;
+	}
+	/*-----------------------------------------------------------*/
+
+#else /* configSIMULATOR_RECORD_REPLAY */
+
+	static void prvReadNextRecord( void )
+	{
+	const Record_t *pxRecord;
+	size_t xLength;
+	ssize_t xResult;
+	char cMessage[ 128 ];
+	int iLength;
+
+		pxReplayRecord = NULL;
+
+		while( ( pxReplayRecord == NULL ) && ( xReplayComplete == pdFALSE ) )
+		{
+			if( ulNextRecord == ulRecordCount )
+			{
+				/* Read as many whole records as the buffer holds. */
+				xLength = 0;
+
+				do
+				{
+					xResult = read( iRecordFile, ( ( uint8_t * ) xRecords ) + xLength, sizeof( xRecords ) - xLength );
+
+					if( xResult > 0 )
+					{
+						xLength += ( size_t ) xResult;
+					}
+				} while( ( xLength < sizeof( xRecords ) ) && ( ( xResult > 0 ) || ( ( xResult < 0 ) && ( errno == EINTR ) ) ) );
+
+				ulRecordCount = ( uint32_t ) ( xLength / sizeof( Record_t ) );
+				ulNextRecord = 0UL;
+			}
+
+			if( ulRecordCount == 0UL )
+			{
+				/* Interrupts raised from now on are only staged, not logged,
+				and the ticks the tick thread generated during the replay are
+				dropped as the log delivered the ticks instead. */
+				close( iRecordFile );
+				iRecordFile = -1;
+				__atomic_store_n( &ulTicksToProcess, 0UL, __ATOMIC_SEQ_CST );
+				__atomic_store_n( &xReplayComplete, pdTRUE, __ATOMIC_SEQ_CST );
+
+				iLength = snprintf( cMessage, sizeof( cMessage ), "Replay of %s complete at tick %lu.\n", configSIMULATOR_RECORD_REPLAY_FILE, ( unsigned long ) xTaskGetTickCount() );
+				( void ) write( STDERR_FILENO, cMessage, ( size_t ) iLength );
+			}
+			else
+			{
+				pxRecord = &( xRecords[ ulNextRecord ] );
+				ulNextRecord++;
+				ullRecordPoint += pxRecord->ulPointDelta;
+
+				if( pxRecord->usEvent != portRECORD_NONE )
+				{
+					pxReplayRecord = pxRecord;
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvCheckRecord( const Record_t *pxRecord, uint16_t usEvent, void *pvTask, uint32_t ulValue )
+	{
+	uint32_t ulTickCount = ( uint32_t ) xTaskGetTickCount();
+	uint16_t usTaskNumber = ( uint16_t ) uxTaskGetTCBNumber( ( TaskHandle_t ) pvTask );
+	char cMessage[ 256 ];
+	int iLength;
+
+		/* The replay no longer follows the recording if the record is late, is
+		a different event, or was logged in a different state. */
+		if( ( ullRecordPoint != ullDeliveryPoints ) || ( pxRecord->usEvent != usEvent ) || ( pxRecord->ulValue != ulValue ) || ( pxRecord->ulTickCount != ulTickCount ) || ( pxRecord->usTaskNumber != usTaskNumber ) )
+		{
+			iLength = snprintf( cMessage, sizeof( cMessage ), "Replay diverged at delivery point %llu, tick %lu, task %u, event %u (%lu): logged at point %llu, tick %lu, task %u, event %u (%lu).\n",
+				( unsigned long long ) ullDeliveryPoints, ( unsigned long ) ulTickCount, ( unsigned ) usTaskNumber, ( unsigned ) usEvent, ( unsigned long ) ulValue,
+				( unsigned long long ) ullRecordPoint, ( unsigned long ) pxRecord->ulTickCount, ( unsigned ) pxRecord->usTaskNumber, ( unsigned ) pxRecord->usEvent, ( unsigned long ) pxRecord->ulValue );
+			( void ) write( STDERR_FILENO, cMessage, ( size_t ) iLength );
+			configASSERT( pdFALSE );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvReplayInterrupts( void )
+	{
+		/* The switch logged at a delivery point is made by the interrupts
+		processed there, so is checked by prvRecordSwitch(). */
+		while( ( pxReplayRecord != NULL ) && ( ullRecordPoint <= ullDeliveryPoints ) && ( pxReplayRecord->usEvent != portRECORD_SWITCH ) )
+		{
+			prvCheckRecord( pxReplayRecord, pxReplayRecord->usEvent, pxCurrentTCB, pxReplayRecord->ulValue );
+
+			if( pxReplayRecord->usEvent == portRECORD_TICKS )
+			{
+				ulTicksDelivered += pxReplayRecord->ulValue;
+				prvPendInterrupt( portINTERRUPT_TICK );
+			}
+			else if( pxReplayRecord->ulValue < portMAX_INTERRUPTS )
+			{
+				prvPendInterrupt( pxReplayRecord->ulValue );
+			}
+
+			prvReadNextRecord();
+		}
+
+		/* A switch that should have been made at an earlier delivery point
+		was not. */
+		if( ( pxReplayRecord != NULL ) && ( ullRecordPoint < ullDeliveryPoints ) )
+		{
+			prvCheckRecord( pxReplayRecord, portRECORD_SWITCH, pxCurrentTCB, pxReplayRecord->ulValue );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvRecordSwitch( void *pvOldTCB )
+	{
+	uint32_t ulTaskNumber = ( uint32_t ) uxTaskGetTCBNumber( ( TaskHandle_t ) pxCurrentTCB );
+
+		if( pxReplayRecord != NULL )
+		{
+			prvCheckRecord( pxReplayRecord, portRECORD_SWITCH, pvOldTCB, ulTaskNumber );
+			prvReadNextRecord();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortFlushRecording( void )
+	{
+		/* Nothing is written when replaying. */
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_RECORD_REPLAY */
+
+void vPortIdleTaskPoll( void )
+{
+	/* The idle task can loop without calling the API, so it passes a
+	delivery point on each pass of its loop. */
+	prvDeliveryPoint();
+
+	if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) != 0UL )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_RECORD_REPLAY */
+
+static void prvProcessSimulatedInterrupts( void )
+{
+void *pvOldCurrentTCB;
+
+	for( ;; )
+	{
+		prvRunPendingInterrupts();
+
+		/* As on a Cortex-M, where the context switch is performed by PendSV at
+		the lowest interrupt priority, a context switch only happens once the
+		last interrupt has returned to task code that does not have interrupts
+		masked. */
+		if( ( ulActivePriority != portTASK_LEVEL_PRIORITY ) || ( ulInterruptMask != portINTERRUPTS_UNMASKED ) || ( xSwitchRequired == pdFALSE ) )
+		{
+			break;
+		}
+
+		/* The switch runs at the kernel interrupt priority with the interrupts
+		that can use the FreeRTOS API masked, so only an interrupt above
+		configMAX_SYSCALL_INTERRUPT_PRIORITY can interrupt it. */
+		ulActivePriority = configKERNEL_INTERRUPT_PRIORITY;
+		ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+		xInsideInterrupt = pdTRUE;
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		xSwitchRequired = pdFALSE;
+
+		pvOldCurrentTCB = pxCurrentTCB;
+
+		/* Record the current stack pointer of the task being switched out
+		before vTaskSwitchContext() runs, so stack overflow checking sees the
+		stack as it is now, as it would on real hardware.  vPortSwitchFiber()
+		stores the exact value. */
+		*( ( void ** ) pvOldCurrentTCB ) = __builtin_frame_address( 0 );
+
+		/* Select the next task to run. */
+		vTaskSwitchContext();
+
+		#if( configSIMULATOR_RECORD_REPLAY != 0 )
+		{
+			prvRecordSwitch( pvOldCurrentTCB );
+		}
+		#endif
+
+		/* If the task selected to enter the running state is not the task
+		that is already in the running state then switch stacks.  This call
+		returns when the old task is next selected to run, from the same point
+		in a different call to this function. */
+		if( pvOldCurrentTCB != pxCurrentTCB )
+		{
+			vPortSwitchFiber( ( void ** ) pvOldCurrentTCB, *( ( void ** ) pxCurrentTCB ) );
+		}
+
+		/* Return to task code, then loop to pick up any interrupt raised
+		during the switch. */
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		ulInterruptMask = portINTERRUPTS_UNMASKED;
+		ulActivePriority = portTASK_LEVEL_PRIORITY;
+		xInsideInterrupt = pdFALSE;
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	{
+		prvTakeRaisedInterrupts();
+	}
+	#endif
+
+	/* Interrupts that are masked, or that do not have a higher priority than
+	the code that was interrupted, remain pending until the mask is lowered
+	or the code returns. */
+	if( xPortRunning == pdTRUE )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+uint32_t ulLimit;
+
+	#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	{
+		/* The pending interrupts of an instance are local to the thread that
+		runs it, so any other thread hands the interrupt to the instance. */
+		if( pthread_equal( pthread_self(), xSimulatedCPUThread ) == 0 )
+		{
+			prvRaiseInKernelInstance( ulInterruptNumber );
+			return;
+		}
+	}
+	#endif
+
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		#if( configSIMULATOR_RECORD_REPLAY != 0 )
+		{
+			/* Interrupts raised by other host threads arrive at times that
+			cannot be repeated, so they wait for a delivery point. */
+			if( pthread_equal( pthread_self(), xSimulatedCPUThread ) == 0 )
+			{
+				prvStageInterrupt( ulInterruptNumber );
+				return;
+			}
+		}
+		#endif
+
+		prvPendInterrupt( ulInterruptNumber );
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			/* Wake the simulated CPU if it is sleeping in tickless idle. */
+			prvAbortTicklessIdle();
+		}
+		#endif
+
+		if( pthread_equal( pthread_self(), xSimulatedCPUThread ) != 0 )
+		{
+			#if( configSIMULATOR_RECORD_REPLAY != 0 )
+			{
+				/* A task raising an interrupt, normally to yield, with
+				interrupts unmasked is a delivery point. */
+				if( ( ulActivePriority == portTASK_LEVEL_PRIORITY ) && ( ulInterruptMask == portINTERRUPTS_UNMASKED ) )
+				{
+					prvDeliveryPoint();
+				}
+			}
+			#endif
+
+			/* Raised by a task or an interrupt handler.  Process the interrupt
+			immediately, just as hardware would, if it has a higher priority
+			than the code that raised it and is not masked - otherwise it will
+			be processed when the critical section or handler exits. */
+			ulLimit = ( ulInterruptMask < ulActivePriority ) ? ulInterruptMask : ulActivePriority;
+
+			if( ucInterruptPriority[ ulInterruptNumber ] < ulLimit )
+			{
+				prvProcessSimulatedInterrupts();
+			}
+		}
+		else
+		{
+			/* Raised by another host thread, such as the tick thread, so
+			interrupt the simulated CPU. */
+			pthread_kill( xSimulatedCPUThread, portINTERRUPT_SIGNAL );
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+
+static void *prvKernelInstanceThread( void *pvParameter )
+{
+	pxThisKernelInstance = ( KernelInstance_t * ) pvParameter;
+	pxThisKernelInstance->pxInstanceMain( pxThisKernelInstance->pvParameter );
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortCreateKernelInstance( void (*pxInstanceMain)( void * ), void *pvParameter, KernelInstanceHandle_t *pxInstance )
+{
+KernelInstance_t *pxNewInstance;
+sigset_t xSignals, xPreviousSignals;
+BaseType_t xReturn = pdFAIL;
+
+	pxNewInstance = ( KernelInstance_t * ) calloc( 1, sizeof( KernelInstance_t ) );
+
+	if( pxNewInstance != NULL )
+	{
+		pxNewInstance->pxInstanceMain = pxInstanceMain;
+		pxNewInstance->pvParameter = pvParameter;
+
+		/* The new thread starts with the interrupt signal blocked, so an
+		interrupt raised in the instance before its scheduler has started
+		stays pending until xPortStartScheduler() unblocks it. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portINTERRUPT_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+
+		if( pthread_create( &( pxNewInstance->xThread ), NULL, prvKernelInstanceThread, pxNewInstance ) == 0 )
+		{
+			*pxInstance = pxNewInstance;
+			xReturn = pdPASS;
+		}
+		else
+		{
+			free( pxNewInstance );
+		}
+
+		pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+	}
+
+	return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPortJoinKernelInstance( KernelInstanceHandle_t xInstance )
+{
+	pthread_join( xInstance->xThread, NULL );
+	free( xInstance );
+}
+/*-----------------------------------------------------------*/
+
+KernelInstanceHandle_t xPortGetKernelInstance( void )
+{
+	return pxThisKernelInstance;
+}
+/*-----------------------------------------------------------*/
+
+void vPortBindKernelInstance( KernelInstanceHandle_t xInstance )
+{
+	configASSERT( ( pxThisKernelInstance == NULL ) || ( pthread_equal( pxThisKernelInstance->xThread, pthread_self() ) == 0 ) );
+	pxThisKernelInstance = xInstance;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRaiseInKernelInstance( uint32_t ulInterruptNumber )
+{
+KernelInstance_t *pxInstance = pxThisKernelInstance;
+
+	configASSERT( pxInstance );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		__atomic_fetch_or( &( pxInstance->ulRaisedInterrupts[ ulInterruptNumber / 32UL ] ), 1UL << ( ulInterruptNumber % 32UL ), __ATOMIC_RELEASE );
+		pthread_kill( pxInstance->xThread, portINTERRUPT_SIGNAL );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvTakeRaisedInterrupts( void )
+{
+uint32_t ulWord, ulRaised;
+uint64_t ullTicksElapsed, ullTicksDelivered;
+
+	for( ulWord = 0UL; ulWord < portINTERRUPT_WORDS; ulWord++ )
+	{
+		ulRaised = __atomic_exchange_n( &( pxThisKernelInstance->ulRaisedInterrupts[ ulWord ] ), 0UL, __ATOMIC_ACQUIRE );
+
+		while( ulRaised != 0UL )
+		{
+			prvPendInterrupt( ( ulWord * 32UL ) + ( uint32_t ) __builtin_ctz( ulRaised ) );
+			ulRaised &= ulRaised - 1UL;
+		}
+	}
+
+	/* The timer signal is not queued while it is already pending, and this
+	handler is also run by the signals of other threads, so count the tick
+	periods that have really elapsed.  The handler can interrupt itself, so
+	the count is claimed with a compare and swap. */
+	if( ullTickTimerStart != 0ULL )
+	{
+		ullTicksElapsed = prvTimeToTick( prvGetMonotonicTime() - ullTickTimerStart );
+		ullTicksDelivered = __atomic_load_n( &ullTickTimerTicks, __ATOMIC_RELAXED );
+
+		while( ullTicksElapsed > ullTicksDelivered )
+		{
+			if( __atomic_compare_exchange_n( &ullTickTimerTicks, &ullTicksDelivered, ullTicksElapsed, pdFALSE, __ATOMIC_RELAXED, __ATOMIC_RELAXED ) != pdFALSE )
+			{
+				if( ( ullTicksElapsed - ullTicksDelivered ) > 1ULL )
+				{
+					__atomic_fetch_add( &ulMissedTicks, ( uint32_t ) ( ullTicksElapsed - ullTicksDelivered - 1ULL ), __ATOMIC_RELAXED );
+				}
+
+				__atomic_fetch_add( &ulTicksToProcess, ( uint32_t ) ( ullTicksElapsed - ullTicksDelivered ), __ATOMIC_RELAXED );
+				prvPendInterrupt( portINTERRUPT_TICK );
+				break;
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_KERNEL_INSTANCES */
+
+void vPortEnterCritical( void )
+{
+	/* (Simulated) interrupts are masked by ulInterruptMask alone, as the only
+	code that can interrupt a task runs on the same host thread.  As on a
+	Cortex-M, interrupts above configMAX_SYSCALL_INTERRUPT_PRIORITY are not
+	masked. */
+	if( ulInterruptMask > configMAX_SYSCALL_INTERRUPT_PRIORITY )
+	{
+		ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+	}
+
+	ulCriticalNesting++;
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		ulCriticalNesting--;
+
+		/* A critical section inside an interrupt handler leaves interrupts
+		masked until the handler returns, when the mask of the interrupted
+		code is restored. */
+		if( ( ulCriticalNesting == portNO_CRITICAL_NESTING ) && ( xInsideInterrupt == pdFALSE ) )
+		{
+			ulInterruptMask = portINTERRUPTS_UNMASKED;
+			__atomic_signal_fence( __ATOMIC_SEQ_CST );
+
+			#if( configSIMULATOR_RECORD_REPLAY != 0 )
+			{
+				if( xPortRunning == pdTRUE )
+				{
+					prvDeliveryPoint();
+				}
+			}
+			#endif
+
+			/* Were any interrupts set to pending while interrupts were
+			(simulated) disabled?  If so process them now. */
+			if( ( ulPendingPriorities != 0UL ) && ( xPortRunning == pdTRUE ) )
+			{
+				prvProcessSimulatedInterrupts();
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+UBaseType_t uxPreviousMask = ( UBaseType_t ) ulInterruptMask;
+
+	if( ulInterruptMask > configMAX_SYSCALL_INTERRUPT_PRIORITY )
+	{
+		ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+	}
+
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	return uxPreviousMask;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+	__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	ulInterruptMask = ( uint32_t ) uxMask;
+
+	#if( configSIMULATOR_RECORD_REPLAY != 0 )
+	{
+		/* A task unmasking interrupts is a delivery point. */
+		if( ( ulActivePriority == portTASK_LEVEL_PRIORITY ) && ( ulInterruptMask == portINTERRUPTS_UNMASKED ) && ( xPortRunning == pdTRUE ) )
+		{
+			prvDeliveryPoint();
+		}
+	}
+	#endif
+
+	/* Run any interrupt that was masked and can now interrupt the code that
+	lowered the mask. */
+	if( ( ulPendingPriorities != 0UL ) && ( xPortRunning == pdTRUE ) )
+	{
+		prvProcessSimulatedInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortValidateInterruptPriority( void )
+{
+	/* An interrupt that is not masked by critical sections must not call
+	the FreeRTOS API, which relies on critical sections for mutual exclusion.
+	Set the priority of such interrupts with vPortSetInterruptPriority(). */
+	configASSERT( ulActivePriority >= configMAX_SYSCALL_INTERRUPT_PRIORITY );
+}
+/*-----------------------------------------------------------*/
+
+#else /* configSIMULATOR_USE_FIBERS */
+
+static void prvWaitForYieldEvent( void )
+{
+HostThread_t *pxHostThread = pxHostThreadOfThisThread;
+sigset_t xSignals, xPreviousSignals;
+
+	/* The simulated interrupt handler can send the suspend signal as soon as
+	it has posted the event, before this thread has returned from sem_wait().
+	sem_wait() is not async-signal-safe, so the signal is blocked until the
+	wait is over rather than let the handler wait on the same event from
+	inside it - the handler then runs as soon as the signal is unblocked.  In
+	the handler itself the signal is already blocked. */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portSUSPEND_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+
+	/* sem_wait() can return early if the thread receives a signal. */
+	while( sem_wait( &( pxHostThread->xYieldEvent ) ) != 0 )
+	{
+		configASSERT( errno == EINTR );
+	}
+
+	/* vPortDeleteThread() posts the event to send the thread back to the pool
+	rather than to run.  The jump restores the signal mask saved by
+	getcontext(), so it can be made from the suspend signal handler. */
+	if( pxHostThread->xRecycle != pdFALSE )
+	{
+		prvRecycleThread( pxHostThread );
+	}
+
+	pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvSuspendSignalHandler( int iSignal )
+{
+ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	if( pxThreadState != NULL )
+	{
+		/* This thread is no longer executing task code, so the simulated
+		interrupt handler can resume a different thread. */
+		sem_post( &xSuspendAcknowledged );
+
+		/* Wait until this task is selected to run again. */
+		prvWaitForYieldEvent();
+	}
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThreadEntry( void *pvParameter )
+{
+HostThread_t *pxHostThread = ( HostThread_t * ) pvParameter;
+ThreadState_t *pxThreadState;
+BaseType_t xRecycleRequested;
+ucontext_t xTaskContext;
+sigset_t xSignals;
+
+	/* The suspend signal handler runs on the alternate signal stack, so the
+	frame of a task that is switched out asynchronously is not pushed onto
+	the task's stack. */
+	prvSetAlternateSignalStack();
+
+	/* The thread was created with portSUSPEND_SIGNAL blocked, as the signal
+	handler cannot do anything until it knows which thread it is running on.
+	Any suspend request that arrived in the meantime is delivered when the
+	signal is unblocked. */
+	pxHostThreadOfThisThread = pxHostThread;
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portSUSPEND_SIGNAL );
+	pthread_sigmask( SIG_UNBLOCK, &xSignals, NULL );
+
+	/* The thread comes back here, on its own stack, each time the task it
+	runs is deleted, with the signal mask restored to the one saved here. */
+	pxHostThread->xRecycling = pdFALSE;
+	getcontext( &( pxHostThread->xRecycleContext ) );
+
+	if( pxHostThread->xRecycling != pdFALSE )
+	{
+		pxHostThread->xRecycling = pdFALSE;
+		xRecycleRequested = pxHostThread->xRecycle;
+		pxHostThread->xRecycle = pdFALSE;
+
+		pxHostThread->pxThreadState = NULL;
+
+		/* If the task was resumed and switched out again before the thread
+		got as far as waiting for the resume, the suspend signal handler
+		took the resume and the wait the thread was about to make was
+		abandoned by the jump, so the recycle request is left in the event.
+		Nothing posts the event of a thread that has no task, so discard it
+		rather than let the next task on this thread start early. */
+		while( sem_trywait( &( pxHostThread->xYieldEvent ) ) == 0 )
+		{
+			/* Discard. */
+		}
+
+		/* The thread goes back in the pool before a task that deleted itself
+		leaves its critical section below.  Otherwise the task that runs next
+		could create a task, find the pool empty and grow it, while this
+		thread was about to return to the pool. */
+		pthread_mutex_lock( &xHostThreadPoolMutex );
+		pxHostThread->pxNext = pxHostThreadPool;
+		pxHostThreadPool = pxHostThread;
+		pthread_mutex_unlock( &xHostThreadPoolMutex );
+
+		if( xRecycleRequested != pdFALSE )
+		{
+			/* The task is no longer running, so the thread is not in a
+			critical section whatever the task was doing when it was
+			deleted. */
+			ulCriticalNesting = portNO_CRITICAL_NESTING;
+
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				ulTaskLockNesting = 0UL;
+			}
+			#endif
+
+			/* vPortDeleteThread() waits for the thread of a task it deleted
+			to be back in the pool. */
+			sem_post( &xRecycleAcknowledged );
+		}
+		else
+		{
+			/* The task deleted itself, and vPortCloseRunningThread() left
+			the critical section vTaskDelete() called it from for this
+			thread to exit.  The task's stack can be freed as soon as the
+			critical section is exited, so it is only exited now that the
+			thread is no longer on that stack. */
+			while( ulCriticalNesting > portNO_CRITICAL_NESTING )
+			{
+				ulCriticalNesting--;
+				prvUnlockInterrupts();
+			}
+
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				/* The task lock is released last, which pends the switch
+				again if the simulated interrupt handler could not make it
+				while the lock was held. */
+				while( ulTaskLockNesting > 0UL )
+				{
+					vPortReleaseTaskLock();
+				}
+			}
+			#endif
+		}
+	}
+
+	/* The equivalent of the Windows port creating the thread suspended - wait
+	until a task has been given to the thread and selected to run for the
+	first time.  The wait does not return if the task is deleted first. */
+	prvWaitForYieldEvent();
+
+	/* Switch to the task's own stack, below the ThreadState_t at its top, and
+	call the task function from there. */
+	pxThreadState = pxHostThread->pxThreadState;
+	getcontext( &xTaskContext );
+	xTaskContext.uc_link = NULL;
+	xTaskContext.uc_stack.ss_sp = pxThreadState->pxEndOfStack;
+	xTaskContext.uc_stack.ss_size = ( size_t ) ( ( uint8_t * ) pxThreadState - ( uint8_t * ) pxThreadState->pxEndOfStack );
+	makecontext( &xTaskContext, prvTaskStackEntry, 0 );
+	setcontext( &xTaskContext );
+
+	/* Should not get here - the thread leaves the task's stack by jumping
+	back to the recycle context. */
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskStackEntry( void )
+{
+ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+
+	pxThreadState->pxCode( pxThreadState->pvParameters );
+
+	/* Tasks must not return from their implementing function, but if one does
+	then delete it rather than leave a task with no thread behind.  This does
+	not return - the thread goes back to the pool. */
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecycleThread( HostThread_t *pxHostThread )
+{
+	pxHostThread->xRecycling = pdTRUE;
+	setcontext( &( pxHostThread->xRecycleContext ) );
+}
+/*-----------------------------------------------------------*/
+
+static HostThread_t *prvCreateHostThread( void )
+{
+HostThread_t *pxHostThread;
+pthread_attr_t xThreadAttributes;
+sigset_t xSignals, xPreviousSignals;
+int iResult;
+
+	pxHostThread = ( HostThread_t * ) malloc( sizeof( HostThread_t ) );
+	configASSERT( pxHostThread );
+
+	pxHostThread->pxThreadState = NULL;
+	pxHostThread->xRecycle = pdFALSE;
+	pxHostThread->pxNext = NULL;
+	iResult = sem_init( &( pxHostThread->xYieldEvent ), 0, 0 );
+	configASSERT( iResult == 0 );
+
+	/* The new thread inherits the signal mask of the calling thread, so block
+	portSUSPEND_SIGNAL until the new thread is ready to handle it - see
+	prvTaskThreadEntry(). */
+	sigemptyset( &xSignals );
+	sigaddset( &xSignals, portSUSPEND_SIGNAL );
+	pthread_sigmask( SIG_BLOCK, &xSignals, &xPreviousSignals );
+
+	/* Create the thread itself.  It waits on its yield event straight away,
+	so it can be given a task before it has even started. */
+	pthread_attr_init( &xThreadAttributes );
+	iResult = pthread_create( &( pxHostThread->xThread ), &xThreadAttributes, prvTaskThreadEntry, pxHostThread );
+	configASSERT( iResult == 0 );
+	pthread_attr_destroy( &xThreadAttributes );
+
+	pthread_sigmask( SIG_SETMASK, &xPreviousSignals, NULL );
+
+	( void ) iResult;
+
+	ulHostThreadsCreated++;
+
+	return pxHostThread;
+}
+/*-----------------------------------------------------------*/
+
+static HostThread_t *prvTakeHostThread( void )
+{
+HostThread_t *pxHostThread;
+int iResult;
+
+	pthread_mutex_lock( &xHostThreadPoolMutex );
+
+	/* Create the pool the first time a task is created.  These threads start
+	outside the pool, as they have not yet run a task, so put them in it. */
+	if( ulHostThreadsCreated == 0UL )
+	{
+		iResult = sem_init( &xRecycleAcknowledged, 0, 0 );
+		configASSERT( iResult == 0 );
+		( void ) iResult;
+
+		#if( configSIMULATOR_THREAD_POOL_SIZE > 0 )
+		{
+			uint32_t ulThread;
+
+			for( ulThread = 0UL; ulThread < configSIMULATOR_THREAD_POOL_SIZE; ulThread++ )
+			{
+				pxHostThread = prvCreateHostThread();
+				pxHostThread->pxNext = pxHostThreadPool;
+				pxHostThreadPool = pxHostThread;
+			}
+		}
+		#endif
+	}
+
+	pxHostThread = pxHostThreadPool;
+
+	if( pxHostThread != NULL )
+	{
+		pxHostThreadPool = pxHostThread->pxNext;
+	}
+	else
+	{
+		/* More tasks exist than there have ever been threads, so the pool
+		grows by one. */
+		pxHostThread = prvCreateHostThread();
+	}
+
+	pthread_mutex_unlock( &xHostThreadPoolMutex );
+
+	return pxHostThread;
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, StackType_t *pxEndOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+ThreadState_t *pxThreadState = NULL;
+int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
+
+	/* In this simulated case a stack is not initialised, but instead a host
+	thread is given the task to execute.  The thread handles the context
+	switching itself.  The ThreadState_t object is placed at the top of the
+	stack that was created for the task, and the thread executes the task on
+	the rest of the stack - see prvTaskThreadEntry(). */
+	pxThreadState = ( ThreadState_t * ) ( pcTopOfStack - sizeof( ThreadState_t ) );
+	pxThreadState->pxEndOfStack = pxEndOfStack;
+	pxThreadState->pxCode = pxCode;
+	pxThreadState->pvParameters = pvParameters;
+	pxThreadState->xThreadValid = pdTRUE;
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		pxThreadState->xCoreID = 0;
+	}
+	#endif
+
+	/* The thread is parked on its yield event, so the simulated interrupt
+	handler must post the event the first time the task is selected. */
+	pxThreadState->xWaiting = pdTRUE;
+
+	/* Give the task to a parked thread.  The thread reads the task from
+	pxThreadState after the event is posted.  A task that creates a task must
+	not be switched out while it holds xHostThreadPoolMutex, as the thread
+	would then hold it until the task runs again. */
+	portENTER_CRITICAL();
+	{
+		pxThreadState->pxHostThread = prvTakeHostThread();
+		pxThreadState->pxHostThread->pxThreadState = pxThreadState;
+	}
+	portEXIT_CRITICAL();
+
+	return ( StackType_t * ) pxThreadState;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetHostThreadCount( void )
+{
+	return ulHostThreadsCreated;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+pthread_mutexattr_t xMutexAttributes;
+struct sigaction xSuspendAction, xInterruptAction;
+sigset_t xSignals;
+int32_t lSuccess = pdPASS;
+
+	/* Install the interrupt handlers used by the scheduler itself. */
+	vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
+	vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
+
+	/* Create the mutex and semaphores that are used to synchronise all the
+	threads.  The mutex is recursive as, like a Windows mutex, it is
+	obtained again each time a critical section is nested. */
+	#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 0 )
+	{
+		pthread_mutexattr_init( &xMutexAttributes );
+		pthread_mutexattr_settype( &xMutexAttributes, PTHREAD_MUTEX_RECURSIVE );
+		if( pthread_mutex_init( &xInterruptEventMutex, &xMutexAttributes ) != 0 )
+		{
+			lSuccess = pdFAIL;
+		}
+		pthread_mutexattr_destroy( &xMutexAttributes );
+	}
+	#else
+	{
+		( void ) xMutexAttributes;
+	}
+	#endif
+
+	if( ( sem_init( &xInterruptEvent, 0, 0 ) != 0 ) || ( sem_init( &xSuspendAcknowledged, 0, 0 ) != 0 ) )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	/* Install the handler that switches task threads out.  It runs on the
+	alternate signal stack, so switching a task out does not use its stack. */
+	sigemptyset( &( xSuspendAction.sa_mask ) );
+	xSuspendAction.sa_flags = SA_RESTART | SA_ONSTACK;
+	xSuspendAction.sa_handler = prvSuspendSignalHandler;
+	if( sigaction( portSUSPEND_SIGNAL, &xSuspendAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	/* Install the handler that lets a higher priority interrupt interrupt
+	this thread, which becomes the simulated interrupt handler.  SA_NODEFER
+	allows the handler to be interrupted in turn.  Until this thread holds the
+	mutex it cannot run the interrupts that critical sections mask. */
+	xSimulatedInterruptThread = pthread_self();
+	ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+	sigemptyset( &( xInterruptAction.sa_mask ) );
+	xInterruptAction.sa_flags = SA_RESTART | SA_NODEFER;
+	xInterruptAction.sa_handler = prvInterruptSignalHandler;
+	if( sigaction( portINTERRUPT_SIGNAL, &xInterruptAction, NULL ) != 0 )
+	{
+		lSuccess = pdFAIL;
+	}
+
+	#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+	{
+		if( prvInstallStackGuardHandler() != pdPASS )
+		{
+			lSuccess = pdFAIL;
+		}
+	}
+	#endif
+
+	if( lSuccess == pdPASS )
+	{
+		/* The tick thread and this thread, which becomes the simulated
+		interrupt handler, never execute task code so never need to be
+		suspended. */
+		sigemptyset( &xSignals );
+		sigaddset( &xSignals, portSUSPEND_SIGNAL );
+		pthread_sigmask( SIG_BLOCK, &xSignals, NULL );
+
+		/* Start the thread that simulates the timer peripheral to generate
+		tick interrupts.  The interrupt lock is used for the
+		handshake / overrun protection. */
+		if( prvStartSimulatedPeripheralTimer() != pdPASS )
+		{
+			lSuccess = pdFAIL;
+		}
+	}
+
+	if( lSuccess == pdPASS )
+	{
+		ulCriticalNesting = portNO_CRITICAL_NESTING;
+
+		/* Handle all simulated interrupts - including yield requests and
+		simulated ticks.  The first task is started by the first interrupt
+		that is processed. */
+		prvProcessSimulatedInterrupts();
+	}
+
+	/* Would not expect to return from prvProcessSimulatedInterrupts(), so should
+	not get here. */
+	return 0;
+}
+/*-----------------------------------------------------------*/
+static void prvSwitchOutThread( void *pvOldCurrentTCB )
+{
+ThreadState_t *pxThreadState;
+BaseType_t xNotWaiting = pdFALSE;
+
+	/* If the old task blocked or yielded then its thread has already marked
+	itself as waiting on its yield event and there is nothing to do.
+	Otherwise the task was switched out asynchronously (by a tick for
+	example), so mark it as waiting, send it the suspend signal and wait for it
+	to acknowledge that it is no longer executing task code - unlike
+	SuspendThread() pthread_kill() is always asynchronous. */
+	pxThreadState = ( ThreadState_t * ) *( ( size_t * ) pvOldCurrentTCB );
+
+	if( ( pxThreadState->xThreadValid != pdFALSE ) &&
+		( __atomic_compare_exchange_n( &( pxThreadState->xWaiting ), &xNotWaiting, pdTRUE, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) != pdFALSE ) )
+	{
+		pthread_kill( pxThreadState->pxHostThread->xThread, portSUSPEND_SIGNAL );
+
+		while( sem_wait( &xSuspendAcknowledged ) != 0 )
+		{
+			/* Interrupted, wait again. */
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	static void prvSwitchCores( void )
+	{
+	uint32_t ulCores;
+	BaseType_t xCoreID, xLocked;
+	void *pvOldCurrentTCB;
+	ThreadState_t *pxThreadState;
+
+		ulCores = __atomic_exchange_n( &ulYieldRequestCores, 0UL, __ATOMIC_SEQ_CST );
+		xLocked = prvTryLockTasks();
+
+		if( xLocked == pdFALSE )
+		{
+			/* A task holds the task lock, so the switches are left for the
+			task to pend again when it releases the lock.  It may have released
+			the lock before it could see them, so try once more. */
+			__atomic_fetch_or( &ulYieldRequestCores, ulCores, __ATOMIC_SEQ_CST );
+			xLocked = prvTryLockTasks();
+
+			if( xLocked != pdFALSE )
+			{
+				ulCores = __atomic_exchange_n( &ulYieldRequestCores, 0UL, __ATOMIC_SEQ_CST );
+			}
+		}
+
+		if( xLocked != pdFALSE )
+		{
+			for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+			{
+				if( ( ulCores & ( 1UL << xCoreID ) ) != 0UL )
+				{
+					/* The kernel selects the task for the core this thread
+					is acting for. */
+					xInterruptCoreID = xCoreID;
+					pvOldCurrentTCB = pxCurrentTCBs[ xCoreID ];
+					vTaskSwitchContext( xCoreID );
+
+					/* The old thread is stopped before the next core is
+					switched, as the task may be selected to run on it. */
+					if( pvOldCurrentTCB != pxCurrentTCBs[ xCoreID ] )
+					{
+						prvSwitchOutThread( pvOldCurrentTCB );
+					}
+
+					pxThreadState = ( ThreadState_t * ) *( ( size_t * ) pxCurrentTCBs[ xCoreID ] );
+					pxThreadState->xCoreID = xCoreID;
+				}
+			}
+
+			xInterruptCoreID = 0;
+			prvUnlockTasks();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_CORES */
+
+static void prvProcessSimulatedInterrupts( void )
+{
+#if( configNUMBER_OF_CORES == 1 )
+	ThreadState_t *pxThreadState;
+	BaseType_t xWaiting;
+	void *pvOldCurrentTCB;
+#else
+	ThreadState_t *pxThreadStates[ configNUMBER_OF_CORES ];
+	BaseType_t xWaiting[ configNUMBER_OF_CORES ], xCoreID;
+	uint32_t ulDeferredCores;
+#endif
+
+	/* Create a pending yield to ensure the first task is started as soon as
+	this thread checks for interrupts. */
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* Every core starts its first task. */
+		ulYieldRequestCores = ( uint32_t ) ( ( 1ULL << configNUMBER_OF_CORES ) - 1ULL );
+	}
+	#endif
+	prvPendInterrupt( portINTERRUPT_YIELD );
+
+	xPortRunning = pdTRUE;
+
+	for(;;)
+	{
+		/* Wait for an interrupt to be raised.  xInterruptEvent is posted each
+		time an interrupt is raised, but this thread takes every interrupt that
+		is pending each time it wakes, so it can wake to find nothing to do. */
+		if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) == 0UL )
+		{
+			while( sem_wait( &xInterruptEvent ) != 0 )
+			{
+				/* Interrupted, wait again. */
+			}
+		}
+
+		/* Interrupts are pended without holding the lock, but the interrupts
+		that critical sections mask cannot be processed while a task is in a
+		critical section.  Tasks that exit a critical section will block on a
+		yield event to wait for an interrupt to process if an interrupt was set
+		pending while the task was inside the critical section. */
+		prvLockInterrupts();
+		xInsideInterrupt = pdTRUE;
+		ulInterruptMask = portINTERRUPTS_UNMASKED;
+
+		for( ;; )
+		{
+			/* Process the pending interrupts, highest priority first.
+			Interrupts raised while they are being processed are taken too. */
+			prvRunPendingInterrupts();
+
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				/* The handlers ran as the interrupts of core 0, so a switch
+				they request is a switch of core 0. */
+				if( xSwitchRequired != pdFALSE )
+				{
+					xSwitchRequired = pdFALSE;
+					__atomic_fetch_or( &ulYieldRequestCores, 1UL, __ATOMIC_SEQ_CST );
+				}
+
+				if( __atomic_load_n( &ulYieldRequestCores, __ATOMIC_SEQ_CST ) != 0UL )
+				{
+					/* As below, the switches run at the kernel interrupt
+					priority. */
+					__atomic_store_n( &ulActivePriority, configKERNEL_INTERRUPT_PRIORITY, __ATOMIC_SEQ_CST );
+					ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+					prvSwitchCores();
+
+					ulInterruptMask = portINTERRUPTS_UNMASKED;
+					__atomic_store_n( &ulActivePriority, portTASK_LEVEL_PRIORITY, __ATOMIC_SEQ_CST );
+				}
+
+				/* See the single core case below - the task that is about to
+				run on each core is checked. */
+				for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+				{
+					pxThreadStates[ xCoreID ] = ( ThreadState_t * ) ( *( size_t * ) pxCurrentTCBs[ xCoreID ] );
+					xWaiting[ xCoreID ] = __atomic_load_n( &( pxThreadStates[ xCoreID ]->xWaiting ), __ATOMIC_SEQ_CST );
+				}
+			}
+			#else
+			{
+				if( xSwitchRequired != pdFALSE )
+				{
+					/* The context switch runs at the kernel interrupt priority
+					with the interrupts that can use the FreeRTOS API masked, as
+					PendSV does on a Cortex-M. */
+					__atomic_store_n( &ulActivePriority, configKERNEL_INTERRUPT_PRIORITY, __ATOMIC_SEQ_CST );
+					ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+					xSwitchRequired = pdFALSE;
+
+					pvOldCurrentTCB = pxCurrentTCB;
+
+					/* Select the next task to run. */
+					vTaskSwitchContext();
+
+					/* If the task selected to enter the running state is not
+					the task that is already in the running state. */
+					if( pvOldCurrentTCB != pxCurrentTCB )
+					{
+						prvSwitchOutThread( pvOldCurrentTCB );
+					}
+
+					ulInterruptMask = portINTERRUPTS_UNMASKED;
+					__atomic_store_n( &ulActivePriority, portTASK_LEVEL_PRIORITY, __ATOMIC_SEQ_CST );
+				}
+
+				/* A task that yields pends the interrupt before marking itself
+				as waiting, so if the task that is about to run is waiting then
+				the interrupt it raised has either been processed already or is
+				pending now.  Check again so the task cannot continue past its
+				yield point before the yield has been processed. */
+				pxThreadState = ( ThreadState_t * ) ( *( size_t *) pxCurrentTCB );
+				xWaiting = __atomic_load_n( &( pxThreadState->xWaiting ), __ATOMIC_SEQ_CST );
+			}
+			#endif /* configNUMBER_OF_CORES */
+
+			/* Mask the interrupts that critical sections mask before checking
+			there is nothing left to do, as they cannot run once the lock is
+			released - from here on only the interrupts above
+			configMAX_SYSCALL_INTERRUPT_PRIORITY can interrupt this thread. */
+			ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+
+			if( ( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) == 0UL ) && ( xSwitchRequired == pdFALSE ) )
+			{
+				break;
+			}
+
+			ulInterruptMask = portINTERRUPTS_UNMASKED;
+		}
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The task of a core whose switch could not be made yet must not
+			run past its yield point, so it is left waiting until the switch
+			is made. */
+			ulDeferredCores = __atomic_load_n( &ulYieldRequestCores, __ATOMIC_SEQ_CST );
+
+			for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+			{
+				if( ( xWaiting[ xCoreID ] != pdFALSE ) && ( ( ulDeferredCores & ( 1UL << xCoreID ) ) == 0UL ) )
+				{
+					configASSERT( pxThreadStates[ xCoreID ]->xThreadValid != pdFALSE );
+					__atomic_store_n( &( pxThreadStates[ xCoreID ]->xWaiting ), pdFALSE, __ATOMIC_SEQ_CST );
+					sem_post( &( pxThreadStates[ xCoreID ]->pxHostThread->xYieldEvent ) );
+				}
+			}
+		}
+		#else
+		{
+			/* A deleted task should never be resumed here. */
+			configASSERT( pxThreadState->xThreadValid != pdFALSE );
+
+			/* If the thread that is about to run stopped running because it
+			yielded, blocked or was switched out then it is waiting on its
+			yield event - post the event to let it continue now that it is
+			valid for it to do so. */
+			if( xWaiting != pdFALSE )
+			{
+				__atomic_store_n( &( pxThreadState->xWaiting ), pdFALSE, __ATOMIC_SEQ_CST );
+				sem_post( &( pxThreadState->pxHostThread->xYieldEvent ) );
+			}
+		}
+		#endif /* configNUMBER_OF_CORES */
+
+		xInsideInterrupt = pdFALSE;
+		prvUnlockInterrupts();
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvInterruptSignalHandler( int iSignal )
+{
+int iSavedErrno = errno;
+
+	( void ) iSignal;
+
+	/* The signal can arrive while this thread is running a lower priority
+	handler, waiting for the lock or waiting for an interrupt to be raised.
+	prvRunPendingInterrupts() only runs the interrupts that can interrupt the
+	code this thread was executing, and any context switch they request is
+	performed by prvProcessSimulatedInterrupts(). */
+	prvRunPendingInterrupts();
+
+	errno = iSavedErrno;
+}
+/*-----------------------------------------------------------*/
+
+void vPortDeleteThread( void *pvTaskToDelete )
+{
+ThreadState_t *pxThreadState;
+
+	/* Find the state of the thread being deleted. */
+	pxThreadState = ( ThreadState_t * ) ( *( size_t *) pvTaskToDelete );
+
+	/* Check that the thread is still valid, it might have been returned to the
+	pool by vPortCloseRunningThread() - which will be the case if the task
+	associated with the thread originally deleted itself rather than being
+	deleted by a different task. */
+	if( pxThreadState->xThreadValid != pdFALSE )
+	{
+		if( xPortRunning == pdTRUE )
+		{
+			prvLockInterrupts();
+		}
+
+		/* The task is not the running task, so its thread is waiting on its
+		yield event - either because the task has not started yet, or from
+		the task's last yield point or the suspend signal handler.  Rather than
+		terminate it, post the event with xRecycle set, which sends the thread
+		back to the pool from wherever it is waiting, and wait for it to get
+		there.  The thread does nothing but put itself in the pool, so this
+		cannot block for long. */
+		pxThreadState->xThreadValid = pdFALSE;
+		pxThreadState->pxHostThread->xRecycle = pdTRUE;
+		sem_post( &( pxThreadState->pxHostThread->xYieldEvent ) );
+
+		while( sem_wait( &xRecycleAcknowledged ) != 0 )
+		{
+			/* Interrupted, wait again. */
+		}
+
+		if( xPortRunning == pdTRUE )
+		{
+			prvUnlockInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
+{
+ThreadState_t *pxThreadState;
+
+	/* Find the state of the thread being deleted. */
+	pxThreadState = ( ThreadState_t * ) ( *( size_t *) pvTaskToDelete );
+
+	/* This function will not return, therefore a yield is set as pending to
+	ensure a context switch occurs away from this thread. */
+	*pxPendYield = pdTRUE;
+
+	/* Mark the thread associated with this task as invalid so
+	vPortDeleteThread() does not try to recycle it again, and the simulated
+	interrupt handler does not try to suspend it. */
+	pxThreadState->xThreadValid = pdFALSE;
+
+	/* This is called from a critical section, which must be exited before the
+	thread goes back to the pool.  The thread leaves the task's stack first,
+	and prvTaskThreadEntry() exits the critical section directly, rather than
+	using taskEXIT_CRITICAL(), as this thread must not wait on its yield
+	event.  A yield interrupt is pended so the scheduler switches away from
+	the deleted task as soon as the critical section is exited instead of at
+	the next tick. */
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		__atomic_fetch_or( &ulYieldRequestCores, ( 1UL << pxThreadState->xCoreID ), __ATOMIC_SEQ_CST );
+	}
+	#endif
+
+	prvPendInterrupt( portINTERRUPT_YIELD );
+	sem_post( &xInterruptEvent );
+
+	prvRecycleThread( pxHostThreadOfThisThread );
+}
+/*-----------------------------------------------------------*/
+
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
+{
+ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+BaseType_t xNotWaiting = pdFALSE;
+uint32_t ulPriority, ulActive;
+
+	configASSERT( xPortRunning );
+
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			if( pxThreadState != NULL )
+			{
+				if( ulInterruptNumber == portINTERRUPT_YIELD )
+				{
+					/* The yield is for the core the task is running on, which
+					is marked before the interrupt is pended so the simulated
+					interrupt handler finds it. */
+					__atomic_fetch_or( &ulYieldRequestCores, ( 1UL << pxThreadState->xCoreID ), __ATOMIC_SEQ_CST );
+				}
+
+				if( ( ulInterruptNumber != portINTERRUPT_YIELD ) || ( ulTaskLockNesting != 0UL ) )
+				{
+					/* Other interrupts are taken by core 0 while the calling
+					task carries on, as on a multi-core target, and a task
+					that holds the task lock cannot be switched out until it
+					releases it - so in both cases the task does not wait. */
+					pxThreadState = NULL;
+				}
+			}
+		}
+		#endif
+
+		/* Pend the interrupt.  This does not need the interrupt lock, which
+		is only held while (simulated) interrupts are disabled - the
+		simulated interrupt handler does not process the interrupt until any
+		critical section that is in progress has been exited. */
+		prvPendInterrupt( ulInterruptNumber );
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			/* Wake the simulated CPU if it is sleeping in tickless idle. */
+			prvAbortTicklessIdle();
+		}
+		#endif
+
+		/* An interrupt that critical sections do not mask, or that has a
+		higher priority than the handler the simulated interrupt thread is
+		running, must interrupt that thread rather than wait for it.
+		ulActivePriority is read after the interrupt is pended, and the thread
+		checks for higher priority interrupts after it updates
+		ulActivePriority, so one side or the other always sees the
+		interrupt. */
+		ulPriority = ucInterruptPriority[ ulInterruptNumber ];
+		ulActive = __atomic_load_n( &ulActivePriority, __ATOMIC_SEQ_CST );
+
+		if( ( ulPriority < configMAX_SYSCALL_INTERRUPT_PRIORITY ) || ( ( ulActive != portTASK_LEVEL_PRIORITY ) && ( ulPriority < ulActive ) ) )
+		{
+			pthread_kill( xSimulatedInterruptThread, portINTERRUPT_SIGNAL );
+		}
+
+		/* The simulated interrupt is now held pending, but don't actually
+		process it yet if this call is within a critical section.  It is
+		possible for this to be in a critical section as calls to wait for
+		mutexes are accumulative.  If in a critical section then the event
+		will get posted when the critical section nesting count is wound back
+		down to zero. */
+		if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+		{
+			if( pxThreadState == NULL )
+			{
+				/* Threads that do not run tasks just pend the interrupt. */
+				sem_post( &xInterruptEvent );
+			}
+			else if( __atomic_compare_exchange_n( &( pxThreadState->xWaiting ), &xNotWaiting, pdTRUE, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) != pdFALSE )
+			{
+				/* An interrupt was pended so block to allow it to execute.
+				The wait only completes when the simulated interrupt handler
+				has selected this task to run again. */
+				sem_post( &xInterruptEvent );
+				prvWaitForYieldEvent();
+			}
+			else
+			{
+				/* The simulated interrupt handler has already switched this
+				task out asynchronously and is about to send it the suspend
+				signal, the handler of which waits for the yield event instead.
+				Don't run past the yield point in the meantime. */
+				while( __atomic_load_n( &( pxThreadState->xWaiting ), __ATOMIC_SEQ_CST ) != pdFALSE )
+				{
+					sched_yield();
+				}
+			}
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) )
+{
+	if( ulInterruptNumber < portMAX_INTERRUPTS )
+	{
+		if( xPortRunning == pdTRUE )
+		{
+			prvLockInterrupts();
+			ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+			prvUnlockInterrupts();
+		}
+		else
+		{
+			ulIsrHandler[ ulInterruptNumber ] = pvHandler;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+
+	static void prvTakeLock( InterruptLock_t *pxLock )
+	{
+	pthread_t xThisThread = pthread_self();
+	uint32_t ulExpected = portLOCK_FREE, ulSpins;
+
+		/* Only the thread that holds the lock can find its own identifier in
+		xOwner. */
+		if( pthread_equal( __atomic_load_n( &( pxLock->xOwner ), __ATOMIC_RELAXED ), xThisThread ) != 0 )
+		{
+			pxLock->ulRecursion++;
+		}
+		else
+		{
+			if( __atomic_compare_exchange_n( &( pxLock->ulState ), &ulExpected, portLOCK_HELD, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) == pdFALSE )
+			{
+				for( ulSpins = 0UL; ulSpins < portLOCK_SPIN_COUNT; ulSpins++ )
+				{
+					portSPIN_WAIT_HINT();
+					ulExpected = portLOCK_FREE;
+
+					if( ( __atomic_load_n( &( pxLock->ulState ), __ATOMIC_RELAXED ) == portLOCK_FREE ) &&
+						( __atomic_compare_exchange_n( &( pxLock->ulState ), &ulExpected, portLOCK_HELD, pdFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) != pdFALSE ) )
+					{
+						break;
+					}
+				}
+
+				if( ulSpins == portLOCK_SPIN_COUNT )
+				{
+					/* Still held, so park.  Marking the lock as contended tells
+					the thread that releases it to wake a parked thread.  A
+					thread woken from here does not know whether other threads
+					are still parked, so it takes the lock as contended too. */
+					while( __atomic_exchange_n( &( pxLock->ulState ), portLOCK_CONTENDED, __ATOMIC_ACQUIRE ) != portLOCK_FREE )
+					{
+						syscall( SYS_futex, &( pxLock->ulState ), FUTEX_WAIT_PRIVATE, portLOCK_CONTENDED, NULL, NULL, 0 );
+					}
+				}
+			}
+
+			__atomic_store_n( &( pxLock->xOwner ), xThisThread, __ATOMIC_RELAXED );
+			pxLock->ulRecursion = 1UL;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvGiveLock( InterruptLock_t *pxLock )
+	{
+		configASSERT( pthread_equal( pxLock->xOwner, pthread_self() ) != 0 );
+
+		pxLock->ulRecursion--;
+
+		if( pxLock->ulRecursion == 0UL )
+		{
+			__atomic_store_n( &( pxLock->xOwner ), ( pthread_t ) 0, __ATOMIC_RELAXED );
+
+			if( __atomic_exchange_n( &( pxLock->ulState ), portLOCK_FREE, __ATOMIC_RELEASE ) == portLOCK_CONTENDED )
+			{
+				syscall( SYS_futex, &( pxLock->ulState ), FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0 );
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS */
+
+static void prvLockInterrupts( void )
+{
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+	prvTakeLock( &xInterruptLock );
+#else
+	pthread_mutex_lock( &xInterruptEventMutex );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlockInterrupts( void )
+{
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+	prvGiveLock( &xInterruptLock );
+#else
+	pthread_mutex_unlock( &xInterruptEventMutex );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	static BaseType_t prvTryLockTasks( void )
+	{
+	BaseType_t xReturn;
+
+		#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+		{
+		uint32_t ulExpected = portLOCK_FREE;
+
+			xReturn = __atomic_compare_exchange_n( &( xTaskLock.ulState ), &ulExpected, portLOCK_HELD, pdFALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) ? pdTRUE : pdFALSE;
+
+			if( xReturn != pdFALSE )
+			{
+				__atomic_store_n( &( xTaskLock.xOwner ), pthread_self(), __ATOMIC_RELAXED );
+				xTaskLock.ulRecursion = 1UL;
+			}
+		}
+		#else
+		{
+			xReturn = ( pthread_mutex_trylock( &xTaskLockMutex ) == 0 ) ? pdTRUE : pdFALSE;
+		}
+		#endif
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvUnlockTasks( void )
+	{
+		#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+		{
+			prvGiveLock( &xTaskLock );
+		}
+		#else
+		{
+			pthread_mutex_unlock( &xTaskLockMutex );
+		}
+		#endif
+
+		/* The simulated interrupt handler looks at the requests after it
+		fails to take the lock, so either it takes the lock or the thread that
+		released it sees the requests it left behind. */
+		__atomic_thread_fence( __ATOMIC_SEQ_CST );
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetTaskLock( void )
+	{
+		/* Only tasks take the lock.  The simulated interrupt thread is held
+		off by the interrupt lock instead, as an interrupt is on a real
+		multi-core target. */
+		if( ( xPortRunning == pdTRUE ) && ( pxHostThreadOfThisThread != NULL ) )
+		{
+			if( ulTaskLockNesting == 0UL )
+			{
+				#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+				{
+					prvTakeLock( &xTaskLock );
+				}
+				#else
+				{
+					pthread_mutex_lock( &xTaskLockMutex );
+				}
+				#endif
+			}
+
+			ulTaskLockNesting++;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseTaskLock( void )
+	{
+		if( ( xPortRunning == pdTRUE ) && ( pxHostThreadOfThisThread != NULL ) )
+		{
+			configASSERT( ulTaskLockNesting > 0UL );
+			ulTaskLockNesting--;
+
+			if( ulTaskLockNesting == 0UL )
+			{
+				prvUnlockTasks();
+
+				/* Switches the simulated interrupt handler could not make
+				while the lock was held are made now. */
+				if( __atomic_load_n( &ulYieldRequestCores, __ATOMIC_SEQ_CST ) != 0UL )
+				{
+					prvPendInterrupt( portINTERRUPT_YIELD );
+					sem_post( &xInterruptEvent );
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xPortGetCoreID( void )
+	{
+	ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+	BaseType_t xReturn = 0;
+
+		if( pxThreadState != NULL )
+		{
+			xReturn = pxThreadState->xCoreID;
+		}
+		else if( pthread_equal( pthread_self(), xSimulatedInterruptThread ) != 0 )
+		{
+			xReturn = xInterruptCoreID;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortYieldCore( BaseType_t xCoreID )
+	{
+		configASSERT( ( xCoreID >= 0 ) && ( xCoreID < configNUMBER_OF_CORES ) );
+
+		/* The core's task is switched out asynchronously, as by an inter
+		processor interrupt, so the caller does not wait. */
+		__atomic_fetch_or( &ulYieldRequestCores, ( 1UL << xCoreID ), __ATOMIC_SEQ_CST );
+		prvPendInterrupt( portINTERRUPT_YIELD );
+
+		if( pthread_equal( pthread_self(), xSimulatedInterruptThread ) == 0 )
+		{
+			sem_post( &xInterruptEvent );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortRaiseInterruptMask( void )
+	{
+	UBaseType_t uxPreviousMask;
+
+		if( pthread_equal( pthread_self(), xSimulatedInterruptThread ) != 0 )
+		{
+			uxPreviousMask = uxPortSetInterruptMask();
+		}
+		else
+		{
+			/* Only the interrupt lock is taken - the caller is stopping the
+			simulated interrupt thread from switching it to another core, not
+			excluding the other cores. */
+			if( xPortRunning == pdTRUE )
+			{
+				prvLockInterrupts();
+			}
+
+			uxPreviousMask = portCRITICAL_SECTION_MASK;
+		}
+
+		return uxPreviousMask;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortRestoreInterruptMask( UBaseType_t uxMask )
+	{
+		if( uxMask != portCRITICAL_SECTION_MASK )
+		{
+			vPortClearInterruptMask( uxMask );
+		}
+		else if( xPortRunning == pdTRUE )
+		{
+			prvUnlockInterrupts();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_CORES */
+
+void vPortEnterCritical( void )
+{
+	if( xPortRunning == pdTRUE )
+	{
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* A task also excludes the tasks running on the other cores.  The
+			task lock is always taken before the interrupt lock. */
+			vPortGetTaskLock();
+		}
+		#endif
+
+		/* The interrupt lock is held for the entire critical section,
+		effectively disabling (simulated) interrupts. */
+		prvLockInterrupts();
+	}
+
+	ulCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+int32_t lMutexNeedsReleasing;
+
+	lMutexNeedsReleasing = pdFALSE;
+
+	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
+	{
+		/* The interrupt lock should already be held by this thread as it was
+		obtained on entry to the critical section. */
+		lMutexNeedsReleasing = pdTRUE;
+		ulCriticalNesting--;
+
+		/* The nesting count belongs to the calling thread, so a critical
+		section inside an interrupt handler only reaches zero here once the
+		handler's own critical section is exited, and the simulated interrupt
+		thread does not then wait for anything below. */
+		if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+		{
+			/* Were any interrupts set to pending while interrupts were
+			(simulated) disabled? */
+			if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) != 0UL )
+			{
+				ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+
+				configASSERT( xPortRunning );
+
+				/* The interrupt won't actually executed until
+				the interrupt lock is released.  xInterruptEvent is only
+				posted when the simulated interrupt is pended if the interrupt
+				is pended from outside a critical section - hence it is posted
+				here. */
+				sem_post( &xInterruptEvent );
+
+				/* A calling task is going to wait for its yield event to
+				ensure the interrupt that is pending executes immediately after
+				the critical section is exited.  A thread that does not run a
+				task just lets the interrupt execute. */
+				#if( configNUMBER_OF_CORES > 1 )
+				{
+					/* With more than one core the pending interrupt may be
+					for another core, and the task cannot be switched out
+					while it still holds the task lock, so only wait if this
+					core is to be switched and the lock is about to be
+					released. */
+					if( ( ulTaskLockNesting != 1UL ) ||
+						( ( __atomic_load_n( &ulYieldRequestCores, __ATOMIC_SEQ_CST ) & ( 1UL << xPortGetCoreID() ) ) == 0UL ) )
+					{
+						pxThreadState = NULL;
+					}
+				}
+				#endif
+
+				if( pxThreadState != NULL )
+				{
+					/* The simulated interrupt handler cannot have switched
+					this task out while it held the lock. */
+					configASSERT( pxThreadState->xWaiting == pdFALSE );
+					__atomic_store_n( &( pxThreadState->xWaiting ), pdTRUE, __ATOMIC_SEQ_CST );
+
+					/* Lock will be released now so the (simulated) interrupt
+					can execute, so does not require releasing on function
+					exit. */
+					lMutexNeedsReleasing = pdFALSE;
+					prvUnlockInterrupts();
+
+					#if( configNUMBER_OF_CORES > 1 )
+					{
+						vPortReleaseTaskLock();
+					}
+					#endif
+
+					prvWaitForYieldEvent();
+				}
+			}
+		}
+	}
+
+	if( xPortRunning == pdTRUE )
+	{
+		if( lMutexNeedsReleasing == pdTRUE )
+		{
+			prvUnlockInterrupts();
+
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				vPortReleaseTaskLock();
+			}
+			#endif
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxPortSetInterruptMask( void )
+{
+UBaseType_t uxPreviousMask;
+
+	if( pthread_equal( pthread_self(), xSimulatedInterruptThread ) != 0 )
+	{
+		/* Called by an interrupt handler, which masks the interrupts that
+		can use the FreeRTOS API so a higher priority one cannot interrupt
+		it. */
+		uxPreviousMask = ( UBaseType_t ) ulInterruptMask;
+
+		if( ulInterruptMask > configMAX_SYSCALL_INTERRUPT_PRIORITY )
+		{
+			ulInterruptMask = configMAX_SYSCALL_INTERRUPT_PRIORITY;
+		}
+
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+	}
+	else
+	{
+		/* Called by a task, or another host thread, which cannot change the
+		mask of the simulated interrupt thread - enter a critical section
+		instead. */
+		vPortEnterCritical();
+		uxPreviousMask = portCRITICAL_SECTION_MASK;
+	}
+
+	return uxPreviousMask;
+}
+/*-----------------------------------------------------------*/
+
+void vPortClearInterruptMask( UBaseType_t uxMask )
+{
+	if( uxMask == portCRITICAL_SECTION_MASK )
+	{
+		vPortExitCritical();
+	}
+	else
+	{
+		__atomic_signal_fence( __ATOMIC_SEQ_CST );
+		ulInterruptMask = ( uint32_t ) uxMask;
+
+		/* Run any interrupt that was masked and can now interrupt the handler
+		that lowered the mask. */
+		if( __atomic_load_n( &ulPendingPriorities, __ATOMIC_SEQ_CST ) != 0UL )
+		{
+			prvRunPendingInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortValidateInterruptPriority( void )
+{
+	/* An interrupt that is not masked by critical sections must not call
+	the FreeRTOS API, which relies on critical sections for mutual exclusion.
+	Only the simulated interrupt thread runs interrupt handlers. */
+	if( pthread_equal( pthread_self(), xSimulatedInterruptThread ) != 0 )
+	{
+		configASSERT( ulActivePriority >= configMAX_SYSCALL_INTERRUPT_PRIORITY );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_USE_FIBERS */
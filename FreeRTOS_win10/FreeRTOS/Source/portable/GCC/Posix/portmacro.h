@@ -0,0 +1,487 @@
+/*
+ * FreeRTOS Kernel V10.4.1
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#include <stdint.h>
+
+/******************************************************************************
+	Defines
+******************************************************************************/
+/* Set configSIMULATOR_USE_FIBERS to 1 in FreeRTOSConfig.h to run every task on
+the single host thread that starts the scheduler, with each task executing on
+its own FreeRTOS allocated stack, instead of running each task in its own host
+thread.  See port.c. */
+#ifndef configSIMULATOR_USE_FIBERS
+	#define configSIMULATOR_USE_FIBERS 0
+#endif
+
+/* Set configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS to 0 in FreeRTOSConfig.h
+to model (simulated) interrupts being disabled with a pthread mutex, rather
+than a lock that is obtained and released without a system call when it is not
+contended.  Only used when configSIMULATOR_USE_FIBERS is 0. */
+#ifndef configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS
+	#define configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS 1
+#endif
+
+/* The number of host threads created, parked, the first time a task is
+created.  Tasks are given a parked thread when they are created, and their
+thread goes back to the pool when they are deleted.  The pool grows if more
+tasks exist at once.  Only used when configSIMULATOR_USE_FIBERS is 0. */
+#ifndef configSIMULATOR_THREAD_POOL_SIZE
+	#define configSIMULATOR_THREAD_POOL_SIZE 8
+#endif
+
+/* Set configSIMULATOR_VIRTUAL_TIME to 1 in FreeRTOSConfig.h to drive the tick
+from virtual time rather than the host clock.  Time only moves on when every
+task is blocked, and then jumps straight to the time the next task unblocks,
+so runs are repeatable and long delays take no host time.  Requires
+configUSE_TICKLESS_IDLE to be 1. */
+#ifndef configSIMULATOR_VIRTUAL_TIME
+	#define configSIMULATOR_VIRTUAL_TIME 0
+#endif
+
+/* Set configSIMULATOR_RECORD_REPLAY to 1 in FreeRTOSConfig.h to log every
+simulated interrupt and context switch to configSIMULATOR_RECORD_REPLAY_FILE,
+or to 2 to make a later run deliver the interrupts logged by a recording at
+exactly the same points.  Only available with configSIMULATOR_USE_FIBERS set to
+1.  See port.c. */
+#ifndef configSIMULATOR_RECORD_REPLAY
+	#define configSIMULATOR_RECORD_REPLAY 0
+#endif
+
+#ifndef configSIMULATOR_RECORD_REPLAY_FILE
+	#define configSIMULATOR_RECORD_REPLAY_FILE "FreeRTOS_Simulator.rr"
+#endif
+
+/* Set configSIMULATOR_KERNEL_INSTANCES to 1 in FreeRTOSConfig.h to give every
+host thread that starts a scheduler a kernel of its own - its own tasks, tick,
+heap and simulated interrupts - so independent instances of the kernel can run
+side by side in one process, for example to run tests in parallel.  Only
+available with configSIMULATOR_USE_FIBERS set to 1.  See
+xPortCreateKernelInstance(). */
+#ifndef configSIMULATOR_KERNEL_INSTANCES
+	#define configSIMULATOR_KERNEL_INSTANCES 0
+#endif
+
+/* The state of the kernel, the heap and the port is declared with this
+qualifier (through PRIVILEGED_DATA in the kernel), so with kernel instances
+each host thread has its own copy of it.  The thread local variables of the
+executable are addressed at a fixed offset from the thread pointer, so reading
+or writing one costs the same as an ordinary global. */
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+	#define portKERNEL_INSTANCE_DATA	_Thread_local
+#else
+	#define portKERNEL_INSTANCE_DATA
+#endif
+
+/* Task stacks are allocated by the port with pvPortMallocStack(), outside of
+the FreeRTOS heap, each with an inaccessible guard region below it, so a task
+that overflows its stack faults at once and vApplicationStackOverflowHook() is
+called.  Set configSTACK_ALLOCATION_FROM_SEPARATE_HEAP to 0 in FreeRTOSConfig.h
+to allocate stacks from the FreeRTOS heap, without guards, instead. */
+#ifndef configSTACK_ALLOCATION_FROM_SEPARATE_HEAP
+	#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 1
+#endif
+
+/* The simulated interrupt controller.  configSIMULATOR_INTERRUPT_LINES is the
+number of interrupts that can be simulated.  Interrupt priorities run from 0,
+the highest, to configKERNEL_INTERRUPT_PRIORITY, the lowest, which is the
+priority of the yield and tick interrupts and the priority every interrupt
+starts with.  As on a Cortex-M, critical sections only mask the interrupts
+with a priority of configMAX_SYSCALL_INTERRUPT_PRIORITY or lower, so
+interrupts above that priority are never delayed by the kernel, but must not
+call the FreeRTOS API.  The priorities are plain level numbers, not values
+shifted into the top bits of a register as on real hardware. */
+#ifndef configSIMULATOR_INTERRUPT_LINES
+	#define configSIMULATOR_INTERRUPT_LINES 32
+#endif
+
+#ifndef configKERNEL_INTERRUPT_PRIORITY
+	#define configKERNEL_INTERRUPT_PRIORITY 15
+#endif
+
+#ifndef configMAX_SYSCALL_INTERRUPT_PRIORITY
+	#define configMAX_SYSCALL_INTERRUPT_PRIORITY 0
+#endif
+
+/* Type definitions. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	size_t
+#define portBASE_TYPE	long
+#define portPOINTER_SIZE_TYPE size_t
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+
+	/* 32-bit tick type on a 32/64-bit architecture, so reads of the tick
+	count do not need to be guarded with a critical section. */
+	#define portTICK_TYPE_IS_ATOMIC 1
+#endif
+
+/* Hardware specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portHAS_STACK_OVERFLOW_CHECKING	1	/* Both engines run tasks on their own stacks, so pxPortInitialiseStack() is also passed the end of the stack. */
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+#define portINLINE __inline
+
+#if defined( __x86_64__ ) || defined( __aarch64__ )
+	#define portBYTE_ALIGNMENT		8
+#else
+	#define portBYTE_ALIGNMENT		4
+#endif
+
+#define portYIELD()					vPortGenerateSimulatedInterrupt( portINTERRUPT_YIELD )
+
+
+extern portKERNEL_INSTANCE_DATA volatile BaseType_t xInsideInterrupt;
+#define portSOFTWARE_BARRIER() while( xInsideInterrupt != pdFALSE )
+
+
+/* Simulated interrupts return pdFALSE if no context switch should be performed,
+or a non-zero number if a context switch should be performed. */
+#define portYIELD_FROM_ISR( x ) ( void ) x
+#define portEND_SWITCHING_ISR( x ) portYIELD_FROM_ISR( ( x ) )
+
+#if( configSIMULATOR_USE_FIBERS == 0 )
+	/* Each task has a host thread that has to be cleaned up when the task is
+	deleted.  With the fiber engine a task is only its stack, which the kernel
+	frees itself. */
+	void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield );
+	void vPortDeleteThread( void *pvThreadToDelete );
+	#define portCLEAN_UP_TCB( pxTCB )	vPortDeleteThread( pxTCB )
+	#define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxPendYield ) vPortCloseRunningThread( ( pvTaskToDelete ), ( pxPendYield ) )
+#endif
+
+/* Returns the number of host threads that have been created to run tasks,
+which only grows when more tasks exist at once than ever before - the threads
+of deleted tasks are reused.  Always 0 when configSIMULATOR_USE_FIBERS is 1. */
+uint32_t ulPortGetHostThreadCount( void );
+#define portDISABLE_INTERRUPTS() vPortEnterCritical()
+#define portENABLE_INTERRUPTS() vPortExitCritical()
+
+/* Critical section handling. */
+void vPortEnterCritical( void );
+void vPortExitCritical( void );
+
+#define portENTER_CRITICAL()		vPortEnterCritical()
+#define portEXIT_CRITICAL()			vPortExitCritical()
+
+/* Masking from interrupt handlers - the equivalent of raising BASEPRI on a
+Cortex-M. */
+UBaseType_t uxPortSetInterruptMask( void );
+void vPortClearInterruptMask( UBaseType_t uxMask );
+
+#define portSET_INTERRUPT_MASK_FROM_ISR()		uxPortSetInterruptMask()
+#define portCLEAR_INTERRUPT_MASK_FROM_ISR( x )	vPortClearInterruptMask( ( x ) )
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	#if( configSIMULATOR_USE_FIBERS == 1 )
+		#error configNUMBER_OF_CORES can only be greater than 1 when configSIMULATOR_USE_FIBERS is 0, as the fiber engine runs every task on one host thread.
+	#endif
+
+	/* Each simulated core is a task thread that is allowed to run at the same
+	time as the others.  The simulated interrupt thread handles the interrupts
+	of core 0, and performs the context switches of every core. */
+	BaseType_t xPortGetCoreID( void );
+	void vPortYieldCore( BaseType_t xCoreID );
+	#define portGET_CORE_ID()				xPortGetCoreID()
+	#define portYIELD_CORE( xCoreID )		vPortYieldCore( ( xCoreID ) )
+
+	/* The task lock is held while the scheduler is suspended and for every
+	critical section entered by a task, so only one core executes the kernel
+	at a time.  The interrupt mask only stops the simulated interrupt thread -
+	it does not stop the other cores. */
+	void vPortGetTaskLock( void );
+	void vPortReleaseTaskLock( void );
+	UBaseType_t uxPortRaiseInterruptMask( void );
+	void vPortRestoreInterruptMask( UBaseType_t uxMask );
+	#define portGET_TASK_LOCK()				vPortGetTaskLock()
+	#define portRELEASE_TASK_LOCK()			vPortReleaseTaskLock()
+	#define portSET_INTERRUPT_MASK()		uxPortRaiseInterruptMask()
+	#define portCLEAR_INTERRUPT_MASK( x )	vPortRestoreInterruptMask( ( x ) )
+
+#endif /* configNUMBER_OF_CORES */
+
+/* Checks that an interrupt safe API function is not called from an interrupt
+that critical sections do not mask. */
+void vPortValidateInterruptPriority( void );
+#define portASSERT_IF_INTERRUPT_PRIORITY_INVALID() vPortValidateInterruptPriority()
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 256 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 256.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#endif
+
+	/* __builtin_clzl() returns the number of leading zeros, so the index of the
+	most significant '1' is the width of the word minus one, minus that count. */
+	#define portBIT_SCAN_REVERSE( uxIndex, ulWord ) uxIndex = ( ( sizeof( unsigned long ) * 8UL ) - 1UL - ( UBaseType_t ) __builtin_clzl( ( ulWord ) ) )
+
+	#if( configMAX_PRIORITIES <= 32 )
+
+		/* Store/clear the ready priorities in a bit map. */
+		#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+		#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) portBIT_SCAN_REVERSE( uxTopPriority, uxReadyPriorities )
+
+	#else
+
+		/* Above 32 priorities the ready priorities are stored in a two level bit
+		map.  Each group of 32 priorities has a word of its own, and a bit in the
+		summary word ulGroups is set while the word of that group is not zero, so
+		the highest ready priority is still found with two bit scans. */
+		typedef struct xREADY_PRIORITIES
+		{
+			uint32_t ulGroups;
+			uint32_t ulPriorities[ ( configMAX_PRIORITIES + 31 ) / 32 ];
+		} ReadyPriorities_t;
+
+		#define portREADY_PRIORITIES_TYPE ReadyPriorities_t
+
+		#define portRECORD_READY_PRIORITY( uxPriority, xReadyPriorities )											\
+		{																											\
+			( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] |= ( 1UL << ( ( uxPriority ) & 31UL ) );	\
+			( xReadyPriorities ).ulGroups |= ( 1UL << ( ( uxPriority ) >> 5UL ) );									\
+		}
+
+		#define portRESET_READY_PRIORITY( uxPriority, xReadyPriorities )											\
+		{																											\
+			( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] &= ~( 1UL << ( ( uxPriority ) & 31UL ) );	\
+			if( ( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] == 0UL )								\
+			{																										\
+				( xReadyPriorities ).ulGroups &= ~( 1UL << ( ( uxPriority ) >> 5UL ) );							\
+			}																										\
+		}
+
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, xReadyPriorities )						\
+		{																						\
+			UBaseType_t uxGroup, uxPriorityInGroup;												\
+			portBIT_SCAN_REVERSE( uxGroup, ( xReadyPriorities ).ulGroups );						\
+			portBIT_SCAN_REVERSE( uxPriorityInGroup, ( xReadyPriorities ).ulPriorities[ uxGroup ] );	\
+			( uxTopPriority ) = ( uxGroup << 5UL ) + uxPriorityInGroup;							\
+		}
+
+	#endif /* configMAX_PRIORITIES */
+
+
+#endif /* taskRECORD_READY_PRIORITY */
+
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void * pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void * pvParameters )
+
+#define portINTERRUPT_YIELD				( 0UL )
+#define portINTERRUPT_TICK				( 1UL )
+
+/*
+ * Raise a simulated interrupt represented by the bit mask in ulInterruptMask.
+ * Each bit can be used to represent an individual interrupt - with the first
+ * two bits being used for the Yield and Tick interrupts respectively.  Unlike
+ * the Windows port this can also be called from a host thread that is not
+ * running a FreeRTOS task (a thread simulating a peripheral for example), in
+ * which case the interrupt is pended but the calling thread does not block.
+*/
+void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
+
+/*
+ * Install an interrupt handler to be called by the simulated interrupt handler
+ * thread.  The interrupt number must be above any used by the kernel itself
+ * (at the time of writing the kernel was using interrupt numbers 0, 1, and 2
+ * as defined above).  The number must also be lower than
+ * configSIMULATOR_INTERRUPT_LINES.
+ *
+ * Interrupt handler functions must return a non-zero value if executing the
+ * handler resulted in a task switch being required.
+ */
+void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
+
+/*
+ * Set the priority of a simulated interrupt, from 0 (the highest) to
+ * configKERNEL_INTERRUPT_PRIORITY (the lowest, and the default).  A pending
+ * interrupt with a higher priority than the handler that is executing
+ * interrupts that handler, and of the interrupts that are pending at once the
+ * highest priority runs first.  Interrupts with a priority above (numerically
+ * below) configMAX_SYSCALL_INTERRUPT_PRIORITY are not masked by critical
+ * sections and must not use the FreeRTOS API.  The priority of the yield and
+ * tick interrupts cannot be changed.  Set the priority before the interrupt is
+ * first raised.
+ */
+void vPortSetInterruptPriority( uint32_t ulInterruptNumber, uint32_t ulPriority );
+
+/*
+ * Returns the total number of ticks that the host did not run the simulated
+ * timer in time to generate when they were due.  The tick thread sleeps until
+ * absolute deadlines, so missed ticks are not lost - they are delivered late,
+ * in one batch, by the next tick interrupt.
+ */
+uint32_t ulPortGetMissedTickCount( void );
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/*
+	 * Tickless idle.  The tick thread stops generating ticks, and sleeps until
+	 * the next task is due to unblock or a simulated interrupt is raised.
+	 */
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+	/*
+	 * Returns the number of ticks that tickless idle suppressed per second,
+	 * measured over the last whole second (or longer sleep) of tick time.
+	 */
+	uint32_t ulPortGetSuppressedTicksPerSecond( void );
+
+#endif
+
+#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+	#if( configUSE_TICKLESS_IDLE != 1 )
+		#error configSIMULATOR_VIRTUAL_TIME requires configUSE_TICKLESS_IDLE to be 1, as virtual time is moved on in place of a tickless idle sleep.
+	#endif
+
+	/* Without a timer to reprogram, the idle task can skip a single tick
+	period. */
+	#define portMIN_EXPECTED_IDLE_TIME	1
+
+	/*
+	 * Returns the virtual time, in nanoseconds, since the scheduler started.
+	 * Advances a whole tick period at a time, and does not wrap around when
+	 * the tick count does.
+	 */
+	uint64_t ullPortGetVirtualTime( void );
+
+#endif
+
+#if( configSIMULATOR_RECORD_REPLAY != 0 )
+
+	#if( configSIMULATOR_USE_FIBERS != 1 )
+		#error configSIMULATOR_RECORD_REPLAY requires configSIMULATOR_USE_FIBERS to be 1, as only the fiber engine runs every task on one host thread.
+	#endif
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configSIMULATOR_RECORD_REPLAY requires configUSE_TICKLESS_IDLE to be 0, as the length of a tickless idle period is not recorded.
+	#endif
+
+	#if( configUSE_TRACE_FACILITY != 1 )
+		#error configSIMULATOR_RECORD_REPLAY requires configUSE_TRACE_FACILITY to be 1, as tasks are identified in the log by uxTaskGetTCBNumber().
+	#endif
+
+	/*
+	 * Called on each pass of the idle loop, which is where the idle task takes
+	 * the simulated interrupts raised while it runs.
+	 */
+	void vPortIdleTaskPoll( void );
+	#define portIDLE_TASK_POLL() vPortIdleTaskPoll()
+
+	/*
+	 * Writes the records still held in memory to the log.  Called at exit,
+	 * and can be called from an assert handler so a recording that ends in a
+	 * failure is complete.  Does nothing when replaying.
+	 */
+	void vPortFlushRecording( void );
+
+#endif
+
+#if( configSIMULATOR_KERNEL_INSTANCES == 1 )
+
+	#if( configSIMULATOR_USE_FIBERS != 1 )
+		#error configSIMULATOR_KERNEL_INSTANCES requires configSIMULATOR_USE_FIBERS to be 1, as the thread per task engine runs a kernel on many host threads.
+	#endif
+
+	#if( configUSE_TICKLESS_IDLE != 0 )
+		#error configSIMULATOR_KERNEL_INSTANCES requires configUSE_TICKLESS_IDLE to be 0, as each instance is ticked by a timer that signals its own thread.
+	#endif
+
+	#if( configSIMULATOR_RECORD_REPLAY != 0 )
+		#error configSIMULATOR_RECORD_REPLAY cannot be used with configSIMULATOR_KERNEL_INSTANCES, as there is one log for the whole process.
+	#endif
+
+	#if( configUSE_TRACE_FACILITY != 0 )
+		#error configSIMULATOR_KERNEL_INSTANCES requires configUSE_TRACE_FACILITY to be 0, as the trace recorder it enables has one trace buffer for the whole process.
+	#endif
+
+	typedef struct xKERNEL_INSTANCE * KernelInstanceHandle_t;
+
+	/*
+	 * Creates a host thread that runs a new instance of the kernel.  The thread
+	 * calls pxInstanceMain( pvParameter ), which creates the tasks of the
+	 * instance and calls vTaskStartScheduler() just as main() does.  The
+	 * instance ends when one of its tasks calls vTaskEndScheduler(), which
+	 * returns from vTaskStartScheduler() in pxInstanceMain() - the thread ends
+	 * when pxInstanceMain() returns.  The thread that calls main() can run an
+	 * instance too, by calling vTaskStartScheduler() itself.
+	 */
+	BaseType_t xPortCreateKernelInstance( void (*pxInstanceMain)( void * ), void *pvParameter, KernelInstanceHandle_t *pxInstance );
+
+	/*
+	 * Waits for the thread of an instance created by
+	 * xPortCreateKernelInstance() to end, then frees the handle.
+	 */
+	void vPortJoinKernelInstance( KernelInstanceHandle_t xInstance );
+
+	/*
+	 * Returns the instance the calling thread runs, or that it was bound to by
+	 * vPortBindKernelInstance().
+	 */
+	KernelInstanceHandle_t xPortGetKernelInstance( void );
+
+	/*
+	 * Binds the calling thread, which must not run an instance itself, to an
+	 * instance, so the interrupts it raises with
+	 * vPortGenerateSimulatedInterrupt() are raised in that instance.  A thread
+	 * simulating a peripheral is bound to the instance that owns the
+	 * peripheral, and must stop raising interrupts before the instance ends.
+	 */
+	void vPortBindKernelInstance( KernelInstanceHandle_t xInstance );
+
+#endif
+
+#endif
+
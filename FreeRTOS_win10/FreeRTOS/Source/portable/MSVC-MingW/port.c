@@ -27,6 +27,8 @@
 
 /* Standard includes. */
 #include <stdio.h>
+#include <setjmp.h>
+#include <malloc.h>
 
 /* Scheduler includes. */
 #include "FreeRTOS.h"
@@ -42,19 +44,36 @@
 #define portNO_CRITICAL_NESTING 		( ( uint32_t ) 0 )
 
 /* The priorities at which the various components of the simulation execute. */
-#define portDELETE_SELF_THREAD_PRIORITY			 THREAD_PRIORITY_TIME_CRITICAL /* Must be highest. */
 #define portSIMULATED_INTERRUPTS_THREAD_PRIORITY THREAD_PRIORITY_TIME_CRITICAL
 #define portSIMULATED_TIMER_THREAD_PRIORITY		 THREAD_PRIORITY_HIGHEST
 #define portTASK_THREAD_PRIORITY				 THREAD_PRIORITY_ABOVE_NORMAL
 
+/* Not defined by older SDK and MingW headers.  Requires Windows 10 version 1803
+or later - CreateWaitableTimerEx() fails on earlier versions. */
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+	#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION	0x00000002
+#endif
+
+#if( configSIMULATOR_VIRTUAL_TIME == 0 )
+
 /*
  * Created as a high priority thread, this function uses a timer to simulate
- * a tick interrupt being generated on an embedded target.  In this Windows
- * environment the timer does not achieve anything approaching real time
- * performance though.
+ * a tick interrupt being generated on an embedded target.  Each tick is due at
+ * an absolute time measured with the performance counter, so the tick rate
+ * does not drift.  Windows does not always run the thread on time though, so
+ * each wake counts how many tick periods have really elapsed and any ticks
+ * that were missed are delivered together.
  */
 static DWORD WINAPI prvSimulatedPeripheralTimer( LPVOID lpParameter );
 
+/*
+ * Called when the process exits to let Windows know the high timer resolution
+ * is no longer required.  Only the tick thread changes the timer resolution.
+ */
+static BOOL WINAPI prvEndProcess( DWORD dwCtrlType );
+
+#endif
+
 /*
  * Process all the simulated interrupts - each represented by a bit in
  * ulPendingInterrupts variable.
@@ -72,37 +91,264 @@ static uint32_t prvProcessTickInterrupt( void );
  * Exiting a critical section will cause the calling task to block on yield
  * event to wait for an interrupt to process if an interrupt was pended while
  * inside the critical section.  This variable protects against a recursive
- * attempt to obtain pvInterruptEventMutex if a critical section is used inside
+ * attempt to obtain the interrupt lock if a critical section is used inside
  * an interrupt handler itself.
  */
 volatile BaseType_t xInsideInterrupt = pdFALSE;
 
 /*
- * Called when the process exits to let Windows know the high timer resolution
- * is no longer required.
+ * The entry point of every Windows thread that runs tasks.  Records where the
+ * thread's stack starts, then calls prvRunTasks(), which never returns.
  */
-static BOOL WINAPI prvEndProcess( DWORD dwCtrlType );
+static DWORD WINAPI prvHostThreadEntry( LPVOID lpParameter );
+
+/*
+ * Runs one task at a time on the calling thread, waiting to be selected by
+ * the scheduler before calling the task function, and returns the thread to
+ * the pool of parked threads each time the task is deleted.  xRecycled is
+ * pdTRUE if the thread has just been recycled by prvRecycleSuspendedThread().
+ * A task whose stack was allocated by pvPortMallocStack() runs on that stack,
+ * which is part of the thread's own stack.
+ */
+static void prvRunTasks( BaseType_t xRecycled );
+
+/*
+ * Where a thread that was suspended by the simulated interrupt handler starts
+ * executing when its task is deleted.  vPortDeleteThread() points the
+ * suspended thread's instruction pointer here, and its stack pointer back
+ * near the top of its stack, so the thread abandons the task's frames.
+ */
+static void prvRecycleSuspendedThread( void );
+
+/*
+ * Create a Windows thread to run tasks, which waits on its yield event until
+ * it is given one.  The thread's stack has room below the frames that park it
+ * for a task stack of xTaskStackSize bytes.
+ */
+static struct xHOST_THREAD *prvCreateHostThread( size_t xTaskStackSize );
+
+/*
+ * Take a parked thread with room for a task stack of xTaskStackSize bytes from
+ * the pool, creating the pool the first time it is used and a new thread if
+ * no thread in the pool is big enough.
+ */
+static struct xHOST_THREAD *prvTakeHostThread( size_t xTaskStackSize );
+
+/*
+ * Put a thread whose task was deleted back in the pool, or, if the task's
+ * stack is part of the thread's stack, in pxTaskStackThreads until the kernel
+ * frees the stack.
+ */
+static void prvReturnHostThread( struct xHOST_THREAD *pxHostThread );
+
+#if( configCHECK_FOR_STACK_OVERFLOW > 0 )
+
+	/*
+	 * Vectored exception handler that calls vApplicationStackOverflowHook()
+	 * when a task has overflowed not only its own stack but the rest of its
+	 * thread's stack below it too.
+	 */
+	static LONG WINAPI prvStackOverflowHandler( PEXCEPTION_POINTERS pxExceptionInfo );
+
+#endif
+
+/*
+ * Wait on the yield event of the calling thread until the task it runs is
+ * selected to run.  Does not return if the task is deleted in the meantime -
+ * the thread goes back to the pool instead.
+ */
+static void prvWaitForYieldEvent( void );
+
+/*
+ * Stop the thread of a task that the scheduler has just switched out.  If the
+ * task blocked or yielded its thread is already waiting on its yield event,
+ * otherwise the thread is suspended.
+ */
+static void prvSwitchOutThread( void *pvOldCurrentTCB );
+
+/*
+ * Let the thread of a task that is about to run continue, from its yield
+ * event or from where it was suspended.
+ */
+struct xTHREAD_STATE;
+static void prvResumeThread( struct xTHREAD_STATE *pxThreadState );
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Switch the tasks of the cores that have requested a context switch, if
+	 * the task lock can be taken.
+	 */
+	static void prvSwitchCores( void );
+
+#endif
 
 /*-----------------------------------------------------------*/
 
+/* How far below the point recorded by prvHostThreadEntry() the stack of a
+recycled thread starts, leaving the frames that call prvRunTasks() intact. */
+#define portRECYCLED_STACK_OFFSET		( 512 )
+
+/* How far below the point recorded by prvHostThreadEntry() a stack allocated
+by pvPortMallocStack() ends, leaving room for the frames of a thread that is
+parked on its yield event, which must survive the kernel filling the stack. */
+#define portTASK_STACK_OFFSET			( ( size_t ) ( 8 * 1024 ) )
+
+/* The part of a thread's stack left below a stack allocated by
+pvPortMallocStack().  A task that overflows its stack runs on into it rather
+than off the end of the thread's stack, so the kernel can still report the
+overflow when the task is switched out. */
+#define portSTACK_OVERFLOW_SPACE		( ( size_t ) ( 64 * 1024 ) )
+
+/* The stack Windows keeps in reserve to handle EXCEPTION_STACK_OVERFLOW, which
+has to be enough to call vApplicationStackOverflowHook(). */
+#define portSTACK_GUARANTEE				( 16UL * 1024UL )
+
+/* The page size of x86 and x64 Windows. */
+#define portHOST_PAGE_SIZE				( ( size_t ) 4096 )
+
+/* The values passed to longjmp() to return a thread to prvRunTasks() - when
+its task is deleted by another task, and when its task deletes itself. */
+#define portRECYCLE_DELETED				( 1 )
+#define portRECYCLE_SELF_DELETED		( 2 )
+
+/* A Windows thread that runs tasks.  Threads are not created and destroyed
+with the tasks they run - a thread whose task is deleted goes back to a pool of
+parked threads, and is given the next task that is created, so creating a task
+does not normally create a thread, and deleting one never terminates a
+thread. */
+typedef struct xHOST_THREAD
+{
+	void *pvThread;
+	DWORD dwThreadId;
+
+	/* Event the thread waits on whenever it is not the running task, or has
+	no task to run. */
+	void *pvYieldEvent;
+
+	/* The state of the task the thread runs, or NULL while the thread is in
+	the pool. */
+	struct xTHREAD_STATE * volatile pxThreadState;
+
+	/* Set by vPortDeleteThread() to send the thread back to the pool rather
+	than let it run the task again. */
+	volatile LONG lRecycle;
+
+	/* Where a thread that was waiting on its yield event jumps to when its
+	task is deleted, abandoning the task's frames. */
+	jmp_buf xRecycleBuffer;
+
+	/* A point near the top of the thread's stack, below which a thread that
+	was suspended when its task was deleted starts again. */
+	void *pvStackTop;
+
+	/* The lowest address of the thread's stack. */
+	int8_t *pcStackLimit;
+
+	/* The task stack pvPortMallocStack() allocated from the thread's stack,
+	and its size, or NULL if the task's stack was allocated elsewhere. */
+	int8_t *pcTaskStack;
+	size_t xTaskStackSize;
+
+	#if !defined( __x86_64__ ) && !defined( _M_X64 )
+		/* The structured exception handler list when the thread started,
+		which is on the stack and so must be restored along with it. */
+		void *pvExceptionList;
+	#endif
+
+	/* The next thread in the pool or in pxTaskStackThreads. */
+	struct xHOST_THREAD *pxNext;
+} HostThread_t;
+
 /* The WIN32 simulator runs each task in a thread.  The context switching is
 managed by the threads, so the task stack does not have to be managed directly,
-although the task stack is still used to hold an xThreadState structure this is
-the only thing it will ever hold.  The structure indirectly maps the task handle
-to a thread handle. */
-typedef struct
+although the task stack is still used to hold an xThreadState structure at its
+top.  When the stack was allocated by pvPortMallocStack() the task runs on the
+rest of it, otherwise the structure is the only thing it will ever hold.  The
+structure indirectly maps the task handle to a thread handle. */
+typedef struct xTHREAD_STATE
 {
-	/* Handle of the thread that executes the task. */
+	/* Handle of the thread that executes the task.  A copy of the handle held
+	by pxHostThread, set to NULL when the task is deleted. */
 	void *pvThread;
 
-	/* Event used to make sure the thread does not execute past a yield point
-	between the call to SuspendThread() to suspend the thread and the
-	asynchronous SuspendThread() operation actually being performed. */
+	/* Identifier of the thread that executes the task. */
+	DWORD dwThreadId;
+
+	/* Event the thread waits on after it yields, until the simulated
+	interrupt handler has processed the yield and selected the task to run
+	again. */
 	void *pvYieldEvent;
+
+	/* The pooled thread that executes the task. */
+	HostThread_t *pxHostThread;
+
+	/* The task function and its parameter, passed to the thread when the task
+	starts. */
+	TaskFunction_t pxCode;
+	void *pvParameters;
+
+	/* Set when the thread is, or is about to be, waiting on pvYieldEvent or
+	suspended, so the simulated interrupt handler knows it has to set the
+	event or resume the thread before the task can run.  Only ever set with
+	InterlockedCompareExchange() - by the thread itself when it yields, or by
+	the simulated interrupt handler when it switches the thread out
+	asynchronously - so the thread is never both waiting and suspended, and
+	only ever cleared by the simulated interrupt handler. */
+	volatile LONG lWaiting;
+
+	/* pdTRUE if the thread was suspended with SuspendThread() rather than
+	waiting on pvYieldEvent.  Only accessed with the interrupt lock held - by
+	the simulated interrupt handler, and by vPortDeleteThread(). */
+	BaseType_t xSuspended;
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The core the task last ran on, set by the simulated interrupt
+		handler before the task is resumed on a core, so it only changes
+		while the task is not running. */
+		volatile BaseType_t xCoreID;
+	#endif
 } ThreadState_t;
 
+/* Threads that have no task to run, parked on their yield events, and the
+number of threads that have been created to run tasks.  Both are protected by
+xHostThreadPoolLock. */
+static HostThread_t *pxHostThreadPool = NULL;
+static uint32_t ulHostThreadsCreated = 0UL;
+static SRWLOCK xHostThreadPoolLock = SRWLOCK_INIT;
+
+/* Threads whose stacks hold a task stack allocated by pvPortMallocStack() but
+which have no task, either because the task has not been created yet or
+because it was deleted and the kernel has not freed its stack yet.  The kernel
+may still write to the task stack, so the thread cannot go back in the pool
+until vPortFreeStack() is called.  Also protected by xHostThreadPoolLock. */
+static HostThread_t *pxTaskStackThreads = NULL;
+
+/* Set by a thread once it is back in the pool after its task was deleted by
+another task, so the pool cannot grow just because the deleting task runs
+ahead of the threads it is recycling. */
+static void *pvRecycleAcknowledged = NULL;
+
+/* Set by a new thread once it has recorded where its stack is. */
+static void *pvHostThreadStarted = NULL;
+
+/* The HostThread_t of the calling thread, or NULL if the calling thread does
+not run tasks. */
+#ifdef __GNUC__
+	static __thread HostThread_t *pxHostThreadOfThisThread = NULL;
+#else
+	static __declspec( thread ) HostThread_t *pxHostThreadOfThisThread = NULL;
+#endif
+
+/* The ThreadState_t of the task executed by the calling thread, or NULL if the
+calling thread is not running a task. */
+#define portTHREAD_STATE_OF_THIS_THREAD()	( ( pxHostThreadOfThisThread != NULL ) ? pxHostThreadOfThisThread->pxThreadState : NULL )
+
 /* Simulated interrupts waiting to be processed.  This is a bit mask where each
-bit represents one interrupt, so a maximum of 32 interrupts can be simulated. */
+bit represents one interrupt, so a maximum of 32 interrupts can be simulated.
+Bits are set with InterlockedOr() and the simulated interrupt handler takes the
+whole mask with InterlockedExchange(), so no lock is needed to pend an
+interrupt. */
 static volatile uint32_t ulPendingInterrupts = 0UL;
 
 /* An event used to inform the simulated interrupt processing thread (a high
@@ -110,91 +356,378 @@ priority thread that simulated interrupt processing) that an interrupt is
 pending. */
 static void *pvInterruptEvent = NULL;
 
-/* Mutex used to protect all the simulated interrupt variables that are accessed
-by multiple threads. */
-static void *pvInterruptEventMutex = NULL;
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+
+	/* The values of xInterruptLock.lState. */
+	#define portLOCK_FREE					( 0L )
+	#define portLOCK_HELD					( 1L )
+	#define portLOCK_CONTENDED				( 2L )
+
+	/* A recursive lock that is taken and released with interlocked operations
+	alone when it is not contended, and parks the calling thread on an event
+	when it is.  With one simulated core every thread of the simulation is
+	confined to the same host core, so the thread that holds the lock cannot
+	run while another thread spins waiting for it - a thread that finds the
+	lock held parks straight away. */
+	typedef struct
+	{
+		volatile LONG lState;
+		volatile DWORD dwOwner;
+		uint32_t ulRecursion;
+		void *pvParkEvent;
+	} InterruptLock_t;
+
+	/* Held by a task for the whole of a critical section, and by the simulated
+	interrupt processing thread while it processes interrupts.  Holding it is
+	the simulated equivalent of having interrupts disabled. */
+	static InterruptLock_t xInterruptLock = { portLOCK_FREE, 0, 0UL, NULL };
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The kernel's task lock - see vPortGetTaskLock(). */
+		static InterruptLock_t xTaskLock = { portLOCK_FREE, 0, 0UL, NULL };
+	#endif
+
+	/*
+	 * Obtain and release a lock.  Both can be nested by the thread that holds
+	 * the lock.
+	 */
+	static void prvTakeLock( InterruptLock_t *pxLock );
+	static void prvGiveLock( InterruptLock_t *pxLock );
+
+#else
+
+	/* Mutex held by a task for the whole of a critical section, and by the
+	simulated interrupt processing thread while it processes interrupts.
+	Holding it is the simulated equivalent of having interrupts disabled. */
+	static void *pvInterruptEventMutex = NULL;
+
+	#if( configNUMBER_OF_CORES > 1 )
+		/* The kernel's task lock - see vPortGetTaskLock(). */
+		static void *pvTaskLockMutex = NULL;
+	#endif
+
+#endif /* configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS */
+
+/*
+ * Obtain and release the lock that models (simulated) interrupts being
+ * disabled.  Both can be nested.
+ */
+static void prvLockInterrupts( void );
+static void prvUnlockInterrupts( void );
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	/*
+	 * Take the task lock for the simulated interrupt thread, which switches
+	 * the tasks of a core while holding it, without waiting for it.  Returns
+	 * pdFALSE if a task holds the lock.
+	 */
+	static BaseType_t prvTryLockTasks( void );
+	static void prvUnlockTasks( void );
+
+	/* The number of times the calling task thread has taken the task lock
+	without releasing it.  The lock itself is only taken when this is 0. */
+	#ifdef __GNUC__
+		static __thread uint32_t ulTaskLockNesting = 0UL;
+	#else
+		static __declspec( thread ) uint32_t ulTaskLockNesting = 0UL;
+	#endif
+
+	/* One bit for each core whose task must be switched out - set when a
+	core yields or is asked to yield by another core, and cleared when the
+	simulated interrupt handler performs the switch.  A core whose bit is set
+	when the handler cannot take the task lock keeps its bit, and the switch
+	is made once the task that holds the lock releases it. */
+	static volatile uint32_t ulYieldRequestCores = 0UL;
+
+	/* The core the simulated interrupt thread is acting for - the core whose
+	context switch it is performing, otherwise 0, as the thread also runs the
+	interrupt handlers of core 0. */
+	static volatile BaseType_t xInterruptCoreID = 0;
+
+	/* The identifier of the simulated interrupt thread. */
+	static DWORD dwSimulatedInterruptThreadId = 0;
+
+#endif /* configNUMBER_OF_CORES */
+
+/* The critical nesting count of the calling thread.  Tasks are never switched
+out while they are in a critical section, so this is the same as the count of
+the task the thread runs, but a task can read its own count without holding
+the interrupt lock while the simulated interrupt handler is changing the
+count of its own thread.  Task threads start outside of a critical section. */
+#ifdef __GNUC__
+	static __thread uint32_t ulCriticalNesting = 0UL;
+#else
+	static __declspec( thread ) uint32_t ulCriticalNesting = 0UL;
+#endif
+
+/* Tick periods that have elapsed but have not yet been processed by the tick
+interrupt handler.  Incremented by the tick thread and cleared by the handler,
+so normally 1 each time the tick interrupt executes. */
+static volatile LONG lTicksToProcess = 0L;
+
+/* The total number of ticks that Windows did not run the tick thread in time
+to generate, and were therefore delivered late in a batch.  Read by
+ulPortGetMissedTickCount(). */
+static volatile uint32_t ulMissedTicks = 0UL;
+
+/* Set to wake the tick thread before the deadline it is waiting for - only
+used to start and end tickless idle periods. */
+static void *pvTickTimerEvent = NULL;
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/* The states of a tickless idle period.  The idle task requests the
+	period, the tick thread stops generating ticks and sleeps for the period,
+	then reports the number of tick periods that elapsed while it slept. */
+	#define portTICKLESS_IDLE_INACTIVE		( 0L )
+	#define portTICKLESS_IDLE_REQUESTED		( 1L )
+	#define portTICKLESS_IDLE_SLEEPING		( 2L )
+
+	static volatile LONG lTicklessIdleState = portTICKLESS_IDLE_INACTIVE;
+
+	/* The maximum number of ticks the tick thread can suppress, as passed to
+	vPortSuppressTicksAndSleep(). */
+	static TickType_t xTicklessIdleTime = 0;
+
+	/* Set when a simulated interrupt is raised during a tickless idle period,
+	to end the period early - the simulated equivalent of an interrupt waking
+	the processor from sleep. */
+	static volatile LONG lTicklessIdleAbort = pdFALSE;
+
+	/* The tick periods that elapsed while the tick thread was sleeping, and
+	the event set when the value is available. */
+	static TickType_t xTicklessIdleElapsed = 0;
+	static void *pvTicklessIdleComplete = NULL;
+
+	/* The number of ticks suppressed per second, measured each time the
+	tick count passes a second boundary.  Returned by
+	ulPortGetSuppressedTicksPerSecond(). */
+	static volatile uint32_t ulSuppressedTicksPerSecond = 0UL;
+
+	/*
+	 * Ends a tickless idle period early, if one is in progress, because a
+	 * simulated interrupt has been raised.  Must be called after the
+	 * interrupt has been pended.
+	 */
+	static void prvAbortTicklessIdle( void );
+
+	#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+		/*
+		 * Called by vPortSuppressTicksAndSleep() in place of sleeping.  Moves
+		 * virtual time on to the time the next task unblocks.
+		 */
+		static void prvAdvanceVirtualTime( TickType_t xExpectedIdleTime );
+
+	#endif
 
-/* The critical nesting count for the currently executing task.  This is
-initialised to a non-zero value so interrupts do not become enabled during
-the initialisation phase.  As each task has its own critical nesting value
-ulCriticalNesting will get set to zero when the first task runs.  This
-initialisation is probably not critical in this simulated environment as the
-simulated interrupt handlers do not get created until the FreeRTOS scheduler is
-started anyway. */
-static volatile uint32_t ulCriticalNesting = 9999UL;
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+	/* The number of tick periods of virtual time that have passed since the
+	scheduler started - the tick count, without the wrap around of a 32-bit
+	TickType_t.  Only the thread that updates the tick count writes it. */
+	static volatile LONG64 llVirtualTicks = 0LL;
+
+#endif /* configSIMULATOR_VIRTUAL_TIME */
 
 /* Handlers for all the simulated software interrupts.  The first two positions
 are used for the Yield and Tick interrupts so are handled slightly differently,
 all the other interrupts can be user defined. */
 static uint32_t (*ulIsrHandler[ portMAX_INTERRUPTS ])( void ) = { 0 };
 
-/* Pointer to the TCB of the currently executing task. */
-extern void * volatile pxCurrentTCB;
+#if( configNUMBER_OF_CORES == 1 )
+	/* Pointer to the TCB of the currently executing task. */
+	extern void * volatile pxCurrentTCB;
+#else
+	/* Pointers to the TCB of the task executing on each core. */
+	extern void * volatile pxCurrentTCBs[ configNUMBER_OF_CORES ];
+#endif
 
 /* Used to ensure nothing is processed during the startup sequence. */
 static BaseType_t xPortRunning = pdFALSE;
 
 /*-----------------------------------------------------------*/
 
+#if( configSIMULATOR_VIRTUAL_TIME == 0 )
+
 static DWORD WINAPI prvSimulatedPeripheralTimer( LPVOID lpParameter )
 {
-TickType_t xMinimumWindowsBlockTime;
 TIMECAPS xTimeCaps;
+void *pvTimer;
+LARGE_INTEGER xFrequency, xStartTime, xNow, xDueTime;
+uint64_t ullTicksGenerated = 0ULL, ullNextTickCount, ullElapsedCount, ullTicksElapsed, ullTicksToWait;
+void *pvWaitObjects[ 2 ];
+#if( configUSE_TICKLESS_IDLE == 1 )
+	BaseType_t xTicklessIdleSleeping;
+	uint32_t ulSuppressedTicks = 0UL, ulSuppressedTicksAtLastSecond = 0UL;
+	uint64_t ullSecond = 0ULL;
+#endif
 
-	/* Set the timer resolution to the maximum possible. */
+	/* Set the timer resolution to the maximum possible.  This only matters if
+	a high resolution waitable timer is not available. */
 	if( timeGetDevCaps( &xTimeCaps, sizeof( xTimeCaps ) ) == MMSYSERR_NOERROR )
 	{
-		xMinimumWindowsBlockTime = ( TickType_t ) xTimeCaps.wPeriodMin;
 		timeBeginPeriod( xTimeCaps.wPeriodMin );
 
 		/* Register an exit handler so the timeBeginPeriod() function can be
 		matched with a timeEndPeriod() when the application exits. */
 		SetConsoleCtrlHandler( prvEndProcess, TRUE );
 	}
-	else
+
+	/* Use a high resolution waitable timer if the host supports one, otherwise
+	fall back to a standard waitable timer, which has the resolution set by
+	timeBeginPeriod(). */
+	pvTimer = CreateWaitableTimerEx( NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS );
+	if( pvTimer == NULL )
 	{
-		xMinimumWindowsBlockTime = ( TickType_t ) 20;
+		pvTimer = CreateWaitableTimer( NULL, TRUE, NULL );
 	}
+	configASSERT( pvTimer );
+
+	/* Wait for either the timer to expire or the tick timer event. */
+	pvWaitObjects[ 0 ] = pvTimer;
+	pvWaitObjects[ 1 ] = pvTickTimerEvent;
+
+	QueryPerformanceFrequency( &xFrequency );
+	QueryPerformanceCounter( &xStartTime );
 
 	/* Just to prevent compiler warnings. */
 	( void ) lpParameter;
 
 	for( ;; )
 	{
-		/* Wait until the timer expires and we can access the simulated interrupt
-		variables.  *NOTE* this is not a 'real time' way of generating tick
-		events as the next wake time should be relative to the previous wake
-		time, not the time that Sleep() is called.  It is done this way to
-		prevent overruns in this very non real time simulated/emulated
-		environment. */
-		if( portTICK_PERIOD_MS < xMinimumWindowsBlockTime )
+		ullTicksToWait = 1ULL;
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
 		{
-			Sleep( xMinimumWindowsBlockTime );
+			/* If the idle task has requested a tickless idle period then sleep
+			for the whole period instead of generating ticks.  The period ends
+			early if a simulated interrupt is raised - including one raised
+			before the request was seen. */
+			xTicklessIdleSleeping = pdFALSE;
+
+			if( lTicklessIdleState == portTICKLESS_IDLE_REQUESTED )
+			{
+				xTicklessIdleSleeping = pdTRUE;
+				InterlockedExchange( &lTicklessIdleState, portTICKLESS_IDLE_SLEEPING );
+
+				/* Discard a wake left over from an earlier period - the abort
+				flag records one that is still relevant. */
+				ResetEvent( pvTickTimerEvent );
+
+				if( InterlockedCompareExchange( &lTicklessIdleAbort, pdFALSE, pdFALSE ) == pdFALSE )
+				{
+					ullTicksToWait = ( uint64_t ) xTicklessIdleTime;
+				}
+				else
+				{
+					ullTicksToWait = 0ULL;
+				}
+			}
 		}
-		else
+		#endif /* configUSE_TICKLESS_IDLE */
+
+		/* Wait until the deadline of the next tick.  The deadline is calculated
+		from the time the timer started, not from the time this thread last
+		woke, so neither late wakes nor the rounding of the tick period to
+		whole performance counter counts cause the tick rate to drift.
+		pvTickTimerEvent is only set to start or end a tickless idle period. */
+		if( ullTicksToWait > 0ULL )
 		{
-			Sleep( portTICK_PERIOD_MS );
+			ullNextTickCount = ( ( ullTicksGenerated + ullTicksToWait ) / configTICK_RATE_HZ ) * ( uint64_t ) xFrequency.QuadPart;
+			ullNextTickCount += ( ( ( ullTicksGenerated + ullTicksToWait ) % configTICK_RATE_HZ ) * ( uint64_t ) xFrequency.QuadPart ) / configTICK_RATE_HZ;
+			QueryPerformanceCounter( &xNow );
+
+			if( ( uint64_t ) ( xNow.QuadPart - xStartTime.QuadPart ) < ullNextTickCount )
+			{
+				/* Waitable timer due times are in 100ns units, and negative for
+				a time relative to now. */
+				xDueTime.QuadPart = -( LONGLONG ) ( ( ( ullNextTickCount - ( uint64_t ) ( xNow.QuadPart - xStartTime.QuadPart ) ) * 10000000ULL ) / ( uint64_t ) xFrequency.QuadPart );
+				if( xDueTime.QuadPart == 0 )
+				{
+					xDueTime.QuadPart = -1;
+				}
+
+				SetWaitableTimer( pvTimer, &xDueTime, 0, NULL, NULL, FALSE );
+				WaitForMultipleObjects( sizeof( pvWaitObjects ) / sizeof( void * ), pvWaitObjects, FALSE, INFINITE );
+			}
 		}
 
-		configASSERT( xPortRunning );
+		/* Windows may not have run this thread at the deadline, and the wait
+		may have ended early, so work out how many tick periods have really
+		elapsed since the timer started. */
+		QueryPerformanceCounter( &xNow );
+		ullElapsedCount = ( uint64_t ) ( xNow.QuadPart - xStartTime.QuadPart );
+		ullTicksElapsed = ( ullElapsedCount / ( uint64_t ) xFrequency.QuadPart ) * configTICK_RATE_HZ;
+		ullTicksElapsed += ( ( ullElapsedCount % ( uint64_t ) xFrequency.QuadPart ) * configTICK_RATE_HZ ) / ( uint64_t ) xFrequency.QuadPart;
 
-		/* Can't proceed if in a critical section as pvInterruptEventMutex won't
-		be available. */
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+		if( ullTicksElapsed < ullTicksGenerated )
+		{
+			ullTicksElapsed = ullTicksGenerated;
+		}
 
-		/* The timer has expired, generate the simulated tick event. */
-		ulPendingInterrupts |= ( 1 << portINTERRUPT_TICK );
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			if( xTicklessIdleSleeping != pdFALSE )
+			{
+				/* Hand the elapsed tick periods to the idle task, which steps
+				the tick count forward by them, instead of generating them. */
+				xTicklessIdleElapsed = ( TickType_t ) ( ullTicksElapsed - ullTicksGenerated );
 
-		/* The interrupt is now pending - notify the simulated interrupt
-		handler thread.  Must be outside of a critical section to get here so
-		the handler thread can execute immediately pvInterruptEventMutex is
-		released. */
-		configASSERT( ulCriticalNesting == 0UL );
-		SetEvent( pvInterruptEvent );
+				/* The last period is delivered as a tick interrupt, see
+				vPortSuppressTicksAndSleep(). */
+				if( xTicklessIdleElapsed < xTicklessIdleTime )
+				{
+					ulSuppressedTicks += ( uint32_t ) xTicklessIdleElapsed;
+				}
+				else
+				{
+					ulSuppressedTicks += ( uint32_t ) ( xTicklessIdleTime - 1 );
+				}
+
+				ullTicksGenerated = ullTicksElapsed;
+				SetEvent( pvTicklessIdleComplete );
+			}
+
+			/* Each time a second boundary is passed record how many ticks
+			were suppressed per second since the last boundary. */
+			if( ( ullTicksElapsed / configTICK_RATE_HZ ) != ullSecond )
+			{
+				ulSuppressedTicksPerSecond = ( ulSuppressedTicks - ulSuppressedTicksAtLastSecond ) / ( uint32_t ) ( ( ullTicksElapsed / configTICK_RATE_HZ ) - ullSecond );
+				ulSuppressedTicksAtLastSecond = ulSuppressedTicks;
+				ullSecond = ullTicksElapsed / configTICK_RATE_HZ;
+			}
+		}
+		#endif /* configUSE_TICKLESS_IDLE */
+
+		if( ullTicksElapsed > ullTicksGenerated )
+		{
+			/* Only this thread writes ulMissedTicks. */
+			ulMissedTicks += ( uint32_t ) ( ullTicksElapsed - ullTicksGenerated - 1ULL );
+			InterlockedExchangeAdd( &lTicksToProcess, ( LONG ) ( ullTicksElapsed - ullTicksGenerated ) );
+			ullTicksGenerated = ullTicksElapsed;
+
+			configASSERT( xPortRunning );
 
-		/* Give back the mutex so the simulated interrupt handler unblocks
-		and can access the interrupt handler variables. */
-		ReleaseMutex( pvInterruptEventMutex );
+			/* The timer has expired, generate the simulated tick event.  There
+			is no need to wait for a critical section to end first, the
+			simulated interrupt handler will not process the tick until it has
+			ended. */
+			InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_TICK ) );
+
+			#if( configUSE_TICKLESS_IDLE == 1 )
+			{
+				prvAbortTicklessIdle();
+			}
+			#endif
+
+			/* The interrupt is now pending - notify the simulated interrupt
+			handler thread. */
+			SetEvent( pvInterruptEvent );
+		}
 	}
 
 	#ifdef __GNUC__
@@ -222,44 +755,492 @@ TIMECAPS xTimeCaps;
 }
 /*-----------------------------------------------------------*/
 
-StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+#endif /* configSIMULATOR_VIRTUAL_TIME */
+
+static DWORD WINAPI prvHostThreadEntry( LPVOID lpParameter )
 {
-ThreadState_t *pxThreadState = NULL;
-int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
-const SIZE_T xStackSize = 1024; /* Set the size to a small number which will get rounded up to the minimum possible. */
+HostThread_t *pxHostThread = ( HostThread_t * ) lpParameter;
+MEMORY_BASIC_INFORMATION xStackInfo;
+ULONG ulGuarantee = portSTACK_GUARANTEE;
 
-	/* In this simulated case a stack is not initialised, but instead a thread
-	is created that will execute the task being created.  The thread handles
-	the context switching itself.  The ThreadState_t object is placed onto
-	the stack that was created for the task - so the stack buffer is still
-	used, just not in the conventional way.  It will not be used for anything
-	other than holding this structure. */
-	pxThreadState = ( ThreadState_t * ) ( pcTopOfStack - sizeof( ThreadState_t ) );
+	pxHostThreadOfThisThread = pxHostThread;
+	pxHostThread->pvStackTop = ( void * ) &pxHostThread;
+
+	/* The whole stack is one allocation, which starts at its lowest address. */
+	VirtualQuery( pxHostThread->pvStackTop, &xStackInfo, sizeof( xStackInfo ) );
+	pxHostThread->pcStackLimit = ( int8_t * ) xStackInfo.AllocationBase;
+
+	/* Leave enough stack to call vApplicationStackOverflowHook() from
+	prvStackOverflowHandler() if the stack overflows. */
+	SetThreadStackGuarantee( &ulGuarantee );
+
+	#if !defined( __x86_64__ ) && !defined( _M_X64 )
+	{
+		pxHostThread->pvExceptionList = ( ( NT_TIB * ) NtCurrentTeb() )->ExceptionList;
+	}
+	#endif
+
+	SetEvent( pvHostThreadStarted );
+
+	prvRunTasks( pdFALSE );
+
+	return 0;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunTasks( BaseType_t xRecycled )
+{
+HostThread_t *pxHostThread = pxHostThreadOfThisThread;
+ThreadState_t *pxThreadState;
+LONG lRecycleRequested;
+void * volatile pvTaskFrames;
+int lJump;
+
+	/* The thread comes back here each time the task it runs is deleted while
+	it is running or waiting on its yield event. */
+	lJump = setjmp( pxHostThread->xRecycleBuffer );
+
+	if( lJump == portRECYCLE_SELF_DELETED )
+	{
+		/* The task deleted itself from inside a critical section, which
+		vPortCloseRunningThread() leaves to be exited here, now that the thread
+		no longer uses the task's stack.  The kernel may free the stack as soon
+		as the critical section is exited. */
+		while( ulCriticalNesting > portNO_CRITICAL_NESTING )
+		{
+			ulCriticalNesting--;
+			prvUnlockInterrupts();
+		}
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The task lock is released last, which pends the switch again if
+			the simulated interrupt handler could not make it while the lock
+			was held. */
+			while( ulTaskLockNesting > 0UL )
+			{
+				vPortReleaseTaskLock();
+			}
+		}
+		#endif
+	}
+	else if( lJump != 0 )
+	{
+		xRecycled = pdTRUE;
+	}
+
+	if( xRecycled != pdFALSE )
+	{
+		/* The task is no longer running, so the thread is not in a critical
+		section whatever the task was doing when it was deleted. */
+		ulCriticalNesting = portNO_CRITICAL_NESTING;
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			ulTaskLockNesting = 0UL;
+		}
+		#endif
+
+		/* A task that deleted itself has already put its thread back in the
+		pool - see vPortCloseRunningThread() - but vPortDeleteThread() leaves
+		it to the thread, and waits until it is there. */
+		lRecycleRequested = InterlockedExchange( &( pxHostThread->lRecycle ), pdFALSE );
+
+		if( lRecycleRequested != pdFALSE )
+		{
+			prvReturnHostThread( pxHostThread );
+			SetEvent( pvRecycleAcknowledged );
+		}
+	}
+
+	/* The equivalent of the thread being created suspended - wait until a
+	task has been given to the thread and selected to run for the first time.
+	The wait does not return if the task is deleted first. */
+	prvWaitForYieldEvent();
+
+	pxThreadState = pxHostThread->pxThreadState;
+
+	if( pxHostThread->pcTaskStack != NULL )
+	{
+		/* Move the stack pointer down to just below the ThreadState_t, which
+		is at the top of the task's stack, so the task runs on its own stack. */
+		pvTaskFrames = _alloca( ( size_t ) ( ( int8_t * ) &pxThreadState - ( int8_t * ) pxThreadState ) );
+		( void ) pvTaskFrames;
+	}
+
+	pxThreadState->pxCode( pxThreadState->pvParameters );
+
+	/* Tasks must not return from their implementing function, but if one does
+	then delete it rather than leave a task with no thread behind.  This does
+	not return - the thread goes back to the pool. */
+	vTaskDelete( NULL );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRecycleSuspendedThread( void )
+{
+	#if !defined( __x86_64__ ) && !defined( _M_X64 )
+	{
+		/* The handlers registered by the abandoned frames are gone too. */
+		( ( NT_TIB * ) NtCurrentTeb() )->ExceptionList = pxHostThreadOfThisThread->pvExceptionList;
+	}
+	#endif
+
+	/* The frames of the previous call to prvRunTasks() have been abandoned,
+	so this does not make the stack any deeper. */
+	prvRunTasks( pdTRUE );
+}
+/*-----------------------------------------------------------*/
+
+static HostThread_t *prvCreateHostThread( size_t xTaskStackSize )
+{
+HostThread_t *pxHostThread;
+SIZE_T xStackSize;
+
+	/* The frames of the parked thread, the task stack, and what is left for a
+	task that overflows.  Windows rounds the reservation up. */
+	xStackSize = ( SIZE_T ) ( portTASK_STACK_OFFSET + xTaskStackSize + portSTACK_OVERFLOW_SPACE );
+
+	pxHostThread = ( HostThread_t * ) malloc( sizeof( HostThread_t ) );
+	configASSERT( pxHostThread );
+
+	pxHostThread->pxThreadState = NULL;
+	pxHostThread->lRecycle = pdFALSE;
+	pxHostThread->pcTaskStack = NULL;
+	pxHostThread->xTaskStackSize = 0;
+	pxHostThread->pxNext = NULL;
 
 	/* Create the event used to prevent the thread from executing past its yield
 	point if the SuspendThread() call that suspends the thread does not take
 	effect immediately (it is an asynchronous call). */
-	pxThreadState->pvYieldEvent = CreateEvent(  NULL,  /* Default security attributes. */
+	pxHostThread->pvYieldEvent = CreateEvent(  NULL,  /* Default security attributes. */
 												FALSE, /* Auto reset. */
 												FALSE, /* Start not signalled. */
 												NULL );/* No name. */
 
-	/* Create the thread itself. */
-	pxThreadState->pvThread = CreateThread( NULL, xStackSize, ( LPTHREAD_START_ROUTINE ) pxCode, pvParameters, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, NULL );
-	configASSERT( pxThreadState->pvThread ); /* See comment where TerminateThread() is called. */
-	SetThreadAffinityMask( pxThreadState->pvThread, 0x01 );
-	SetThreadPriorityBoost( pxThreadState->pvThread, TRUE );
-	SetThreadPriority( pxThreadState->pvThread, portTASK_THREAD_PRIORITY );
+	/* Create the thread itself.  It is created suspended so it can be
+	confined to the same core as the rest of the simulation before it runs,
+	then waits on its yield event straight away.  With more than one simulated
+	core the threads must be free to run on different host cores. */
+	pxHostThread->pvThread = CreateThread( NULL, xStackSize, prvHostThreadEntry, pxHostThread, CREATE_SUSPENDED | STACK_SIZE_PARAM_IS_A_RESERVATION, &( pxHostThread->dwThreadId ) );
+	configASSERT( pxHostThread->pvThread );
+	#if( configNUMBER_OF_CORES == 1 )
+	{
+		SetThreadAffinityMask( pxHostThread->pvThread, 0x01 );
+	}
+	#endif
+	SetThreadPriorityBoost( pxHostThread->pvThread, TRUE );
+	SetThreadPriority( pxHostThread->pvThread, portTASK_THREAD_PRIORITY );
+	ResumeThread( pxHostThread->pvThread );
+
+	/* Task stacks are placed relative to pvStackTop, so wait until the thread
+	has recorded it. */
+	WaitForSingleObject( pvHostThreadStarted, INFINITE );
+
+	ulHostThreadsCreated++;
+
+	return pxHostThread;
+}
+/*-----------------------------------------------------------*/
+
+static HostThread_t *prvTakeHostThread( size_t xTaskStackSize )
+{
+HostThread_t *pxHostThread;
+HostThread_t **ppxPrevious;
+size_t xRoom;
+
+	AcquireSRWLockExclusive( &xHostThreadPoolLock );
+
+	/* Create the pool the first time a task is created.  These threads start
+	outside the pool, as they have not yet run a task, so put them in it. */
+	if( ulHostThreadsCreated == 0UL )
+	{
+		pvRecycleAcknowledged = CreateEvent( NULL, FALSE, FALSE, NULL );
+		configASSERT( pvRecycleAcknowledged );
+		pvHostThreadStarted = CreateEvent( NULL, FALSE, FALSE, NULL );
+		configASSERT( pvHostThreadStarted );
+
+		#if( configSIMULATOR_THREAD_POOL_SIZE > 0 )
+		{
+			uint32_t ulThread;
+
+			for( ulThread = 0UL; ulThread < configSIMULATOR_THREAD_POOL_SIZE; ulThread++ )
+			{
+				pxHostThread = prvCreateHostThread( ( size_t ) configMINIMAL_STACK_SIZE * sizeof( StackType_t ) );
+				pxHostThread->pxNext = pxHostThreadPool;
+				pxHostThreadPool = pxHostThread;
+			}
+		}
+		#endif
+	}
+
+	/* Take the first thread whose stack has room for the task's stack. */
+	ppxPrevious = &pxHostThreadPool;
+
+	for( pxHostThread = pxHostThreadPool; pxHostThread != NULL; pxHostThread = pxHostThread->pxNext )
+	{
+		xRoom = ( size_t ) ( ( int8_t * ) pxHostThread->pvStackTop - pxHostThread->pcStackLimit );
+
+		if( xRoom >= ( portTASK_STACK_OFFSET + xTaskStackSize + portSTACK_OVERFLOW_SPACE ) )
+		{
+			*ppxPrevious = pxHostThread->pxNext;
+			break;
+		}
+
+		ppxPrevious = &( pxHostThread->pxNext );
+	}
+
+	if( pxHostThread == NULL )
+	{
+		/* More tasks exist than there have ever been threads, or the task
+		needs a bigger stack than any parked thread has, so the pool grows by
+		one. */
+		pxHostThread = prvCreateHostThread( xTaskStackSize );
+	}
+
+	ReleaseSRWLockExclusive( &xHostThreadPoolLock );
+
+	return pxHostThread;
+}
+/*-----------------------------------------------------------*/
+
+static void prvReturnHostThread( HostThread_t *pxHostThread )
+{
+	pxHostThread->pxThreadState = NULL;
+
+	/* If the task was resumed and then suspended again before the thread got
+	as far as waiting on its event, the event is still set.  Nothing sets the
+	event of a thread that has no task, so clear it rather than let the next
+	task on this thread start early. */
+	ResetEvent( pxHostThread->pvYieldEvent );
+
+	AcquireSRWLockExclusive( &xHostThreadPoolLock );
+
+	if( pxHostThread->pcTaskStack != NULL )
+	{
+		pxHostThread->pxNext = pxTaskStackThreads;
+		pxTaskStackThreads = pxHostThread;
+	}
+	else
+	{
+		pxHostThread->pxNext = pxHostThreadPool;
+		pxHostThreadPool = pxHostThread;
+	}
+
+	ReleaseSRWLockExclusive( &xHostThreadPoolLock );
+}
+/*-----------------------------------------------------------*/
+
+static void prvWaitForYieldEvent( void )
+{
+HostThread_t *pxHostThread = pxHostThreadOfThisThread;
+
+	WaitForSingleObject( pxHostThread->pvYieldEvent, INFINITE );
+
+	/* vPortDeleteThread() sets the event to send the thread back to the pool
+	rather than to run. */
+	if( pxHostThread->lRecycle != pdFALSE )
+	{
+		longjmp( pxHostThread->xRecycleBuffer, portRECYCLE_DELETED );
+	}
+}
+/*-----------------------------------------------------------*/
+
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+ThreadState_t *pxThreadState = NULL;
+HostThread_t *pxHostThread;
+HostThread_t **ppxPrevious;
+int8_t *pcTopOfStack = ( int8_t * ) pxTopOfStack;
+
+	/* In this simulated case a stack is not initialised, but instead a thread
+	is given the task to execute.  The thread handles the context switching
+	itself.  The ThreadState_t object is placed at the top of the stack that
+	was created for the task.  If pvPortMallocStack() allocated the stack the
+	thread runs the task on the rest of it, otherwise it will not be used for
+	anything other than holding this structure. */
+	pxThreadState = ( ThreadState_t * ) ( pcTopOfStack - sizeof( ThreadState_t ) );
+	pxThreadState->pxCode = pxCode;
+	pxThreadState->pvParameters = pvParameters;
+
+	/* The thread is parked on its yield event, so the simulated interrupt
+	handler must set the event the first time the task is selected. */
+	pxThreadState->lWaiting = pdTRUE;
+	pxThreadState->xSuspended = pdFALSE;
+
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		pxThreadState->xCoreID = 0;
+	}
+	#endif
+
+	/* Give the task to a parked thread.  The thread reads the task from
+	pxThreadState after its event is set.  A task that creates a task must not
+	be suspended while it holds xHostThreadPoolLock, as the lock would then be
+	held until the task runs again. */
+	portENTER_CRITICAL();
+	{
+		/* A stack allocated by pvPortMallocStack() belongs to a thread that is
+		waiting for the task in pxTaskStackThreads.  The kernel may reuse a
+		stack for another task without freeing it, so the stack is found from
+		any address in it. */
+		AcquireSRWLockExclusive( &xHostThreadPoolLock );
+		ppxPrevious = &pxTaskStackThreads;
+
+		for( pxHostThread = pxTaskStackThreads; pxHostThread != NULL; pxHostThread = pxHostThread->pxNext )
+		{
+			if( ( pcTopOfStack > pxHostThread->pcTaskStack ) && ( pcTopOfStack <= ( pxHostThread->pcTaskStack + pxHostThread->xTaskStackSize ) ) )
+			{
+				*ppxPrevious = pxHostThread->pxNext;
+				break;
+			}
+
+			ppxPrevious = &( pxHostThread->pxNext );
+		}
+
+		ReleaseSRWLockExclusive( &xHostThreadPoolLock );
+
+		if( pxHostThread == NULL )
+		{
+			pxHostThread = prvTakeHostThread( 0 );
+		}
+
+		pxHostThread->pxThreadState = pxThreadState;
+	}
+	portEXIT_CRITICAL();
+
+	pxThreadState->pxHostThread = pxHostThread;
+	pxThreadState->pvThread = pxHostThread->pvThread;
+	pxThreadState->dwThreadId = pxHostThread->dwThreadId;
+	pxThreadState->pvYieldEvent = pxHostThread->pvYieldEvent;
 
 	return ( StackType_t * ) pxThreadState;
 }
 /*-----------------------------------------------------------*/
 
+uint32_t ulPortGetHostThreadCount( void )
+{
+	return ulHostThreadsCreated;
+}
+/*-----------------------------------------------------------*/
+
+#if( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+
+	void *pvPortMallocStack( size_t xSize )
+	{
+	HostThread_t *pxHostThread;
+	int8_t *pcStack;
+	void *pvCommitted;
+	DWORD dwOldProtection;
+	BOOL xProtected;
+
+		/* Remove compiler warnings if configASSERT() is not defined. */
+		( void ) pvCommitted;
+		( void ) xProtected;
+
+		/* As in pxPortInitialiseStack(), the task must not be suspended while
+		it holds xHostThreadPoolLock. */
+		portENTER_CRITICAL();
+		{
+			pxHostThread = prvTakeHostThread( xSize );
+
+			/* The stack starts on a page boundary, so the guard page below is
+			right next to it. */
+			pcStack = ( int8_t * ) ( ( ( size_t ) pxHostThread->pvStackTop - portTASK_STACK_OFFSET - xSize ) & ~( portHOST_PAGE_SIZE - 1 ) );
+
+			/* The kernel fills the stack from this thread, and only the
+			thread that owns a stack can grow it through its guard page, so
+			commit everything from the bottom of the task's stack up to where
+			the thread is parked.  That also clears any guard page left inside
+			it by an earlier task. */
+			pvCommitted = VirtualAlloc( pcStack, ( SIZE_T ) ( ( int8_t * ) pxHostThread->pvStackTop - pcStack ), MEM_COMMIT, PAGE_READWRITE );
+			configASSERT( pvCommitted );
+			xProtected = VirtualProtect( pcStack, ( SIZE_T ) ( ( int8_t * ) pxHostThread->pvStackTop - pcStack ), PAGE_READWRITE, &dwOldProtection );
+			configASSERT( xProtected );
+
+			/* Then make the page below the task's stack the guard page, so a
+			task that overflows grows its thread's stack into
+			portSTACK_OVERFLOW_SPACE, and only a task that overflows that too
+			raises EXCEPTION_STACK_OVERFLOW. */
+			pvCommitted = VirtualAlloc( pcStack - portHOST_PAGE_SIZE, portHOST_PAGE_SIZE, MEM_COMMIT, PAGE_READWRITE | PAGE_GUARD );
+			configASSERT( pvCommitted );
+			xProtected = VirtualProtect( pcStack - portHOST_PAGE_SIZE, portHOST_PAGE_SIZE, PAGE_READWRITE | PAGE_GUARD, &dwOldProtection );
+			configASSERT( xProtected );
+
+			pxHostThread->pcTaskStack = pcStack;
+			pxHostThread->xTaskStackSize = xSize;
+
+			/* The thread waits for its task in pxTaskStackThreads. */
+			AcquireSRWLockExclusive( &xHostThreadPoolLock );
+			pxHostThread->pxNext = pxTaskStackThreads;
+			pxTaskStackThreads = pxHostThread;
+			ReleaseSRWLockExclusive( &xHostThreadPoolLock );
+		}
+		portEXIT_CRITICAL();
+
+		return ( void * ) pcStack;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortFreeStack( void *pv )
+	{
+	HostThread_t *pxHostThread;
+	HostThread_t **ppxPrevious;
+
+		portENTER_CRITICAL();
+		{
+			/* The thread has no task, because the task was deleted or never
+			created, so it is in pxTaskStackThreads.  Now that nothing can use
+			the stack it can go back in the pool. */
+			AcquireSRWLockExclusive( &xHostThreadPoolLock );
+			ppxPrevious = &pxTaskStackThreads;
+
+			for( pxHostThread = pxTaskStackThreads; pxHostThread != NULL; pxHostThread = pxHostThread->pxNext )
+			{
+				if( pxHostThread->pcTaskStack == ( int8_t * ) pv )
+				{
+					*ppxPrevious = pxHostThread->pxNext;
+					pxHostThread->pcTaskStack = NULL;
+					pxHostThread->xTaskStackSize = 0;
+					pxHostThread->pxNext = pxHostThreadPool;
+					pxHostThreadPool = pxHostThread;
+					break;
+				}
+
+				ppxPrevious = &( pxHostThread->pxNext );
+			}
+
+			ReleaseSRWLockExclusive( &xHostThreadPoolLock );
+
+			configASSERT( pxHostThread );
+		}
+		portEXIT_CRITICAL();
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configSTACK_ALLOCATION_FROM_SEPARATE_HEAP */
+
+#if( configCHECK_FOR_STACK_OVERFLOW > 0 )
+
+	static LONG WINAPI prvStackOverflowHandler( PEXCEPTION_POINTERS pxExceptionInfo )
+	{
+		/* Overflows that stay within portSTACK_OVERFLOW_SPACE are found by the
+		kernel when the task is switched out. */
+		if( ( pxExceptionInfo->ExceptionRecord->ExceptionCode == EXCEPTION_STACK_OVERFLOW ) && ( portTHREAD_STATE_OF_THIS_THREAD() != NULL ) )
+		{
+			vApplicationStackOverflowHook( xTaskGetCurrentTaskHandle(), pcTaskGetName( NULL ) );
+		}
+
+		return EXCEPTION_CONTINUE_SEARCH;
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configCHECK_FOR_STACK_OVERFLOW */
+
 BaseType_t xPortStartScheduler( void )
 {
 void *pvHandle = NULL;
 int32_t lSuccess;
-ThreadState_t *pxThreadState = NULL;
 SYSTEM_INFO xSystemInfo;
 
 	/* This port runs windows threads with extremely high priority.  All the
@@ -286,16 +1267,79 @@ SYSTEM_INFO xSystemInfo;
 		vPortSetInterruptHandler( portINTERRUPT_YIELD, prvProcessYieldInterrupt );
 		vPortSetInterruptHandler( portINTERRUPT_TICK, prvProcessTickInterrupt );
 
+		#if( configCHECK_FOR_STACK_OVERFLOW > 0 )
+		{
+			AddVectoredExceptionHandler( 1, prvStackOverflowHandler );
+		}
+		#endif
+
 		/* Create the events and mutexes that are used to synchronise all the
 		threads. */
-		pvInterruptEventMutex = CreateMutex( NULL, FALSE, NULL );
+		#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+		{
+			xInterruptLock.pvParkEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+			if( xInterruptLock.pvParkEvent == NULL )
+			{
+				lSuccess = pdFAIL;
+			}
+		}
+		#else
+		{
+			pvInterruptEventMutex = CreateMutex( NULL, FALSE, NULL );
+
+			if( pvInterruptEventMutex == NULL )
+			{
+				lSuccess = pdFAIL;
+			}
+		}
+		#endif
+
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+			{
+				xTaskLock.pvParkEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+				if( xTaskLock.pvParkEvent == NULL )
+				{
+					lSuccess = pdFAIL;
+				}
+			}
+			#else
+			{
+				pvTaskLockMutex = CreateMutex( NULL, FALSE, NULL );
+
+				if( pvTaskLockMutex == NULL )
+				{
+					lSuccess = pdFAIL;
+				}
+			}
+			#endif
+
+			dwSimulatedInterruptThreadId = GetCurrentThreadId();
+		}
+		#endif
+
 		pvInterruptEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
+		pvTickTimerEvent = CreateEvent( NULL, FALSE, FALSE, NULL );
 
-		if( ( pvInterruptEventMutex == NULL ) || ( pvInterruptEvent == NULL ) )
+		if( ( pvInterruptEvent == NULL ) || ( pvTickTimerEvent == NULL ) )
 		{
 			lSuccess = pdFAIL;
 		}
 
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			pvTicklessIdleComplete = CreateEvent( NULL, FALSE, FALSE, NULL );
+
+			if( pvTicklessIdleComplete == NULL )
+			{
+				lSuccess = pdFAIL;
+			}
+		}
+		#endif
+
 		/* Set the priority of this thread such that it is above the priority of
 		the threads that run tasks.  This higher priority is required to ensure
 		simulated interrupts take priority over tasks. */
@@ -313,34 +1357,46 @@ SYSTEM_INFO xSystemInfo;
 			lSuccess = pdFAIL;
 		}
 		SetThreadPriorityBoost( pvHandle, TRUE );
-		SetThreadAffinityMask( pvHandle, 0x01 );
+
+		#if( configNUMBER_OF_CORES == 1 )
+		{
+			SetThreadAffinityMask( pvHandle, 0x01 );
+		}
+		#endif
 	}
 
 	if( lSuccess == pdPASS )
 	{
 		/* Start the thread that simulates the timer peripheral to generate
 		tick interrupts.  The priority is set below that of the simulated
-		interrupt handler so the interrupt event mutex is used for the
-		handshake / overrun protection. */
-		pvHandle = CreateThread( NULL, 0, prvSimulatedPeripheralTimer, NULL, CREATE_SUSPENDED, NULL );
-		if( pvHandle != NULL )
+		interrupt handler so the interrupt lock is used for the
+		handshake / overrun protection.  In virtual time the tick is only
+		advanced by the idle task, see vPortSuppressTicksAndSleep(), so the
+		thread is not needed. */
+		#if( configSIMULATOR_VIRTUAL_TIME == 0 )
 		{
-			SetThreadPriority( pvHandle, portSIMULATED_TIMER_THREAD_PRIORITY );
-			SetThreadPriorityBoost( pvHandle, TRUE );
-			SetThreadAffinityMask( pvHandle, 0x01 );
-			ResumeThread( pvHandle );
+			pvHandle = CreateThread( NULL, 0, prvSimulatedPeripheralTimer, NULL, CREATE_SUSPENDED, NULL );
+			if( pvHandle != NULL )
+			{
+				SetThreadPriority( pvHandle, portSIMULATED_TIMER_THREAD_PRIORITY );
+				SetThreadPriorityBoost( pvHandle, TRUE );
+
+				#if( configNUMBER_OF_CORES == 1 )
+				{
+					SetThreadAffinityMask( pvHandle, 0x01 );
+				}
+				#endif
+
+				ResumeThread( pvHandle );
+			}
 		}
+		#endif
 
-		/* Start the highest priority task by obtaining its associated thread
-		state structure, in which is stored the thread handle. */
-		pxThreadState = ( ThreadState_t * ) *( ( size_t * ) pxCurrentTCB );
 		ulCriticalNesting = portNO_CRITICAL_NESTING;
 
-		/* Start the first task. */
-		ResumeThread( pxThreadState->pvThread );
-
 		/* Handle all simulated interrupts - including yield requests and
-		simulated ticks. */
+		simulated ticks.  The highest priority task is started by the first
+		interrupt that is processed. */
 		prvProcessSimulatedInterrupts();
 	}
 
@@ -352,140 +1408,502 @@ SYSTEM_INFO xSystemInfo;
 
 static uint32_t prvProcessYieldInterrupt( void )
 {
-	/* Always return true as this is a yield. */
-	return pdTRUE;
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* The cores to switch are marked in ulYieldRequestCores, and a yield
+		is not a request to switch core 0 in particular. */
+		return pdFALSE;
+	}
+	#else
+	{
+		/* Always return true as this is a yield. */
+		return pdTRUE;
+	}
+	#endif
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvProcessTickInterrupt( void )
+{
+uint32_t ulSwitchRequired = pdFALSE;
+LONG lTicks;
+
+	configASSERT( xPortRunning );
+
+	/* Take every tick generated since the handler last executed.  This is
+	zero if the ticks were already taken by the previous execution of the
+	handler, which can happen because pending interrupts are not counted. */
+	lTicks = InterlockedExchange( &lTicksToProcess, 0L );
+
+	#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+	{
+		InterlockedExchangeAdd64( &llVirtualTicks, ( LONG64 ) lTicks );
+	}
+	#endif
+
+	/* Normally there is one tick to process, but if the host fell behind
+	then the ticks that were missed are delivered here in one batch rather
+	than being lost.  This is what xTaskCatchUpTicks() does, but that cannot
+	be called from a simulated interrupt as vTaskSuspendAll() waits for
+	xInsideInterrupt to be cleared. */
+	while( lTicks > 0L )
+	{
+		if( xTaskIncrementTick() != pdFALSE )
+		{
+			ulSwitchRequired = pdTRUE;
+		}
+
+		lTicks--;
+	}
+
+	return ulSwitchRequired;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetMissedTickCount( void )
+{
+	return ulMissedTicks;
+}
+/*-----------------------------------------------------------*/
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	TickType_t xTicksToStep, xTicksToDeliver = 0;
+
+		/* Called by the idle task with the scheduler suspended.  Disable
+		(simulated) interrupts, as the port for a real target would while it
+		reprograms the tick timer, then check a task has not been made ready
+		since the scheduler was suspended. */
+		portDISABLE_INTERRUPTS();
+
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+		{
+			prvAdvanceVirtualTime( xExpectedIdleTime );
+			portENABLE_INTERRUPTS();
+			return;
+		}
+		#endif
+
+		/* Ask the tick thread to stop generating ticks and sleep instead.
+		Interrupts are pended without holding the interrupt lock, so the
+		request is registered before ulPendingInterrupts is checked, while an
+		interrupt is pended before checking for a request - so either an
+		interrupt raised at the same time is seen here, or the thread that
+		raised it sees the request and ends the period. */
+		xTicklessIdleTime = xExpectedIdleTime;
+		InterlockedExchange( &lTicklessIdleAbort, pdFALSE );
+		InterlockedExchange( &lTicklessIdleState, portTICKLESS_IDLE_REQUESTED );
+
+		if( ulPendingInterrupts != 0UL )
+		{
+			InterlockedExchange( &lTicklessIdleAbort, pdTRUE );
+		}
+
+		SetEvent( pvTickTimerEvent );
+
+		/* Sleep until the tick thread wakes.  Simulated interrupts are enabled
+		while sleeping so they can execute, and end the sleep, but they cannot
+		cause a context switch as the scheduler is suspended. */
+		portENABLE_INTERRUPTS();
+		WaitForSingleObject( pvTicklessIdleComplete, INFINITE );
+		portDISABLE_INTERRUPTS();
+
+		InterlockedExchange( &lTicklessIdleState, portTICKLESS_IDLE_INACTIVE );
+
+		/* Step the tick count forward by the tick periods that elapsed.  The
+		tick count must not be stepped to or beyond the time the next task
+		unblocks, so the last period (and any overrun) is delivered as a tick
+		interrupt instead, which unblocks the task as normal. */
+		xTicksToStep = xTicklessIdleElapsed;
+
+		if( xTicksToStep >= xExpectedIdleTime )
+		{
+			xTicksToDeliver = xTicksToStep - ( xExpectedIdleTime - 1 );
+			xTicksToStep = xExpectedIdleTime - 1;
+		}
+
+		if( xTicksToStep > 0 )
+		{
+			vTaskStepTick( xTicksToStep );
+		}
+
+		if( xTicksToDeliver > 0 )
+		{
+			InterlockedExchangeAdd( &lTicksToProcess, ( LONG ) xTicksToDeliver );
+			vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+		}
+
+		portENABLE_INTERRUPTS();
+	}
+	/*-----------------------------------------------------------*/
+
+	#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+		static void prvAdvanceVirtualTime( TickType_t xExpectedIdleTime )
+		{
+			/* An interrupt raised by another Windows thread, a simulated
+			peripheral for example, executes before time moves on. */
+			if( ulPendingInterrupts != 0UL )
+			{
+				return;
+			}
+
+			if( ( TickType_t ) ( xTaskGetTickCount() + xExpectedIdleTime ) != portMAX_DELAY )
+			{
+				/* Every task is blocked, so nothing happens before the next task
+				unblocks - jump straight to that time.  The tick count is
+				stepped to the period before, and the last period is delivered
+				as a tick interrupt, which unblocks the task as normal. */
+				if( xExpectedIdleTime > 1 )
+				{
+					vTaskStepTick( xExpectedIdleTime - 1 );
+					InterlockedExchangeAdd64( &llVirtualTicks, ( LONG64 ) ( xExpectedIdleTime - 1 ) );
+				}
+
+				InterlockedExchangeAdd( &lTicksToProcess, 1L );
+				vPortGenerateSimulatedInterrupt( portINTERRUPT_TICK );
+			}
+			else
+			{
+				/* The next unblock time is portMAX_DELAY when no task is
+				waiting for a time, only for an event, so only an interrupt
+				from outside the simulation can unblock one.  Wait for it
+				without moving time on.  The request is registered before
+				ulPendingInterrupts is checked, as in
+				vPortSuppressTicksAndSleep(), so an interrupt raised at the
+				same time is not missed. */
+				InterlockedExchange( &lTicklessIdleAbort, pdFALSE );
+				InterlockedExchange( &lTicklessIdleState, portTICKLESS_IDLE_SLEEPING );
+
+				if( ulPendingInterrupts == 0UL )
+				{
+					portENABLE_INTERRUPTS();
+
+					while( lTicklessIdleAbort == pdFALSE )
+					{
+						WaitForSingleObject( pvTickTimerEvent, INFINITE );
+					}
+
+					portDISABLE_INTERRUPTS();
+				}
+
+				InterlockedExchange( &lTicklessIdleState, portTICKLESS_IDLE_INACTIVE );
+			}
+		}
+		/*-----------------------------------------------------------*/
+
+		uint64_t ullPortGetVirtualTime( void )
+		{
+		uint64_t ullTicks = ( uint64_t ) InterlockedCompareExchange64( &llVirtualTicks, 0LL, 0LL );
+
+			/* Split the calculation so the intermediate values cannot
+			overflow. */
+			return ( ( ullTicks / configTICK_RATE_HZ ) * 1000000000ULL ) + ( ( ( ullTicks % configTICK_RATE_HZ ) * 1000000000ULL ) / configTICK_RATE_HZ );
+		}
+		/*-----------------------------------------------------------*/
+
+	#endif /* configSIMULATOR_VIRTUAL_TIME */
+
+	static void prvAbortTicklessIdle( void )
+	{
+		if( lTicklessIdleState != portTICKLESS_IDLE_INACTIVE )
+		{
+			InterlockedExchange( &lTicklessIdleAbort, pdTRUE );
+			SetEvent( pvTickTimerEvent );
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	uint32_t ulPortGetSuppressedTicksPerSecond( void )
+	{
+		return ulSuppressedTicksPerSecond;
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+static void prvSwitchOutThread( void *pvOldCurrentTCB )
+{
+ThreadState_t *pxThreadState;
+CONTEXT xContext;
+
+	/* If the old task blocked or yielded then its thread has already marked
+	itself as waiting on its yield event and there is nothing to do.
+	Otherwise the task was switched out asynchronously (by a tick for
+	example), so mark it as waiting and suspend it.  pvThread can be NULL if
+	the task deleted itself. */
+	pxThreadState = ( ThreadState_t *) *( ( size_t * ) pvOldCurrentTCB );
+
+	if( ( pxThreadState->pvThread != NULL ) && ( InterlockedCompareExchange( &( pxThreadState->lWaiting ), pdTRUE, pdFALSE ) == pdFALSE ) )
+	{
+		SuspendThread( pxThreadState->pvThread );
+		pxThreadState->xSuspended = pdTRUE;
+
+		/* Ensure the thread is actually suspended by performing a synchronous
+		operation that can only complete when the thread is actually
+		suspended.  The below code asks for dummy register data.
+		Experimentation shows that these two lines don't appear to do anything
+		now, but according to
+		https://devblogs.microsoft.com/oldnewthing/20150205-00/?p=44743
+		they do - so as they do not harm (slight run-time hit). */
+		xContext.ContextFlags = CONTEXT_INTEGER;
+		( void ) GetThreadContext( pxThreadState->pvThread, &xContext );
+	}
 }
 /*-----------------------------------------------------------*/
 
-static uint32_t prvProcessTickInterrupt( void )
-{
-uint32_t ulSwitchRequired;
+static void prvResumeThread( ThreadState_t *pxThreadState )
+{
+	/* pxThreadState->pvThread can be NULL if the task deleted itself - but
+	a deleted task should never be resumed here. */
+	configASSERT( pxThreadState->pvThread != NULL );
+
+	InterlockedExchange( &( pxThreadState->lWaiting ), pdFALSE );
+
+	if( pxThreadState->xSuspended != pdFALSE )
+	{
+		pxThreadState->xSuspended = pdFALSE;
+		ResumeThread( pxThreadState->pvThread );
+	}
+	else
+	{
+		SetEvent( pxThreadState->pvYieldEvent );
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configNUMBER_OF_CORES > 1 )
+
+	static void prvSwitchCores( void )
+	{
+	uint32_t ulCores;
+	BaseType_t xCoreID, xLocked;
+	void *pvOldCurrentTCB;
+	ThreadState_t *pxThreadState;
+
+		ulCores = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulYieldRequestCores, 0L );
+		xLocked = prvTryLockTasks();
+
+		if( xLocked == pdFALSE )
+		{
+			/* A task holds the task lock, so the switches are left for the
+			task to pend again when it releases the lock.  It may have released
+			the lock before it could see them, so try once more. */
+			InterlockedOr( ( volatile LONG * ) &ulYieldRequestCores, ( LONG ) ulCores );
+			xLocked = prvTryLockTasks();
+
+			if( xLocked != pdFALSE )
+			{
+				ulCores = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulYieldRequestCores, 0L );
+			}
+		}
+
+		if( xLocked != pdFALSE )
+		{
+			for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+			{
+				if( ( ulCores & ( 1UL << xCoreID ) ) != 0UL )
+				{
+					/* The kernel selects the task for the core this thread
+					is acting for. */
+					xInterruptCoreID = xCoreID;
+					pvOldCurrentTCB = pxCurrentTCBs[ xCoreID ];
+					vTaskSwitchContext( xCoreID );
+
+					/* The old thread is stopped before the next core is
+					switched, as the task may be selected to run on it. */
+					if( pvOldCurrentTCB != pxCurrentTCBs[ xCoreID ] )
+					{
+						prvSwitchOutThread( pvOldCurrentTCB );
+					}
 
-	/* Process the tick itself. */
-	configASSERT( xPortRunning );
-	ulSwitchRequired = ( uint32_t ) xTaskIncrementTick();
+					pxThreadState = ( ThreadState_t * ) *( ( size_t * ) pxCurrentTCBs[ xCoreID ] );
+					pxThreadState->xCoreID = xCoreID;
+				}
+			}
 
-	return ulSwitchRequired;
-}
-/*-----------------------------------------------------------*/
+			xInterruptCoreID = 0;
+			prvUnlockTasks();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_CORES */
 
 static void prvProcessSimulatedInterrupts( void )
 {
-uint32_t ulSwitchRequired, i;
-ThreadState_t *pxThreadState;
-void *pvObjectList[ 2 ];
-CONTEXT xContext;
-
-	/* Going to block on the mutex that ensured exclusive access to the simulated
-	interrupt objects, and the event that signals that a simulated interrupt
-	should be processed. */
-	pvObjectList[ 0 ] = pvInterruptEventMutex;
-	pvObjectList[ 1 ] = pvInterruptEvent;
+uint32_t ulSwitchRequired, ulInterrupts, i;
+#if( configNUMBER_OF_CORES == 1 )
+	ThreadState_t *pxThreadState;
+	LONG lWaiting;
+#else
+	ThreadState_t *pxThreadStates[ configNUMBER_OF_CORES ];
+	LONG lWaiting[ configNUMBER_OF_CORES ];
+	BaseType_t xCoreID;
+	uint32_t ulDeferredCores;
+#endif
 
-	/* Create a pending tick to ensure the first task is started as soon as
-	this thread pends. */
-	ulPendingInterrupts |= ( 1 << portINTERRUPT_TICK );
-	SetEvent( pvInterruptEvent );
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		/* Create a pending yield of every core to ensure the first tasks are
+		started as soon as this thread pends. */
+		ulYieldRequestCores = ( uint32_t ) ( ( 1ULL << configNUMBER_OF_CORES ) - 1ULL );
+		InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_YIELD ) );
+	}
+	#else
+	{
+		/* Create a pending tick to ensure the first task is started as soon as
+		this thread pends. */
+		InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_TICK ) );
+	}
+	#endif
 
 	xPortRunning = pdTRUE;
 
 	for(;;)
 	{
-		xInsideInterrupt = pdFALSE;
-		WaitForMultipleObjects( sizeof( pvObjectList ) / sizeof( void * ), pvObjectList, TRUE, INFINITE );
+		/* Wait for an interrupt to be raised.  This thread takes every
+		interrupt that is pending each time it runs, so the event can be left
+		set when there is nothing left to process. */
+		if( ulPendingInterrupts == 0UL )
+		{
+			WaitForSingleObject( pvInterruptEvent, INFINITE );
+		}
 
-		/* Cannot be in a critical section to get here.  Tasks that exit a
-		critical section will block on a yield mutex to wait for an interrupt to
-		process if an interrupt was set pending while the task was inside the
-		critical section.  xInsideInterrupt prevents interrupts that contain
-		critical sections from doing the same. */
+		/* Interrupts are pended without holding the lock, but cannot be
+		processed while a task is in a critical section.  Tasks that exit a
+		critical section will block on a yield event to wait for an interrupt
+		to process if an interrupt was set pending while the task was inside
+		the critical section.  xInsideInterrupt prevents interrupts that
+		contain critical sections from doing the same. */
+		prvLockInterrupts();
 		xInsideInterrupt = pdTRUE;
 
-		/* Used to indicate whether the simulated interrupt processing has
-		necessitated a context switch to another task/thread. */
-		ulSwitchRequired = pdFALSE;
-
-		/* For each interrupt we are interested in processing, each of which is
-		represented by a bit in the 32bit ulPendingInterrupts variable. */
-		for( i = 0; i < portMAX_INTERRUPTS; i++ )
+		do
 		{
-			/* Is the simulated interrupt pending? */
-			if( ( ulPendingInterrupts & ( 1UL << i ) ) != 0 )
+			/* Take all the pending interrupts in one go, then process them.
+			Interrupts raised while they are being processed are taken the
+			next time around the loop. */
+			while( ( ulInterrupts = ( uint32_t ) InterlockedExchange( ( volatile LONG * ) &ulPendingInterrupts, 0L ) ) != 0UL )
 			{
-				/* Is a handler installed? */
-				if( ulIsrHandler[ i ] != NULL )
+				/* Used to indicate whether the simulated interrupt processing
+				has necessitated a context switch to another task/thread. */
+				ulSwitchRequired = pdFALSE;
+
+				/* For each interrupt we are interested in processing, each of
+				which is represented by a bit in the 32bit ulInterrupts
+				variable. */
+				for( i = 0; i < portMAX_INTERRUPTS; i++ )
 				{
-					/* Run the actual handler.  Handlers return pdTRUE if they
-					necessitate a context switch. */
-					if( ulIsrHandler[ i ]() != pdFALSE )
+					/* Is the simulated interrupt pending and is a handler
+					installed? */
+					if( ( ( ulInterrupts & ( 1UL << i ) ) != 0 ) && ( ulIsrHandler[ i ] != NULL ) )
 					{
-						/* A bit mask is used purely to help debugging. */
-						ulSwitchRequired |= ( 1 << i );
+						/* Run the actual handler.  Handlers return pdTRUE if
+						they necessitate a context switch. */
+						if( ulIsrHandler[ i ]() != pdFALSE )
+						{
+							/* A bit mask is used purely to help debugging. */
+							ulSwitchRequired |= ( 1 << i );
+						}
 					}
 				}
 
-				/* Clear the interrupt pending bit. */
-				ulPendingInterrupts &= ~( 1UL << i );
-			}
-		}
+				#if( configNUMBER_OF_CORES > 1 )
+				{
+					/* The handlers ran as the interrupts of core 0, so a
+					switch they request is a switch of core 0. */
+					if( ulSwitchRequired != pdFALSE )
+					{
+						InterlockedOr( ( volatile LONG * ) &ulYieldRequestCores, 1L );
+					}
 
-		if( ulSwitchRequired != pdFALSE )
-		{
-			void *pvOldCurrentTCB;
+					if( ulYieldRequestCores != 0UL )
+					{
+						prvSwitchCores();
+					}
+				}
+				#else
+				{
+					if( ulSwitchRequired != pdFALSE )
+					{
+						void *pvOldCurrentTCB;
 
-			pvOldCurrentTCB = pxCurrentTCB;
+						pvOldCurrentTCB = pxCurrentTCB;
 
-			/* Select the next task to run. */
-			vTaskSwitchContext();
+						/* Select the next task to run. */
+						vTaskSwitchContext();
+
+						/* If the task selected to enter the running state is
+						not the task that is already in the running state. */
+						if( pvOldCurrentTCB != pxCurrentTCB )
+						{
+							prvSwitchOutThread( pvOldCurrentTCB );
+						}
+					}
+				}
+				#endif /* configNUMBER_OF_CORES */
+			}
 
-			/* If the task selected to enter the running state is not the task
-			that is already in the running state. */
-			if( pvOldCurrentTCB != pxCurrentTCB )
+			/* A task that yields pends the interrupt before marking itself as
+			waiting, so if the task that is about to run is waiting then the
+			interrupt it raised has either been processed already or is pending
+			now.  Check again so the task cannot continue past its yield point
+			before the yield has been processed. */
+			#if( configNUMBER_OF_CORES > 1 )
 			{
-				/* Suspend the old thread.  In the cases where the (simulated)
-				interrupt is asynchronous (tick event swapping a task out rather
-				than a task blocking or yielding) it doesn't matter if the
-				'suspend' operation doesn't take effect immediately - if it
-				doesn't it would just be like the interrupt occurring slightly
-				later.  In cases where the yield was caused by a task blocking
-				or yielding then the task will block on a yield event after the
-				yield operation in case the 'suspend' operation doesn't take
-				effect immediately.  */
-				pxThreadState = ( ThreadState_t *) *( ( size_t * ) pvOldCurrentTCB );
-				SuspendThread( pxThreadState->pvThread );
+				for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+				{
+					pxThreadStates[ xCoreID ] = ( ThreadState_t * ) ( *( size_t *) pxCurrentTCBs[ xCoreID ] );
+					lWaiting[ xCoreID ] = InterlockedCompareExchange( &( pxThreadStates[ xCoreID ]->lWaiting ), pdTRUE, pdTRUE );
+				}
+			}
+			#else
+			{
+				pxThreadState = ( ThreadState_t * ) ( *( size_t *) pxCurrentTCB );
+				lWaiting = InterlockedCompareExchange( &( pxThreadState->lWaiting ), pdTRUE, pdTRUE );
+			}
+			#endif
 
-				/* Ensure the thread is actually suspended by performing a
-				synchronous operation that can only complete when the thread is
-				actually suspended.  The below code asks for dummy register
-				data.  Experimentation shows that these two lines don't appear
-				to do anything now, but according to
-				https://devblogs.microsoft.com/oldnewthing/20150205-00/?p=44743
-				they do - so as they do not harm (slight run-time hit). */
-				xContext.ContextFlags = CONTEXT_INTEGER;
-				( void ) GetThreadContext( pxThreadState->pvThread, &xContext );
+		} while( ulPendingInterrupts != 0UL );
 
-				/* Obtain the state of the task now selected to enter the
-				Running state. */
-				pxThreadState = ( ThreadState_t * ) ( *( size_t *) pxCurrentTCB );
+		/* If the thread that is about to run stopped running because it
+		yielded, blocked or was switched out then let it continue now that it
+		is valid for it to do so. */
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The task of a core whose switch could not be made yet must not
+			run past its yield point, so it is left waiting until the switch
+			is made. */
+			ulDeferredCores = ( uint32_t ) InterlockedCompareExchange( ( volatile LONG * ) &ulYieldRequestCores, 0L, 0L );
 
-				/* pxThreadState->pvThread can be NULL if the task deleted
-				itself - but a deleted task should never be resumed here. */
-				configASSERT( pxThreadState->pvThread != NULL );
-				ResumeThread( pxThreadState->pvThread );
+			for( xCoreID = 0; xCoreID < configNUMBER_OF_CORES; xCoreID++ )
+			{
+				if( ( lWaiting[ xCoreID ] != pdFALSE ) && ( ( ulDeferredCores & ( 1UL << xCoreID ) ) == 0UL ) )
+				{
+					prvResumeThread( pxThreadStates[ xCoreID ] );
+				}
+			}
+		}
+		#else
+		{
+			if( lWaiting != pdFALSE )
+			{
+				prvResumeThread( pxThreadState );
 			}
 		}
+		#endif
 
-		/* If the thread that is about to be resumed stopped running
-		because it yielded then it will wait on an event when it resumed
-		(to ensure it does not continue running after the call to
-		SuspendThread() above as SuspendThread() is asynchronous).
-		Signal the event to ensure the thread can proceed now it is
-		valid for it to do so.  Signaling the event is benign in the case that
-		the task was switched out asynchronously by an interrupt as the event
-		is reset before the task blocks on it. */
-		pxThreadState = ( ThreadState_t * ) ( *( size_t *) pxCurrentTCB );
-		SetEvent( pxThreadState->pvYieldEvent );
-		ReleaseMutex( pvInterruptEventMutex );
+		xInsideInterrupt = pdFALSE;
+		prvUnlockInterrupts();
 	}
 }
 /*-----------------------------------------------------------*/
@@ -493,6 +1911,8 @@ CONTEXT xContext;
 void vPortDeleteThread( void *pvTaskToDelete )
 {
 ThreadState_t *pxThreadState;
+HostThread_t *pxHostThread;
+CONTEXT xContext;
 uint32_t ulErrorCode;
 
 	/* Remove compiler warnings if configASSERT() is not defined. */
@@ -501,25 +1921,66 @@ uint32_t ulErrorCode;
 	/* Find the handle of the thread being deleted. */
 	pxThreadState = ( ThreadState_t * ) ( *( size_t *) pvTaskToDelete );
 
-	/* Check that the thread is still valid, it might have been closed by
-	vPortCloseRunningThread() - which will be the case if the task associated
-	with the thread originally deleted itself rather than being deleted by a
-	different task. */
+	/* Check that the thread is still valid, it might have been returned to the
+	pool by vPortCloseRunningThread() - which will be the case if the task
+	associated with the thread originally deleted itself rather than being
+	deleted by a different task. */
 	if( pxThreadState->pvThread != NULL )
 	{
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+		pxHostThread = pxThreadState->pxHostThread;
+
+		if( xPortRunning == pdTRUE )
+		{
+			prvLockInterrupts();
+		}
+
+		pxThreadState->pvThread = NULL;
+		pxHostThread->lRecycle = pdTRUE;
+
+		/* The task is not the running task, so its thread is either waiting
+		on its yield event or was suspended by the simulated interrupt handler
+		wherever the task happened to be.  Rather than terminate it, send it
+		back to the pool. */
+		if( pxThreadState->xSuspended != pdFALSE )
+		{
+			/* Restart the suspended thread from prvRecycleSuspendedThread(),
+			on a stack pointer just below the frames that started it, as if
+			prvRecycleSuspendedThread() had been called from there. */
+			xContext.ContextFlags = CONTEXT_CONTROL;
+			ulErrorCode = GetThreadContext( pxHostThread->pvThread, &xContext );
+			configASSERT( ulErrorCode );
+
+			#if defined( __x86_64__ ) || defined( _M_X64 )
+			{
+				xContext.Rsp = ( ( ( DWORD64 ) pxHostThread->pvStackTop - portRECYCLED_STACK_OFFSET ) & ~( ( DWORD64 ) 0x0f ) ) - sizeof( DWORD64 );
+				xContext.Rip = ( DWORD64 ) prvRecycleSuspendedThread;
+			}
+			#else
+			{
+				xContext.Esp = ( ( ( DWORD ) pxHostThread->pvStackTop - portRECYCLED_STACK_OFFSET ) & ~( ( DWORD ) 0x0f ) ) - sizeof( DWORD );
+				xContext.Eip = ( DWORD ) prvRecycleSuspendedThread;
+			}
+			#endif
 
-		/* !!! This is not a nice way to terminate a thread, and will eventually
-		result in resources being depleted if tasks frequently delete other
-		tasks (rather than deleting themselves) as the task stacks will not be
-		freed. */
-		ulErrorCode = TerminateThread( pxThreadState->pvThread, 0 );
-		configASSERT( ulErrorCode );
+			ulErrorCode = SetThreadContext( pxHostThread->pvThread, &xContext );
+			configASSERT( ulErrorCode );
+
+			pxThreadState->xSuspended = pdFALSE;
+			ResumeThread( pxHostThread->pvThread );
+		}
+		else
+		{
+			SetEvent( pxHostThread->pvYieldEvent );
+		}
 
-		ulErrorCode = CloseHandle( pxThreadState->pvThread );
-		configASSERT( ulErrorCode );
+		/* The thread does nothing but put itself in the pool, so this cannot
+		block for long. */
+		WaitForSingleObject( pvRecycleAcknowledged, INFINITE );
 
-		ReleaseMutex( pvInterruptEventMutex );
+		if( xPortRunning == pdTRUE )
+		{
+			prvUnlockInterrupts();
+		}
 	}
 }
 /*-----------------------------------------------------------*/
@@ -527,39 +1988,43 @@ uint32_t ulErrorCode;
 void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendYield )
 {
 ThreadState_t *pxThreadState;
-void *pvThread;
-uint32_t ulErrorCode;
-
-	/* Remove compiler warnings if configASSERT() is not defined. */
-	( void ) ulErrorCode;
 
 	/* Find the handle of the thread being deleted. */
 	pxThreadState = ( ThreadState_t * ) ( *( size_t *) pvTaskToDelete );
-	pvThread = pxThreadState->pvThread;
-
-	/* Raise the Windows priority of the thread to ensure the FreeRTOS scheduler
-	does not run and swap it out before it is closed.  If that were to happen
-	the thread would never run again and effectively be a thread handle and
-	memory leak. */
-	SetThreadPriority( pvThread, portDELETE_SELF_THREAD_PRIORITY );
 
 	/* This function will not return, therefore a yield is set as pending to
-	ensure a context switch occurs away from this thread on the next tick. */
+	ensure a context switch occurs away from this thread. */
 	*pxPendYield = pdTRUE;
 
 	/* Mark the thread associated with this task as invalid so
-	vPortDeleteThread() does not try to terminate it. */
+	vPortDeleteThread() does not try to recycle it again, and the simulated
+	interrupt handler does not try to suspend it. */
 	pxThreadState->pvThread = NULL;
 
-	/* Close the thread. */
-	ulErrorCode = CloseHandle( pvThread );
-	configASSERT( ulErrorCode );
-
 	/* This is called from a critical section, which must be exited before the
-	thread stops. */
-	taskEXIT_CRITICAL();
-	CloseHandle( pxThreadState->pvYieldEvent );
-	ExitThread( 0 );
+	thread waits for another task.  The critical section is exited directly, by
+	prvRunTasks(), rather than using taskEXIT_CRITICAL(), as this thread must
+	not wait on its yield event.  A yield interrupt is pended so the scheduler
+	switches away from the deleted task immediately instead of at the next
+	tick. */
+	#if( configNUMBER_OF_CORES > 1 )
+	{
+		InterlockedOr( ( volatile LONG * ) &ulYieldRequestCores, ( LONG ) ( 1UL << pxThreadState->xCoreID ) );
+	}
+	#endif
+
+	InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_YIELD ) );
+	SetEvent( pvInterruptEvent );
+
+	/* The thread goes back in the pool before the critical section is exited.
+	Otherwise the task that runs next could create a task, find the pool empty
+	and grow it, while this thread was about to return to the pool.  Nothing
+	can give the thread a task until the critical section is exited, which
+	prvRunTasks() only does once the thread has left the task's stack, as the
+	kernel may free the stack and give it to a new task straight after. */
+	prvReturnHostThread( pxHostThreadOfThisThread );
+
+	longjmp( pxHostThreadOfThisThread->xRecycleBuffer, portRECYCLE_SELF_DELETED );
 }
 /*-----------------------------------------------------------*/
 
@@ -571,14 +2036,38 @@ void vPortEndScheduler( void )
 
 void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber )
 {
-ThreadState_t *pxThreadState = ( ThreadState_t *) *( ( size_t * ) pxCurrentTCB );
+ThreadState_t *pxThreadState;
 
 	configASSERT( xPortRunning );
 
-	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( pvInterruptEventMutex != NULL ) )
+	if( ( ulInterruptNumber < portMAX_INTERRUPTS ) && ( pvInterruptEvent != NULL ) )
 	{
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
-		ulPendingInterrupts |= ( 1 << ulInterruptNumber );
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* The yield is for the core the task is running on, which is
+			marked before the interrupt is pended so the simulated interrupt
+			handler finds it. */
+			pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+
+			if( ( pxThreadState != NULL ) && ( ulInterruptNumber == portINTERRUPT_YIELD ) )
+			{
+				InterlockedOr( ( volatile LONG * ) &ulYieldRequestCores, ( LONG ) ( 1UL << pxThreadState->xCoreID ) );
+			}
+		}
+		#endif
+
+		/* Pend the interrupt.  This does not need the interrupt lock, which
+		is only held while (simulated) interrupts are disabled - the
+		simulated interrupt handler does not process the interrupt until any
+		critical section that is in progress has been exited. */
+		InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << ulInterruptNumber ) );
+
+		#if( configUSE_TICKLESS_IDLE == 1 )
+		{
+			/* Wake the simulated CPU if it is sleeping in tickless idle. */
+			prvAbortTicklessIdle();
+		}
+		#endif
 
 		/* The simulated interrupt is now held pending, but don't actually
 		process it yet if this call is within a critical section.  It is
@@ -586,23 +2075,61 @@ ThreadState_t *pxThreadState = ( ThreadState_t *) *( ( size_t * ) pxCurrentTCB )
 		mutexes are accumulative.  If in a critical section then the event
 		will get set when the critical section nesting count is wound back
 		down to zero. */
+		#if( configNUMBER_OF_CORES > 1 )
+			if( ( pxThreadState == NULL ) || ( ulInterruptNumber != portINTERRUPT_YIELD ) || ( ulTaskLockNesting != 0UL ) )
+			{
+				/* Other interrupts are taken by core 0 while the calling task
+				carries on, as on a multi-core target, and a task that holds
+				the task lock cannot be switched out until it releases it - so
+				in both cases the task does not wait.  Nor does a thread that
+				does not run a task. */
+				if( ulCriticalNesting == portNO_CRITICAL_NESTING )
+				{
+					SetEvent( pvInterruptEvent );
+				}
+			}
+			else
+		#endif
 		if( ulCriticalNesting == portNO_CRITICAL_NESTING )
 		{
-			SetEvent( pvInterruptEvent );
+			#if( configNUMBER_OF_CORES == 1 )
+			{
+				/* pxCurrentTCB is changed by the simulated interrupt handler
+				without this thread holding any lock, so it only refers to the
+				calling task if the task has not been switched out.  If it has,
+				the thread is about to be suspended. */
+				for( ;; )
+				{
+					pxThreadState = ( ThreadState_t * ) *( ( size_t * ) pxCurrentTCB );
 
-			/* Going to wait for an event - make sure the event is not already
-			signaled. */
-			ResetEvent( pxThreadState->pvYieldEvent );
-		}
+					if( pxThreadState->dwThreadId == GetCurrentThreadId() )
+					{
+						break;
+					}
 
-		ReleaseMutex( pvInterruptEventMutex );
-		if( ulCriticalNesting == portNO_CRITICAL_NESTING )
-		{
-			/* An interrupt was pended so ensure to block to allow it to
-			execute.  In most cases the (simulated) interrupt will have
-			executed before the next line is reached - so this is just to make
-			sure. */
-			WaitForSingleObject( pxThreadState->pvYieldEvent, INFINITE );
+					SwitchToThread();
+				}
+			}
+			#endif
+
+			if( InterlockedCompareExchange( &( pxThreadState->lWaiting ), pdTRUE, pdFALSE ) == pdFALSE )
+			{
+				/* An interrupt was pended so block to allow it to execute.
+				The wait only completes when the simulated interrupt handler
+				has selected this task to run again. */
+				SetEvent( pvInterruptEvent );
+				prvWaitForYieldEvent();
+			}
+			else
+			{
+				/* The simulated interrupt handler has already switched this
+				task out asynchronously and is about to suspend it.  Don't run
+				past the yield point in the meantime. */
+				while( pxThreadState->lWaiting != pdFALSE )
+				{
+					SwitchToThread();
+				}
+			}
 		}
 	}
 }
@@ -612,11 +2139,11 @@ void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)
 {
 	if( ulInterruptNumber < portMAX_INTERRUPTS )
 	{
-		if( pvInterruptEventMutex != NULL )
+		if( xPortRunning == pdTRUE )
 		{
-			WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+			prvLockInterrupts();
 			ulIsrHandler[ ulInterruptNumber ] = pvHandler;
-			ReleaseMutex( pvInterruptEventMutex );
+			prvUnlockInterrupts();
 		}
 		else
 		{
@@ -630,9 +2157,17 @@ void vPortEnterCritical( void )
 {
 	if( xPortRunning == pdTRUE )
 	{
-		/* The interrupt event mutex is held for the entire critical section,
+		#if( configNUMBER_OF_CORES > 1 )
+		{
+			/* A task also excludes the tasks running on the other cores.  The
+			task lock is always taken before the interrupt lock. */
+			vPortGetTaskLock();
+		}
+		#endif
+
+		/* The interrupt lock is held for the entire critical section,
 		effectively disabling (simulated) interrupts. */
-		WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+		prvLockInterrupts();
 	}
 
 	ulCriticalNesting++;
@@ -643,12 +2178,13 @@ void vPortExitCritical( void )
 {
 int32_t lMutexNeedsReleasing;
 
-	/* The interrupt event mutex should already be held by this thread as it was
-	obtained on entry to the critical section. */
-	lMutexNeedsReleasing = pdTRUE;
+	lMutexNeedsReleasing = pdFALSE;
 
 	if( ulCriticalNesting > portNO_CRITICAL_NESTING )
 	{
+		/* The interrupt lock should already be held by this thread as it was
+		obtained on entry to the critical section. */
+		lMutexNeedsReleasing = pdTRUE;
 		ulCriticalNesting--;
 
 		/* Don't need to wait for any pending interrupts to execute if the
@@ -657,43 +2193,295 @@ int32_t lMutexNeedsReleasing;
 		{
 			/* Were any interrupts set to pending while interrupts were
 			(simulated) disabled? */
+			#if( configNUMBER_OF_CORES > 1 )
+				/* With more than one core the pending interrupt may be for
+				another core, and the task cannot be switched out while it
+				still holds the task lock, so only wait if this core is to be
+				switched and the lock is about to be released.  Threads that
+				do not run tasks just let the interrupt execute. */
+				if( ( ulPendingInterrupts != 0UL ) &&
+					( ( portTHREAD_STATE_OF_THIS_THREAD() == NULL ) || ( ulTaskLockNesting != 1UL ) ||
+					  ( ( ulYieldRequestCores & ( 1UL << xPortGetCoreID() ) ) == 0UL ) ) )
+				{
+					SetEvent( pvInterruptEvent );
+				}
+				else
+			#endif
 			if( ulPendingInterrupts != 0UL )
 			{
-				ThreadState_t *pxThreadState = ( ThreadState_t *) *( ( size_t * ) pxCurrentTCB );
+				#if( configNUMBER_OF_CORES > 1 )
+					ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+				#else
+					ThreadState_t *pxThreadState = ( ThreadState_t *) *( ( size_t * ) pxCurrentTCB );
+				#endif
 
 				configASSERT( xPortRunning );
 
+				/* The calling task is going to wait for an event to ensure the
+				interrupt that is pending executes immediately after the
+				critical section is exited.  The simulated interrupt handler
+				cannot have switched this task out while it held the lock. */
+				configASSERT( pxThreadState->lWaiting == pdFALSE );
+				InterlockedExchange( &( pxThreadState->lWaiting ), pdTRUE );
+
 				/* The interrupt won't actually executed until
-				pvInterruptEventMutex is released as it waits on both
-				pvInterruptEventMutex and pvInterruptEvent.
-				pvInterruptEvent is only set when the simulated
-				interrupt is pended if the interrupt is pended
-				from outside a critical section - hence it is set
+				the interrupt lock is released.  pvInterruptEvent is only
+				set when the simulated interrupt is pended if the interrupt is
+				pended from outside a critical section - hence it is set
 				here. */
 				SetEvent( pvInterruptEvent );
-				/* The calling task is going to wait for an event to ensure the
-				interrupt that is pending executes immediately after the
-				critical section is exited - so make sure the event is not
-				already signaled. */
-				ResetEvent( pxThreadState->pvYieldEvent );
 
-				/* Mutex will be released now so the (simulated) interrupt can
+				/* Lock will be released now so the (simulated) interrupt can
 				execute, so does not require releasing on function exit. */
 				lMutexNeedsReleasing = pdFALSE;
-				ReleaseMutex( pvInterruptEventMutex );
-				WaitForSingleObject( pxThreadState->pvYieldEvent, INFINITE );
+				prvUnlockInterrupts();
+
+				#if( configNUMBER_OF_CORES > 1 )
+				{
+					vPortReleaseTaskLock();
+				}
+				#endif
+
+				prvWaitForYieldEvent();
 			}
 		}
 	}
 
-	if( pvInterruptEventMutex != NULL )
+	if( xPortRunning == pdTRUE )
 	{
 		if( lMutexNeedsReleasing == pdTRUE )
 		{
-			configASSERT( xPortRunning );
-			ReleaseMutex( pvInterruptEventMutex );
+			prvUnlockInterrupts();
+
+			#if( configNUMBER_OF_CORES > 1 )
+			{
+				vPortReleaseTaskLock();
+			}
+			#endif
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+
+	static void prvTakeLock( InterruptLock_t *pxLock )
+	{
+	DWORD dwThisThread = GetCurrentThreadId();
+
+		/* Only the thread that holds the lock can find its own identifier in
+		dwOwner. */
+		if( pxLock->dwOwner == dwThisThread )
+		{
+			pxLock->ulRecursion++;
+		}
+		else
+		{
+			if( InterlockedCompareExchange( &( pxLock->lState ), portLOCK_HELD, portLOCK_FREE ) != portLOCK_FREE )
+			{
+				/* Park.  Marking the lock as contended tells the thread that
+				releases it to set the event.  A thread woken from here does
+				not know whether other threads are still parked, so it takes
+				the lock as contended too. */
+				while( InterlockedExchange( &( pxLock->lState ), portLOCK_CONTENDED ) != portLOCK_FREE )
+				{
+					WaitForSingleObject( pxLock->pvParkEvent, INFINITE );
+				}
+			}
+
+			pxLock->dwOwner = dwThisThread;
+			pxLock->ulRecursion = 1UL;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvGiveLock( InterruptLock_t *pxLock )
+	{
+		configASSERT( pxLock->dwOwner == GetCurrentThreadId() );
+
+		pxLock->ulRecursion--;
+
+		if( pxLock->ulRecursion == 0UL )
+		{
+			pxLock->dwOwner = 0;
+
+			if( InterlockedExchange( &( pxLock->lState ), portLOCK_FREE ) == portLOCK_CONTENDED )
+			{
+				SetEvent( pxLock->pvParkEvent );
+			}
 		}
 	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS */
+
+static void prvLockInterrupts( void )
+{
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+	prvTakeLock( &xInterruptLock );
+#else
+	WaitForSingleObject( pvInterruptEventMutex, INFINITE );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+static void prvUnlockInterrupts( void )
+{
+#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+	prvGiveLock( &xInterruptLock );
+#else
+	ReleaseMutex( pvInterruptEventMutex );
+#endif
 }
 /*-----------------------------------------------------------*/
 
+#if( configNUMBER_OF_CORES > 1 )
+
+	static BaseType_t prvTryLockTasks( void )
+	{
+	BaseType_t xReturn;
+
+		#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+		{
+			xReturn = ( InterlockedCompareExchange( &( xTaskLock.lState ), portLOCK_HELD, portLOCK_FREE ) == portLOCK_FREE ) ? pdTRUE : pdFALSE;
+
+			if( xReturn != pdFALSE )
+			{
+				xTaskLock.dwOwner = GetCurrentThreadId();
+				xTaskLock.ulRecursion = 1UL;
+			}
+		}
+		#else
+		{
+			xReturn = ( WaitForSingleObject( pvTaskLockMutex, 0 ) == WAIT_OBJECT_0 ) ? pdTRUE : pdFALSE;
+		}
+		#endif
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	static void prvUnlockTasks( void )
+	{
+		#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+		{
+			prvGiveLock( &xTaskLock );
+		}
+		#else
+		{
+			ReleaseMutex( pvTaskLockMutex );
+		}
+		#endif
+
+		/* The simulated interrupt handler looks at the requests after it
+		fails to take the lock, so either it takes the lock or the thread that
+		released it sees the requests it left behind. */
+		MemoryBarrier();
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortGetTaskLock( void )
+	{
+		/* Only tasks take the lock.  The simulated interrupt thread is held
+		off by the interrupt lock instead, as an interrupt is on a real
+		multi-core target. */
+		if( ( xPortRunning == pdTRUE ) && ( pxHostThreadOfThisThread != NULL ) )
+		{
+			if( ulTaskLockNesting == 0UL )
+			{
+				#if( configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1 )
+				{
+					prvTakeLock( &xTaskLock );
+				}
+				#else
+				{
+					WaitForSingleObject( pvTaskLockMutex, INFINITE );
+				}
+				#endif
+			}
+
+			ulTaskLockNesting++;
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortReleaseTaskLock( void )
+	{
+		if( ( xPortRunning == pdTRUE ) && ( pxHostThreadOfThisThread != NULL ) )
+		{
+			configASSERT( ulTaskLockNesting > 0UL );
+			ulTaskLockNesting--;
+
+			if( ulTaskLockNesting == 0UL )
+			{
+				prvUnlockTasks();
+
+				/* Switches the simulated interrupt handler could not make
+				while the lock was held are made now. */
+				if( ulYieldRequestCores != 0UL )
+				{
+					InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_YIELD ) );
+					SetEvent( pvInterruptEvent );
+				}
+			}
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+	BaseType_t xPortGetCoreID( void )
+	{
+	ThreadState_t *pxThreadState = portTHREAD_STATE_OF_THIS_THREAD();
+	BaseType_t xReturn = 0;
+
+		if( pxThreadState != NULL )
+		{
+			xReturn = pxThreadState->xCoreID;
+		}
+		else if( GetCurrentThreadId() == dwSimulatedInterruptThreadId )
+		{
+			xReturn = xInterruptCoreID;
+		}
+
+		return xReturn;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortYieldCore( BaseType_t xCoreID )
+	{
+		configASSERT( ( xCoreID >= 0 ) && ( xCoreID < configNUMBER_OF_CORES ) );
+
+		/* The core's task is switched out asynchronously, as by an inter
+		processor interrupt, so the caller does not wait. */
+		InterlockedOr( ( volatile LONG * ) &ulYieldRequestCores, ( LONG ) ( 1UL << xCoreID ) );
+		InterlockedOr( ( volatile LONG * ) &ulPendingInterrupts, ( LONG ) ( 1UL << portINTERRUPT_YIELD ) );
+		SetEvent( pvInterruptEvent );
+	}
+	/*-----------------------------------------------------------*/
+
+	UBaseType_t uxPortRaiseInterruptMask( void )
+	{
+		/* Only the interrupt lock is taken - the caller is stopping the
+		simulated interrupt thread from switching it to another core, not
+		excluding the other cores.  The simulated interrupt thread already
+		holds the lock while it runs the handlers, so takes it again. */
+		if( xPortRunning == pdTRUE )
+		{
+			prvLockInterrupts();
+		}
+
+		return 0;
+	}
+	/*-----------------------------------------------------------*/
+
+	void vPortRestoreInterruptMask( UBaseType_t uxMask )
+	{
+		( void ) uxMask;
+
+		if( xPortRunning == pdTRUE )
+		{
+			prvUnlockInterrupts();
+		}
+	}
+	/*-----------------------------------------------------------*/
+
+#endif /* configNUMBER_OF_CORES */
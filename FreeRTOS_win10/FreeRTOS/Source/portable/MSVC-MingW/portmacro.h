@@ -34,6 +34,31 @@
 /******************************************************************************
 	Defines
 ******************************************************************************/
+/* Set configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS to 0 in FreeRTOSConfig.h
+to model (simulated) interrupts being disabled with a Windows mutex, rather
+than a lock that is obtained and released without a kernel call when it is not
+contended. */
+#ifndef configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS
+	#define configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS 1
+#endif
+
+/* The number of Windows threads created, parked, the first time a task is
+created.  Tasks are given a parked thread when they are created, and their
+thread goes back to the pool when they are deleted.  The pool grows if more
+tasks exist at once. */
+#ifndef configSIMULATOR_THREAD_POOL_SIZE
+	#define configSIMULATOR_THREAD_POOL_SIZE 8
+#endif
+
+/* Set configSIMULATOR_VIRTUAL_TIME to 1 in FreeRTOSConfig.h to drive the tick
+from virtual time rather than the host clock.  Time only moves on when every
+task is blocked, and then jumps straight to the time the next task unblocks,
+so runs are repeatable and long delays take no host time.  Requires
+configUSE_TICKLESS_IDLE to be 1. */
+#ifndef configSIMULATOR_VIRTUAL_TIME
+	#define configSIMULATOR_VIRTUAL_TIME 0
+#endif
+
 /* Type definitions. */
 #define portCHAR		char
 #define portFLOAT		float
@@ -61,6 +86,16 @@ typedef unsigned long UBaseType_t;
 	#define portTICK_TYPE_IS_ATOMIC 1
 #endif
 
+/* Task stacks are allocated by the port with pvPortMallocStack(), from the
+stack of the host thread that will run the task, which then runs the task on
+it.  Set configSTACK_ALLOCATION_FROM_SEPARATE_HEAP to 0 in FreeRTOSConfig.h to
+allocate stacks from the FreeRTOS heap instead, in which case each task runs on
+whatever part of its host thread's stack it likes and only holds one small
+structure in the stack allocated for it. */
+#ifndef configSTACK_ALLOCATION_FROM_SEPARATE_HEAP
+	#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP 1
+#endif
+
 /* Hardware specifics. */
 #define portSTACK_GROWTH			( -1 )
 #define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
@@ -88,6 +123,11 @@ void vPortCloseRunningThread( void *pvTaskToDelete, volatile BaseType_t *pxPendY
 void vPortDeleteThread( void *pvThreadToDelete );
 #define portCLEAN_UP_TCB( pxTCB )	vPortDeleteThread( pxTCB )
 #define portPRE_TASK_DELETE_HOOK( pvTaskToDelete, pxPendYield ) vPortCloseRunningThread( ( pvTaskToDelete ), ( pxPendYield ) )
+
+/* Returns the number of Windows threads that have been created to run tasks,
+which only grows when more tasks exist at once than ever before - the threads
+of deleted tasks are reused. */
+uint32_t ulPortGetHostThreadCount( void );
 #define portDISABLE_INTERRUPTS() vPortEnterCritical()
 #define portENABLE_INTERRUPTS() vPortExitCritical()
 
@@ -98,6 +138,32 @@ void vPortExitCritical( void );
 #define portENTER_CRITICAL()		vPortEnterCritical()
 #define portEXIT_CRITICAL()			vPortExitCritical()
 
+#if( configNUMBER_OF_CORES > 1 )
+
+	/* Each simulated core is a task thread that is allowed to run at the same
+	time as the others, so the threads are not confined to one host core.  The
+	simulated interrupt thread handles the interrupts of core 0, and performs
+	the context switches of every core. */
+	BaseType_t xPortGetCoreID( void );
+	void vPortYieldCore( BaseType_t xCoreID );
+	#define portGET_CORE_ID()				xPortGetCoreID()
+	#define portYIELD_CORE( xCoreID )		vPortYieldCore( ( xCoreID ) )
+
+	/* The task lock is held while the scheduler is suspended and for every
+	critical section entered by a task, so only one core executes the kernel
+	at a time.  The interrupt mask only stops the simulated interrupt thread -
+	it does not stop the other cores. */
+	void vPortGetTaskLock( void );
+	void vPortReleaseTaskLock( void );
+	UBaseType_t uxPortRaiseInterruptMask( void );
+	void vPortRestoreInterruptMask( UBaseType_t uxMask );
+	#define portGET_TASK_LOCK()				vPortGetTaskLock()
+	#define portRELEASE_TASK_LOCK()			vPortReleaseTaskLock()
+	#define portSET_INTERRUPT_MASK()		uxPortRaiseInterruptMask()
+	#define portCLEAR_INTERRUPT_MASK( x )	vPortRestoreInterruptMask( ( x ) )
+
+#endif /* configNUMBER_OF_CORES */
+
 #ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
 	#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
 #endif
@@ -105,27 +171,68 @@ void vPortExitCritical( void );
 #if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
 
 	/* Check the configuration. */
-	#if( configMAX_PRIORITIES > 32 )
-		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
+	#if( configMAX_PRIORITIES > 256 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 256.  It is very rare that a system requires more than 10 to 15 difference priorities as tasks that share a priority will time slice.
 	#endif
 
-	/* Store/clear the ready priorities in a bit map. */
-	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
-	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
-
-
-	/*-----------------------------------------------------------*/
-
 	#ifdef __GNUC__
-		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )	\
-			__asm volatile(	"bsr %1, %0\n\t" 									\
-							:"=r"(uxTopPriority) : "rm"(uxReadyPriorities) : "cc" )
+		#define portBIT_SCAN_REVERSE( uxIndex, ulWord )	\
+			__asm volatile(	"bsr %1, %0\n\t" 			\
+							:"=r"(uxIndex) : "rm"(ulWord) : "cc" )
 	#else
 		/* BitScanReverse returns the bit position of the most significant '1'
 		in the word. */
-		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) _BitScanReverse( ( DWORD * ) &( uxTopPriority ), ( uxReadyPriorities ) )
+		#define portBIT_SCAN_REVERSE( uxIndex, ulWord ) _BitScanReverse( ( DWORD * ) &( uxIndex ), ( ulWord ) )
 	#endif /* __GNUC__ */
 
+	#if( configMAX_PRIORITIES <= 32 )
+
+		/* Store/clear the ready priorities in a bit map. */
+		#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+		#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) portBIT_SCAN_REVERSE( uxTopPriority, uxReadyPriorities )
+
+	#else
+
+		/* Above 32 priorities the ready priorities are stored in a two level bit
+		map.  Each group of 32 priorities has a word of its own, and a bit in the
+		summary word ulGroups is set while the word of that group is not zero, so
+		the highest ready priority is still found with two bit scans. */
+		typedef struct xREADY_PRIORITIES
+		{
+			uint32_t ulGroups;
+			uint32_t ulPriorities[ ( configMAX_PRIORITIES + 31 ) / 32 ];
+		} ReadyPriorities_t;
+
+		#define portREADY_PRIORITIES_TYPE ReadyPriorities_t
+
+		#define portRECORD_READY_PRIORITY( uxPriority, xReadyPriorities )											\
+		{																											\
+			( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] |= ( 1UL << ( ( uxPriority ) & 31UL ) );	\
+			( xReadyPriorities ).ulGroups |= ( 1UL << ( ( uxPriority ) >> 5UL ) );									\
+		}
+
+		#define portRESET_READY_PRIORITY( uxPriority, xReadyPriorities )											\
+		{																											\
+			( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] &= ~( 1UL << ( ( uxPriority ) & 31UL ) );	\
+			if( ( xReadyPriorities ).ulPriorities[ ( uxPriority ) >> 5UL ] == 0UL )								\
+			{																										\
+				( xReadyPriorities ).ulGroups &= ~( 1UL << ( ( uxPriority ) >> 5UL ) );							\
+			}																										\
+		}
+
+		#define portGET_HIGHEST_PRIORITY( uxTopPriority, xReadyPriorities )						\
+		{																						\
+			UBaseType_t uxGroup, uxPriorityInGroup;												\
+			portBIT_SCAN_REVERSE( uxGroup, ( xReadyPriorities ).ulGroups );						\
+			portBIT_SCAN_REVERSE( uxPriorityInGroup, ( xReadyPriorities ).ulPriorities[ uxGroup ] );	\
+			( uxTopPriority ) = ( uxGroup << 5UL ) + uxPriorityInGroup;							\
+		}
+
+	#endif /* configMAX_PRIORITIES */
+
+
 #endif /* taskRECORD_READY_PRIORITY */
 
 #ifndef __GNUC__
@@ -155,8 +262,69 @@ void vPortGenerateSimulatedInterrupt( uint32_t ulInterruptNumber );
  *
  * Interrupt handler functions must return a non-zero value if executing the
  * handler resulted in a task switch being required.
+ *
+ * Pending interrupts are held in a single 32-bit word, so this port simulates
+ * at most 32 interrupts, all of the same priority.  Each time the simulated
+ * interrupt thread runs it handles every pending interrupt in number order,
+ * and one handler never interrupts another.  A critical section masks every
+ * interrupt.  The prioritised, nestable controller configured with
+ * configSIMULATOR_INTERRUPT_LINES, configKERNEL_INTERRUPT_PRIORITY and
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY is only implemented by the GCC/Posix
+ * port, and those settings are ignored here.
  */
 void vPortSetInterruptHandler( uint32_t ulInterruptNumber, uint32_t (*pvHandler)( void ) );
 
+/*
+ * Returns the total number of ticks that Windows did not run the simulated
+ * timer in time to generate when they were due.  The tick thread waits for
+ * absolute deadlines, so missed ticks are not lost - they are delivered late,
+ * in one batch, by the next tick interrupt.
+ */
+uint32_t ulPortGetMissedTickCount( void );
+
+#if( configUSE_TICKLESS_IDLE == 1 )
+
+	/*
+	 * Tickless idle.  The tick thread stops generating ticks, and sleeps until
+	 * the next task is due to unblock or a simulated interrupt is raised.
+	 */
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+
+	/*
+	 * Returns the number of ticks that tickless idle suppressed per second,
+	 * measured over the last whole second (or longer sleep) of tick time.
+	 */
+	uint32_t ulPortGetSuppressedTicksPerSecond( void );
+
+#endif
+
+#if( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+	#if( configUSE_TICKLESS_IDLE != 1 )
+		#error configSIMULATOR_VIRTUAL_TIME requires configUSE_TICKLESS_IDLE to be 1, as virtual time is moved on in place of a tickless idle sleep.
+	#endif
+
+	/* Without a timer to reprogram, the idle task can skip a single tick
+	period. */
+	#define portMIN_EXPECTED_IDLE_TIME	1
+
+	/*
+	 * Returns the virtual time, in nanoseconds, since the scheduler started.
+	 * Advances a whole tick period at a time, and does not wrap around when
+	 * the tick count does.
+	 */
+	uint64_t ullPortGetVirtualTime( void );
+
+#endif
+
+#if( defined( configSIMULATOR_RECORD_REPLAY ) && ( configSIMULATOR_RECORD_REPLAY != 0 ) )
+	#error configSIMULATOR_RECORD_REPLAY is only implemented by the fiber engine of the GCC/Posix port.
+#endif
+
+#if( defined( configSIMULATOR_KERNEL_INSTANCES ) && ( configSIMULATOR_KERNEL_INSTANCES != 0 ) )
+	#error configSIMULATOR_KERNEL_INSTANCES is only implemented by the fiber engine of the GCC/Posix port.
+#endif
+
 #endif
 
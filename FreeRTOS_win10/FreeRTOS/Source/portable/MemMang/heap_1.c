@@ -61,18 +61,18 @@
 * heap - probably so it can be placed in a special segment or address. */
     extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
 #else
-    static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+    PRIVILEGED_DATA static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
 #endif /* configAPPLICATION_ALLOCATED_HEAP */
 
 /* Index into the ucHeap array. */
-static size_t xNextFreeByte = ( size_t ) 0;
+PRIVILEGED_DATA static size_t xNextFreeByte = ( size_t ) 0;
 
 /*-----------------------------------------------------------*/
 
 void * pvPortMalloc( size_t xWantedSize )
 {
     void * pvReturn = NULL;
-    static uint8_t * pucAlignedHeap = NULL;
+    PRIVILEGED_DATA static uint8_t * pucAlignedHeap = NULL;
 
     /* Ensure that blocks are always aligned to the required number of bytes. */
     #if ( portBYTE_ALIGNMENT != 1 )
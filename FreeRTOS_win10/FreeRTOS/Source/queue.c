@@ -74,6 +74,10 @@ typedef struct SemaphoreData
 {
     TaskHandle_t xMutexHolder;        /*< The handle of the task that holds the mutex. */
     UBaseType_t uxRecursiveCallCount; /*< Maintains a count of the number of times a recursive mutex has been recursively 'taken' when the structure is used as a mutex. */
+
+    #if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+        UBaseType_t uxCeilingPriority; /*< The priority a task runs at while it holds the mutex, or 0 if the mutex uses priority inheritance instead. */
+    #endif
 } SemaphoreData_t;
 
 /* Semaphores do not actually store or copy data, so have an item size of
@@ -81,6 +85,14 @@ typedef struct SemaphoreData
 #define queueSEMAPHORE_QUEUE_ITEM_LENGTH    ( ( UBaseType_t ) 0 )
 #define queueMUTEX_GIVE_BLOCK_TIME          ( ( TickType_t ) 0U )
 
+/* A mutex with a priority ceiling raises its holder when it is taken, so a task
+ * that finds it held has nothing to pass on to the holder. */
+#if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+    #define queueMUTEX_USES_INHERITANCE( pxQueue )    ( ( pxQueue )->u.xSemaphore.uxCeilingPriority == ( UBaseType_t ) 0 )
+#else
+    #define queueMUTEX_USES_INHERITANCE( pxQueue )    ( pdTRUE )
+#endif
+
 #if ( configUSE_PREEMPTION == 0 )
 
 /* If the cooperative scheduler is being used then a yield should not be
@@ -500,6 +512,12 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
             /* In case this is a recursive mutex. */
             pxNewQueue->u.xSemaphore.uxRecursiveCallCount = 0;
 
+            #if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+                {
+                    pxNewQueue->u.xSemaphore.uxCeilingPriority = 0;
+                }
+            #endif
+
             traceCREATE_MUTEX( pxNewQueue );
 
             /* Start with the semaphore in the expected state. */
@@ -551,6 +569,59 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+
+    QueueHandle_t xQueueCreateMutexWithCeiling( const uint8_t ucQueueType,
+                                                const UBaseType_t uxCeilingPriority )
+    {
+        QueueHandle_t xNewQueue;
+
+        configASSERT( ( uxCeilingPriority > ( UBaseType_t ) 0U ) && ( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES ) );
+
+        xNewQueue = xQueueCreateMutex( ucQueueType );
+
+        if( xNewQueue != NULL )
+        {
+            ( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xNewQueue;
+    }
+
+#endif /* ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) )
+
+    QueueHandle_t xQueueCreateMutexWithCeilingStatic( const uint8_t ucQueueType,
+                                                      const UBaseType_t uxCeilingPriority,
+                                                      StaticQueue_t * pxStaticQueue )
+    {
+        QueueHandle_t xNewQueue;
+
+        configASSERT( ( uxCeilingPriority > ( UBaseType_t ) 0U ) && ( uxCeilingPriority < ( UBaseType_t ) configMAX_PRIORITIES ) );
+
+        xNewQueue = xQueueCreateMutexStatic( ucQueueType, pxStaticQueue );
+
+        if( xNewQueue != NULL )
+        {
+            ( ( Queue_t * ) xNewQueue )->u.xSemaphore.uxCeilingPriority = uxCeilingPriority;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xNewQueue;
+    }
+
+#endif /* ( ( configUSE_MUTEX_PRIORITY_CEILING == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_MUTEXES == 1 ) && ( INCLUDE_xSemaphoreGetMutexHolder == 1 ) )
 
     TaskHandle_t xQueueGetMutexHolder( QueueHandle_t xSemaphore )
@@ -1480,6 +1551,15 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
         }
     #endif
 
+    /* A task above the ceiling of a mutex could be kept waiting by a lower
+     * priority holder that the ceiling does not raise far enough, so the
+     * ceiling must be at least the priority of every task that takes it. */
+    #if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+        {
+            configASSERT( !( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( queueMUTEX_USES_INHERITANCE( pxQueue ) == pdFALSE ) && ( xTaskPriorityAboveCeiling( pxQueue->u.xSemaphore.uxCeilingPriority ) != pdFALSE ) ) );
+        }
+    #endif
+
     /*lint -save -e904 This function relaxes the coding standard somewhat to allow return
      * statements within the function itself.  This is done in the interest
      * of execution time efficiency. */
@@ -1508,6 +1588,22 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                             /* Record the information required to implement
                              * priority inheritance should it become necessary. */
                             pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+
+                            #if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+                                {
+                                    if( pxQueue->u.xSemaphore.uxCeilingPriority != ( UBaseType_t ) 0 )
+                                    {
+                                        /* Run at the ceiling until the mutex is
+                                         * given back, so no task that might want
+                                         * the mutex can preempt the holder. */
+                                        vTaskPriorityRaiseToCeiling( pxQueue->u.xSemaphore.uxCeilingPriority );
+                                    }
+                                    else
+                                    {
+                                        mtCOVERAGE_TEST_MARKER();
+                                    }
+                                }
+                            #endif /* configUSE_MUTEX_PRIORITY_CEILING */
                         }
                         else
                         {
@@ -1550,6 +1646,14 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                         }
                     #endif /* configUSE_MUTEXES */
 
+                    #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                        {
+                            /* This task might have blocked on the mutex before
+                             * another task took it first. */
+                            vTaskSetBlockingMutex( NULL );
+                        }
+                    #endif
+
                     /* The semaphore count was 0 and no block time is specified
                      * (or the block time has expired) so exit now. */
                     taskEXIT_CRITICAL();
@@ -1591,10 +1695,19 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
 
                 #if ( configUSE_MUTEXES == 1 )
                     {
-                        if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+                        if( ( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX ) && ( queueMUTEX_USES_INHERITANCE( pxQueue ) != pdFALSE ) )
                         {
                             taskENTER_CRITICAL();
                             {
+                                #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                                    {
+                                        /* Let a task that later blocks on a mutex
+                                         * this task holds raise the holder of this
+                                         * mutex too. */
+                                        vTaskSetBlockingMutex( &( pxQueue->u.xSemaphore.xMutexHolder ) );
+                                    }
+                                #endif
+
                                 xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
                             }
                             taskEXIT_CRITICAL();
@@ -1638,6 +1751,12 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
              * queue being empty is equivalent to the semaphore count being 0. */
             if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
             {
+                #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                    {
+                        vTaskSetBlockingMutex( NULL );
+                    }
+                #endif
+
                 #if ( configUSE_MUTEXES == 1 )
                     {
                         /* xInheritanceOccurred could only have be set if
@@ -2104,15 +2223,8 @@ void vQueueDelete( QueueHandle_t xQueue )
          * disinherit the priority - but only down to the highest priority of any
          * other tasks that are waiting for the same mutex.  For this purpose,
          * return the priority of the highest priority task that is waiting for the
-         * mutex. */
-        if( listCURRENT_LIST_LENGTH( &( pxQueue->xTasksWaitingToReceive ) ) > 0U )
-        {
-            uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( &( pxQueue->xTasksWaitingToReceive ) );
-        }
-        else
-        {
-            uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
-        }
+         * mutex, not counting any waiting for it through xMultiWaitForObjects(). */
+        uxHighestPriorityOfWaitingTasks = uxTaskGetHighestWaitingPriority( &( pxQueue->xTasksWaitingToReceive ) );
 
         return uxHighestPriorityOfWaitingTasks;
     }
@@ -2843,6 +2955,25 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
 #endif /* configUSE_TIMERS */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vQueuePlaceMultiWaitItem( QueueHandle_t xQueue,
+                                   ListItem_t * const pxListItem )
+    {
+        Queue_t * const pxQueue = xQueue;
+
+        configASSERT( pxQueue );
+
+        /* This function should not be called by application code.  It is used
+         * by xMultiWaitForObjects(), which calls it from a critical section with
+         * the scheduler suspended.  No task can have the queue locked then, so
+         * the list of tasks waiting to receive can be written directly. */
+        vTaskPlaceMultiWaitItemOnEventList( &( pxQueue->xTasksWaitingToReceive ), pxListItem );
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
 #if ( ( configUSE_QUEUE_SETS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 
     QueueSetHandle_t xQueueCreateSet( const UBaseType_t uxEventQueueLength )
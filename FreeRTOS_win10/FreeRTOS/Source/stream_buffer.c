@@ -1294,6 +1294,47 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
     pxStreamBuffer->ucFlags = ucFlags;
 }
 
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vStreamBufferPlaceMultiWaitReceiver( StreamBufferHandle_t xStreamBuffer )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        configASSERT( pxStreamBuffer );
+
+        /* Called by xMultiWaitForObjects() from a critical section, as
+         * xStreamBufferReceive() sets the waiting task.  The task is notified at
+         * the default index when data is sent. */
+        configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+        pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vStreamBufferRemoveMultiWaitReceiver( StreamBufferHandle_t xStreamBuffer )
+    {
+        StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+
+        configASSERT( pxStreamBuffer );
+
+        /* Sending data clears the waiting task, so it is only cleared here if
+         * the calling task was woken by something else. */
+        if( pxStreamBuffer->xTaskWaitingToReceive == xTaskGetCurrentTaskHandle() )
+        {
+            pxStreamBuffer->xTaskWaitingToReceive = NULL;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
     UBaseType_t uxStreamBufferGetStreamBufferNumber( StreamBufferHandle_t xStreamBuffer )
@@ -39,6 +39,10 @@
 #include "timers.h"
 #include "stack_macros.h"
 
+#if ( configUSE_MULTI_WAIT == 1 )
+    #include "multiwait.h"
+#endif
+
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
  * for the header files above, but not in this file, in order to generate the
@@ -70,6 +74,52 @@
 #define taskWAITING_NOTIFICATION                  ( ( uint8_t ) 1 )
 #define taskNOTIFICATION_RECEIVED                 ( ( uint8_t ) 2 )
 
+#if ( configUSE_MULTI_WAIT == 1 )
+
+/* Values that can be assigned to the ucMultiWaitState member of the TCB.  A
+ * task blocked in xMultiWaitForObjects() is woken by the first of its objects
+ * to become ready, its time out, or an abort, whichever happens first.  The
+ * list items it left on the other objects' event lists stay there until the
+ * task removes them, and are skipped by anything that finds them before then. */
+    #define taskMULTI_WAIT_NONE                   ( ( uint8_t ) 0 )
+    #define taskMULTI_WAIT_BLOCKED                ( ( uint8_t ) 1 )
+    #define taskMULTI_WAIT_WOKEN                  ( ( uint8_t ) 2 )
+
+/* True if pxEventListItem, owned by pxTCB, is one of those left on an event
+ * list after xMultiWaitForObjects() was woken. */
+    #define taskMULTI_WAIT_ITEM_IS_STALE( pxTCB, pxEventListItem ) \
+    ( ( ( pxEventListItem ) != &( ( pxTCB )->xEventListItem ) ) && ( ( pxTCB )->ucMultiWaitState != taskMULTI_WAIT_BLOCKED ) )
+#endif
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+/* The xTaskRunState member of the TCB holds the core the task is running on,
+ * or this value if it is not running on any core. */
+    #define taskTASK_NOT_RUNNING     ( ( BaseType_t ) -1 )
+
+/* Bits of the uxTaskAttributes member of the TCB. */
+    #define taskATTRIBUTE_IS_IDLE    ( ( UBaseType_t ) 0x01UL )
+
+    #define taskTASK_IS_RUNNING( pxTCB )    ( ( pxTCB )->xTaskRunState != taskTASK_NOT_RUNNING )
+#else
+    #define taskTASK_IS_RUNNING( pxTCB )    ( ( pxTCB ) == pxCurrentTCB )
+#endif
+
+#if ( ( configNUMBER_OF_CORES > 1 ) && ( configASSERT_DEFINED == 1 ) )
+
+/* A task on another core may have the scheduler suspended.  It holds the task
+ * lock until it resumes the scheduler, so the check is made with the lock held
+ * and only fails if it is the calling task that suspended the scheduler. */
+    #define taskASSERT_SCHEDULER_NOT_SUSPENDED()       \
+    do {                                               \
+        taskENTER_CRITICAL();                          \
+        configASSERT( uxSchedulerSuspended == 0 );     \
+        taskEXIT_CRITICAL();                           \
+    } while( 0 )
+#else
+    #define taskASSERT_SCHEDULER_NOT_SUSPENDED()    configASSERT( uxSchedulerSuspended == 0 )
+#endif
+
 /*
  * The value used to fill the stack of a task when the task is created.  This
  * is used purely for checking the high water mark for tasks.
@@ -90,6 +140,15 @@
     #define tskSET_NEW_STACKS_TO_KNOWN_VALUE    0
 #endif
 
+/* The stack of a task pool slot is filled when the pool is created and again
+ * when a task is deleted from the slot, so is not filled when a task is
+ * created in the slot. */
+#if ( configUSE_TASK_POOLS == 1 )
+    #define tskSTACK_IS_FILLED( pxTCB )    ( ( pxTCB )->pxPool != NULL )
+#else
+    #define tskSTACK_IS_FILLED( pxTCB )    ( pdFALSE )
+#endif
+
 /*
  * Macros used by vListTask to indicate which state a task is in.
  */
@@ -99,6 +158,12 @@
 #define tskDELETED_CHAR      ( 'D' )
 #define tskSUSPENDED_CHAR    ( 'S' )
 
+/*
+ * The number of tasks vTaskList() and vTaskGetRunTimeStats() fetch the state of
+ * at a time.  The TaskStatus_t array is on the stack of the calling task.
+ */
+#define tskSTATUS_CHUNK_LENGTH    ( ( UBaseType_t ) 4U )
+
 /*
  * Some kernel aware debuggers require the data the debugger needs access to be
  * global, rather than file scope.
@@ -113,6 +178,108 @@
     #define configIDLE_TASK_NAME    "IDLE"
 #endif
 
+/* True if the tick count xA is earlier than the tick count xB, allowing for the
+ * tick count wrapping between the two. */
+#define taskTIME_IS_BEFORE( xA, xB )    ( ( TickType_t ) ( ( xA ) - ( xB ) ) > ( portMAX_DELAY >> 1 ) )
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/* The ready tasks of priority configEDF_TASK_PRIORITY are kept in deadline
+ * order, and the one at the head runs.  The tasks of other priorities share the
+ * processor in turn. */
+    #define taskSELECT_FROM_READY_LIST( uxTopPriority )                                                \
+    {                                                                                                  \
+        if( ( uxTopPriority ) == ( UBaseType_t ) configEDF_TASK_PRIORITY )                             \
+        {                                                                                              \
+            pxCurrentTCB = listGET_OWNER_OF_HEAD_ENTRY( &( pxReadyTasksLists[ ( uxTopPriority ) ] ) ); \
+        }                                                                                              \
+        else                                                                                           \
+        {                                                                                              \
+            listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ ( uxTopPriority ) ] ) );  \
+        }                                                                                              \
+    }
+
+    #define taskINSERT_INTO_READY_LIST( pxTCB )                                                                \
+    {                                                                                                          \
+        if( ( pxTCB )->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY )                                 \
+        {                                                                                                      \
+            prvAddTaskToDeadlineOrderedList( pxTCB );                                                          \
+        }                                                                                                      \
+        else                                                                                                   \
+        {                                                                                                      \
+            vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+        }                                                                                                      \
+    }
+
+/* The deadline ordered tasks are not time sliced.  The tick only switches away
+ * from one if a task with an earlier deadline was made ready since it was
+ * selected, without it preempting. */
+    #define taskIS_TIME_SLICED( uxPriority )                                     \
+    ( ( ( uxPriority ) != ( UBaseType_t ) configEDF_TASK_PRIORITY ) ||           \
+      ( listGET_OWNER_OF_HEAD_ENTRY( &( pxReadyTasksLists[ ( uxPriority ) ] ) ) != pxCurrentTCB ) )
+
+/* True if the deadline ordered task pxTCB goes in front of pxOtherTCB in the
+ * ready list.  A task without a deadline goes in front of all of them, and a
+ * task with one in front of those with a later deadline. */
+    #define taskDEADLINE_IS_BEFORE( pxTCB, pxOtherTCB )                                  \
+    ( ( ( pxTCB )->xRelativeDeadline == ( TickType_t ) 0U ) ||                           \
+      ( ( ( pxOtherTCB )->xRelativeDeadline != ( TickType_t ) 0U ) &&                    \
+        ( taskTIME_IS_BEFORE( ( pxTCB )->xAbsoluteDeadline, ( pxOtherTCB )->xAbsoluteDeadline ) ) ) )
+
+/* True if pxTCB, once ready, should run in place of the running task - it has
+ * a higher priority, or both are deadline ordered and it goes in front. */
+    #define taskPREEMPTS_CURRENT_TASK( pxTCB )                                        \
+    ( ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority ) ||                         \
+      ( ( ( pxTCB )->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) &&       \
+        ( pxCurrentTCB->uxPriority == ( UBaseType_t ) configEDF_TASK_PRIORITY ) &&    \
+        ( taskDEADLINE_IS_BEFORE( ( pxTCB ), pxCurrentTCB ) ) ) )
+
+#else /* configUSE_EDF_SCHEDULING */
+
+/* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of the
+ * same priority get an equal share of the processor time. */
+    #define taskSELECT_FROM_READY_LIST( uxTopPriority )    listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ ( uxTopPriority ) ] ) )
+
+    #define taskINSERT_INTO_READY_LIST( pxTCB )            vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) )
+
+    #define taskIS_TIME_SLICED( uxPriority )               ( pdTRUE )
+
+    #define taskPREEMPTS_CURRENT_TASK( pxTCB )             ( ( pxTCB )->uxPriority > pxCurrentTCB->uxPriority )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/* Read the run time stats counter into ulValue. */
+    #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
+        #define taskREAD_RUN_TIME_COUNTER( ulValue )    portALT_GET_RUN_TIME_COUNTER_VALUE( ulValue )
+    #else
+        #define taskREAD_RUN_TIME_COUNTER( ulValue )    ( ulValue ) = portGET_RUN_TIME_COUNTER_VALUE()
+    #endif
+
+/* The largest difference between two run time counter values that is taken as
+ * time having passed.  A larger one is a counter that went backwards - the
+ * host counters of the simulator ports can when read from different threads. */
+    #define taskMAX_RUN_TIME_STEP    ( ( ( configRUN_TIME_COUNTER_TYPE ) ~( ( configRUN_TIME_COUNTER_TYPE ) 0 ) ) >> 1 )
+
+/* Note the time a task that is not running is made ready, from which its wake
+ * latency is measured when it is switched in.  A task that is moved between
+ * ready lists while it waits to run keeps the time it was first made ready. */
+    #define taskRECORD_READY_TIME( pxTCB )                                                 \
+    if( ( ( pxTCB )->xReadyTimeValid == pdFALSE ) && ( !taskTASK_IS_RUNNING( pxTCB ) ) ) \
+    {                                                                                      \
+        taskREAD_RUN_TIME_COUNTER( ( pxTCB )->ulReadyTime );                               \
+        ( pxTCB )->xReadyTimeValid = pdTRUE;                                               \
+    }
+
+#else /* configGENERATE_RUN_TIME_STATS */
+
+    #define taskRECORD_READY_TIME( pxTCB )
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
@@ -142,9 +309,7 @@
             --uxTopPriority;                                                  \
         }                                                                     \
                                                                               \
-        /* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of \
-         * the  same priority get an equal share of the processor time. */                    \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) ); \
+        taskSELECT_FROM_READY_LIST( uxTopPriority );                                          \
         uxTopReadyPriority = uxTopPriority;                                                   \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
@@ -174,7 +339,7 @@
         /* Find the highest priority list that contains ready tasks. */                         \
         portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                          \
         configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 ); \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );   \
+        taskSELECT_FROM_READY_LIST( uxTopPriority );                                            \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 /*-----------------------------------------------------------*/
@@ -194,6 +359,37 @@
 
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* The timing wheel splits a wake time into digits of taskWHEEL_SLOT_BITS bits,
+ * one level of the wheel per digit. */
+    #define taskWHEEL_SLOT_BITS     ( 5U )
+    #define taskWHEEL_SLOTS         ( 1U << taskWHEEL_SLOT_BITS )
+    #define taskWHEEL_SLOT_MASK     ( ( TickType_t ) taskWHEEL_SLOTS - ( TickType_t ) 1U )
+    #define taskWHEEL_LEVELS        ( ( ( sizeof( TickType_t ) * 8U ) + taskWHEEL_SLOT_BITS - 1U ) / taskWHEEL_SLOT_BITS )
+
+/* True if pxList is one of the slots of the timing wheel. */
+    #define taskLIST_IS_IN_DELAY_WHEEL( pxList ) \
+    ( ( ( pxList ) >= &( xDelayWheel[ 0 ][ 0 ] ) ) && ( ( pxList ) <= &( xDelayWheel[ taskWHEEL_LEVELS - 1U ][ taskWHEEL_SLOTS - 1U ] ) ) )
+
+/* The wheel holds the delayed tasks whose wake time has not overflowed, and
+ * pxOverflowDelayedTaskList (unsorted) holds those that have.  When the tick
+ * count overflows the wheel is empty, so it is re-arranged around a tick count
+ * of zero and the overflowed tasks are moved into it. */
+    #define taskSWITCH_DELAYED_LISTS() \
+    {                                  \
+        prvDelayWheelOverflow();       \
+        xNumOfOverflows++;             \
+        prvResetNextTaskUnblockTime(); \
+    }
+
+/* Place the state list item of a task that is entering the Blocked state in the
+ * delayed tasks, or in the overflowed delayed tasks if its wake time overflowed. */
+    #define taskINSERT_DELAYED_TASK( pxListItem )       prvDelayWheelInsert( pxListItem )
+    #define taskINSERT_OVERFLOWED_TASK( pxListItem )    vListInsertEnd( pxOverflowDelayedTaskList, pxListItem )
+
+#else /* configUSE_DELAYED_TASK_WHEEL */
+
 /* pxDelayedTaskList and pxOverflowDelayedTaskList are switched when the tick
  * count overflows. */
 #define taskSWITCH_DELAYED_LISTS()                                                \
@@ -210,17 +406,47 @@
         prvResetNextTaskUnblockTime();                                            \
     }
 
+/* The delayed lists are kept in wake time order. */
+#define taskINSERT_DELAYED_TASK( pxListItem )       vListInsert( pxDelayedTaskList, pxListItem )
+#define taskINSERT_OVERFLOWED_TASK( pxListItem )    vListInsert( pxOverflowDelayedTaskList, pxListItem )
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
+
 /*-----------------------------------------------------------*/
 
 /*
  * Place the task represented by pxTCB into the appropriate ready list for
- * the task.  It is inserted at the end of the list.
+ * the task.  It is inserted at the end of the list, or in deadline order if
+ * the list is that of configEDF_TASK_PRIORITY.
  */
-#define prvAddTaskToReadyList( pxTCB )                                                                 \
-    traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                           \
-    taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                \
-    vListInsertEnd( &( pxReadyTasksLists[ ( pxTCB )->uxPriority ] ), &( ( pxTCB )->xStateListItem ) ); \
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+/* A task that is suspended because it used up its budget waits in
+ * xThrottledTaskList instead, until its budget is replenished. */
+    #define prvAddTaskToReadyList( pxTCB )                                                                                  \
+    if( ( ( pxTCB )->xBudgetExhausted != pdFALSE ) && ( ( pxTCB )->ucBudgetAction == ( uint8_t ) eBudgetSuspend ) ) \
+    {                                                                                                                   \
+        vListInsertEnd( &xThrottledTaskList, &( ( pxTCB )->xStateListItem ) );                                         \
+    }                                                                                                                   \
+    else                                                                                                                \
+    {                                                                                                                   \
+        traceMOVED_TASK_TO_READY_STATE( pxTCB );                                                                        \
+        taskRECORD_READY_TIME( pxTCB );                                                                                 \
+        taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );                                                             \
+        taskINSERT_INTO_READY_LIST( pxTCB );                                                                            \
+        tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB );                                                                   \
+    }
+
+#else /* configUSE_TASK_BUDGETS */
+
+    #define prvAddTaskToReadyList( pxTCB )                  \
+    traceMOVED_TASK_TO_READY_STATE( pxTCB );                \
+    taskRECORD_READY_TIME( pxTCB );                         \
+    taskRECORD_READY_PRIORITY( ( pxTCB )->uxPriority );     \
+    taskINSERT_INTO_READY_LIST( pxTCB );                    \
     tracePOST_MOVED_TASK_TO_READY_STATE( pxTCB )
+
+#endif /* configUSE_TASK_BUDGETS */
 /*-----------------------------------------------------------*/
 
 /*
@@ -245,6 +471,17 @@
     #define taskEVENT_LIST_ITEM_VALUE_IN_USE    0x80000000UL
 #endif
 
+/* A task is blocked on the mutex recorded by vTaskSetBlockingMutex() while its
+ * event list item is in the list of tasks waiting for that mutex.  Once the task
+ * has been unblocked the item is either in no list or, if the scheduler was
+ * suspended, in xPendingReadyList. */
+#if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+    #define taskIS_WAITING_FOR_MUTEX( pxTCB )                                                 \
+    ( ( ( pxTCB )->pxWaitingMutexHolder != NULL ) &&                                          \
+      ( listLIST_ITEM_CONTAINER( &( ( pxTCB )->xEventListItem ) ) != NULL ) &&                \
+      ( listLIST_ITEM_CONTAINER( &( ( pxTCB )->xEventListItem ) ) != &xPendingReadyList ) )
+#endif
+
 /*
  * Task control block.  A task control block (TCB) is allocated for each task,
  * and stores task state information, including a pointer to the task's context
@@ -273,13 +510,18 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #endif
 
     #if ( configUSE_TRACE_FACILITY == 1 )
-        UBaseType_t uxTCBNumber;  /*< Stores a number that increments each time a TCB is created.  It allows debuggers to determine when a task has been deleted and then recreated. */
-        UBaseType_t uxTaskNumber; /*< Stores a number specifically for use by third party trace code. */
+        UBaseType_t uxTCBNumber;        /*< Stores a number that increments each time a TCB is created.  It allows debuggers to determine when a task has been deleted and then recreated. */
+        UBaseType_t uxTaskNumber;       /*< Stores a number specifically for use by third party trace code. */
+        ListItem_t xAllTasksListItem;   /*< Used to reference the task from xAllTasksList. */
     #endif
 
     #if ( configUSE_MUTEXES == 1 )
         UBaseType_t uxBasePriority; /*< The priority last assigned to the task - used by the priority inheritance mechanism. */
         UBaseType_t uxMutexesHeld;
+
+        #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+            TaskHandle_t * pxWaitingMutexHolder; /*< Where the holder of the mutex the task is blocked on is stored, so inheritance can follow a chain of blocked holders. */
+        #endif
     #endif
 
     #if ( configUSE_APPLICATION_TASK_TAG == 1 )
@@ -291,7 +533,15 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #endif
 
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
-        uint32_t ulRunTimeCounter; /*< Stores the amount of time the task has spent in the Running state. */
+        configRUN_TIME_COUNTER_TYPE ulRunTimeCounter;   /*< Stores the amount of time the task has spent in the Running state. */
+        configRUN_TIME_COUNTER_TYPE ulReadyTime;        /*< The run time counter value when the task was last made ready, valid while xReadyTimeValid is pdTRUE. */
+        configRUN_TIME_COUNTER_TYPE ulWakeLatencyTotal; /*< The sum of the ulWakeups wake latencies, for their average. */
+        uint32_t ulSwitchesIn;                          /*< The number of times the task has been switched in. */
+        uint32_t ulPreemptions;                         /*< The number of times the task was switched out while it was still ready to run. */
+        uint32_t ulWakeups;                             /*< The number of wake latencies measured. */
+        uint32_t ulWakeLatencyMin;                      /*< The shortest time from being made ready to being switched in. */
+        uint32_t ulWakeLatencyMax;                      /*< The longest time from being made ready to being switched in. */
+        BaseType_t xReadyTimeValid;                     /*< pdTRUE from when the task is made ready until it is switched in. */
     #endif
 
     #if ( configUSE_NEWLIB_REENTRANT == 1 )
@@ -327,15 +577,80 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        volatile BaseType_t xTaskRunState; /*< The core the task is running on, or taskTASK_NOT_RUNNING.  A task that has blocked keeps its core until the core switches to another task. */
+        UBaseType_t uxTaskAttributes;      /*< taskATTRIBUTE_IS_IDLE is set for the idle tasks. */
+    #endif
+
+    #if ( configUSE_CORE_AFFINITY == 1 )
+        UBaseType_t uxCoreAffinityMask; /*< Bit n is set if the task is allowed to run on core n. */
+    #endif
+
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        TickType_t xRelativeDeadline; /*< The time within which each job of the task must complete after its release, or 0 if the task has no deadline. */
+        TickType_t xPeriod;           /*< The time between the releases of the task's jobs. */
+        TickType_t xReleaseTime;      /*< The time the current job was released. */
+        TickType_t xAbsoluteDeadline; /*< The time by which the current job must complete - orders the ready tasks of priority configEDF_TASK_PRIORITY. */
+        UBaseType_t uxDeadlineMisses; /*< The number of jobs that completed after their deadline. */
+    #endif
+
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        configRUN_TIME_COUNTER_TYPE ulBudget;       /*< The run time the task can use in each budget period, or 0 if the task has no budget. */
+        configRUN_TIME_COUNTER_TYPE ulBudgetUsed;   /*< The run time the task has used in the current budget period. */
+        TickType_t xBudgetPeriod;                   /*< The time between replenishments of the budget. */
+        TickType_t xBudgetReplenishTime;            /*< The time the current budget period ends. */
+        UBaseType_t uxDemotedPriority;              /*< The priority of the task while it is demoted. */
+        UBaseType_t uxBudgetOverruns;               /*< The number of budget periods in which the task used up its budget. */
+        BaseType_t xBudgetExhausted;                /*< pdTRUE from when the task uses up its budget until the budget is replenished. */
+        struct tskTaskControlBlock * pxNextBudgeted; /*< Links the tasks that have a budget. */
+        uint8_t ucBudgetAction;                     /*< The eBudgetAction taken when the budget is used up. */
+    #endif
+
+    #if ( configUSE_TASK_POOLS == 1 )
+        struct tskTaskPool * pxPool; /*< The pool the task's TCB and stack belong to, or NULL if the task was not created from a pool. */
+    #endif
+
+    #if ( configUSE_MULTI_WAIT == 1 )
+        MultiWaitObject_t * pxMultiWaitObjects; /*< The objects the task is waiting on in xMultiWaitForObjects(). */
+        UBaseType_t uxMultiWaitObjectCount;     /*< The number of objects in pxMultiWaitObjects. */
+        uint8_t ucMultiWaitState;               /*< One of the taskMULTI_WAIT_ values. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
  * below to enable the use of older kernel aware debuggers. */
 typedef tskTCB TCB_t;
 
+#if ( configUSE_TASK_POOLS == 1 )
+
+/* A pool of task slots, created by xTaskPoolCreate().  Each slot is a TCB and
+ * the stack it points to, allocated when the pool is created.  The free slots
+ * are linked through the xStateListItem of their TCB, which is otherwise unused
+ * while a slot is free. */
+    typedef struct tskTaskPool
+    {
+        List_t xFreeSlots;                   /*< The slots not in use. */
+        TCB_t * pxSlots;                     /*< The TCBs of all the slots. */
+        UBaseType_t uxSlots;                 /*< The number of slots. */
+        configSTACK_DEPTH_TYPE usStackDepth; /*< The depth, in words, of the stack of each slot. */
+    } TaskPool_t;
+
+#endif
+
 /*lint -save -e956 A manual analysis and inspection has been used to determine
  * which static variables must be declared volatile. */
-PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#if ( configNUMBER_OF_CORES == 1 )
+    PRIVILEGED_DATA TCB_t * volatile pxCurrentTCB = NULL;
+#else
+
+/* The task running on each core.  The code shared with the single core build
+ * refers to the task running on the calling core, which is read with the
+ * interrupts masked so the calling task cannot move to another core half way
+ * through reading it. */
+    PRIVILEGED_DATA TCB_t * volatile pxCurrentTCBs[ configNUMBER_OF_CORES ] = { NULL };
+    #define pxCurrentTCB    xTaskGetCurrentTaskHandle()
+#endif
 
 /* Lists for ready and blocked tasks. --------------------
  * xDelayedTaskList1 and xDelayedTaskList2 could be move to function scople but
@@ -348,6 +663,59 @@ PRIVILEGED_DATA static List_t * volatile pxDelayedTaskList;              /*< Poi
 PRIVILEGED_DATA static List_t * volatile pxOverflowDelayedTaskList;      /*< Points to the delayed task list currently being used to hold tasks that have overflowed the current tick count. */
 PRIVILEGED_DATA static List_t xPendingReadyList;                         /*< Tasks that have been readied while the scheduler was suspended.  They will be moved to the ready list when the scheduler is resumed. */
 
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/* With the timing wheel the delayed tasks are held in xDelayWheel instead of
+ * pxDelayedTaskList, which stays empty.  A task is held at the level of the
+ * highest digit in which its wake time differs from xDelayWheelTime, in the slot
+ * of its wake time's digit at that level. */
+    PRIVILEGED_DATA static List_t xDelayWheel[ taskWHEEL_LEVELS ][ taskWHEEL_SLOTS ]; /*< Delayed tasks, unsorted within each slot. */
+    PRIVILEGED_DATA static uint32_t ulDelayWheelOccupied[ taskWHEEL_LEVELS ];         /*< A bit per slot that might not be empty.  Bits are only cleared when the slot is next looked at, as tasks also leave the wheel through uxListRemove(). */
+    PRIVILEGED_DATA static TickType_t xDelayWheelTime = ( TickType_t ) 0U;             /*< The time the wheel is arranged around.  Never later than the wake time of any task in the wheel. */
+
+#endif
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    PRIVILEGED_DATA static TCB_t * pxBudgetedTasks = NULL;                                        /*< The tasks that have a budget, linked through pxNextBudgeted. */
+    PRIVILEGED_DATA static List_t xThrottledTaskList;                                             /*< Tasks that used up their budget with eBudgetSuspend, and would otherwise be ready. */
+    PRIVILEGED_DATA static volatile TickType_t xNextBudgetReplenishTime = ( TickType_t ) 0U;      /*< The earliest xBudgetReplenishTime of the tasks that have a budget. */
+    PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulBudgetChargedTime = 0UL;                 /*< The run time counter value up to which the running task's budget has been charged. */
+
+#endif
+
+#if ( configUSE_TIME_SLICE_QUANTA == 1 )
+
+    PRIVILEGED_DATA static TickType_t xTimeSliceTicks[ configMAX_PRIORITIES ] = { 0U }; /*< The time slice of each priority in ticks, 0 for configTIME_SLICE_TICKS. */
+
+    #if ( configNUMBER_OF_CORES == 1 )
+        PRIVILEGED_DATA static TickType_t xTimeSliceTicksUsed = ( TickType_t ) 0U;                         /*< The ticks since the running task was switched in. */
+    #else
+        PRIVILEGED_DATA static TickType_t xTimeSliceTicksUsed[ configNUMBER_OF_CORES ] = { ( TickType_t ) 0U }; /*< The ticks since the task running on each core was switched in. */
+    #endif
+
+/* The time slice of uxPriority in ticks. */
+    #define taskPRIORITY_TIME_SLICE_TICKS( uxPriority )    ( ( xTimeSliceTicks[ ( uxPriority ) ] != ( TickType_t ) 0U ) ? xTimeSliceTicks[ ( uxPriority ) ] : ( TickType_t ) configTIME_SLICE_TICKS )
+
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+
+/* The deadline ordered tasks are not time sliced, so a switch the tick finds
+ * is needed at configEDF_TASK_PRIORITY is never held back by a time slice. */
+        #define taskTIME_SLICE_TICKS( uxPriority )                                                 \
+    ( ( ( uxPriority ) == ( UBaseType_t ) configEDF_TASK_PRIORITY ) ? ( TickType_t ) 0U : \
+      taskPRIORITY_TIME_SLICE_TICKS( uxPriority ) )
+    #else
+        #define taskTIME_SLICE_TICKS( uxPriority )    taskPRIORITY_TIME_SLICE_TICKS( uxPriority )
+    #endif
+
+#endif
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    PRIVILEGED_DATA static List_t xAllTasksList; /*< Every task that has been created and not deleted, in the order they were created, so in uxTCBNumber order. */
+
+#endif
+
 #if ( INCLUDE_vTaskDelete == 1 )
 
     PRIVILEGED_DATA static List_t xTasksWaitingTermination; /*< Tasks that have been deleted - but their memory not yet freed. */
@@ -370,14 +738,31 @@ PRIVILEGED_DATA static List_t xPendingReadyList;                         /*< Tas
 /* Other file private variables. --------------------------------*/
 PRIVILEGED_DATA static volatile UBaseType_t uxCurrentNumberOfTasks = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xTickCount = ( TickType_t ) configINITIAL_TICK_COUNT;
-PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+#ifdef portREADY_PRIORITIES_TYPE
+    /* The port keeps the ready priorities in a structure of its own when there
+     * are more of them than bits in a word. */
+    PRIVILEGED_DATA static volatile portREADY_PRIORITIES_TYPE uxTopReadyPriority;
+#else
+    PRIVILEGED_DATA static volatile UBaseType_t uxTopReadyPriority = tskIDLE_PRIORITY;
+#endif
 PRIVILEGED_DATA static volatile BaseType_t xSchedulerRunning = pdFALSE;
 PRIVILEGED_DATA static volatile TickType_t xPendedTicks = ( TickType_t ) 0U;
-PRIVILEGED_DATA static volatile BaseType_t xYieldPending = pdFALSE;
 PRIVILEGED_DATA static volatile BaseType_t xNumOfOverflows = ( BaseType_t ) 0;
 PRIVILEGED_DATA static UBaseType_t uxTaskNumber = ( UBaseType_t ) 0U;
 PRIVILEGED_DATA static volatile TickType_t xNextTaskUnblockTime = ( TickType_t ) 0U; /* Initialised to portMAX_DELAY before the scheduler starts. */
-PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle = NULL;                          /*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+
+#if ( configNUMBER_OF_CORES == 1 )
+    PRIVILEGED_DATA static volatile BaseType_t xYieldPending = pdFALSE;
+    PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandle = NULL; /*< Holds the handle of the idle task.  The idle task is created automatically when the scheduler is started. */
+#else
+
+/* Each core has its own yield pending flag and idle task.  The shared code
+ * refers to the flag of the calling core, and to the idle task of core 0. */
+    PRIVILEGED_DATA static volatile BaseType_t xYieldPendings[ configNUMBER_OF_CORES ] = { pdFALSE };
+    PRIVILEGED_DATA static TaskHandle_t xIdleTaskHandles[ configNUMBER_OF_CORES ] = { NULL };
+    #define xYieldPending      xYieldPendings[ portGET_CORE_ID() ]
+    #define xIdleTaskHandle    xIdleTaskHandles[ 0 ]
+#endif
 
 /* Context switches are held pending while the scheduler is suspended.  Also,
  * interrupts must not manipulate the xStateListItem of a TCB, or any of the
@@ -393,8 +778,14 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t
 
 /* Do not move these variables to function scope as doing so prevents the
  * code working with debuggers that need to remove the static qualifier. */
-    PRIVILEGED_DATA static uint32_t ulTaskSwitchedInTime = 0UL;    /*< Holds the value of a timer/counter the last time a task was switched in. */
-    PRIVILEGED_DATA static volatile uint32_t ulTotalRunTime = 0UL; /*< Holds the total amount of execution time as defined by the run time counter clock. */
+    #if ( configNUMBER_OF_CORES == 1 )
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime = 0UL; /*< Holds the value of a timer/counter the last time a task was switched in. */
+    #else
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulTaskSwitchedInTime[ configNUMBER_OF_CORES ] = { 0UL };     /*< Holds the value of a timer/counter the last time a task was switched in on each core. */
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCoreRunTimeCounter[ configNUMBER_OF_CORES ] = { 0UL };     /*< The time each core has spent running tasks other than the idle tasks. */
+        PRIVILEGED_DATA static configRUN_TIME_COUNTER_TYPE ulCoreIdleRunTimeCounter[ configNUMBER_OF_CORES ] = { 0UL }; /*< The time each core has spent running an idle task. */
+    #endif
+    PRIVILEGED_DATA static volatile configRUN_TIME_COUNTER_TYPE ulTotalRunTime = 0UL; /*< Holds the total amount of execution time as defined by the run time counter clock. */
 
 #endif
 
@@ -520,6 +911,87 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
  */
 static void prvResetNextTaskUnblockTime( void ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/*
+ * Place a task of priority configEDF_TASK_PRIORITY in its ready list, which is
+ * kept in order of absolute deadline.
+ */
+    static void prvAddTaskToDeadlineOrderedList( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+/*
+ * Demote or suspend a task, as its eBudgetAction says, because it has used up
+ * its budget.  Called from vTaskSwitchContext(), each time the task is switched
+ * out until the budget is replenished.
+ */
+    static void prvThrottleTask( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * End the demotion or suspension of a task whose budget has been replenished,
+ * returning pdTRUE if the task should preempt the running task.
+ */
+    static BaseType_t prvReleaseThrottledTask( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Start a new budget period for each task whose period has ended at
+ * xTimeNow, returning pdTRUE if a task that was throttled should preempt the
+ * running task.  Called from the tick interrupt.
+ */
+    static BaseType_t prvReplenishBudgets( const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Change the priority a task runs at, without changing its base priority, and
+ * move it to the matching ready list if it is ready.
+ */
+    static void prvSetTaskRunPriority( TCB_t * pxTCB,
+                                       UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
+
+/*
+ * Take a task out of the list of tasks that have a budget, if it is in it.
+ */
+    static void prvRemoveBudgetedTask( const TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( ( configUSE_TASK_POOLS == 1 ) && ( INCLUDE_vTaskDelete == 1 ) )
+
+/*
+ * Called by prvDeleteTCB() for a task created from a pool.  Fills the part of
+ * the stack the task used, if stacks are filled at all, and puts the slot back
+ * in the pool's list of free slots.
+ */
+    static void prvReturnTaskToPool( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+/*
+ * Place the state list item of a delayed task, the value of which is the
+ * task's wake time, in the timing wheel.  The wake time must not be earlier
+ * than xDelayWheelTime.
+ */
+    static void prvDelayWheelInsert( ListItem_t * const pxListItem ) PRIVILEGED_FUNCTION;
+
+/*
+ * Re-arrange the timing wheel around xTime, which must not be later than the
+ * wake time of any task in the wheel, and return the slot that holds the tasks
+ * that wake at xTime.
+ */
+    static List_t * prvDelayWheelAdvance( const TickType_t xTime ) PRIVILEGED_FUNCTION;
+
+/*
+ * Re-arrange the (empty) timing wheel around a tick count of zero and move the
+ * tasks whose wake time had overflowed into it.
+ */
+    static void prvDelayWheelOverflow( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 #if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
 /*
@@ -550,6 +1022,111 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
  */
 static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+/*
+ * Marks notification uxIndexToNotify of pxTCB as received and updates its value
+ * as eAction specifies, passing out the state the notification was in before.
+ * Returns pdFAIL if eAction is eSetValueWithoutOverwrite and a notification was
+ * already pending, otherwise pdPASS.  Must be called with interrupts masked.
+ */
+    static BaseType_t prvUpdateNotification( TCB_t * pxTCB,
+                                             UBaseType_t uxIndexToNotify,
+                                             uint32_t ulValue,
+                                             eNotifyAction eAction,
+                                             uint8_t * pucOriginalNotifyState ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_MUTEXES == 1 )
+
+/*
+ * Changes the priority of pxTCB, which holds a mutex, to uxNewPriority as the
+ * result of priority inheritance or a priority ceiling, moving the task to the
+ * matching ready list if it is ready.  A task blocked on another mutex is also
+ * moved to its new place among the tasks waiting for that mutex.  Must be
+ * called from a critical section.
+ */
+    static void prvSetMutexHolderPriority( TCB_t * const pxTCB,
+                                           UBaseType_t uxNewPriority ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+/*
+ * Records that pxTCB, if it is blocked in xMultiWaitForObjects(), has been
+ * woken, so the list items it left on the event lists of its other objects
+ * are skipped from now on.  Must be called with interrupts masked.
+ */
+    static void prvMultiWaitWoken( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the list items left by tasks that have been woken from
+ * xMultiWaitForObjects() from the head of pxEventList, so the head is either
+ * a task that is still waiting or the end of the list.
+ */
+    static void prvRemoveStaleMultiWaitItems( const List_t * const pxEventList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes the list items pxTCB placed on event lists in xMultiWaitForObjects()
+ * from the lists that still hold them.
+ */
+    static void prvRemoveMultiWaitItems( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+/*
+ * Called by vTaskSwitchContext() after pxNewTCB was selected to run in place
+ * of pxOldTCB at run time counter value ulNow.  Counts the switch and, if the
+ * new task was woken, its wake latency.
+ */
+    static void prvRecordTaskSwitch( TCB_t * pxOldTCB,
+                                     TCB_t * pxNewTCB,
+                                     configRUN_TIME_COUNTER_TYPE ulNow ) PRIVILEGED_FUNCTION;
+
+#endif
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+/*
+ * Selects the task core xCoreID runs next - the highest priority ready task
+ * that is not running on another core and is allowed to run on this one.  The
+ * task the core was running goes to the end of its ready list first, so tasks
+ * of equal priority take turns.
+ */
+    static void prvSelectHighestPriorityTask( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+/*
+ * Requests a context switch on core xCoreID.  Another core is sent a yield
+ * interrupt.  For the calling core pdTRUE is returned instead, and the caller
+ * yields exactly as it would on a single core.  Must be called from a critical
+ * section or with the scheduler suspended.
+ */
+    static BaseType_t prvYieldCore( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns pdTRUE if core xCoreID shares its time with the ready tasks of the
+ * priority it is running, which it does if there are more of them than cores
+ * running that priority.  Must be called from a critical section.
+ */
+    #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+        static BaseType_t prvPeerIsReady( BaseType_t xCoreID ) PRIVILEGED_FUNCTION;
+    #endif
+
+/*
+ * Called when pxTCB has entered the Ready state.  Finds the core running the
+ * lowest priority task, if that priority is below that of pxTCB, and requests a
+ * context switch on it.  The idle tasks count as having a priority below
+ * tskIDLE_PRIORITY.  Returns pdTRUE if the core is the calling core.  Must be
+ * called from a critical section or with the scheduler suspended.
+ */
+    static BaseType_t prvYieldForTask( const TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif /* configNUMBER_OF_CORES */
+
 /*
  * freertos_tasks_c_additions_init() should only be called if the user definable
  * macro FREERTOS_TASKS_C_ADDITIONS_INIT() is defined, as that is the only macro
@@ -605,6 +1182,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 }
             #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+            #if ( configUSE_TASK_POOLS == 1 )
+                {
+                    pxNewTCB->pxPool = NULL;
+                }
+            #endif
+
             prvInitialiseNewTask( pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &xReturn, pxNewTCB, NULL );
             prvAddNewTaskToReadyList( pxNewTCB );
         }
@@ -648,6 +1231,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 }
             #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+            #if ( configUSE_TASK_POOLS == 1 )
+                {
+                    pxNewTCB->pxPool = NULL;
+                }
+            #endif
+
             prvInitialiseNewTask( pxTaskDefinition->pvTaskCode,
                                   pxTaskDefinition->pcName,
                                   ( uint32_t ) pxTaskDefinition->usStackDepth,
@@ -697,6 +1286,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                     }
                 #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+                #if ( configUSE_TASK_POOLS == 1 )
+                    {
+                        pxNewTCB->pxPool = NULL;
+                    }
+                #endif
+
                 prvInitialiseNewTask( pxTaskDefinition->pvTaskCode,
                                       pxTaskDefinition->pcName,
                                       ( uint32_t ) pxTaskDefinition->usStackDepth,
@@ -743,7 +1338,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                     /* Allocate space for the stack used by the task being created.
                      * The base of the stack memory stored in the TCB so the task can
                      * be deleted later if required. */
-                    pxNewTCB->pxStack = ( StackType_t * ) pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                    pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
 
                     if( pxNewTCB->pxStack == NULL )
                     {
@@ -758,7 +1353,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 StackType_t * pxStack;
 
                 /* Allocate space for the stack used by the task being created. */
-                pxStack = pvPortMalloc( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
+                pxStack = pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation is the stack. */
 
                 if( pxStack != NULL )
                 {
@@ -774,7 +1369,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                     {
                         /* The stack cannot be used as the TCB was not created.  Free
                          * it again. */
-                        vPortFree( pxStack );
+                        vPortFreeStack( pxStack );
                     }
                 }
                 else
@@ -794,6 +1389,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                 }
             #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+            #if ( configUSE_TASK_POOLS == 1 )
+                {
+                    pxNewTCB->pxPool = NULL;
+                }
+            #endif
+
             prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
             prvAddNewTaskToReadyList( pxNewTCB );
             xReturn = pdPASS;
@@ -809,42 +1410,247 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
 #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 /*-----------------------------------------------------------*/
 
-static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
-                                  const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
-                                  const uint32_t ulStackDepth,
-                                  void * const pvParameters,
-                                  UBaseType_t uxPriority,
-                                  TaskHandle_t * const pxCreatedTask,
-                                  TCB_t * pxNewTCB,
-                                  const MemoryRegion_t * const xRegions )
-{
-    StackType_t * pxTopOfStack;
-    UBaseType_t x;
+#if ( ( configUSE_EDF_SCHEDULING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
 
-    #if ( portUSING_MPU_WRAPPERS == 1 )
-        /* Should the task be created in privileged mode? */
-        BaseType_t xRunPrivileged;
+    BaseType_t xTaskCreateWithDeadline( TaskFunction_t pxTaskCode,
+                                        const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                        const configSTACK_DEPTH_TYPE usStackDepth,
+                                        void * const pvParameters,
+                                        TickType_t xRelativeDeadline,
+                                        TickType_t xPeriod,
+                                        TaskHandle_t * const pxCreatedTask )
+    {
+        TCB_t * pxNewTCB = NULL;
+        BaseType_t xReturn;
 
-        if( ( uxPriority & portPRIVILEGE_BIT ) != 0U )
-        {
-            xRunPrivileged = pdTRUE;
-        }
-        else
-        {
-            xRunPrivileged = pdFALSE;
-        }
-        uxPriority &= ~portPRIVILEGE_BIT;
-    #endif /* portUSING_MPU_WRAPPERS == 1 */
+        configASSERT( xRelativeDeadline > ( TickType_t ) 0U );
+        configASSERT( xPeriod > ( TickType_t ) 0U );
 
-    /* Avoid dependency on memset() if it is not required. */
-    #if ( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+        /* The task must not run before it has its deadline, so it is created
+         * with the scheduler suspended. */
+        vTaskSuspendAll();
         {
-            /* Fill the stack with a known value to assist debugging. */
-            ( void ) memset( pxNewTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) ulStackDepth * sizeof( StackType_t ) );
-        }
-    #endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+            xReturn = xTaskCreate( pxTaskCode, pcName, usStackDepth, pvParameters, configEDF_TASK_PRIORITY, ( TaskHandle_t * ) &pxNewTCB );
 
-    /* Calculate the top of stack address.  This depends on whether the stack
+            if( xReturn == pdPASS )
+            {
+                /* The first job is released now. */
+                pxNewTCB->xRelativeDeadline = xRelativeDeadline;
+                pxNewTCB->xPeriod = xPeriod;
+                pxNewTCB->xReleaseTime = xTickCount;
+                pxNewTCB->xAbsoluteDeadline = pxNewTCB->xReleaseTime + xRelativeDeadline;
+
+                /* The task was placed in the ready list as a task without a
+                 * deadline, so move it to its place in deadline order. */
+                ( void ) uxListRemove( &( pxNewTCB->xStateListItem ) );
+                prvAddTaskToReadyList( pxNewTCB );
+
+                if( pxCreatedTask != NULL )
+                {
+                    *pxCreatedTask = ( TaskHandle_t ) pxNewTCB;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xReturn;
+    }
+
+#endif /* ( configUSE_EDF_SCHEDULING == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_POOLS == 1 )
+
+    TaskPoolHandle_t xTaskPoolCreate( UBaseType_t uxTasks,
+                                      configSTACK_DEPTH_TYPE usStackDepth )
+    {
+        TaskPool_t * pxPool;
+        TCB_t * pxTCB;
+        UBaseType_t x;
+
+        configASSERT( uxTasks > ( UBaseType_t ) 0U );
+
+        pxPool = ( TaskPool_t * ) pvPortMalloc( sizeof( TaskPool_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack. */
+
+        if( pxPool != NULL )
+        {
+            /* The TCBs are a single allocation.  Each stack is allocated
+             * separately with pvPortMallocStack(), so it is placed as the port
+             * places any other task stack. */
+            pxPool->pxSlots = ( TCB_t * ) pvPortMalloc( ( size_t ) uxTasks * sizeof( TCB_t ) ); /*lint !e9087 !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack. */
+            pxPool->uxSlots = 0;
+            pxPool->usStackDepth = usStackDepth;
+            vListInitialise( &( pxPool->xFreeSlots ) );
+
+            if( pxPool->pxSlots != NULL )
+            {
+                for( x = 0; x < uxTasks; x++ )
+                {
+                    pxTCB = &( pxPool->pxSlots[ x ] );
+                    pxTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) usStackDepth ) * sizeof( StackType_t ) ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+                    if( pxTCB->pxStack == NULL )
+                    {
+                        break;
+                    }
+
+                    /* Fill the stack now so it need not be filled each time a
+                     * task is created in the slot. */
+                    #if ( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+                        {
+                            ( void ) memset( pxTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) usStackDepth * sizeof( StackType_t ) );
+                        }
+                    #endif
+
+                    pxTCB->pxPool = pxPool;
+                    vListInitialiseItem( &( pxTCB->xStateListItem ) );
+                    listSET_LIST_ITEM_OWNER( &( pxTCB->xStateListItem ), pxTCB );
+                    vListInsertEnd( &( pxPool->xFreeSlots ), &( pxTCB->xStateListItem ) );
+                    pxPool->uxSlots++;
+                }
+            }
+
+            if( pxPool->uxSlots != uxTasks )
+            {
+                /* Not all the slots could be allocated, so free what was. */
+                for( x = 0; x < pxPool->uxSlots; x++ )
+                {
+                    vPortFreeStack( pxPool->pxSlots[ x ].pxStack );
+                }
+
+                vPortFree( pxPool->pxSlots );
+                vPortFree( pxPool );
+                pxPool = NULL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return pxPool;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTaskCreateFromPool( TaskPoolHandle_t xPool,
+                                    TaskFunction_t pxTaskCode,
+                                    const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                    void * const pvParameters,
+                                    UBaseType_t uxPriority,
+                                    TaskHandle_t * const pxCreatedTask )
+    {
+        TaskPool_t * const pxPool = xPool;
+        TCB_t * pxNewTCB = NULL;
+        BaseType_t xReturn;
+
+        configASSERT( pxPool );
+
+        /* Taking a slot is only a list removal, so a critical section is held
+         * rather than the scheduler suspended as pvPortMalloc() would. */
+        taskENTER_CRITICAL();
+        {
+            if( listLIST_IS_EMPTY( &( pxPool->xFreeSlots ) ) == pdFALSE )
+            {
+                pxNewTCB = listGET_OWNER_OF_HEAD_ENTRY( &( pxPool->xFreeSlots ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                ( void ) uxListRemove( &( pxNewTCB->xStateListItem ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( pxNewTCB != NULL )
+        {
+            #if ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
+                {
+                    /* The memory belongs to the pool, which is checked for
+                     * before this when the task is deleted. */
+                    pxNewTCB->ucStaticallyAllocated = tskSTATICALLY_ALLOCATED_STACK_AND_TCB;
+                }
+            #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
+
+            prvInitialiseNewTask( pxTaskCode, pcName, ( uint32_t ) pxPool->usStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
+            prvAddNewTaskToReadyList( pxNewTCB );
+            xReturn = pdPASS;
+        }
+        else
+        {
+            xReturn = errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxTaskPoolGetFreeSlots( TaskPoolHandle_t xPool )
+    {
+        TaskPool_t * const pxPool = xPool;
+
+        configASSERT( pxPool );
+
+        return listCURRENT_LIST_LENGTH( &( pxPool->xFreeSlots ) );
+    }
+
+#endif /* configUSE_TASK_POOLS */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
+                                  const char * const pcName, /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+                                  const uint32_t ulStackDepth,
+                                  void * const pvParameters,
+                                  UBaseType_t uxPriority,
+                                  TaskHandle_t * const pxCreatedTask,
+                                  TCB_t * pxNewTCB,
+                                  const MemoryRegion_t * const xRegions )
+{
+    StackType_t * pxTopOfStack;
+    UBaseType_t x;
+
+    #if ( portUSING_MPU_WRAPPERS == 1 )
+        /* Should the task be created in privileged mode? */
+        BaseType_t xRunPrivileged;
+
+        if( ( uxPriority & portPRIVILEGE_BIT ) != 0U )
+        {
+            xRunPrivileged = pdTRUE;
+        }
+        else
+        {
+            xRunPrivileged = pdFALSE;
+        }
+        uxPriority &= ~portPRIVILEGE_BIT;
+    #endif /* portUSING_MPU_WRAPPERS == 1 */
+
+    /* Avoid dependency on memset() if it is not required. */
+    #if ( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+        {
+            if( tskSTACK_IS_FILLED( pxNewTCB ) == pdFALSE )
+            {
+                /* Fill the stack with a known value to assist debugging. */
+                ( void ) memset( pxNewTCB->pxStack, ( int ) tskSTACK_FILL_BYTE, ( size_t ) ulStackDepth * sizeof( StackType_t ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    #endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+
+    /* Calculate the top of stack address.  This depends on whether the stack
      * grows from high memory to low (as per the 80x86) or vice versa.
      * portSTACK_GROWTH is used to make the result positive or negative as required
      * by the port. */
@@ -924,6 +1730,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         {
             pxNewTCB->uxBasePriority = uxPriority;
             pxNewTCB->uxMutexesHeld = 0;
+
+            #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                {
+                    pxNewTCB->pxWaitingMutexHolder = NULL;
+                }
+            #endif
         }
     #endif /* configUSE_MUTEXES */
 
@@ -938,6 +1750,13 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     listSET_LIST_ITEM_VALUE( &( pxNewTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
     listSET_LIST_ITEM_OWNER( &( pxNewTCB->xEventListItem ), pxNewTCB );
 
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        {
+            vListInitialiseItem( &( pxNewTCB->xAllTasksListItem ) );
+            listSET_LIST_ITEM_OWNER( &( pxNewTCB->xAllTasksListItem ), pxNewTCB );
+        }
+    #endif /* configUSE_TRACE_FACILITY */
+
     #if ( portCRITICAL_NESTING_IN_TCB == 1 )
         {
             pxNewTCB->uxCriticalNesting = ( UBaseType_t ) 0U;
@@ -953,6 +1772,14 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     #if ( configGENERATE_RUN_TIME_STATS == 1 )
         {
             pxNewTCB->ulRunTimeCounter = 0UL;
+            pxNewTCB->ulReadyTime = 0UL;
+            pxNewTCB->ulWakeLatencyTotal = 0UL;
+            pxNewTCB->ulSwitchesIn = 0UL;
+            pxNewTCB->ulPreemptions = 0UL;
+            pxNewTCB->ulWakeups = 0UL;
+            pxNewTCB->ulWakeLatencyMin = 0UL;
+            pxNewTCB->ulWakeLatencyMax = 0UL;
+            pxNewTCB->xReadyTimeValid = pdFALSE;
         }
     #endif /* configGENERATE_RUN_TIME_STATS */
 
@@ -995,6 +1822,61 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         }
     #endif
 
+    #if ( configUSE_MULTI_WAIT == 1 )
+        {
+            pxNewTCB->pxMultiWaitObjects = NULL;
+            pxNewTCB->uxMultiWaitObjectCount = 0;
+            pxNewTCB->ucMultiWaitState = taskMULTI_WAIT_NONE;
+        }
+    #endif
+
+    #if ( configNUMBER_OF_CORES > 1 )
+        {
+            pxNewTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+
+            if( pxTaskCode == prvIdleTask )
+            {
+                pxNewTCB->uxTaskAttributes = taskATTRIBUTE_IS_IDLE;
+            }
+            else
+            {
+                pxNewTCB->uxTaskAttributes = 0U;
+            }
+        }
+    #endif
+
+    #if ( configUSE_CORE_AFFINITY == 1 )
+        {
+            pxNewTCB->uxCoreAffinityMask = tskNO_AFFINITY;
+        }
+    #endif
+
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        {
+            /* xTaskCreateWithDeadline() gives the task its deadline once it
+             * has been created. */
+            pxNewTCB->xRelativeDeadline = ( TickType_t ) 0U;
+            pxNewTCB->xPeriod = ( TickType_t ) 0U;
+            pxNewTCB->xReleaseTime = ( TickType_t ) 0U;
+            pxNewTCB->xAbsoluteDeadline = ( TickType_t ) 0U;
+            pxNewTCB->uxDeadlineMisses = ( UBaseType_t ) 0U;
+        }
+    #endif
+
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        {
+            pxNewTCB->ulBudget = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+            pxNewTCB->ulBudgetUsed = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+            pxNewTCB->xBudgetPeriod = ( TickType_t ) 0U;
+            pxNewTCB->xBudgetReplenishTime = ( TickType_t ) 0U;
+            pxNewTCB->uxDemotedPriority = tskIDLE_PRIORITY;
+            pxNewTCB->uxBudgetOverruns = ( UBaseType_t ) 0U;
+            pxNewTCB->xBudgetExhausted = pdFALSE;
+            pxNewTCB->pxNextBudgeted = NULL;
+            pxNewTCB->ucBudgetAction = ( uint8_t ) eBudgetDemote;
+        }
+    #endif
+
     /* Initialize the TCB stack to look as if the task was already running,
      * but had been interrupted by the scheduler.  The return address is set
      * to the start of the task function. Once the stack has been initialised
@@ -1060,6 +1942,8 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
 }
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES == 1 )
+
 static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 {
     /* Ensure interrupts don't access the task lists while the lists are being
@@ -1114,6 +1998,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             {
                 /* Add a counter into the TCB for tracing only. */
                 pxNewTCB->uxTCBNumber = uxTaskNumber;
+                vListInsertEnd( &xAllTasksList, &( pxNewTCB->xAllTasksListItem ) );
             }
         #endif /* configUSE_TRACE_FACILITY */
         traceTASK_CREATE( pxNewTCB );
@@ -1142,6 +2027,84 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
         mtCOVERAGE_TEST_MARKER();
     }
 }
+
+#else /* configNUMBER_OF_CORES */
+
+    static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
+    {
+        BaseType_t xCoreID, xYieldRequired = pdFALSE;
+
+        /* Ensure interrupts don't access the task lists while the lists are
+         * being updated. */
+        taskENTER_CRITICAL();
+        {
+            uxCurrentNumberOfTasks++;
+
+            if( uxCurrentNumberOfTasks == ( UBaseType_t ) 1 )
+            {
+                /* This is the first task to be created so do the preliminary
+                 * initialisation required. */
+                prvInitialiseTaskLists();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Each core starts by running its own idle task, as there is one
+             * idle task per core.  Every core then selects the task it should
+             * run the first time it is yielded by the port, so no other task
+             * is made current before the scheduler starts. */
+            if( ( xSchedulerRunning == pdFALSE ) &&
+                ( ( pxNewTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U ) )
+            {
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    if( pxCurrentTCBs[ xCoreID ] == NULL )
+                    {
+                        pxNewTCB->xTaskRunState = xCoreID;
+                        pxCurrentTCBs[ xCoreID ] = pxNewTCB;
+                        break;
+                    }
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            uxTaskNumber++;
+
+            #if ( configUSE_TRACE_FACILITY == 1 )
+                {
+                    /* Add a counter into the TCB for tracing only. */
+                    pxNewTCB->uxTCBNumber = uxTaskNumber;
+                    vListInsertEnd( &xAllTasksList, &( pxNewTCB->xAllTasksListItem ) );
+                }
+            #endif /* configUSE_TRACE_FACILITY */
+            traceTASK_CREATE( pxNewTCB );
+
+            prvAddTaskToReadyList( pxNewTCB );
+
+            portSETUP_TCB( pxNewTCB );
+
+            /* If the created task is of a higher priority than the task
+             * running on any core it may run on, then it should run now. */
+            xYieldRequired = prvYieldForTask( pxNewTCB );
+        }
+        taskEXIT_CRITICAL();
+
+        if( xYieldRequired != pdFALSE )
+        {
+            taskYIELD_IF_USING_PREEMPTION();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configNUMBER_OF_CORES */
 /*-----------------------------------------------------------*/
 
 #if ( INCLUDE_vTaskDelete == 1 )
@@ -1176,6 +2139,24 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_MULTI_WAIT == 1 )
+                {
+                    prvRemoveMultiWaitItems( pxTCB );
+                }
+            #endif
+
+            #if ( configUSE_TASK_BUDGETS == 1 )
+                {
+                    prvRemoveBudgetedTask( pxTCB );
+                }
+            #endif
+
+            #if ( configUSE_TRACE_FACILITY == 1 )
+                {
+                    ( void ) uxListRemove( &( pxTCB->xAllTasksListItem ) );
+                }
+            #endif
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1207,6 +2188,19 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                  * required. */
                 portPRE_TASK_DELETE_HOOK( pxTCB, &xYieldPending );
             }
+
+            #if ( configNUMBER_OF_CORES > 1 )
+                else if( pxTCB->xTaskRunState != taskTASK_NOT_RUNNING )
+                {
+                    /* The task is running on another core, so cannot be freed
+                     * until that core has switched away from it.  The idle task
+                     * frees it once it is no longer running. */
+                    vListInsertEnd( &xTasksWaitingTermination, &( pxTCB->xStateListItem ) );
+                    ++uxDeletedTasksWaitingCleanUp;
+                    traceTASK_DELETE( pxTCB );
+                    ( void ) prvYieldCore( pxTCB->xTaskRunState );
+                }
+            #endif /* configNUMBER_OF_CORES */
             else
             {
                 --uxCurrentNumberOfTasks;
@@ -1226,7 +2220,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
         {
             if( pxTCB == pxCurrentTCB )
             {
-                configASSERT( uxSchedulerSuspended == 0 );
+                taskASSERT_SCHEDULER_NOT_SUSPENDED();
                 portYIELD_WITHIN_API();
             }
             else
@@ -1249,7 +2243,7 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 
         configASSERT( pxPreviousWakeTime );
         configASSERT( ( xTimeIncrement > 0U ) );
-        configASSERT( uxSchedulerSuspended == 0 );
+        taskASSERT_SCHEDULER_NOT_SUSPENDED();
 
         vTaskSuspendAll();
         {
@@ -1324,19 +2318,518 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_vTaskDelayUntil */
 /*-----------------------------------------------------------*/
 
-#if ( INCLUDE_vTaskDelay == 1 )
+#if ( configUSE_EDF_SCHEDULING == 1 )
 
-    void vTaskDelay( const TickType_t xTicksToDelay )
+    void vTaskWaitForNextPeriod( void )
     {
-        BaseType_t xAlreadyYielded = pdFALSE;
+        TCB_t * const pxTCB = pxCurrentTCB;
+        BaseType_t xAlreadyYielded;
 
-        /* A delay time of zero just forces a reschedule. */
-        if( xTicksToDelay > ( TickType_t ) 0U )
-        {
-            configASSERT( uxSchedulerSuspended == 0 );
-            vTaskSuspendAll();
-            {
-                traceTASK_DELAY();
+        configASSERT( pxTCB->xRelativeDeadline > ( TickType_t ) 0U );
+        taskASSERT_SCHEDULER_NOT_SUSPENDED();
+
+        vTaskSuspendAll();
+        {
+            /* Minor optimisation.  The tick count cannot change in this
+             * block. */
+            const TickType_t xConstTickCount = xTickCount;
+
+            /* The job just completed.  It met its deadline if it completed
+             * before the deadline's tick period was over. */
+            if( taskTIME_IS_BEFORE( pxTCB->xAbsoluteDeadline, xConstTickCount ) )
+            {
+                ( pxTCB->uxDeadlineMisses )++;
+                traceTASK_DEADLINE_MISSED( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            pxTCB->xReleaseTime += pxTCB->xPeriod;
+            pxTCB->xAbsoluteDeadline = pxTCB->xReleaseTime + pxTCB->xRelativeDeadline;
+
+            if( taskTIME_IS_BEFORE( xConstTickCount, pxTCB->xReleaseTime ) )
+            {
+                traceTASK_DELAY_UNTIL( pxTCB->xReleaseTime );
+
+                /* The task is selected in deadline order again when the
+                 * delay ends and it is added back to the ready list. */
+                prvAddCurrentTaskToDelayedList( pxTCB->xReleaseTime - xConstTickCount, pdFALSE );
+            }
+            else
+            {
+                /* The job overran its period, so the next one has already been
+                 * released.  Move the task to its place for the new deadline,
+                 * behind any task whose deadline is earlier. */
+                if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                {
+                    portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                prvAddTaskToReadyList( pxTCB );
+                xYieldPending = pdTRUE;
+            }
+        }
+        xAlreadyYielded = xTaskResumeAll();
+
+        if( xAlreadyYielded == pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvAddTaskToDeadlineOrderedList( TCB_t * pxTCB )
+    {
+        List_t * const pxList = &( pxReadyTasksLists[ configEDF_TASK_PRIORITY ] );
+        ListItem_t const * const pxEnd = listGET_END_MARKER( pxList );
+        ListItem_t * pxIterator;
+        const TCB_t * pxOtherTCB;
+
+        /* A task without a deadline goes to the front.  A task with a deadline
+         * goes behind the tasks without one and behind the tasks whose
+         * deadline is the same or earlier.  The deadlines are compared
+         * relative to each other, rather than as list item values, so the
+         * order is kept while the tick count wraps. */
+        pxIterator = listGET_HEAD_ENTRY( pxList );
+
+        while( pxIterator != pxEnd )
+        {
+            pxOtherTCB = listGET_LIST_ITEM_OWNER( pxIterator );
+
+            if( taskDEADLINE_IS_BEFORE( pxTCB, pxOtherTCB ) )
+            {
+                break;
+            }
+
+            pxIterator = listGET_NEXT( pxIterator );
+        }
+
+        /* vListInsertEnd() inserts in front of the list's index, which is not
+         * otherwise used by this list as the task at its head is the one
+         * selected. */
+        pxList->pxIndex = pxIterator;
+        vListInsertEnd( pxList, &( pxTCB->xStateListItem ) );
+        pxList->pxIndex = ( ListItem_t * ) &( pxList->xListEnd );
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    void vTaskSetBudget( TaskHandle_t xTask,
+                         configRUN_TIME_COUNTER_TYPE ulBudget,
+                         TickType_t xPeriod,
+                         eBudgetAction eAction,
+                         UBaseType_t uxDemotedPriority )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        configASSERT( ( ulBudget == ( configRUN_TIME_COUNTER_TYPE ) 0U ) || ( xPeriod > ( TickType_t ) 0U ) );
+        configASSERT( uxDemotedPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+        taskENTER_CRITICAL();
+        {
+            /* If null is passed in here then it is the budget of the calling
+             * task that is being set. */
+            pxTCB = prvGetTCBFromHandle( xTask );
+
+            /* A task that is given a new budget starts a new period with all
+             * of it, so a task that used up its old budget is released. */
+            prvRemoveBudgetedTask( pxTCB );
+            pxTCB->ulBudget = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+            pxTCB->ulBudgetUsed = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+            xYieldRequired = prvReleaseThrottledTask( pxTCB );
+
+            pxTCB->ulBudget = ulBudget;
+            pxTCB->xBudgetPeriod = xPeriod;
+            pxTCB->xBudgetReplenishTime = xTickCount + xPeriod;
+            pxTCB->ucBudgetAction = ( uint8_t ) eAction;
+            pxTCB->uxDemotedPriority = uxDemotedPriority;
+
+            if( ulBudget != ( configRUN_TIME_COUNTER_TYPE ) 0U )
+            {
+                if( ( pxBudgetedTasks == NULL ) || taskTIME_IS_BEFORE( pxTCB->xBudgetReplenishTime, xNextBudgetReplenishTime ) )
+                {
+                    xNextBudgetReplenishTime = pxTCB->xBudgetReplenishTime;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxTCB->pxNextBudgeted = pxBudgetedTasks;
+                pxBudgetedTasks = pxTCB;
+
+                if( pxTCB == pxCurrentTCB )
+                {
+                    /* Only the time the task runs from now on is charged. */
+                    taskREAD_RUN_TIME_COUNTER( ulBudgetChargedTime );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( xYieldRequired != pdFALSE )
+            {
+                taskYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvThrottleTask( TCB_t * pxTCB )
+    {
+        if( pxTCB->xBudgetExhausted == pdFALSE )
+        {
+            pxTCB->xBudgetExhausted = pdTRUE;
+            ( pxTCB->uxBudgetOverruns )++;
+            traceTASK_BUDGET_EXHAUSTED( pxTCB );
+
+            /* A task that is switched out because it blocked is held back by
+             * prvAddTaskToReadyList() when it is unblocked instead, as is a
+             * task that is inheriting a priority once it gives the mutex back. */
+            if( ( pxTCB->ucBudgetAction == ( uint8_t ) eBudgetSuspend ) &&
+                ( pxTCB->uxPriority == pxTCB->uxBasePriority ) )
+            {
+                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                {
+                    if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                    {
+                        portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    vListInsertEnd( &xThrottledTaskList, &( pxTCB->xStateListItem ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* Nor is a task demoted while it has inherited a priority from a task
+         * waiting for a mutex it holds.  Releasing the mutex restores its base
+         * priority, so it is demoted the next time it is switched out. */
+        if( ( pxTCB->ucBudgetAction == ( uint8_t ) eBudgetDemote ) &&
+            ( pxTCB->uxPriority == pxTCB->uxBasePriority ) &&
+            ( pxTCB->uxPriority > pxTCB->uxDemotedPriority ) )
+        {
+            prvSetTaskRunPriority( pxTCB, pxTCB->uxDemotedPriority );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReleaseThrottledTask( TCB_t * pxTCB )
+    {
+        BaseType_t xYieldRequired = pdFALSE;
+
+        if( pxTCB->xBudgetExhausted != pdFALSE )
+        {
+            pxTCB->xBudgetExhausted = pdFALSE;
+            traceTASK_BUDGET_REPLENISHED( pxTCB );
+
+            if( pxTCB->ucBudgetAction == ( uint8_t ) eBudgetSuspend )
+            {
+                if( listIS_CONTAINED_WITHIN( &xThrottledTaskList, &( pxTCB->xStateListItem ) ) != pdFALSE )
+                {
+                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                    prvAddTaskToReadyList( pxTCB );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else if( pxTCB->uxPriority < pxTCB->uxBasePriority )
+            {
+                /* Only a demotion takes the priority below the base priority. */
+                prvSetTaskRunPriority( pxTCB, pxTCB->uxBasePriority );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ( taskPREEMPTS_CURRENT_TASK( pxTCB ) ) &&
+                ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE ) )
+            {
+                xYieldRequired = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xYieldRequired;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvReplenishBudgets( const TickType_t xTimeNow )
+    {
+        TCB_t * pxTCB;
+        TickType_t xTimeToNext = portMAX_DELAY;
+        BaseType_t xSwitchRequired = pdFALSE;
+
+        for( pxTCB = pxBudgetedTasks; pxTCB != NULL; pxTCB = pxTCB->pxNextBudgeted )
+        {
+            if( taskTIME_IS_BEFORE( xTimeNow, pxTCB->xBudgetReplenishTime ) == pdFALSE )
+            {
+                /* The next period starts where this one ended, unless ticks
+                 * were missed for more than a whole period. */
+                pxTCB->xBudgetReplenishTime += pxTCB->xBudgetPeriod;
+
+                if( taskTIME_IS_BEFORE( xTimeNow, pxTCB->xBudgetReplenishTime ) == pdFALSE )
+                {
+                    pxTCB->xBudgetReplenishTime = xTimeNow + pxTCB->xBudgetPeriod;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxTCB->ulBudgetUsed = ( configRUN_TIME_COUNTER_TYPE ) 0U;
+
+                if( pxTCB == pxCurrentTCB )
+                {
+                    /* The time the running task ran in the previous period is
+                     * not charged to the new one. */
+                    taskREAD_RUN_TIME_COUNTER( ulBudgetChargedTime );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( prvReleaseThrottledTask( pxTCB ) != pdFALSE )
+                {
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            if( ( TickType_t ) ( pxTCB->xBudgetReplenishTime - xTimeNow ) < xTimeToNext )
+            {
+                xTimeToNext = pxTCB->xBudgetReplenishTime - xTimeNow;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        xNextBudgetReplenishTime = xTimeNow + xTimeToNext;
+
+        #if ( configUSE_PREEMPTION == 0 )
+            {
+                xSwitchRequired = pdFALSE;
+            }
+        #endif
+
+        return xSwitchRequired;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvSetTaskRunPriority( TCB_t * pxTCB,
+                                       UBaseType_t uxNewPriority )
+    {
+        const UBaseType_t uxPriorityUsedOnEntry = pxTCB->uxPriority;
+
+        traceTASK_PRIORITY_SET( pxTCB, uxNewPriority );
+
+        pxTCB->uxPriority = uxNewPriority;
+
+        /* As vTaskPrioritySet(), only reset the event list item value if the
+         * value is not being used for anything else. */
+        if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+        {
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ) ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+        {
+            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+            {
+                portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            prvAddTaskToReadyList( pxTCB );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvRemoveBudgetedTask( const TCB_t * pxTCB )
+    {
+        TCB_t ** ppxLink;
+
+        for( ppxLink = &pxBudgetedTasks; *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNextBudgeted ) )
+        {
+            if( *ppxLink == pxTCB )
+            {
+                *ppxLink = pxTCB->pxNextBudgeted;
+                break;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIME_SLICE_QUANTA == 1 )
+
+    void vTaskSetTimeSliceTicks( UBaseType_t uxPriority,
+                                 TickType_t xTicks )
+    {
+        configASSERT( uxPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+        /* The tick reads the time slice from the tick interrupt, and a tick
+         * count might not be written atomically. */
+        taskENTER_CRITICAL();
+        {
+            xTimeSliceTicks[ uxPriority ] = xTicks;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    TickType_t xTaskGetTimeSliceTicks( UBaseType_t uxPriority )
+    {
+        TickType_t xReturn;
+
+        configASSERT( uxPriority < ( UBaseType_t ) configMAX_PRIORITIES );
+
+        taskENTER_CRITICAL();
+        {
+            xReturn = taskPRIORITY_TIME_SLICE_TICKS( uxPriority );
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTaskYieldIfPeerReady( void )
+    {
+        BaseType_t xPeerReady;
+
+        taskENTER_CRITICAL();
+        {
+            #if ( configNUMBER_OF_CORES == 1 )
+                {
+                    /* The test the tick makes before time slicing, so a deadline
+                     * ordered task does not yield to one with a later deadline. */
+                    if( ( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 ) &&
+                        ( taskIS_TIME_SLICED( pxCurrentTCB->uxPriority ) != pdFALSE ) )
+                    {
+                        xPeerReady = pdTRUE;
+                    }
+                    else
+                    {
+                        xPeerReady = pdFALSE;
+                    }
+                }
+            #else
+                {
+                    xPeerReady = prvPeerIsReady( portGET_CORE_ID() );
+                }
+            #endif /* configNUMBER_OF_CORES */
+        }
+        taskEXIT_CRITICAL();
+
+        if( xPeerReady != pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xPeerReady;
+    }
+
+#endif /* configUSE_TIME_SLICE_QUANTA */
+/*-----------------------------------------------------------*/
+
+#if ( INCLUDE_vTaskDelay == 1 )
+
+    void vTaskDelay( const TickType_t xTicksToDelay )
+    {
+        BaseType_t xAlreadyYielded = pdFALSE;
+
+        /* A delay time of zero just forces a reschedule. */
+        if( xTicksToDelay > ( TickType_t ) 0U )
+        {
+            taskASSERT_SCHEDULER_NOT_SUSPENDED();
+            vTaskSuspendAll();
+            {
+                traceTASK_DELAY();
 
                 /* A task that is removed from the event list while the
                  * scheduler is suspended will not get placed in the ready
@@ -1379,9 +2872,10 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 
         configASSERT( pxTCB );
 
-        if( pxTCB == pxCurrentTCB )
+        if( taskTASK_IS_RUNNING( pxTCB ) )
         {
-            /* The task calling this function is querying its own state. */
+            /* The task calling this function is querying its own state, or
+             * the state of a task running on another core. */
             eReturn = eRunning;
         }
         else
@@ -1401,6 +2895,21 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 eReturn = eBlocked;
             }
 
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                else if( taskLIST_IS_IN_DELAY_WHEEL( pxStateList ) )
+                {
+                    eReturn = eBlocked;
+                }
+            #endif
+
+            #if ( configUSE_TASK_BUDGETS == 1 )
+                else if( pxStateList == &xThrottledTaskList )
+                {
+                    /* The task is held back until its budget is replenished. */
+                    eReturn = eSuspended;
+                }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
                 else if( pxStateList == &xSuspendedTaskList )
                 {
@@ -1573,6 +3082,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                  * priority than the calling task. */
                 if( uxNewPriority > uxCurrentBasePriority )
                 {
+                    #if ( configNUMBER_OF_CORES > 1 )
+                        {
+                            /* Whether another core should now run the task is
+                             * decided once it is in its new ready list. */
+                        }
+                    #else
                     if( pxTCB != pxCurrentTCB )
                     {
                         /* The priority of a task other than the currently
@@ -1593,13 +3108,22 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                          * but the running task must already be the highest
                          * priority task able to run so no yield is required. */
                     }
+                    #endif /* configNUMBER_OF_CORES */
                 }
-                else if( pxTCB == pxCurrentTCB )
+                else if( taskTASK_IS_RUNNING( pxTCB ) )
                 {
                     /* Setting the priority of the running task down means
                      * there may now be another task of higher priority that
                      * is ready to execute. */
-                    xYieldRequired = pdTRUE;
+                    #if ( configNUMBER_OF_CORES > 1 )
+                        {
+                            xYieldRequired = prvYieldCore( pxTCB->xTaskRunState );
+                        }
+                    #else
+                        {
+                            xYieldRequired = pdTRUE;
+                        }
+                    #endif
                 }
                 else
                 {
@@ -1668,6 +3192,15 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                     }
 
                     prvAddTaskToReadyList( pxTCB );
+
+                    #if ( configNUMBER_OF_CORES > 1 )
+                        {
+                            if( uxNewPriority > uxCurrentBasePriority )
+                            {
+                                xYieldRequired = prvYieldForTask( pxTCB );
+                            }
+                        }
+                    #endif
                 }
                 else
                 {
@@ -1694,6 +3227,83 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_vTaskPrioritySet */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_CORE_AFFINITY == 1 )
+
+    void vTaskCoreAffinitySet( const TaskHandle_t xTask,
+                               UBaseType_t uxCoreAffinityMask )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xYieldRequired = pdFALSE;
+
+        /* The task must be allowed to run on at least one core. */
+        configASSERT( ( uxCoreAffinityMask & ( ( ( UBaseType_t ) 1U << configNUMBER_OF_CORES ) - 1U ) ) != 0U );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            pxTCB->uxCoreAffinityMask = uxCoreAffinityMask;
+
+            if( xSchedulerRunning != pdFALSE )
+            {
+                if( pxTCB->xTaskRunState != taskTASK_NOT_RUNNING )
+                {
+                    /* The task must leave a core it may no longer run on. */
+                    if( ( uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) pxTCB->xTaskRunState ) ) == 0U )
+                    {
+                        xYieldRequired = prvYieldCore( pxTCB->xTaskRunState );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+                {
+                    /* A ready task may now be able to run on a core it could
+                     * not run on before. */
+                    xYieldRequired = prvYieldForTask( pxTCB );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xYieldRequired != pdFALSE )
+        {
+            portYIELD_WITHIN_API();
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t vTaskCoreAffinityGet( const TaskHandle_t xTask )
+    {
+        const TCB_t * pxTCB;
+        UBaseType_t uxCoreAffinityMask;
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+            uxCoreAffinityMask = pxTCB->uxCoreAffinityMask;
+        }
+        taskEXIT_CRITICAL();
+
+        return uxCoreAffinityMask;
+    }
+
+#endif /* configUSE_CORE_AFFINITY */
+/*-----------------------------------------------------------*/
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
     void vTaskSuspend( TaskHandle_t xTaskToSuspend )
@@ -1729,8 +3339,22 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_MULTI_WAIT == 1 )
+                {
+                    prvMultiWaitWoken( pxTCB );
+                }
+            #endif
+
             vListInsertEnd( &xSuspendedTaskList, &( pxTCB->xStateListItem ) );
 
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                {
+                    /* A task that was ready is not woken by being resumed until
+                     * it is made ready again. */
+                    pxTCB->xReadyTimeValid = pdFALSE;
+                }
+            #endif
+
             #if ( configUSE_TASK_NOTIFICATIONS == 1 )
                 {
                     BaseType_t x;
@@ -1746,6 +3370,23 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                     }
                 }
             #endif /* if ( configUSE_TASK_NOTIFICATIONS == 1 ) */
+
+            #if ( configNUMBER_OF_CORES > 1 )
+                {
+                    /* A task running on another core keeps running until that
+                     * core switches away from it. */
+                    if( ( xSchedulerRunning != pdFALSE ) &&
+                        ( pxTCB->xTaskRunState != taskTASK_NOT_RUNNING ) &&
+                        ( pxTCB->xTaskRunState != portGET_CORE_ID() ) )
+                    {
+                        ( void ) prvYieldCore( pxTCB->xTaskRunState );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif /* configNUMBER_OF_CORES */
         }
         taskEXIT_CRITICAL();
 
@@ -1769,26 +3410,37 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
             if( xSchedulerRunning != pdFALSE )
             {
                 /* The current task has just been suspended. */
-                configASSERT( uxSchedulerSuspended == 0 );
+                taskASSERT_SCHEDULER_NOT_SUSPENDED();
                 portYIELD_WITHIN_API();
             }
             else
             {
-                /* The scheduler is not running, but the task that was pointed
-                 * to by pxCurrentTCB has just been suspended and pxCurrentTCB
-                 * must be adjusted to point to a different task. */
-                if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
-                {
-                    /* No other tasks are ready, so set pxCurrentTCB back to
-                     * NULL so when the next task is created pxCurrentTCB will
-                     * be set to point to it no matter what its relative priority
-                     * is. */
-                    pxCurrentTCB = NULL;
-                }
-                else
-                {
-                    vTaskSwitchContext();
-                }
+                #if ( configNUMBER_OF_CORES == 1 )
+                    {
+                        /* The scheduler is not running, but the task that was pointed
+                         * to by pxCurrentTCB has just been suspended and pxCurrentTCB
+                         * must be adjusted to point to a different task. */
+                        if( listCURRENT_LIST_LENGTH( &xSuspendedTaskList ) == uxCurrentNumberOfTasks ) /*lint !e931 Right has no side effect, just volatile. */
+                        {
+                            /* No other tasks are ready, so set pxCurrentTCB back to
+                             * NULL so when the next task is created pxCurrentTCB will
+                             * be set to point to it no matter what its relative priority
+                             * is. */
+                            pxCurrentTCB = NULL;
+                        }
+                        else
+                        {
+                            vTaskSwitchContext();
+                        }
+                    }
+                #else
+                    {
+                        /* Only the idle tasks are current before the scheduler
+                         * starts, and every core selects the task it runs when
+                         * the scheduler starts. */
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                #endif /* configNUMBER_OF_CORES */
             }
         }
         else
@@ -1871,7 +3523,11 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                     prvAddTaskToReadyList( pxTCB );
 
                     /* A higher priority task may have just been resumed. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    #if ( configNUMBER_OF_CORES == 1 )
+                        if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    #else
+                        if( prvYieldForTask( pxTCB ) != pdFALSE )
+                    #endif
                     {
                         /* This yield may not cause the task just resumed to run,
                          * but will leave the lists in the correct state for the
@@ -1939,23 +3595,34 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 {
                     /* Ready lists can be accessed so move the task from the
                      * suspended list to the ready list directly. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
-                    {
-                        xYieldRequired = pdTRUE;
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                    #if ( configNUMBER_OF_CORES == 1 )
+                        {
+                            if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                            {
+                                xYieldRequired = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
 
-                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-                    prvAddTaskToReadyList( pxTCB );
+                            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                            prvAddTaskToReadyList( pxTCB );
+                        }
+                    #else
+                        {
+                            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                            prvAddTaskToReadyList( pxTCB );
+                            xYieldRequired = prvYieldForTask( pxTCB );
+                        }
+                    #endif /* configNUMBER_OF_CORES */
                 }
                 else
                 {
                     /* The delayed or ready lists cannot be accessed so the task
                      * is held in the pending ready list until the scheduler is
                      * unsuspended. */
+                    taskRECORD_READY_TIME( pxTCB );
                     vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
             }
@@ -2015,6 +3682,24 @@ void vTaskStartScheduler( void )
         }
     #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+    #if ( configNUMBER_OF_CORES > 1 )
+        {
+            BaseType_t xCoreID;
+
+            /* Every other core has an idle task of its own, which is what the
+             * core runs when there is no other task it can run. */
+            for( xCoreID = 1; ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) && ( xReturn == pdPASS ); xCoreID++ )
+            {
+                xReturn = xTaskCreate( prvIdleTask,
+                                       configIDLE_TASK_NAME,
+                                       configMINIMAL_STACK_SIZE,
+                                       ( void * ) NULL,
+                                       portPRIVILEGE_BIT,
+                                       &( xIdleTaskHandles[ xCoreID ] ) );
+            }
+        }
+    #endif /* configNUMBER_OF_CORES */
+
     #if ( configUSE_TIMERS == 1 )
         {
             if( xReturn == pdPASS )
@@ -2109,22 +3794,44 @@ void vTaskEndScheduler( void )
 
 void vTaskSuspendAll( void )
 {
-    /* A critical section is not required as the variable is of type
-     * BaseType_t.  Please read Richard Barry's reply in the following link to a
-     * post in the FreeRTOS support forum before reporting this as a bug! -
-     * http://goo.gl/wu4acr */
-
-    /* portSOFRWARE_BARRIER() is only implemented for emulated/simulated ports that
-     * do not otherwise exhibit real time behaviour. */
-    portSOFTWARE_BARRIER();
-
-    /* The scheduler is suspended if uxSchedulerSuspended is non-zero.  An increment
-     * is used to allow calls to vTaskSuspendAll() to nest. */
-    ++uxSchedulerSuspended;
-
-    /* Enforces ordering for ports and optimised compilers that may otherwise place
-     * the above increment elsewhere. */
-    portMEMORY_BARRIER();
+    #if ( configNUMBER_OF_CORES == 1 )
+        {
+            /* A critical section is not required as the variable is of type
+             * BaseType_t.  Please read Richard Barry's reply in the following link to a
+             * post in the FreeRTOS support forum before reporting this as a bug! -
+             * http://goo.gl/wu4acr */
+
+            /* portSOFRWARE_BARRIER() is only implemented for emulated/simulated ports that
+             * do not otherwise exhibit real time behaviour. */
+            portSOFTWARE_BARRIER();
+
+            /* The scheduler is suspended if uxSchedulerSuspended is non-zero.  An increment
+             * is used to allow calls to vTaskSuspendAll() to nest. */
+            ++uxSchedulerSuspended;
+
+            /* Enforces ordering for ports and optimised compilers that may otherwise place
+             * the above increment elsewhere. */
+            portMEMORY_BARRIER();
+        }
+    #else /* configNUMBER_OF_CORES */
+        {
+            UBaseType_t uxSavedInterruptStatus;
+
+            /* The task lock is held until the matching xTaskResumeAll(), so
+             * tasks on the other cores cannot enter a critical section or
+             * suspend the scheduler themselves, and no core switches task, in
+             * the meantime.  The increment is made with interrupts masked so
+             * an interrupt on this core sees either value, and never a task
+             * switched in on this core half way through. */
+            portGET_TASK_LOCK();
+
+            uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+            {
+                ++uxSchedulerSuspended;
+            }
+            portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+        }
+    #endif /* configNUMBER_OF_CORES */
 }
 /*----------------------------------------------------------*/
 
@@ -2148,14 +3855,18 @@ void vTaskSuspendAll( void )
             }
         #else
             {
-                const UBaseType_t uxLeastSignificantBit = ( UBaseType_t ) 0x01;
+                UBaseType_t uxTopPriority;
 
                 /* When port optimised task selection is used the uxTopReadyPriority
-                 * variable is used as a bit map.  If bits other than the least
-                 * significant bit are set then there are tasks that have a priority
-                 * above the idle priority that are in the Ready state.  This takes
-                 * care of the case where the co-operative scheduler is in use. */
-                if( uxTopReadyPriority > uxLeastSignificantBit )
+                 * variable is used as a bit map, which always has the bit of the
+                 * idle priority set here as the idle task is running.  If the
+                 * highest bit set is above it then there are tasks that have a
+                 * priority above the idle priority that are in the Ready state.
+                 * This takes care of the case where the co-operative scheduler is
+                 * in use. */
+                portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );
+
+                if( uxTopPriority > tskIDLE_PRIORITY )
                 {
                     uxHigherPriorityReadyTasks = pdTRUE;
                 }
@@ -2183,6 +3894,22 @@ void vTaskSuspendAll( void )
         else
         {
             xReturn = xNextTaskUnblockTime - xTickCount;
+
+            #if ( configUSE_TASK_BUDGETS == 1 )
+                {
+                    /* A task held back until its budget is replenished must
+                     * not sleep through the replenishment. */
+                    if( ( listLIST_IS_EMPTY( &xThrottledTaskList ) == pdFALSE ) &&
+                        ( ( TickType_t ) ( xNextBudgetReplenishTime - xTickCount ) < xReturn ) )
+                    {
+                        xReturn = xNextBudgetReplenishTime - xTickCount;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif
         }
 
         return xReturn;
@@ -2224,7 +3951,11 @@ BaseType_t xTaskResumeAll( void )
 
                     /* If the moved task has a priority higher than the current
                      * task then a yield must be performed. */
-                    if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    #if ( configNUMBER_OF_CORES == 1 )
+                        if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                    #else
+                        if( prvYieldForTask( pxTCB ) != pdFALSE )
+                    #endif
                     {
                         xYieldPending = pdTRUE;
                     }
@@ -2295,6 +4026,15 @@ BaseType_t xTaskResumeAll( void )
         {
             mtCOVERAGE_TEST_MARKER();
         }
+
+        #if ( configNUMBER_OF_CORES > 1 )
+            {
+                /* Release the lock taken by vTaskSuspendAll().  A yield
+                 * requested above happens when the critical section is
+                 * exited. */
+                portRELEASE_TASK_LOCK();
+            }
+        #endif
     }
     taskEXIT_CRITICAL();
 
@@ -2473,6 +4213,20 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 pxTCB = prvSearchForNameWithinSingleList( ( List_t * ) pxOverflowDelayedTaskList, pcNameToQuery );
             }
 
+            #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                {
+                    UBaseType_t uxLevel, uxSlot;
+
+                    for( uxLevel = 0U; ( uxLevel < taskWHEEL_LEVELS ) && ( pxTCB == NULL ); uxLevel++ )
+                    {
+                        for( uxSlot = 0U; ( uxSlot < taskWHEEL_SLOTS ) && ( pxTCB == NULL ); uxSlot++ )
+                        {
+                            pxTCB = prvSearchForNameWithinSingleList( &( xDelayWheel[ uxLevel ][ uxSlot ] ), pcNameToQuery );
+                        }
+                    }
+                }
+            #endif
+
             #if ( INCLUDE_vTaskSuspend == 1 )
                 {
                     if( pxTCB == NULL )
@@ -2483,6 +4237,16 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 }
             #endif
 
+            #if ( configUSE_TASK_BUDGETS == 1 )
+                {
+                    if( pxTCB == NULL )
+                    {
+                        /* Search the tasks held back by their budget. */
+                        pxTCB = prvSearchForNameWithinSingleList( &xThrottledTaskList, pcNameToQuery );
+                    }
+                }
+            #endif
+
             #if ( INCLUDE_vTaskDelete == 1 )
                 {
                     if( pxTCB == NULL )
@@ -2505,7 +4269,7 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
 
     UBaseType_t uxTaskGetSystemState( TaskStatus_t * const pxTaskStatusArray,
                                       const UBaseType_t uxArraySize,
-                                      uint32_t * const pulTotalRunTime )
+                                      configRUN_TIME_COUNTER_TYPE * const pulTotalRunTime )
     {
         UBaseType_t uxTask = 0, uxQueue = configMAX_PRIORITIES;
 
@@ -2527,6 +4291,20 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxDelayedTaskList, eBlocked );
                 uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), ( List_t * ) pxOverflowDelayedTaskList, eBlocked );
 
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                    {
+                        UBaseType_t uxLevel, uxSlot;
+
+                        for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+                        {
+                            for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+                            {
+                                uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &( xDelayWheel[ uxLevel ][ uxSlot ] ), eBlocked );
+                            }
+                        }
+                    }
+                #endif
+
                 #if ( INCLUDE_vTaskDelete == 1 )
                     {
                         /* Fill in an TaskStatus_t structure with information on
@@ -2543,6 +4321,14 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
                     }
                 #endif
 
+                #if ( configUSE_TASK_BUDGETS == 1 )
+                    {
+                        /* Fill in an TaskStatus_t structure with information on
+                         * each task held back until its budget is replenished. */
+                        uxTask += prvListTasksWithinSingleList( &( pxTaskStatusArray[ uxTask ] ), &xThrottledTaskList, eSuspended );
+                    }
+                #endif
+
                 #if ( configGENERATE_RUN_TIME_STATS == 1 )
                     {
                         if( pulTotalRunTime != NULL )
@@ -2576,6 +4362,176 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
 #endif /* configUSE_TRACE_FACILITY */
 /*----------------------------------------------------------*/
 
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    void vTaskInitStateCursor( TaskStateCursor_t * pxCursor )
+    {
+        configASSERT( pxCursor );
+
+        pxCursor->pvNextTask = NULL;
+        pxCursor->uxNextTaskNumber = ( UBaseType_t ) 0U;
+        pxCursor->uxTaskListVersion = ( UBaseType_t ) 0U;
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxTaskGetNextTaskStates( TaskStateCursor_t * pxCursor,
+                                         TaskStatus_t * pxTaskStatusArray,
+                                         UBaseType_t uxArraySize,
+                                         BaseType_t xGetFreeStackSpace )
+    {
+        const ListItem_t * pxEndMarker;
+        const ListItem_t * pxItem;
+        TCB_t * pxTCB;
+        UBaseType_t uxTask = 0;
+
+        configASSERT( pxCursor );
+        configASSERT( ( pxTaskStatusArray != NULL ) || ( uxArraySize == 0U ) );
+
+        vTaskSuspendAll();
+        {
+            pxEndMarker = listGET_END_MARKER( &xAllTasksList );
+
+            /* uxTaskNumber changes whenever a task is created or deleted, so
+             * if it has not the task the cursor was left at is still in the
+             * list.  Otherwise the list is walked to the first task created
+             * after the last one visited, which is where the cursor would be. */
+            if( ( pxCursor->pvNextTask != NULL ) && ( pxCursor->uxTaskListVersion == uxTaskNumber ) )
+            {
+                pxItem = ( const ListItem_t * ) pxCursor->pvNextTask;
+            }
+            else
+            {
+                for( pxItem = listGET_HEAD_ENTRY( &xAllTasksList ); pxItem != pxEndMarker; pxItem = listGET_NEXT( pxItem ) )
+                {
+                    pxTCB = listGET_LIST_ITEM_OWNER( pxItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                    if( pxTCB->uxTCBNumber >= pxCursor->uxNextTaskNumber )
+                    {
+                        break;
+                    }
+                }
+            }
+
+            while( ( pxItem != pxEndMarker ) && ( uxTask < uxArraySize ) )
+            {
+                pxTCB = listGET_LIST_ITEM_OWNER( pxItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                vTaskGetInfo( ( TaskHandle_t ) pxTCB, &( pxTaskStatusArray[ uxTask ] ), xGetFreeStackSpace, eInvalid );
+                pxCursor->uxNextTaskNumber = pxTCB->uxTCBNumber + ( UBaseType_t ) 1U;
+                uxTask++;
+                pxItem = listGET_NEXT( pxItem );
+            }
+
+            pxCursor->pvNextTask = ( void * ) pxItem;
+            pxCursor->uxTaskListVersion = uxTaskNumber;
+        }
+        ( void ) xTaskResumeAll();
+
+        return uxTask;
+    }
+/*-----------------------------------------------------------*/
+
+    static uint8_t * prvWriteSerialisedNumber( uint8_t * pucBuffer,
+                                               uint64_t ullValue )
+    {
+        /* Seven bits per byte, least significant first, with the top bit set
+         * in every byte but the last. */
+        while( ullValue >= 0x80U )
+        {
+            *pucBuffer = ( uint8_t ) ( ( ullValue & 0x7FU ) | 0x80U );
+            pucBuffer++;
+            ullValue >>= 7;
+        }
+
+        *pucBuffer = ( uint8_t ) ullValue;
+
+        return pucBuffer + 1;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xTaskSerialiseTaskStatus( const TaskStatus_t * pxTaskStatus,
+                                     uint8_t * pucBuffer,
+                                     size_t xBufferLength )
+    {
+        uint8_t ucRecord[ tskSERIALISED_TASK_STATUS_MAX_LENGTH ];
+        uint8_t * pucNext = ucRecord;
+        size_t xNameLength, xLength = 0;
+
+        configASSERT( pxTaskStatus );
+
+        /* The record is built in ucRecord, as its length is not known until
+         * it has been written. */
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->xTaskNumber );
+        *pucNext = ( uint8_t ) pxTaskStatus->eCurrentState;
+        pucNext++;
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->uxCurrentPriority );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->uxBasePriority );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->usStackHighWaterMark );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulRunTimeCounter );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulSwitchesIn );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulPreemptions );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulWakeups );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulMinWakeLatency );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulAvgWakeLatency );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->ulMaxWakeLatency );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->uxDeadlineMisses );
+        pucNext = prvWriteSerialisedNumber( pucNext, ( uint64_t ) pxTaskStatus->uxBudgetOverruns );
+
+        for( xNameLength = 0; xNameLength < ( size_t ) configMAX_TASK_NAME_LEN; xNameLength++ )
+        {
+            if( pxTaskStatus->pcTaskName[ xNameLength ] == ( char ) 0x00 )
+            {
+                break;
+            }
+        }
+
+        *pucNext = ( uint8_t ) xNameLength;
+        pucNext++;
+        ( void ) memcpy( ( void * ) pucNext, ( const void * ) pxTaskStatus->pcTaskName, xNameLength );
+        pucNext += xNameLength;
+
+        if( ( size_t ) ( pucNext - ucRecord ) <= xBufferLength )
+        {
+            xLength = ( size_t ) ( pucNext - ucRecord );
+            ( void ) memcpy( ( void * ) pucBuffer, ( const void * ) ucRecord, xLength );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xLength;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xTaskSerialiseNextTaskStates( TaskStateCursor_t * pxCursor,
+                                         uint8_t * pucBuffer,
+                                         size_t xBufferLength )
+    {
+        TaskStateCursor_t xNextCursor = *pxCursor;
+        TaskStatus_t xTaskStatus;
+        size_t xWritten = 0, xLength;
+
+        /* A task that does not fit is visited again by the next call, so the
+         * cursor is only moved once the task has been written. */
+        while( uxTaskGetNextTaskStates( &xNextCursor, &xTaskStatus, 1, pdTRUE ) != ( UBaseType_t ) 0U )
+        {
+            xLength = xTaskSerialiseTaskStatus( &xTaskStatus, &( pucBuffer[ xWritten ] ), xBufferLength - xWritten );
+
+            if( xLength == ( size_t ) 0U )
+            {
+                break;
+            }
+
+            xWritten += xLength;
+            *pxCursor = xNextCursor;
+        }
+
+        return xWritten;
+    }
+
+#endif /* configUSE_TRACE_FACILITY */
+/*----------------------------------------------------------*/
+
 #if ( INCLUDE_xTaskGetIdleTaskHandle == 1 )
 
     TaskHandle_t xTaskGetIdleTaskHandle( void )
@@ -2586,6 +4542,17 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) /*lint !e971 Unqualified char
         return xIdleTaskHandle;
     }
 
+    #if ( configNUMBER_OF_CORES > 1 )
+
+        TaskHandle_t xTaskGetIdleTaskHandleForCore( BaseType_t xCoreID )
+        {
+            configASSERT( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) );
+            configASSERT( ( xIdleTaskHandles[ xCoreID ] != NULL ) );
+            return xIdleTaskHandles[ xCoreID ];
+        }
+
+    #endif /* configNUMBER_OF_CORES */
+
 #endif /* INCLUDE_xTaskGetIdleTaskHandle */
 /*----------------------------------------------------------*/
 
@@ -2614,7 +4581,7 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
 
     /* Must not be called with the scheduler suspended as the implementation
      * relies on xPendedTicks being wound down to 0 in xTaskResumeAll(). */
-    configASSERT( uxSchedulerSuspended == 0 );
+    taskASSERT_SCHEDULER_NOT_SUSPENDED();
 
     /* Use xPendedTicks to mimic xTicksToCatchUp number of ticks occurring when
      * the scheduler is suspended so the ticks are executed in xTaskResumeAll(). */
@@ -2667,6 +4634,23 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
+
+                    #if ( configUSE_MULTI_WAIT == 1 )
+                        {
+                            /* A task in xMultiWaitForObjects() is not on an
+                             * event list through its own event list item, but
+                             * must not block again either. */
+                            if( pxTCB->ucMultiWaitState == taskMULTI_WAIT_BLOCKED )
+                            {
+                                prvMultiWaitWoken( pxTCB );
+                                pxTCB->ucDelayAborted = pdTRUE;
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
+                        }
+                    #endif
                 }
                 taskEXIT_CRITICAL();
 
@@ -2680,7 +4664,11 @@ BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp )
                         /* Preemption is on, but a context switch should only be
                          *  performed if the unblocked task has a priority that is
                          *  equal to or higher than the currently executing task. */
-                        if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                        #if ( configNUMBER_OF_CORES == 1 )
+                            if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                        #else
+                            if( prvYieldForTask( pxTCB ) != pdFALSE )
+                        #endif
                         {
                             /* Pend the yield to be performed when the scheduler
                              * is unsuspended. */
@@ -2711,6 +4699,7 @@ BaseType_t xTaskIncrementTick( void )
     TCB_t * pxTCB;
     TickType_t xItemValue;
     BaseType_t xSwitchRequired = pdFALSE;
+    List_t * pxDueList;
 
     /* Called by the portable layer each time a tick interrupt occurs.
      * Increments the tick then checks to see if the new tick value will cause any
@@ -2740,18 +4729,48 @@ BaseType_t xTaskIncrementTick( void )
          * the  queue in the order of their wake time - meaning once one task
          * has been found whose block time has not expired there is no need to
          * look any further down the list. */
+        pxDueList = pxDelayedTaskList;
+
         if( xConstTickCount >= xNextTaskUnblockTime )
         {
             for( ; ; )
             {
-                if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
+                #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                    {
+                        /* xNextTaskUnblockTime is never later than the earliest
+                         * wake time, so every task in the slot returned wakes at
+                         * xNextTaskUnblockTime.  Advancing to that time rather
+                         * than to the tick count keeps the tasks whose wake time
+                         * was stepped over by vTaskStepTick() in the wheel. */
+                        pxDueList = prvDelayWheelAdvance( xNextTaskUnblockTime );
+                    }
+                #endif
+
+                if( listLIST_IS_EMPTY( pxDueList ) != pdFALSE )
                 {
-                    /* The delayed list is empty.  Set xNextTaskUnblockTime
-                     * to the maximum possible value so it is extremely
-                     * unlikely that the
-                     * if( xTickCount >= xNextTaskUnblockTime ) test will pass
-                     * next time through. */
-                    xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+                        {
+                            /* No tasks are left at xNextTaskUnblockTime, so find
+                             * the next wake time in the wheel.  It might have
+                             * passed already, in which case go round again. */
+                            xItemValue = xNextTaskUnblockTime;
+                            prvResetNextTaskUnblockTime();
+
+                            if( ( xConstTickCount >= xNextTaskUnblockTime ) && ( xNextTaskUnblockTime != xItemValue ) )
+                            {
+                                continue;
+                            }
+                        }
+                    #else
+                        {
+                            /* The delayed list is empty.  Set xNextTaskUnblockTime
+                             * to the maximum possible value so it is extremely
+                             * unlikely that the
+                             * if( xTickCount >= xNextTaskUnblockTime ) test will pass
+                             * next time through. */
+                            xNextTaskUnblockTime = portMAX_DELAY; /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                        }
+                    #endif
                     break;
                 }
                 else
@@ -2760,7 +4779,7 @@ BaseType_t xTaskIncrementTick( void )
                      * item at the head of the delayed list.  This is the time
                      * at which the task at the head of the delayed list must
                      * be removed from the Blocked state. */
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDelayedTaskList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( pxDueList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
                     xItemValue = listGET_LIST_ITEM_VALUE( &( pxTCB->xStateListItem ) );
 
                     if( xConstTickCount < xItemValue )
@@ -2792,6 +4811,12 @@ BaseType_t xTaskIncrementTick( void )
                         mtCOVERAGE_TEST_MARKER();
                     }
 
+                    #if ( configUSE_MULTI_WAIT == 1 )
+                        {
+                            prvMultiWaitWoken( pxTCB );
+                        }
+                    #endif
+
                     /* Place the unblocked task into the appropriate ready
                      * list. */
                     prvAddTaskToReadyList( pxTCB );
@@ -2804,7 +4829,11 @@ BaseType_t xTaskIncrementTick( void )
                              * only be performed if the unblocked task has a
                              * priority that is equal to or higher than the
                              * currently executing task. */
-                            if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                            #if ( configNUMBER_OF_CORES == 1 )
+                                if( pxTCB->uxPriority >= pxCurrentTCB->uxPriority )
+                            #else
+                                if( prvYieldForTask( pxTCB ) != pdFALSE )
+                            #endif
                             {
                                 xSwitchRequired = pdTRUE;
                             }
@@ -2818,20 +4847,117 @@ BaseType_t xTaskIncrementTick( void )
             }
         }
 
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                if( pxBudgetedTasks != NULL )
+                {
+                    if( taskTIME_IS_BEFORE( xConstTickCount, xNextBudgetReplenishTime ) == pdFALSE )
+                    {
+                        if( prvReplenishBudgets( xConstTickCount ) != pdFALSE )
+                        {
+                            xSwitchRequired = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    #if ( configUSE_PREEMPTION == 1 )
+                        {
+                            /* The budget of the running task is charged when it is
+                             * switched out, so switch it out if it has now used
+                             * up its budget, or if it is still to be demoted
+                             * again after a mutex restored its priority. */
+                            if( pxCurrentTCB->ulBudget != ( configRUN_TIME_COUNTER_TYPE ) 0U )
+                            {
+                                configRUN_TIME_COUNTER_TYPE ulNow;
+
+                                taskREAD_RUN_TIME_COUNTER( ulNow );
+
+                                if( pxCurrentTCB->xBudgetExhausted == pdFALSE )
+                                {
+                                    if( ( ulNow - ulBudgetChargedTime ) >= ( pxCurrentTCB->ulBudget - pxCurrentTCB->ulBudgetUsed ) )
+                                    {
+                                        xSwitchRequired = pdTRUE;
+                                    }
+                                }
+                                else if( ( pxCurrentTCB->ucBudgetAction == ( uint8_t ) eBudgetDemote ) &&
+                                         ( pxCurrentTCB->uxPriority == pxCurrentTCB->uxBasePriority ) &&
+                                         ( pxCurrentTCB->uxPriority > pxCurrentTCB->uxDemotedPriority ) )
+                                {
+                                    xSwitchRequired = pdTRUE;
+                                }
+                                else
+                                {
+                                    mtCOVERAGE_TEST_MARKER();
+                                }
+                            }
+                        }
+                    #endif /* configUSE_PREEMPTION */
+                }
+            }
+        #endif /* configUSE_TASK_BUDGETS */
+
         /* Tasks of equal priority to the currently running task will share
          * processing time (time slice) if preemption is on, and the application
-         * writer has not explicitly turned time slicing off. */
-        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+         * writer has not explicitly turned time slicing off.  With time slice
+         * quanta the running task keeps the processor until it has run for the
+         * time slice of its priority, counted from when it was switched in. */
+        #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) && ( configNUMBER_OF_CORES == 1 ) )
             {
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 )
+                #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+                    {
+                        xTimeSliceTicksUsed++;
+                    }
+                #endif
+
+                if( ( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ) ) > ( UBaseType_t ) 1 ) &&
+                    ( taskIS_TIME_SLICED( pxCurrentTCB->uxPriority ) != pdFALSE ) )
                 {
-                    xSwitchRequired = pdTRUE;
+                    #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+                        if( xTimeSliceTicksUsed >= taskTIME_SLICE_TICKS( pxCurrentTCB->uxPriority ) )
+                    #endif
+                    {
+                        xSwitchRequired = pdTRUE;
+                    }
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
+        #elif ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+            {
+                BaseType_t xCoreID;
+
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+                        {
+                            xTimeSliceTicksUsed[ xCoreID ]++;
+                        }
+                    #endif
+
+                    if( prvPeerIsReady( xCoreID ) != pdFALSE )
+                    {
+                        #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+                            if( xTimeSliceTicksUsed[ xCoreID ] >= taskTIME_SLICE_TICKS( pxCurrentTCBs[ xCoreID ]->uxPriority ) )
+                        #endif
+                        {
+                            xYieldPendings[ xCoreID ] = pdTRUE;
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
         #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
 
         #if ( configUSE_TICK_HOOK == 1 )
@@ -2849,7 +4975,7 @@ BaseType_t xTaskIncrementTick( void )
             }
         #endif /* configUSE_TICK_HOOK */
 
-        #if ( configUSE_PREEMPTION == 1 )
+        #if ( ( configUSE_PREEMPTION == 1 ) && ( configNUMBER_OF_CORES == 1 ) )
             {
                 if( xYieldPending != pdFALSE )
                 {
@@ -2860,6 +4986,27 @@ BaseType_t xTaskIncrementTick( void )
                     mtCOVERAGE_TEST_MARKER();
                 }
             }
+        #elif ( configUSE_PREEMPTION == 1 )
+            {
+                BaseType_t xCoreID;
+
+                /* The switch on the calling core is requested by the return
+                 * value, as on a single core. */
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    if( xYieldPendings[ xCoreID ] != pdFALSE )
+                    {
+                        if( prvYieldCore( xCoreID ) != pdFALSE )
+                        {
+                            xSwitchRequired = pdTRUE;
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            }
         #endif /* configUSE_PREEMPTION */
     }
     else
@@ -2991,8 +5138,14 @@ BaseType_t xTaskIncrementTick( void )
 #endif /* configUSE_APPLICATION_TASK_TAG */
 /*-----------------------------------------------------------*/
 
+#if ( configNUMBER_OF_CORES == 1 )
+
 void vTaskSwitchContext( void )
 {
+    #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_TIME_SLICE_QUANTA == 1 ) )
+        TCB_t * pxPreviousTCB;
+    #endif
+
     if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
     {
         /* The scheduler is currently suspended - do not allow a context
@@ -3004,67 +5157,455 @@ void vTaskSwitchContext( void )
         xYieldPending = pdFALSE;
         traceTASK_SWITCHED_OUT();
 
-        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            {
+                configRUN_TIME_COUNTER_TYPE ulElapsed;
+
+                taskREAD_RUN_TIME_COUNTER( ulTotalRunTime );
+
+                /* Add the amount of time the task has been running to the
+                 * accumulated time so far.  The time the task started running was
+                 * stored in ulTaskSwitchedInTime.  The difference is unsigned, so
+                 * it is still right after the counter wraps, if the counter is as
+                 * wide as configRUN_TIME_COUNTER_TYPE, and with a 64 bit type the
+                 * accumulated times do not wrap either.  The guard against steps
+                 * of more than half the range is to protect against a counter
+                 * that runs backwards - counters are provided by the application,
+                 * not the kernel. */
+                ulElapsed = ulTotalRunTime - ulTaskSwitchedInTime;
+
+                if( ulElapsed <= taskMAX_RUN_TIME_STEP )
+                {
+                    pxCurrentTCB->ulRunTimeCounter += ulElapsed;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                ulTaskSwitchedInTime = ulTotalRunTime;
+            }
+        #endif /* configGENERATE_RUN_TIME_STATS */
+
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                /* Charge the time the task has run to its budget, and demote or
+                 * suspend it if the budget is used up, before the next task to
+                 * run is selected. */
+                if( pxCurrentTCB->ulBudget != ( configRUN_TIME_COUNTER_TYPE ) 0U )
+                {
+                    if( ( configRUN_TIME_COUNTER_TYPE ) ( ulTotalRunTime - ulBudgetChargedTime ) <= taskMAX_RUN_TIME_STEP )
+                    {
+                        pxCurrentTCB->ulBudgetUsed += ulTotalRunTime - ulBudgetChargedTime;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    if( pxCurrentTCB->ulBudgetUsed >= pxCurrentTCB->ulBudget )
+                    {
+                        prvThrottleTask( pxCurrentTCB );
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                ulBudgetChargedTime = ulTotalRunTime;
+            }
+        #endif /* configUSE_TASK_BUDGETS */
+
+        /* Check for stack overflow, if configured. */
+        taskCHECK_FOR_STACK_OVERFLOW();
+
+        /* Before the currently running task is switched out, save its errno. */
+        #if ( configUSE_POSIX_ERRNO == 1 )
+            {
+                pxCurrentTCB->iTaskErrno = FreeRTOS_errno;
+            }
+        #endif
+
+        #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_TIME_SLICE_QUANTA == 1 ) )
+            {
+                pxPreviousTCB = pxCurrentTCB;
+            }
+        #endif
+
+        /* Select a new task to run using either the generic C or port
+         * optimised asm code. */
+        taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        traceTASK_SWITCHED_IN();
+
+        #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+            {
+                /* A task that is switched in starts a new time slice. */
+                if( pxCurrentTCB != pxPreviousTCB )
+                {
+                    xTimeSliceTicksUsed = ( TickType_t ) 0U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        #endif
+
+        #if ( configGENERATE_RUN_TIME_STATS == 1 )
+            {
+                prvRecordTaskSwitch( pxPreviousTCB, pxCurrentTCB, ulTotalRunTime );
+            }
+        #endif
+
+        /* After the new task is switched in, update the global errno. */
+        #if ( configUSE_POSIX_ERRNO == 1 )
+            {
+                FreeRTOS_errno = pxCurrentTCB->iTaskErrno;
+            }
+        #endif
+
+        #if ( configUSE_NEWLIB_REENTRANT == 1 )
+            {
+                /* Switch Newlib's _impure_ptr variable to point to the _reent
+                 * structure specific to this task.
+                 * See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
+                 * for additional information. */
+                _impure_ptr = &( pxCurrentTCB->xNewLib_reent );
+            }
+        #endif /* configUSE_NEWLIB_REENTRANT */
+    }
+}
+
+#else /* configNUMBER_OF_CORES */
+
+    void vTaskSwitchContext( BaseType_t xCoreID )
+    {
+        #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_TIME_SLICE_QUANTA == 1 ) )
+            TCB_t * pxPreviousTCB;
+        #endif
+
+        if( uxSchedulerSuspended != ( UBaseType_t ) pdFALSE )
+        {
+            /* The scheduler is currently suspended - do not allow a context
+             * switch. */
+            xYieldPendings[ xCoreID ] = pdTRUE;
+        }
+        else
+        {
+            xYieldPendings[ xCoreID ] = pdFALSE;
+            traceTASK_SWITCHED_OUT();
+
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                {
+                    configRUN_TIME_COUNTER_TYPE ulElapsed;
+
+                    taskREAD_RUN_TIME_COUNTER( ulTotalRunTime );
+
+                    /* As on a single core, but the time is also added to the
+                     * total of the core, separately for the idle tasks. */
+                    ulElapsed = ulTotalRunTime - ulTaskSwitchedInTime[ xCoreID ];
+
+                    if( ulElapsed <= taskMAX_RUN_TIME_STEP )
+                    {
+                        pxCurrentTCBs[ xCoreID ]->ulRunTimeCounter += ulElapsed;
+
+                        if( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U )
+                        {
+                            ulCoreIdleRunTimeCounter[ xCoreID ] += ulElapsed;
+                        }
+                        else
+                        {
+                            ulCoreRunTimeCounter[ xCoreID ] += ulElapsed;
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+
+                    ulTaskSwitchedInTime[ xCoreID ] = ulTotalRunTime;
+                }
+            #endif /* configGENERATE_RUN_TIME_STATS */
+
+            #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) || ( configUSE_TIME_SLICE_QUANTA == 1 ) )
+                {
+                    pxPreviousTCB = pxCurrentTCBs[ xCoreID ];
+                }
+            #endif
+
+            /* Check for stack overflow, if configured. */
+            taskCHECK_FOR_STACK_OVERFLOW();
+
+            /* Before the currently running task is switched out, save its errno. */
+            #if ( configUSE_POSIX_ERRNO == 1 )
+                {
+                    pxCurrentTCBs[ xCoreID ]->iTaskErrno = FreeRTOS_errno;
+                }
+            #endif
+
+            prvSelectHighestPriorityTask( xCoreID );
+            traceTASK_SWITCHED_IN();
+
+            #if ( configUSE_TIME_SLICE_QUANTA == 1 )
+                {
+                    if( pxCurrentTCBs[ xCoreID ] != pxPreviousTCB )
+                    {
+                        xTimeSliceTicksUsed[ xCoreID ] = ( TickType_t ) 0U;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif
+
+            #if ( configGENERATE_RUN_TIME_STATS == 1 )
+                {
+                    prvRecordTaskSwitch( pxPreviousTCB, pxCurrentTCBs[ xCoreID ], ulTotalRunTime );
+                }
+            #endif
+
+            /* After the new task is switched in, update the global errno. */
+            #if ( configUSE_POSIX_ERRNO == 1 )
+                {
+                    FreeRTOS_errno = pxCurrentTCBs[ xCoreID ]->iTaskErrno;
+                }
+            #endif
+
+            #if ( configUSE_NEWLIB_REENTRANT == 1 )
+                {
+                    _impure_ptr = &( pxCurrentTCBs[ xCoreID ]->xNewLib_reent );
+                }
+            #endif /* configUSE_NEWLIB_REENTRANT */
+        }
+    }
+
+#endif /* configNUMBER_OF_CORES */
+/*-----------------------------------------------------------*/
+
+#if ( configNUMBER_OF_CORES > 1 )
+
+    static void prvSelectHighestPriorityTask( BaseType_t xCoreID )
+    {
+        TCB_t * pxTCB = pxCurrentTCBs[ xCoreID ];
+        List_t * pxReadyList;
+        ListItem_t const * pxEndMarker;
+        ListItem_t const * pxIterator;
+        UBaseType_t uxPriority;
+        BaseType_t xFound = pdFALSE;
+
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+            BaseType_t xHigherListsEmpty = pdTRUE;
+        #endif
+
+        /* The task the core was running can now be selected by any core.  It
+         * goes to the end of its ready list, if it is still ready, so it runs
+         * after the other ready tasks of its priority. */
+        pxTCB->xTaskRunState = taskTASK_NOT_RUNNING;
+
+        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+        {
+            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+            vListInsertEnd( &( pxReadyTasksLists[ pxTCB->uxPriority ] ), &( pxTCB->xStateListItem ) );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+            {
+                uxPriority = uxTopReadyPriority;
+            }
+        #else
+            {
+                portGET_HIGHEST_PRIORITY( uxPriority, uxTopReadyPriority );
+            }
+        #endif
+
+        /* The ready lists are walked from their head, rather than with
+         * listGET_OWNER_OF_NEXT_ENTRY(), as the tasks running on the other
+         * cores are skipped.  There is an idle task for every core, so a task
+         * is always found. */
+        for( ; ; )
+        {
+            pxReadyList = &( pxReadyTasksLists[ uxPriority ] );
+            pxEndMarker = listGET_END_MARKER( pxReadyList );
+
+            for( pxIterator = listGET_HEAD_ENTRY( pxReadyList ); pxIterator != pxEndMarker; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxTCB = listGET_LIST_ITEM_OWNER( pxIterator ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                #if ( configUSE_CORE_AFFINITY == 1 )
+                    if( ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) &&
+                        ( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U ) )
+                #else
+                    if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
+                #endif
+                {
+                    xFound = pdTRUE;
+                    break;
+                }
+            }
+
+            if( xFound != pdFALSE )
+            {
+                break;
+            }
+
+            configASSERT( uxPriority > tskIDLE_PRIORITY );
+
+            #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
+                {
+                    /* As taskSELECT_HIGHEST_PRIORITY_TASK(), uxTopReadyPriority
+                     * only moves down past lists that are empty. */
+                    if( listLIST_IS_EMPTY( pxReadyList ) == pdFALSE )
+                    {
+                        xHigherListsEmpty = pdFALSE;
+                    }
+                    else if( xHigherListsEmpty != pdFALSE )
+                    {
+                        --uxTopReadyPriority;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif
+
+            --uxPriority;
+        }
+
+        pxTCB->xTaskRunState = xCoreID;
+        pxCurrentTCBs[ xCoreID ] = pxTCB;
+    }
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvYieldCore( BaseType_t xCoreID )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        xYieldPendings[ xCoreID ] = pdTRUE;
+
+        if( xCoreID == portGET_CORE_ID() )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            portYIELD_CORE( xCoreID );
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) )
+
+        static BaseType_t prvPeerIsReady( BaseType_t xCoreID )
+        {
+            UBaseType_t uxPriority = pxCurrentTCBs[ xCoreID ]->uxPriority;
+            UBaseType_t uxRunning = 0U;
+            BaseType_t xOtherCoreID, xReturn;
+
+            for( xOtherCoreID = 0; xOtherCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xOtherCoreID++ )
+            {
+                if( pxCurrentTCBs[ xOtherCoreID ]->uxPriority == uxPriority )
+                {
+                    uxRunning++;
+                }
+            }
+
+            if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxPriority ] ) ) > uxRunning )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                xReturn = pdFALSE;
+            }
+
+            return xReturn;
+        }
+
+    #endif /* ( ( configUSE_PREEMPTION == 1 ) && ( configUSE_TIME_SLICING == 1 ) ) */
+/*-----------------------------------------------------------*/
+
+    static BaseType_t prvYieldForTask( const TCB_t * pxTCB )
+    {
+        BaseType_t xCoreID, xLowestCoreID = taskTASK_NOT_RUNNING;
+        BaseType_t xLowestPriority, xCorePriority;
+        const TCB_t * pxCoreTCB;
+        BaseType_t xReturn = pdFALSE;
+
+        if( ( xSchedulerRunning != pdFALSE ) && ( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING ) )
+        {
+            xLowestPriority = ( BaseType_t ) pxTCB->uxPriority;
+
+            /* A core that is already going to switch task is left to select
+             * for itself. */
+            for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
             {
-                #ifdef portALT_GET_RUN_TIME_COUNTER_VALUE
-                    portALT_GET_RUN_TIME_COUNTER_VALUE( ulTotalRunTime );
-                #else
-                    ulTotalRunTime = portGET_RUN_TIME_COUNTER_VALUE();
-                #endif
+                pxCoreTCB = pxCurrentTCBs[ xCoreID ];
 
-                /* Add the amount of time the task has been running to the
-                 * accumulated time so far.  The time the task started running was
-                 * stored in ulTaskSwitchedInTime.  Note that there is no overflow
-                 * protection here so count values are only valid until the timer
-                 * overflows.  The guard against negative values is to protect
-                 * against suspect run time stat counter implementations - which
-                 * are provided by the application, not the kernel. */
-                if( ulTotalRunTime > ulTaskSwitchedInTime )
+                if( ( pxCoreTCB->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U )
                 {
-                    pxCurrentTCB->ulRunTimeCounter += ( ulTotalRunTime - ulTaskSwitchedInTime );
+                    xCorePriority = -1;
                 }
                 else
                 {
-                    mtCOVERAGE_TEST_MARKER();
+                    xCorePriority = ( BaseType_t ) pxCoreTCB->uxPriority;
                 }
 
-                ulTaskSwitchedInTime = ulTotalRunTime;
+                #if ( configUSE_CORE_AFFINITY == 1 )
+                    if( ( xCorePriority < xLowestPriority ) && ( xYieldPendings[ xCoreID ] == pdFALSE ) &&
+                        ( ( pxTCB->uxCoreAffinityMask & ( ( UBaseType_t ) 1U << ( UBaseType_t ) xCoreID ) ) != 0U ) )
+                #else
+                    if( ( xCorePriority < xLowestPriority ) && ( xYieldPendings[ xCoreID ] == pdFALSE ) )
+                #endif
+                {
+                    xLowestPriority = xCorePriority;
+                    xLowestCoreID = xCoreID;
+                }
             }
-        #endif /* configGENERATE_RUN_TIME_STATS */
 
-        /* Check for stack overflow, if configured. */
-        taskCHECK_FOR_STACK_OVERFLOW();
-
-        /* Before the currently running task is switched out, save its errno. */
-        #if ( configUSE_POSIX_ERRNO == 1 )
+            if( xLowestCoreID != taskTASK_NOT_RUNNING )
             {
-                pxCurrentTCB->iTaskErrno = FreeRTOS_errno;
+                #if ( configUSE_PREEMPTION == 1 )
+                    {
+                        xReturn = prvYieldCore( xLowestCoreID );
+                    }
+                #else
+                    {
+                        /* Without preemption other cores are not interrupted -
+                         * their idle tasks yield to find the task. */
+                        if( xLowestCoreID == portGET_CORE_ID() )
+                        {
+                            xReturn = prvYieldCore( xLowestCoreID );
+                        }
+                    }
+                #endif
             }
-        #endif
-
-        /* Select a new task to run using either the generic C or port
-         * optimised asm code. */
-        taskSELECT_HIGHEST_PRIORITY_TASK(); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-        traceTASK_SWITCHED_IN();
-
-        /* After the new task is switched in, update the global errno. */
-        #if ( configUSE_POSIX_ERRNO == 1 )
+            else
             {
-                FreeRTOS_errno = pxCurrentTCB->iTaskErrno;
+                mtCOVERAGE_TEST_MARKER();
             }
-        #endif
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
 
-        #if ( configUSE_NEWLIB_REENTRANT == 1 )
-            {
-                /* Switch Newlib's _impure_ptr variable to point to the _reent
-                 * structure specific to this task.
-                 * See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
-                 * for additional information. */
-                _impure_ptr = &( pxCurrentTCB->xNewLib_reent );
-            }
-        #endif /* configUSE_NEWLIB_REENTRANT */
+        return xReturn;
     }
-}
+
+#endif /* configNUMBER_OF_CORES */
 /*-----------------------------------------------------------*/
 
 void vTaskPlaceOnEventList( List_t * const pxEventList,
@@ -3149,7 +5690,8 @@ void vTaskPlaceOnUnorderedEventList( List_t * pxEventList,
 BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
 {
     TCB_t * pxUnblockedTCB;
-    BaseType_t xReturn;
+    ListItem_t * pxEventListItem;
+    BaseType_t xReturn = pdFALSE;
 
     /* THIS FUNCTION MUST BE CALLED FROM A CRITICAL SECTION.  It can also be
      * called from a critical section within an ISR. */
@@ -3163,16 +5705,143 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
      * means exclusive access to the event list is guaranteed here.
      *
      * This function assumes that a check has already been made to ensure that
-     * pxEventList is not empty. */
-    pxUnblockedTCB = listGET_OWNER_OF_HEAD_ENTRY( pxEventList ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-    configASSERT( pxUnblockedTCB );
-    ( void ) uxListRemove( &( pxUnblockedTCB->xEventListItem ) );
+     * pxEventList is not empty.  It can still find the list empty once the
+     * items left by tasks that xMultiWaitForObjects() has already woken are
+     * removed, in which case no task is unblocked. */
+    #if ( configUSE_MULTI_WAIT == 1 )
+        {
+            prvRemoveStaleMultiWaitItems( pxEventList );
+        }
+    #endif
 
-    if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+    if( listLIST_IS_EMPTY( pxEventList ) == pdFALSE )
     {
-        ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
-        prvAddTaskToReadyList( pxUnblockedTCB );
+        pxEventListItem = listGET_HEAD_ENTRY( pxEventList );
+        pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        configASSERT( pxUnblockedTCB );
+
+        /* The head entry is the task's own event list item unless the task is
+         * waiting in xMultiWaitForObjects(), in which case the task's event list
+         * item is not in use. */
+        ( void ) uxListRemove( pxEventListItem );
+
+        #if ( configUSE_MULTI_WAIT == 1 )
+            {
+                prvMultiWaitWoken( pxUnblockedTCB );
+            }
+        #endif
+
+        if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+        {
+            ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+            prvAddTaskToReadyList( pxUnblockedTCB );
+
+            #if ( configUSE_TICKLESS_IDLE != 0 )
+                {
+                    /* If a task is blocked on a kernel object then xNextTaskUnblockTime
+                     * might be set to the blocked task's time out time.  If the task is
+                     * unblocked for a reason other than a timeout xNextTaskUnblockTime is
+                     * normally left unchanged, because it is automatically reset to a new
+                     * value when the tick count equals xNextTaskUnblockTime.  However if
+                     * tickless idling is used it might be more important to enter sleep mode
+                     * at the earliest possible time - so reset xNextTaskUnblockTime here to
+                     * ensure it is updated at the earliest possible time. */
+                    prvResetNextTaskUnblockTime();
+                }
+            #endif
+        }
+        else
+        {
+            /* The delayed and ready lists cannot be accessed, so hold this task
+             * pending until the scheduler is resumed. */
+            taskRECORD_READY_TIME( pxUnblockedTCB );
+            vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+        }
+
+        #if ( configNUMBER_OF_CORES == 1 )
+            {
+                if( taskPREEMPTS_CURRENT_TASK( pxUnblockedTCB ) )
+                {
+                    /* Return true if the task removed from the event list has a higher
+                     * priority than the calling task.  This allows the calling task to know if
+                     * it should force a context switch now. */
+                    xReturn = pdTRUE;
+
+                    /* Mark that a yield is pending in case the user is not using the
+                     * "xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
+                    xYieldPending = pdTRUE;
+                }
+                else
+                {
+                    xReturn = pdFALSE;
+                }
+            }
+        #else /* configNUMBER_OF_CORES */
+            {
+                /* Another core is yielded directly, and true is only returned if
+                 * the calling core should switch to the unblocked task.  A task
+                 * held pending is placed by xTaskResumeAll() instead. */
+                if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+                {
+                    xReturn = prvYieldForTask( pxUnblockedTCB );
+                }
+                else
+                {
+                    xReturn = pdFALSE;
+                }
+            }
+        #endif /* configNUMBER_OF_CORES */
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
+                                        const TickType_t xItemValue )
+{
+    TCB_t * pxUnblockedTCB;
+
+    /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
+     * the event flags implementation. */
+    configASSERT( uxSchedulerSuspended != pdFALSE );
+
+    /* Store the new item value in the event list. */
+    listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+
+    /* Remove the event list form the event flag.  Interrupts do not access
+     * event flags. */
+    pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+    configASSERT( pxUnblockedTCB );
+    ( void ) uxListRemove( pxEventListItem );
+
+    #if ( configUSE_MULTI_WAIT == 1 )
+        {
+            /* An item left by a task that xMultiWaitForObjects() has already
+             * woken is only removed.  Interrupts can wake the task through a
+             * queue or notification, so its state is checked in a critical
+             * section. */
+            taskENTER_CRITICAL();
+            {
+                if( taskMULTI_WAIT_ITEM_IS_STALE( pxUnblockedTCB, pxEventListItem ) )
+                {
+                    pxUnblockedTCB = NULL;
+                }
+                else
+                {
+                    prvMultiWaitWoken( pxUnblockedTCB );
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+    #endif
 
+    if( pxUnblockedTCB != NULL )
+    {
         #if ( configUSE_TICKLESS_IDLE != 0 )
             {
                 /* If a task is blocked on a kernel object then xNextTaskUnblockTime
@@ -3186,81 +5855,263 @@ BaseType_t xTaskRemoveFromEventList( const List_t * const pxEventList )
                 prvResetNextTaskUnblockTime();
             }
         #endif
+
+        /* Remove the task from the delayed list and add it to the ready list.  The
+         * scheduler is suspended so interrupts will not be accessing the ready
+         * lists. */
+        ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
+        prvAddTaskToReadyList( pxUnblockedTCB );
+
+        #if ( configNUMBER_OF_CORES == 1 )
+            {
+                if( taskPREEMPTS_CURRENT_TASK( pxUnblockedTCB ) )
+                {
+                    /* The unblocked task has a priority above that of the calling task, so
+                     * a context switch is required.  This function is called with the
+                     * scheduler suspended so xYieldPending is set so the context switch
+                     * occurs immediately that the scheduler is resumed (unsuspended). */
+                    xYieldPending = pdTRUE;
+                }
+            }
+        #else
+            {
+                /* prvYieldCore() sets xYieldPending itself if it is the calling
+                 * core that should switch. */
+                ( void ) prvYieldForTask( pxUnblockedTCB );
+            }
+        #endif /* configNUMBER_OF_CORES */
     }
     else
     {
-        /* The delayed and ready lists cannot be accessed, so hold this task
-         * pending until the scheduler is resumed. */
-        vListInsertEnd( &( xPendingReadyList ), &( pxUnblockedTCB->xEventListItem ) );
+        mtCOVERAGE_TEST_MARKER();
     }
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
 
-    if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+    void vTaskPlaceMultiWaitItemOnEventList( List_t * const pxEventList,
+                                             ListItem_t * const pxEventListItem )
     {
-        /* Return true if the task removed from the event list has a higher
-         * priority than the calling task.  This allows the calling task to know if
-         * it should force a context switch now. */
-        xReturn = pdTRUE;
+        configASSERT( pxEventList );
+        configASSERT( pxEventListItem );
 
-        /* Mark that a yield is pending in case the user is not using the
-         * "xHigherPriorityTaskWoken" parameter to an ISR safe FreeRTOS function. */
-        xYieldPending = pdTRUE;
+        /* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED AND THE
+         * SCHEDULER SUSPENDED. */
+
+        /* The item takes the place the task's own event list item would, in
+         * priority order. */
+        listSET_LIST_ITEM_VALUE( pxEventListItem, ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+        listSET_LIST_ITEM_OWNER( pxEventListItem, pxCurrentTCB );
+        vListInsert( pxEventList, pxEventListItem );
     }
-    else
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vTaskPlaceMultiWaitItemOnUnorderedEventList( List_t * pxEventList,
+                                                      ListItem_t * const pxEventListItem,
+                                                      const TickType_t xItemValue )
     {
-        xReturn = pdFALSE;
+        configASSERT( pxEventList );
+        configASSERT( pxEventListItem );
+
+        /* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED AND THE
+         * SCHEDULER SUSPENDED.  It is used for event groups. */
+        configASSERT( uxSchedulerSuspended != 0 );
+
+        listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+        listSET_LIST_ITEM_OWNER( pxEventListItem, pxCurrentTCB );
+        vListInsertEnd( pxEventList, pxEventListItem );
     }
 
-    return xReturn;
-}
+#endif /* configUSE_MULTI_WAIT */
 /*-----------------------------------------------------------*/
 
-void vTaskRemoveFromUnorderedEventList( ListItem_t * pxEventListItem,
-                                        const TickType_t xItemValue )
-{
-    TCB_t * pxUnblockedTCB;
+#if ( configUSE_MULTI_WAIT == 1 )
 
-    /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED.  It is used by
-     * the event flags implementation. */
-    configASSERT( uxSchedulerSuspended != pdFALSE );
+    BaseType_t xTaskMultiWaitNotificationPending( UBaseType_t uxIndexToWaitOn )
+    {
+        BaseType_t xReturn;
 
-    /* Store the new item value in the event list. */
-    listSET_LIST_ITEM_VALUE( pxEventListItem, xItemValue | taskEVENT_LIST_ITEM_VALUE_IN_USE );
+        configASSERT( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+
+        if( pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] == taskNOTIFICATION_RECEIVED )
+        {
+            xReturn = pdTRUE;
+        }
+        else
+        {
+            xReturn = pdFALSE;
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vTaskMultiWaitBlock( MultiWaitObject_t * const pxObjects,
+                              const UBaseType_t uxObjectCount,
+                              const TickType_t xTicksToWait )
+    {
+        UBaseType_t uxIndex;
+
+        /* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED AND THE
+         * SCHEDULER SUSPENDED, once the task's list items have been placed on
+         * the event lists of its queues and event groups. */
+        configASSERT( uxSchedulerSuspended != 0 );
+        configASSERT( pxCurrentTCB->ucMultiWaitState == taskMULTI_WAIT_NONE );
+
+        pxCurrentTCB->pxMultiWaitObjects = pxObjects;
+        pxCurrentTCB->uxMultiWaitObjectCount = uxObjectCount;
+        pxCurrentTCB->ucMultiWaitState = taskMULTI_WAIT_BLOCKED;
+
+        for( uxIndex = 0; uxIndex < uxObjectCount; uxIndex++ )
+        {
+            if( pxObjects[ uxIndex ].eObjectType == eMultiWaitNotification )
+            {
+                configASSERT( pxObjects[ uxIndex ].uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+                pxCurrentTCB->ucNotifyState[ pxObjects[ uxIndex ].uxIndexToWaitOn ] = taskWAITING_NOTIFICATION;
+            }
+            else if( pxObjects[ uxIndex ].eObjectType == eMultiWaitStreamBuffer )
+            {
+                /* A stream buffer wakes the task waiting to receive from it
+                 * with a notification at the default index. */
+                pxCurrentTCB->ucNotifyState[ tskDEFAULT_INDEX_TO_NOTIFY ] = taskWAITING_NOTIFICATION;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        /* The task is never held in xSuspendedTaskList, even if xTicksToWait
+         * is portMAX_DELAY, as its own event list item is not in use so it
+         * would appear to be suspended.  xMultiWaitForObjects() blocks again
+         * if it wakes without anything being ready and without timing out. */
+        prvAddCurrentTaskToDelayedList( xTicksToWait, pdFALSE );
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    void vTaskMultiWaitEnd( void )
+    {
+        MultiWaitObject_t * pxObjects = pxCurrentTCB->pxMultiWaitObjects;
+        UBaseType_t uxIndex;
+        UBaseType_t uxIndexToWaitOn;
+
+        /* THIS FUNCTION MUST BE CALLED WITH INTERRUPTS DISABLED AND THE
+         * SCHEDULER SUSPENDED. */
+        prvRemoveMultiWaitItems( pxCurrentTCB );
+
+        for( uxIndex = 0; uxIndex < pxCurrentTCB->uxMultiWaitObjectCount; uxIndex++ )
+        {
+            if( pxObjects[ uxIndex ].eObjectType == eMultiWaitNotification )
+            {
+                uxIndexToWaitOn = pxObjects[ uxIndex ].uxIndexToWaitOn;
+            }
+            else if( pxObjects[ uxIndex ].eObjectType == eMultiWaitStreamBuffer )
+            {
+                uxIndexToWaitOn = tskDEFAULT_INDEX_TO_NOTIFY;
+            }
+            else
+            {
+                /* The object does not wait on a notification. */
+                uxIndexToWaitOn = configTASK_NOTIFICATION_ARRAY_ENTRIES;
+            }
+
+            /* Notifications that were not received are no longer waited for. */
+            if( ( uxIndexToWaitOn < configTASK_NOTIFICATION_ARRAY_ENTRIES ) &&
+                ( pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] == taskWAITING_NOTIFICATION ) )
+            {
+                pxCurrentTCB->ucNotifyState[ uxIndexToWaitOn ] = taskNOT_WAITING_NOTIFICATION;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        pxCurrentTCB->pxMultiWaitObjects = NULL;
+        pxCurrentTCB->uxMultiWaitObjectCount = 0;
+        pxCurrentTCB->ucMultiWaitState = taskMULTI_WAIT_NONE;
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    static void prvMultiWaitWoken( TCB_t * const pxTCB )
+    {
+        if( pxTCB->ucMultiWaitState == taskMULTI_WAIT_BLOCKED )
+        {
+            pxTCB->ucMultiWaitState = taskMULTI_WAIT_WOKEN;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
 
-    /* Remove the event list form the event flag.  Interrupts do not access
-     * event flags. */
-    pxUnblockedTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-    configASSERT( pxUnblockedTCB );
-    ( void ) uxListRemove( pxEventListItem );
+#if ( configUSE_MULTI_WAIT == 1 )
+
+    static void prvRemoveStaleMultiWaitItems( const List_t * const pxEventList )
+    {
+        ListItem_t * pxEventListItem;
+        TCB_t * pxTCB;
+        BaseType_t xHeadIsStale = pdTRUE;
 
-    #if ( configUSE_TICKLESS_IDLE != 0 )
+        while( ( xHeadIsStale != pdFALSE ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
         {
-            /* If a task is blocked on a kernel object then xNextTaskUnblockTime
-             * might be set to the blocked task's time out time.  If the task is
-             * unblocked for a reason other than a timeout xNextTaskUnblockTime is
-             * normally left unchanged, because it is automatically reset to a new
-             * value when the tick count equals xNextTaskUnblockTime.  However if
-             * tickless idling is used it might be more important to enter sleep mode
-             * at the earliest possible time - so reset xNextTaskUnblockTime here to
-             * ensure it is updated at the earliest possible time. */
-            prvResetNextTaskUnblockTime();
+            pxEventListItem = listGET_HEAD_ENTRY( pxEventList );
+            pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+            if( taskMULTI_WAIT_ITEM_IS_STALE( pxTCB, pxEventListItem ) )
+            {
+                ( void ) uxListRemove( pxEventListItem );
+            }
+            else
+            {
+                xHeadIsStale = pdFALSE;
+            }
         }
-    #endif
+    }
 
-    /* Remove the task from the delayed list and add it to the ready list.  The
-     * scheduler is suspended so interrupts will not be accessing the ready
-     * lists. */
-    ( void ) uxListRemove( &( pxUnblockedTCB->xStateListItem ) );
-    prvAddTaskToReadyList( pxUnblockedTCB );
+#endif /* configUSE_MULTI_WAIT */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MULTI_WAIT == 1 )
 
-    if( pxUnblockedTCB->uxPriority > pxCurrentTCB->uxPriority )
+    static void prvRemoveMultiWaitItems( TCB_t * const pxTCB )
     {
-        /* The unblocked task has a priority above that of the calling task, so
-         * a context switch is required.  This function is called with the
-         * scheduler suspended so xYieldPending is set so the context switch
-         * occurs immediately that the scheduler is resumed (unsuspended). */
-        xYieldPending = pdTRUE;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0; uxIndex < pxTCB->uxMultiWaitObjectCount; uxIndex++ )
+        {
+            if( listLIST_ITEM_CONTAINER( &( pxTCB->pxMultiWaitObjects[ uxIndex ].xListItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxTCB->pxMultiWaitObjects[ uxIndex ].xListItem ) );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
     }
-}
+
+#endif /* configUSE_MULTI_WAIT */
 /*-----------------------------------------------------------*/
 
 void vTaskSetTimeOutState( TimeOut_t * const pxTimeOut )
@@ -3391,6 +6242,29 @@ void vTaskMissedYield( void )
         }
     }
 
+#endif /* configUSE_TRACE_FACILITY */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TRACE_FACILITY == 1 )
+
+    UBaseType_t uxTaskGetTCBNumber( TaskHandle_t xTask )
+    {
+        UBaseType_t uxReturn;
+        TCB_t const * pxTCB;
+
+        if( xTask != NULL )
+        {
+            pxTCB = xTask;
+            uxReturn = pxTCB->uxTCBNumber;
+        }
+        else
+        {
+            uxReturn = 0U;
+        }
+
+        return uxReturn;
+    }
+
 #endif /* configUSE_TRACE_FACILITY */
 
 /*
@@ -3423,6 +6297,8 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
          * is responsible for freeing the deleted task's TCB and stack. */
         prvCheckTasksWaitingTermination();
 
+        portIDLE_TASK_POLL();
+
         #if ( configUSE_PREEMPTION == 0 )
             {
                 /* If we are not using preemption we keep forcing a task switch to
@@ -3443,8 +6319,9 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
                  * A critical region is not required here as we are just reading from
                  * the list, and an occasional incorrect value will not matter.  If
                  * the ready list at the idle priority contains more than one task
-                 * then a task other than the idle task is ready to execute. */
-                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) 1 )
+                 * then a task other than the idle task is ready to execute.  With
+                 * more than one core there is an idle task for each core. */
+                if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) configNUMBER_OF_CORES )
                 {
                     taskYIELD();
                 }
@@ -3642,6 +6519,20 @@ static void prvInitialiseTaskLists( void )
     vListInitialise( &xDelayedTaskList2 );
     vListInitialise( &xPendingReadyList );
 
+    #if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+        {
+            UBaseType_t uxLevel, uxSlot;
+
+            for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+            {
+                for( uxSlot = 0U; uxSlot < taskWHEEL_SLOTS; uxSlot++ )
+                {
+                    vListInitialise( &( xDelayWheel[ uxLevel ][ uxSlot ] ) );
+                }
+            }
+        }
+    #endif /* configUSE_DELAYED_TASK_WHEEL */
+
     #if ( INCLUDE_vTaskDelete == 1 )
         {
             vListInitialise( &xTasksWaitingTermination );
@@ -3654,6 +6545,18 @@ static void prvInitialiseTaskLists( void )
         }
     #endif /* INCLUDE_vTaskSuspend */
 
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        {
+            vListInitialise( &xThrottledTaskList );
+        }
+    #endif /* configUSE_TASK_BUDGETS */
+
+    #if ( configUSE_TRACE_FACILITY == 1 )
+        {
+            vListInitialise( &xAllTasksList );
+        }
+    #endif /* configUSE_TRACE_FACILITY */
+
     /* Start with pxDelayedTaskList using list1 and the pxOverflowDelayedTaskList
      * using list2. */
     pxDelayedTaskList = &xDelayedTaskList1;
@@ -3673,14 +6576,50 @@ static void prvCheckTasksWaitingTermination( void )
              * being called too often in the idle task. */
             while( uxDeletedTasksWaitingCleanUp > ( UBaseType_t ) 0U )
             {
-                taskENTER_CRITICAL();
-                {
-                    pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
-                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
-                    --uxCurrentNumberOfTasks;
-                    --uxDeletedTasksWaitingCleanUp;
-                }
-                taskEXIT_CRITICAL();
+                #if ( configNUMBER_OF_CORES == 1 )
+                    {
+                        taskENTER_CRITICAL();
+                        {
+                            pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                            ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                            --uxCurrentNumberOfTasks;
+                            --uxDeletedTasksWaitingCleanUp;
+                        }
+                        taskEXIT_CRITICAL();
+                    }
+                #else /* configNUMBER_OF_CORES */
+                    {
+                        /* The idle task of another core may have freed the
+                         * task first, and a task is not freed until the core it
+                         * was deleted on has switched away from it. */
+                        pxTCB = NULL;
+
+                        taskENTER_CRITICAL();
+                        {
+                            if( listLIST_IS_EMPTY( &xTasksWaitingTermination ) == pdFALSE )
+                            {
+                                pxTCB = listGET_OWNER_OF_HEAD_ENTRY( ( &xTasksWaitingTermination ) ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                                if( pxTCB->xTaskRunState == taskTASK_NOT_RUNNING )
+                                {
+                                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                                    --uxCurrentNumberOfTasks;
+                                    --uxDeletedTasksWaitingCleanUp;
+                                }
+                                else
+                                {
+                                    pxTCB = NULL;
+                                }
+                            }
+                        }
+                        taskEXIT_CRITICAL();
+
+                        if( pxTCB == NULL )
+                        {
+                            break;
+                        }
+                    }
+                #endif /* configNUMBER_OF_CORES */
 
                 prvDeleteTCB( pxTCB );
             }
@@ -3720,10 +6659,50 @@ static void prvCheckTasksWaitingTermination( void )
         #if ( configGENERATE_RUN_TIME_STATS == 1 )
             {
                 pxTaskStatus->ulRunTimeCounter = pxTCB->ulRunTimeCounter;
+                pxTaskStatus->ulSwitchesIn = pxTCB->ulSwitchesIn;
+                pxTaskStatus->ulPreemptions = pxTCB->ulPreemptions;
+                pxTaskStatus->ulWakeups = pxTCB->ulWakeups;
+                pxTaskStatus->ulMinWakeLatency = pxTCB->ulWakeLatencyMin;
+                pxTaskStatus->ulMaxWakeLatency = pxTCB->ulWakeLatencyMax;
+
+                if( pxTCB->ulWakeups != 0UL )
+                {
+                    pxTaskStatus->ulAvgWakeLatency = ( uint32_t ) ( pxTCB->ulWakeLatencyTotal / pxTCB->ulWakeups );
+                }
+                else
+                {
+                    pxTaskStatus->ulAvgWakeLatency = 0UL;
+                }
             }
         #else
             {
                 pxTaskStatus->ulRunTimeCounter = 0;
+                pxTaskStatus->ulSwitchesIn = 0UL;
+                pxTaskStatus->ulPreemptions = 0UL;
+                pxTaskStatus->ulWakeups = 0UL;
+                pxTaskStatus->ulMinWakeLatency = 0UL;
+                pxTaskStatus->ulAvgWakeLatency = 0UL;
+                pxTaskStatus->ulMaxWakeLatency = 0UL;
+            }
+        #endif
+
+        #if ( configUSE_EDF_SCHEDULING == 1 )
+            {
+                pxTaskStatus->uxDeadlineMisses = pxTCB->uxDeadlineMisses;
+            }
+        #else
+            {
+                pxTaskStatus->uxDeadlineMisses = 0;
+            }
+        #endif
+
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                pxTaskStatus->uxBudgetOverruns = pxTCB->uxBudgetOverruns;
+            }
+        #else
+            {
+                pxTaskStatus->uxBudgetOverruns = 0;
             }
         #endif
 
@@ -3732,7 +6711,7 @@ static void prvCheckTasksWaitingTermination( void )
          * state is just set to whatever is passed in. */
         if( eState != eInvalid )
         {
-            if( pxTCB == pxCurrentTCB )
+            if( taskTASK_IS_RUNNING( pxTCB ) )
             {
                 pxTaskStatus->eCurrentState = eRunning;
             }
@@ -3829,6 +6808,30 @@ static void prvCheckTasksWaitingTermination( void )
     {
         uint32_t ulCount = 0U;
 
+        #if ( portSTACK_GROWTH < 0 )
+            {
+                const size_t * pxStackWord;
+                size_t xFillWord;
+
+                /* Most of a stack is normally never used, so while the scan is
+                 * word aligned compare a whole word of fill bytes at a time. */
+                ( void ) memset( &xFillWord, ( int ) tskSTACK_FILL_BYTE, sizeof( xFillWord ) );
+
+                if( ( ( ( portPOINTER_SIZE_TYPE ) pucStackByte ) & ( ( portPOINTER_SIZE_TYPE ) sizeof( size_t ) - 1U ) ) == 0U )
+                {
+                    pxStackWord = ( const size_t * ) pucStackByte; /*lint !e9087 !e740 The stack was filled a byte at a time and is only being compared. */
+
+                    while( *pxStackWord == xFillWord )
+                    {
+                        pxStackWord++;
+                        ulCount += ( uint32_t ) sizeof( size_t );
+                    }
+
+                    pucStackByte = ( const uint8_t * ) pxStackWord;
+                }
+            }
+        #endif /* portSTACK_GROWTH */
+
         while( *pucStackByte == ( uint8_t ) tskSTACK_FILL_BYTE )
         {
             pucStackByte -= portSTACK_GROWTH;
@@ -3930,44 +6933,261 @@ static void prvCheckTasksWaitingTermination( void )
             }
         #endif /* configUSE_NEWLIB_REENTRANT */
 
-        #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
+        #if ( configUSE_TASK_POOLS == 1 )
+            if( pxTCB->pxPool != NULL )
             {
-                /* The task can only have been allocated dynamically - free both
-                 * the stack and TCB. */
-                vPortFree( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                /* The memory belongs to a pool, so is kept for the next task
+                 * created from the pool rather than freed. */
+                prvReturnTaskToPool( pxTCB );
             }
-        #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
-            {
-                /* The task could have been allocated statically or dynamically, so
-                 * check what was statically allocated before trying to free the
-                 * memory. */
-                if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+            else
+        #endif /* configUSE_TASK_POOLS */
+        {
+            #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
                 {
-                    /* Both the stack and TCB were allocated dynamically, so both
-                     * must be freed. */
-                    vPortFree( pxTCB->pxStack );
+                    /* The task can only have been allocated dynamically - free both
+                     * the stack and TCB. */
+                    vPortFreeStack( pxTCB->pxStack );
                     vPortFree( pxTCB );
                 }
-                else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+            #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 ) /*lint !e731 !e9029 Macro has been consolidated for readability reasons. */
                 {
-                    /* Only the stack was statically allocated, so the TCB is the
-                     * only memory that must be freed. */
-                    vPortFree( pxTCB );
+                    /* The task could have been allocated statically or dynamically, so
+                     * check what was statically allocated before trying to free the
+                     * memory. */
+                    if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
+                    {
+                        /* Both the stack and TCB were allocated dynamically, so both
+                         * must be freed. */
+                        vPortFreeStack( pxTCB->pxStack );
+                        vPortFree( pxTCB );
+                    }
+                    else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
+                    {
+                        /* Only the stack was statically allocated, so the TCB is the
+                         * only memory that must be freed. */
+                        vPortFree( pxTCB );
+                    }
+                    else
+                    {
+                        /* Neither the stack nor the TCB were allocated dynamically, so
+                         * nothing needs to be freed. */
+                        configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB );
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+        }
+    }
+
+#endif /* INCLUDE_vTaskDelete */
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_TASK_POOLS == 1 ) && ( INCLUDE_vTaskDelete == 1 ) )
+
+    static void prvReturnTaskToPool( TCB_t * pxTCB )
+    {
+        TaskPool_t * const pxPool = pxTCB->pxPool;
+
+        #if ( tskSET_NEW_STACKS_TO_KNOWN_VALUE == 1 )
+            {
+                uint8_t * pucStackByte;
+                size_t xUnused = 0, xStackSize = ( size_t ) pxPool->usStackDepth * sizeof( StackType_t );
+
+                /* Only the part of the stack between its start and the deepest
+                 * point the task reached has changed, so only that is filled
+                 * again, from here rather than when the next task is created. */
+                #if ( portSTACK_GROWTH < 0 )
+                    {
+                        pucStackByte = ( uint8_t * ) pxTCB->pxStack;
+
+                        while( ( xUnused < xStackSize ) && ( pucStackByte[ xUnused ] == ( uint8_t ) tskSTACK_FILL_BYTE ) )
+                        {
+                            xUnused++;
+                        }
+
+                        ( void ) memset( &( pucStackByte[ xUnused ] ), ( int ) tskSTACK_FILL_BYTE, xStackSize - xUnused );
+                    }
+                #else /* portSTACK_GROWTH */
+                    {
+                        pucStackByte = ( uint8_t * ) pxTCB->pxStack;
+
+                        while( ( xUnused < xStackSize ) && ( pucStackByte[ xStackSize - xUnused - 1U ] == ( uint8_t ) tskSTACK_FILL_BYTE ) )
+                        {
+                            xUnused++;
+                        }
+
+                        ( void ) memset( pucStackByte, ( int ) tskSTACK_FILL_BYTE, xStackSize - xUnused );
+                    }
+                #endif /* portSTACK_GROWTH */
+            }
+        #endif /* tskSET_NEW_STACKS_TO_KNOWN_VALUE */
+
+        taskENTER_CRITICAL();
+        {
+            vListInsertEnd( &( pxPool->xFreeSlots ), &( pxTCB->xStateListItem ) );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* ( configUSE_TASK_POOLS == 1 ) && ( INCLUDE_vTaskDelete == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_DELAYED_TASK_WHEEL == 1 )
+
+    static UBaseType_t prvDelayWheelLowestSlot( const uint32_t ulSlots )
+    {
+        /* De Bruijn sequence lookup for the index of the lowest set bit. */
+        static const uint8_t ucBitPosition[ 32 ] =
+        {
+            0U,  1U,  28U, 2U,  29U, 14U, 24U, 3U,  30U, 22U, 20U, 15U, 25U, 17U, 4U,  8U,
+            31U, 27U, 13U, 23U, 21U, 19U, 16U, 7U,  26U, 12U, 18U, 6U,  11U, 5U,  10U, 9U
+        };
+        const uint32_t ulLowest = ulSlots & ( ( uint32_t ) 0U - ulSlots );
+
+        return ( UBaseType_t ) ucBitPosition[ ( uint32_t ) ( ulLowest * ( uint32_t ) 0x077CB531UL ) >> 27 ];
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvDelayWheelInsert( ListItem_t * const pxListItem )
+    {
+        const TickType_t xTimeToWake = listGET_LIST_ITEM_VALUE( pxListItem );
+        TickType_t xDifference = xTimeToWake ^ xDelayWheelTime;
+        UBaseType_t uxLevel = 0U, uxSlot;
+
+        while( xDifference > taskWHEEL_SLOT_MASK )
+        {
+            xDifference >>= taskWHEEL_SLOT_BITS;
+            uxLevel++;
+        }
+
+        uxSlot = ( UBaseType_t ) ( ( xTimeToWake >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) & taskWHEEL_SLOT_MASK );
+        vListInsertEnd( &( xDelayWheel[ uxLevel ][ uxSlot ] ), pxListItem );
+        ulDelayWheelOccupied[ uxLevel ] |= ( uint32_t ) 1U << uxSlot;
+    }
+    /*-----------------------------------------------------------*/
+
+    static List_t * prvDelayWheelAdvance( const TickType_t xTime )
+    {
+        UBaseType_t uxLevel, uxSlot;
+        List_t * pxSlot;
+        ListItem_t * pxListItem;
+
+        xDelayWheelTime = xTime;
+
+        /* The tasks in a slot agree with the time the wheel was arranged around
+         * in every digit above the slot's level, as does xTime, which lies
+         * between the two.  So only the slots on xTime's own path can hold tasks
+         * that now belong to a lower level - cascade those down, top level
+         * first.  The other tasks stay where they are. */
+        for( uxLevel = taskWHEEL_LEVELS - 1U; uxLevel > 0U; uxLevel-- )
+        {
+            uxSlot = ( UBaseType_t ) ( ( xTime >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) & taskWHEEL_SLOT_MASK );
+
+            if( ( ulDelayWheelOccupied[ uxLevel ] & ( ( uint32_t ) 1U << uxSlot ) ) != 0U )
+            {
+                ulDelayWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+                pxSlot = &( xDelayWheel[ uxLevel ][ uxSlot ] );
+
+                while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+                {
+                    pxListItem = listGET_HEAD_ENTRY( pxSlot );
+                    ( void ) uxListRemove( pxListItem );
+                    prvDelayWheelInsert( pxListItem );
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        return &( xDelayWheel[ 0 ][ xTime & taskWHEEL_SLOT_MASK ] );
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvDelayWheelOverflow( void )
+    {
+        UBaseType_t uxLevel;
+        ListItem_t * pxListItem;
+
+        /* The tasks in the wheel all woke before the tick count overflowed. */
+        for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+        {
+            while( ulDelayWheelOccupied[ uxLevel ] != 0U )
+            {
+                configASSERT( listLIST_IS_EMPTY( &( xDelayWheel[ uxLevel ][ prvDelayWheelLowestSlot( ulDelayWheelOccupied[ uxLevel ] ) ] ) ) );
+                ulDelayWheelOccupied[ uxLevel ] &= ulDelayWheelOccupied[ uxLevel ] - 1U;
+            }
+        }
+
+        xDelayWheelTime = ( TickType_t ) 0U;
+
+        while( listLIST_IS_EMPTY( pxOverflowDelayedTaskList ) == pdFALSE )
+        {
+            pxListItem = listGET_HEAD_ENTRY( pxOverflowDelayedTaskList );
+            ( void ) uxListRemove( pxListItem );
+            prvDelayWheelInsert( pxListItem );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+    static void prvResetNextTaskUnblockTime( void )
+    {
+        UBaseType_t uxLevel, uxSlot;
+        uint32_t ulSlots;
+        List_t * pxSlot;
+        ListItem_t const * pxIterator;
+        ListItem_t const * pxEnd;
+
+        xNextTaskUnblockTime = portMAX_DELAY;
+
+        /* A task at a higher level wakes later than every task at a lower one,
+         * and within a level the slots are in wake time order from the digit of
+         * xDelayWheelTime upwards (the slots below it are empty). */
+        for( uxLevel = 0U; uxLevel < taskWHEEL_LEVELS; uxLevel++ )
+        {
+            uxSlot = ( UBaseType_t ) ( ( xDelayWheelTime >> ( uxLevel * taskWHEEL_SLOT_BITS ) ) & taskWHEEL_SLOT_MASK );
+            ulSlots = ulDelayWheelOccupied[ uxLevel ] & ~( ( ( uint32_t ) 1U << uxSlot ) - 1U );
+
+            while( ulSlots != 0U )
+            {
+                uxSlot = prvDelayWheelLowestSlot( ulSlots );
+                pxSlot = &( xDelayWheel[ uxLevel ][ uxSlot ] );
+
+                if( listLIST_IS_EMPTY( pxSlot ) != pdFALSE )
+                {
+                    /* The tasks that were in the slot have since left it. */
+                    ulDelayWheelOccupied[ uxLevel ] &= ~( ( uint32_t ) 1U << uxSlot );
+                    ulSlots &= ~( ( uint32_t ) 1U << uxSlot );
                 }
                 else
                 {
-                    /* Neither the stack nor the TCB were allocated dynamically, so
-                     * nothing needs to be freed. */
-                    configASSERT( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_AND_TCB );
-                    mtCOVERAGE_TEST_MARKER();
+                    /* The tasks in a slot of the lowest level all wake at the
+                     * same time.  Those in a slot of a higher level have to be
+                     * searched for the earliest. */
+                    xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxSlot );
+
+                    if( uxLevel > 0U )
+                    {
+                        pxEnd = listGET_END_MARKER( pxSlot );
+
+                        for( pxIterator = listGET_HEAD_ENTRY( pxSlot ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+                        {
+                            if( listGET_LIST_ITEM_VALUE( pxIterator ) < xNextTaskUnblockTime )
+                            {
+                                xNextTaskUnblockTime = listGET_LIST_ITEM_VALUE( pxIterator );
+                            }
+                        }
+                    }
+
+                    return;
                 }
             }
-        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+        }
     }
 
-#endif /* INCLUDE_vTaskDelete */
-/*-----------------------------------------------------------*/
+#else /* configUSE_DELAYED_TASK_WHEEL */
 
 static void prvResetNextTaskUnblockTime( void )
 {
@@ -3988,23 +7208,42 @@ static void prvResetNextTaskUnblockTime( void )
         xNextTaskUnblockTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxDelayedTaskList );
     }
 }
+
+#endif /* configUSE_DELAYED_TASK_WHEEL */
 /*-----------------------------------------------------------*/
 
-#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) )
+#if ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUMBER_OF_CORES > 1 ) )
 
     TaskHandle_t xTaskGetCurrentTaskHandle( void )
     {
         TaskHandle_t xReturn;
 
-        /* A critical section is not required as this is not called from
-         * an interrupt and the current TCB will always be the same for any
-         * individual execution thread. */
-        xReturn = pxCurrentTCB;
+        #if ( configNUMBER_OF_CORES == 1 )
+            {
+                /* A critical section is not required as this is not called from
+                 * an interrupt and the current TCB will always be the same for any
+                 * individual execution thread. */
+                xReturn = pxCurrentTCB;
+            }
+        #else
+            {
+                UBaseType_t uxSavedInterruptStatus;
+
+                /* The calling task could be moved to another core between
+                 * reading the core ID and reading the current TCB of that
+                 * core, unless interrupts are masked. */
+                uxSavedInterruptStatus = portSET_INTERRUPT_MASK();
+                {
+                    xReturn = pxCurrentTCBs[ portGET_CORE_ID() ];
+                }
+                portCLEAR_INTERRUPT_MASK( uxSavedInterruptStatus );
+            }
+        #endif /* configNUMBER_OF_CORES */
 
         return xReturn;
     }
 
-#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) ) */
+#endif /* ( ( INCLUDE_xTaskGetCurrentTaskHandle == 1 ) || ( configUSE_MUTEXES == 1 ) || ( configNUMBER_OF_CORES > 1 ) ) */
 /*-----------------------------------------------------------*/
 
 #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -4019,6 +7258,13 @@ static void prvResetNextTaskUnblockTime( void )
         }
         else
         {
+            /* With more than one core the scheduler may be suspended by a
+             * task on another core, which holds the task lock until it resumes
+             * it, so only a suspension by the calling task is reported. */
+            #if ( configNUMBER_OF_CORES > 1 )
+                taskENTER_CRITICAL();
+            #endif
+
             if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
             {
                 xReturn = taskSCHEDULER_RUNNING;
@@ -4027,6 +7273,10 @@ static void prvResetNextTaskUnblockTime( void )
             {
                 xReturn = taskSCHEDULER_SUSPENDED;
             }
+
+            #if ( configNUMBER_OF_CORES > 1 )
+                taskEXIT_CRITICAL();
+            #endif
         }
 
         return xReturn;
@@ -4052,45 +7302,39 @@ static void prvResetNextTaskUnblockTime( void )
              * inherit the priority of the task attempting to obtain the mutex. */
             if( pxMutexHolderTCB->uxPriority < pxCurrentTCB->uxPriority )
             {
-                /* Adjust the mutex holder state to account for its new
-                 * priority.  Only reset the event list item value if the value is
-                 * not being used for anything else. */
-                if( ( listGET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
-                {
-                    listSET_LIST_ITEM_VALUE( &( pxMutexHolderTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) pxCurrentTCB->uxPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+                prvSetMutexHolderPriority( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
+                traceTASK_PRIORITY_INHERIT( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
 
-                /* If the task being modified is in the ready state it will need
-                 * to be moved into a new list. */
-                if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxMutexHolderTCB->uxPriority ] ), &( pxMutexHolderTCB->xStateListItem ) ) != pdFALSE )
-                {
-                    if( uxListRemove( &( pxMutexHolderTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
-                    {
-                        /* It is known that the task is in its ready list so
-                         * there is no need to check again and the port level
-                         * reset macro can be called directly. */
-                        portRESET_READY_PRIORITY( pxMutexHolderTCB->uxPriority, uxTopReadyPriority );
-                    }
-                    else
+                #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
                     {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-
-                    /* Inherit the priority before being moved into the new list. */
-                    pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
-                    prvAddTaskToReadyList( pxMutexHolderTCB );
-                }
-                else
-                {
-                    /* Just inherit the priority. */
-                    pxMutexHolderTCB->uxPriority = pxCurrentTCB->uxPriority;
-                }
+                        TCB_t * pxTCB = pxMutexHolderTCB;
+                        UBaseType_t uxTasksRaised = ( UBaseType_t ) 1;
+
+                        /* If the mutex holder is itself blocked on a mutex then
+                         * the holder of that mutex is also keeping the calling
+                         * task waiting, so inherits its priority too, and so on
+                         * along the chain.  The walk is bounded so that a long
+                         * chain, or a deadlock, cannot keep interrupts masked for
+                         * long. */
+                        while( ( uxTasksRaised < ( UBaseType_t ) configPRIORITY_INHERITANCE_CHAIN_LENGTH ) && ( taskIS_WAITING_FOR_MUTEX( pxTCB ) ) )
+                        {
+                            pxTCB = *( pxTCB->pxWaitingMutexHolder );
 
-                traceTASK_PRIORITY_INHERIT( pxMutexHolderTCB, pxCurrentTCB->uxPriority );
+                            if( ( pxTCB != NULL ) && ( pxTCB->uxPriority < pxCurrentTCB->uxPriority ) )
+                            {
+                                prvSetMutexHolderPriority( pxTCB, pxCurrentTCB->uxPriority );
+                                traceTASK_PRIORITY_INHERIT( pxTCB, pxCurrentTCB->uxPriority );
+                                uxTasksRaised++;
+                            }
+                            else
+                            {
+                                /* The rest of the chain already runs at least
+                                 * at the calling task's priority. */
+                                uxTasksRaised = ( UBaseType_t ) configPRIORITY_INHERITANCE_CHAIN_LENGTH;
+                            }
+                        }
+                    }
+                #endif /* configPRIORITY_INHERITANCE_CHAIN_LENGTH */
 
                 /* Inheritance occurred. */
                 xReturn = pdTRUE;
@@ -4205,13 +7449,65 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_MUTEXES == 1 )
+
+    UBaseType_t uxTaskGetHighestWaitingPriority( const List_t * const pxEventList )
+    {
+        UBaseType_t uxHighestPriorityOfWaitingTasks = tskIDLE_PRIORITY;
+
+        #if ( configUSE_MULTI_WAIT == 1 )
+            {
+                const ListItem_t * pxEventListItem;
+                const ListItem_t * const pxEndMarker = listGET_END_MARKER( pxEventList );
+                TCB_t * pxTCB;
+
+                /* The list is ordered by priority, so the first list item that
+                 * is a task's own event list item is the highest priority task
+                 * waiting.  Those left by xMultiWaitForObjects(), whether the
+                 * task is still waiting or has already been woken, are skipped. */
+                pxEventListItem = listGET_HEAD_ENTRY( pxEventList );
+
+                while( pxEventListItem != pxEndMarker )
+                {
+                    pxTCB = listGET_LIST_ITEM_OWNER( pxEventListItem ); /*lint !e9079 void * is used as this macro is used with timers and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+                    if( pxEventListItem == &( pxTCB->xEventListItem ) )
+                    {
+                        uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_LIST_ITEM_VALUE( pxEventListItem );
+                        pxEventListItem = pxEndMarker;
+                    }
+                    else
+                    {
+                        pxEventListItem = listGET_NEXT( pxEventListItem );
+                    }
+                }
+            }
+        #else /* if ( configUSE_MULTI_WAIT == 1 ) */
+            {
+                if( listCURRENT_LIST_LENGTH( pxEventList ) > 0U )
+                {
+                    uxHighestPriorityOfWaitingTasks = ( UBaseType_t ) configMAX_PRIORITIES - ( UBaseType_t ) listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxEventList );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        #endif /* configUSE_MULTI_WAIT */
+
+        return uxHighestPriorityOfWaitingTasks;
+    }
+
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     void vTaskPriorityDisinheritAfterTimeout( TaskHandle_t const pxMutexHolder,
                                               UBaseType_t uxHighestPriorityWaitingTask )
     {
         TCB_t * const pxTCB = pxMutexHolder;
-        UBaseType_t uxPriorityUsedOnEntry, uxPriorityToUse;
+        UBaseType_t uxPriorityToUse;
         const UBaseType_t uxOnlyOneMutexHeld = ( UBaseType_t ) 1;
 
         if( pxMutexHolder != NULL )
@@ -4247,60 +7543,156 @@ static void prvResetNextTaskUnblockTime( void )
                      * its own priority. */
                     configASSERT( pxTCB != pxCurrentTCB );
 
-                    /* Disinherit the priority, remembering the previous
-                     * priority to facilitate determining the subject task's
-                     * state. */
+                    /* Disinherit the priority. */
                     traceTASK_PRIORITY_DISINHERIT( pxTCB, uxPriorityToUse );
-                    uxPriorityUsedOnEntry = pxTCB->uxPriority;
-                    pxTCB->uxPriority = uxPriorityToUse;
-
-                    /* Only reset the event list item value if the value is not
-                     * being used for anything else. */
-                    if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
-                    {
-                        listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxPriorityToUse ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
+                    prvSetMutexHolderPriority( pxTCB, uxPriorityToUse );
 
-                    /* If the running task is not the task that holds the mutex
-                     * then the task that holds the mutex could be in either the
-                     * Ready, Blocked or Suspended states.  Only remove the task
-                     * from its current state list if it is in the Ready state as
-                     * the task's priority is going to change and there is one
-                     * Ready list per priority. */
-                    if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
-                    {
-                        if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+                    #if ( configNUMBER_OF_CORES > 1 )
                         {
-                            /* It is known that the task is in its ready list so
-                             * there is no need to check again and the port level
-                             * reset macro can be called directly. */
-                            portRESET_READY_PRIORITY( pxTCB->uxPriority, uxTopReadyPriority );
+                            /* The holder may be running on another core, which
+                             * might now have a higher priority task to run. */
+                            if( pxTCB->xTaskRunState != taskTASK_NOT_RUNNING )
+                            {
+                                ( void ) prvYieldCore( pxTCB->xTaskRunState );
+                            }
+                            else
+                            {
+                                mtCOVERAGE_TEST_MARKER();
+                            }
                         }
-                        else
+                    #endif /* configNUMBER_OF_CORES */
+
+                    #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
                         {
-                            mtCOVERAGE_TEST_MARKER();
+                            TCB_t * pxWaitingTCB = pxTCB;
+                            TCB_t * pxHolderTCB;
+                            UBaseType_t uxTasksLowered = ( UBaseType_t ) 1;
+
+                            /* If the holder is itself blocked on a mutex, the
+                             * tasks further along the chain may have inherited the
+                             * same priority through it, so take each of them back
+                             * down to the highest priority still waiting for the
+                             * mutex it holds, under the same one mutex rule. */
+                            while( ( uxTasksLowered < ( UBaseType_t ) configPRIORITY_INHERITANCE_CHAIN_LENGTH ) && ( taskIS_WAITING_FOR_MUTEX( pxWaitingTCB ) ) )
+                            {
+                                pxHolderTCB = *( pxWaitingTCB->pxWaitingMutexHolder );
+                                uxPriorityToUse = uxTaskGetHighestWaitingPriority( listLIST_ITEM_CONTAINER( &( pxWaitingTCB->xEventListItem ) ) );
+
+                                if( ( pxHolderTCB != NULL ) && ( pxHolderTCB->uxBasePriority > uxPriorityToUse ) )
+                                {
+                                    uxPriorityToUse = pxHolderTCB->uxBasePriority;
+                                }
+                                else
+                                {
+                                    mtCOVERAGE_TEST_MARKER();
+                                }
+
+                                if( ( pxHolderTCB != NULL ) && ( pxHolderTCB->uxPriority > uxPriorityToUse ) && ( pxHolderTCB->uxMutexesHeld == uxOnlyOneMutexHeld ) )
+                                {
+                                    traceTASK_PRIORITY_DISINHERIT( pxHolderTCB, uxPriorityToUse );
+                                    prvSetMutexHolderPriority( pxHolderTCB, uxPriorityToUse );
+
+                                    #if ( configNUMBER_OF_CORES > 1 )
+                                        {
+                                            if( pxHolderTCB->xTaskRunState != taskTASK_NOT_RUNNING )
+                                            {
+                                                ( void ) prvYieldCore( pxHolderTCB->xTaskRunState );
+                                            }
+                                            else
+                                            {
+                                                mtCOVERAGE_TEST_MARKER();
+                                            }
+                                        }
+                                    #endif /* configNUMBER_OF_CORES */
+
+                                    pxWaitingTCB = pxHolderTCB;
+                                    uxTasksLowered++;
+                                }
+                                else
+                                {
+                                    uxTasksLowered = ( UBaseType_t ) configPRIORITY_INHERITANCE_CHAIN_LENGTH;
+                                }
+                            }
                         }
+                    #endif /* configPRIORITY_INHERITANCE_CHAIN_LENGTH */
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
 
-                        prvAddTaskToReadyList( pxTCB );
+#endif /* configUSE_MUTEXES */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MUTEXES == 1 )
+
+    static void prvSetMutexHolderPriority( TCB_t * const pxTCB,
+                                           UBaseType_t uxNewPriority )
+    {
+        const UBaseType_t uxPriorityUsedOnEntry = pxTCB->uxPriority;
+
+        pxTCB->uxPriority = uxNewPriority;
+
+        /* Only reset the event list item value if the value is not being used
+         * for anything else. */
+        if( ( listGET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ) ) & taskEVENT_LIST_ITEM_VALUE_IN_USE ) == 0UL )
+        {
+            listSET_LIST_ITEM_VALUE( &( pxTCB->xEventListItem ), ( TickType_t ) configMAX_PRIORITIES - ( TickType_t ) uxNewPriority ); /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+
+            #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                {
+                    /* The list of tasks waiting for a mutex is kept in
+                     * priority order, so the highest priority waiter is the
+                     * one given the mutex. */
+                    if( taskIS_WAITING_FOR_MUTEX( pxTCB ) )
+                    {
+                        List_t * const pxEventList = listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) );
+
+                        ( void ) uxListRemove( &( pxTCB->xEventListItem ) );
+                        vListInsert( pxEventList, &( pxTCB->xEventListItem ) );
                     }
                     else
                     {
                         mtCOVERAGE_TEST_MARKER();
                     }
                 }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+            #endif /* configPRIORITY_INHERITANCE_CHAIN_LENGTH */
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* If the running task is not the task whose priority changes then the
+         * task could be in either the Ready, Blocked or Suspended states.  Only
+         * remove the task from its current state list if it is in the Ready
+         * state, as there is one Ready list per priority. */
+        if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ uxPriorityUsedOnEntry ] ), &( pxTCB->xStateListItem ) ) != pdFALSE )
+        {
+            if( uxListRemove( &( pxTCB->xStateListItem ) ) == ( UBaseType_t ) 0 )
+            {
+                /* It is known that the task is in its ready list so there is
+                 * no need to check again and the port level reset macro can be
+                 * called directly. */
+                portRESET_READY_PRIORITY( uxPriorityUsedOnEntry, uxTopReadyPriority );
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
+
+            prvAddTaskToReadyList( pxTCB );
         }
         else
         {
@@ -4311,6 +7703,73 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* configUSE_MUTEXES */
 /*-----------------------------------------------------------*/
 
+#if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+
+    void vTaskSetBlockingMutex( TaskHandle_t * const pxMutexHolder )
+    {
+        pxCurrentTCB->pxWaitingMutexHolder = pxMutexHolder;
+    }
+
+#endif /* configPRIORITY_INHERITANCE_CHAIN_LENGTH */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_MUTEX_PRIORITY_CEILING == 1 )
+
+    BaseType_t xTaskPriorityAboveCeiling( UBaseType_t uxCeilingPriority )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        /* The mutex can be taken before any tasks have been created, in which
+         * case pxCurrentTCB is NULL and there is no task priority to check. */
+        if( pxCurrentTCB != NULL )
+        {
+            /* The base priority is the one that counts, as a task that has
+             * inherited a priority above the ceiling returns below it once it
+             * gives back the mutex it inherited through. */
+            if( pxCurrentTCB->uxBasePriority > uxCeilingPriority )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskPriorityRaiseToCeiling( UBaseType_t uxCeilingPriority )
+    {
+        /* This runs as the calling task takes the mutex, which it can do
+         * before any tasks have been created, in which case pxCurrentTCB is
+         * NULL and there is no task to raise. */
+        if( pxCurrentTCB != NULL )
+        {
+            if( pxCurrentTCB->uxPriority < uxCeilingPriority )
+            {
+                prvSetMutexHolderPriority( pxCurrentTCB, uxCeilingPriority );
+                traceTASK_PRIORITY_INHERIT( pxCurrentTCB, uxCeilingPriority );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_MUTEX_PRIORITY_CEILING */
+/*-----------------------------------------------------------*/
+
 #if ( portCRITICAL_NESTING_IN_TCB == 1 )
 
     void vTaskEnterCritical( void )
@@ -4401,11 +7860,12 @@ static void prvResetNextTaskUnblockTime( void )
 #endif /* ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+#if ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
     void vTaskList( char * pcWriteBuffer )
     {
-        TaskStatus_t * pxTaskStatusArray;
+        TaskStatus_t xTaskStatusArray[ tskSTATUS_CHUNK_LENGTH ];
+        TaskStateCursor_t xCursor;
         UBaseType_t uxArraySize, x;
         char cStatus;
 
@@ -4416,8 +7876,8 @@ static void prvResetNextTaskUnblockTime( void )
          * of the demo applications.  Do not consider it to be part of the
          * scheduler.
          *
-         * vTaskList() calls uxTaskGetSystemState(), then formats part of the
-         * uxTaskGetSystemState() output into a human readable table that
+         * vTaskList() calls uxTaskGetNextTaskStates(), then formats part of the
+         * uxTaskGetNextTaskStates() output into a human readable table that
          * displays task names, states and stack usage.
          *
          * vTaskList() has a dependency on the sprintf() C library function that
@@ -4428,33 +7888,26 @@ static void prvResetNextTaskUnblockTime( void )
          * printf-stdarg.c (note printf-stdarg.c does not provide a full
          * snprintf() implementation!).
          *
-         * It is recommended that production systems call uxTaskGetSystemState()
-         * directly to get access to raw stats data, rather than indirectly
-         * through a call to vTaskList().
+         * It is recommended that production systems call
+         * uxTaskGetNextTaskStates() or xTaskSerialiseNextTaskStates() directly
+         * to get access to raw stats data, rather than indirectly through a call
+         * to vTaskList().
          */
 
 
         /* Make sure the write buffer does not contain a string. */
         *pcWriteBuffer = ( char ) 0x00;
 
-        /* Take a snapshot of the number of tasks in case it changes while this
-         * function is executing. */
-        uxArraySize = uxCurrentNumberOfTasks;
-
-        /* Allocate an array index for each task.  NOTE!  if
-         * configSUPPORT_DYNAMIC_ALLOCATION is set to 0 then pvPortMalloc() will
-         * equate to NULL. */
-        pxTaskStatusArray = pvPortMalloc( uxCurrentNumberOfTasks * sizeof( TaskStatus_t ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation allocates a struct that has the alignment requirements of a pointer. */
+        /* The tasks are fetched a few at a time so neither a heap allocation
+         * nor an array large enough for every task is needed. */
+        vTaskInitStateCursor( &xCursor );
 
-        if( pxTaskStatusArray != NULL )
+        while( ( uxArraySize = uxTaskGetNextTaskStates( &xCursor, xTaskStatusArray, tskSTATUS_CHUNK_LENGTH, pdTRUE ) ) != ( UBaseType_t ) 0U )
         {
-            /* Generate the (binary) data. */
-            uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, NULL );
-
             /* Create a human readable table from the binary data. */
             for( x = 0; x < uxArraySize; x++ )
             {
-                switch( pxTaskStatusArray[ x ].eCurrentState )
+                switch( xTaskStatusArray[ x ].eCurrentState )
                 {
                     case eRunning:
                         cStatus = tskRUNNING_CHAR;
@@ -4485,33 +7938,26 @@ static void prvResetNextTaskUnblockTime( void )
 
                 /* Write the task name to the string, padding with spaces so it
                  * can be printed in tabular form more easily. */
-                pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, pxTaskStatusArray[ x ].pcTaskName );
+                pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, xTaskStatusArray[ x ].pcTaskName );
 
                 /* Write the rest of the string. */
-                sprintf( pcWriteBuffer, "\t%c\t%u\t%u\t%u\r\n", cStatus, ( unsigned int ) pxTaskStatusArray[ x ].uxCurrentPriority, ( unsigned int ) pxTaskStatusArray[ x ].usStackHighWaterMark, ( unsigned int ) pxTaskStatusArray[ x ].xTaskNumber ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
-                pcWriteBuffer += strlen( pcWriteBuffer );                                                                                                                                                                                                /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
+                sprintf( pcWriteBuffer, "\t%c\t%u\t%u\t%u\r\n", cStatus, ( unsigned int ) xTaskStatusArray[ x ].uxCurrentPriority, ( unsigned int ) xTaskStatusArray[ x ].usStackHighWaterMark, ( unsigned int ) xTaskStatusArray[ x ].xTaskNumber ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                pcWriteBuffer += strlen( pcWriteBuffer );                                                                                                                                                                                          /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
             }
-
-            /* Free the array again.  NOTE!  If configSUPPORT_DYNAMIC_ALLOCATION
-             * is 0 then vPortFree() will be #defined to nothing. */
-            vPortFree( pxTaskStatusArray );
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
         }
     }
 
-#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) ) */
+#endif /* ( ( configUSE_TRACE_FACILITY == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) ) */
 /*----------------------------------------------------------*/
 
-#if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
+#if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) )
 
     void vTaskGetRunTimeStats( char * pcWriteBuffer )
     {
-        TaskStatus_t * pxTaskStatusArray;
+        TaskStatus_t xTaskStatusArray[ tskSTATUS_CHUNK_LENGTH ];
+        TaskStateCursor_t xCursor;
         UBaseType_t uxArraySize, x;
-        uint32_t ulTotalTime, ulStatsAsPercentage;
+        configRUN_TIME_COUNTER_TYPE ulTotalTime, ulStatsAsPercentage;
 
         #if ( configUSE_TRACE_FACILITY != 1 )
             {
@@ -4526,10 +7972,10 @@ static void prvResetNextTaskUnblockTime( void )
          * of the demo applications.  Do not consider it to be part of the
          * scheduler.
          *
-         * vTaskGetRunTimeStats() calls uxTaskGetSystemState(), then formats part
-         * of the uxTaskGetSystemState() output into a human readable table that
-         * displays the amount of time each task has spent in the Running state
-         * in both absolute and percentage terms.
+         * vTaskGetRunTimeStats() calls uxTaskGetNextTaskStates(), then formats
+         * part of the uxTaskGetNextTaskStates() output into a human readable
+         * table that displays the amount of time each task has spent in the
+         * Running state in both absolute and percentage terms.
          *
          * vTaskGetRunTimeStats() has a dependency on the sprintf() C library
          * function that might bloat the code size, use a lot of stack, and
@@ -4539,33 +7985,30 @@ static void prvResetNextTaskUnblockTime( void )
          * a file called printf-stdarg.c (note printf-stdarg.c does not provide
          * a full snprintf() implementation!).
          *
-         * It is recommended that production systems call uxTaskGetSystemState()
-         * directly to get access to raw stats data, rather than indirectly
-         * through a call to vTaskGetRunTimeStats().
+         * It is recommended that production systems call
+         * uxTaskGetNextTaskStates() or xTaskSerialiseNextTaskStates() directly
+         * to get access to raw stats data, rather than indirectly through a call
+         * to vTaskGetRunTimeStats().
          */
 
         /* Make sure the write buffer does not contain a string. */
         *pcWriteBuffer = ( char ) 0x00;
 
-        /* Take a snapshot of the number of tasks in case it changes while this
-         * function is executing. */
-        uxArraySize = uxCurrentNumberOfTasks;
+        /* Read the total before any of the task counters so no task can show
+         * more than 100%. */
+        taskREAD_RUN_TIME_COUNTER( ulTotalTime );
 
-        /* Allocate an array index for each task.  NOTE!  If
-         * configSUPPORT_DYNAMIC_ALLOCATION is set to 0 then pvPortMalloc() will
-         * equate to NULL. */
-        pxTaskStatusArray = pvPortMalloc( uxCurrentNumberOfTasks * sizeof( TaskStatus_t ) ); /*lint !e9079 All values returned by pvPortMalloc() have at least the alignment required by the MCU's stack and this allocation allocates a struct that has the alignment requirements of a pointer. */
+        /* For percentage calculations. */
+        ulTotalTime /= 100UL;
 
-        if( pxTaskStatusArray != NULL )
+        /* Avoid divide by zero errors. */
+        if( ulTotalTime > 0UL )
         {
-            /* Generate the (binary) data. */
-            uxArraySize = uxTaskGetSystemState( pxTaskStatusArray, uxArraySize, &ulTotalTime );
+            /* The tasks are fetched a few at a time so neither a heap
+             * allocation nor an array large enough for every task is needed. */
+            vTaskInitStateCursor( &xCursor );
 
-            /* For percentage calculations. */
-            ulTotalTime /= 100UL;
-
-            /* Avoid divide by zero errors. */
-            if( ulTotalTime > 0UL )
+            while( ( uxArraySize = uxTaskGetNextTaskStates( &xCursor, xTaskStatusArray, tskSTATUS_CHUNK_LENGTH, pdFALSE ) ) != ( UBaseType_t ) 0U )
             {
                 /* Create a human readable table from the binary data. */
                 for( x = 0; x < uxArraySize; x++ )
@@ -4573,24 +8016,24 @@ static void prvResetNextTaskUnblockTime( void )
                     /* What percentage of the total run time has the task used?
                      * This will always be rounded down to the nearest integer.
                      * ulTotalRunTimeDiv100 has already been divided by 100. */
-                    ulStatsAsPercentage = pxTaskStatusArray[ x ].ulRunTimeCounter / ulTotalTime;
+                    ulStatsAsPercentage = xTaskStatusArray[ x ].ulRunTimeCounter / ulTotalTime;
 
                     /* Write the task name to the string, padding with
                      * spaces so it can be printed in tabular form more
                      * easily. */
-                    pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, pxTaskStatusArray[ x ].pcTaskName );
+                    pcWriteBuffer = prvWriteNameToBuffer( pcWriteBuffer, xTaskStatusArray[ x ].pcTaskName );
 
                     if( ulStatsAsPercentage > 0UL )
                     {
                         #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                             {
-                                sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter, ulStatsAsPercentage );
+                                sprintf( pcWriteBuffer, "\t%lu\t\t%lu%%\r\n", ( unsigned long ) xTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned long ) ulStatsAsPercentage );
                             }
                         #else
                             {
                                 /* sizeof( int ) == sizeof( long ) so a smaller
                                  * printf() library can be used. */
-                                sprintf( pcWriteBuffer, "\t%u\t\t%u%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                                sprintf( pcWriteBuffer, "\t%u\t\t%u%%\r\n", ( unsigned int ) xTaskStatusArray[ x ].ulRunTimeCounter, ( unsigned int ) ulStatsAsPercentage ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
                             }
                         #endif
                     }
@@ -4600,13 +8043,13 @@ static void prvResetNextTaskUnblockTime( void )
                          * consumed less than 1% of the total run time. */
                         #ifdef portLU_PRINTF_SPECIFIER_REQUIRED
                             {
-                                sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", pxTaskStatusArray[ x ].ulRunTimeCounter );
+                                sprintf( pcWriteBuffer, "\t%lu\t\t<1%%\r\n", ( unsigned long ) xTaskStatusArray[ x ].ulRunTimeCounter );
                             }
                         #else
                             {
                                 /* sizeof( int ) == sizeof( long ) so a smaller
                                  * printf() library can be used. */
-                                sprintf( pcWriteBuffer, "\t%u\t\t<1%%\r\n", ( unsigned int ) pxTaskStatusArray[ x ].ulRunTimeCounter ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
+                                sprintf( pcWriteBuffer, "\t%u\t\t<1%%\r\n", ( unsigned int ) xTaskStatusArray[ x ].ulRunTimeCounter ); /*lint !e586 sprintf() allowed as this is compiled with many compilers and this is a utility function only - not part of the core kernel implementation. */
                             }
                         #endif
                     }
@@ -4614,14 +8057,6 @@ static void prvResetNextTaskUnblockTime( void )
                     pcWriteBuffer += strlen( pcWriteBuffer ); /*lint !e9016 Pointer arithmetic ok on char pointers especially as in this case where it best denotes the intent of the code. */
                 }
             }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
-            }
-
-            /* Free the array again.  NOTE!  If configSUPPORT_DYNAMIC_ALLOCATION
-             * is 0 then vPortFree() will be #defined to nothing. */
-            vPortFree( pxTaskStatusArray );
         }
         else
         {
@@ -4629,7 +8064,7 @@ static void prvResetNextTaskUnblockTime( void )
         }
     }
 
-#endif /* ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) && ( configSUPPORT_STATIC_ALLOCATION == 1 ) ) */
+#endif /* ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configUSE_STATS_FORMATTING_FUNCTIONS > 0 ) ) */
 /*-----------------------------------------------------------*/
 
 TickType_t uxTaskResetEventItemValue( void )
@@ -4655,6 +8090,14 @@ TickType_t uxTaskResetEventItemValue( void )
         if( pxCurrentTCB != NULL )
         {
             ( pxCurrentTCB->uxMutexesHeld )++;
+
+            #if ( configPRIORITY_INHERITANCE_CHAIN_LENGTH > 1 )
+                {
+                    /* The task is no longer waiting for the mutex it was
+                     * blocked on, if any. */
+                    pxCurrentTCB->pxWaitingMutexHolder = NULL;
+                }
+            #endif
         }
 
         return pxCurrentTCB;
@@ -4823,75 +8266,118 @@ TickType_t uxTaskResetEventItemValue( void )
 
 #if ( configUSE_TASK_NOTIFICATIONS == 1 )
 
-    BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify,
-                                   UBaseType_t uxIndexToNotify,
-                                   uint32_t ulValue,
-                                   eNotifyAction eAction,
-                                   uint32_t * pulPreviousNotificationValue )
+    static BaseType_t prvUpdateNotification( TCB_t * pxTCB,
+                                             UBaseType_t uxIndexToNotify,
+                                             uint32_t ulValue,
+                                             eNotifyAction eAction,
+                                             uint8_t * pucOriginalNotifyState )
     {
-        TCB_t * pxTCB;
         BaseType_t xReturn = pdPASS;
         uint8_t ucOriginalNotifyState;
 
-        configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
-        configASSERT( xTaskToNotify );
-        pxTCB = xTaskToNotify;
+        ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+        pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
 
-        taskENTER_CRITICAL();
-        {
-            if( pulPreviousNotificationValue != NULL )
+        #if ( configUSE_MULTI_WAIT == 1 )
             {
-                *pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
+                /* A task in xMultiWaitForObjects() waits on each of its
+                 * notifications, but is only unblocked by the first thing to
+                 * wake it. */
+                if( ( ucOriginalNotifyState == taskWAITING_NOTIFICATION ) && ( pxTCB->ucMultiWaitState != taskMULTI_WAIT_NONE ) )
+                {
+                    if( pxTCB->ucMultiWaitState == taskMULTI_WAIT_BLOCKED )
+                    {
+                        prvMultiWaitWoken( pxTCB );
+                    }
+                    else
+                    {
+                        ucOriginalNotifyState = taskNOT_WAITING_NOTIFICATION;
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
             }
+        #endif
 
-            ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
+        switch( eAction )
+        {
+            case eSetBits:
+                pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
+                break;
 
-            pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
+            case eIncrement:
+                ( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
+                break;
 
-            switch( eAction )
-            {
-                case eSetBits:
-                    pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
-                    break;
+            case eSetValueWithOverwrite:
+                pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
+                break;
 
-                case eIncrement:
-                    ( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
-                    break;
+            case eSetValueWithoutOverwrite:
 
-                case eSetValueWithOverwrite:
+                if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
+                {
                     pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
-                    break;
+                }
+                else
+                {
+                    /* The value could not be written to the task. */
+                    xReturn = pdFAIL;
+                }
 
-                case eSetValueWithoutOverwrite:
+                break;
 
-                    if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
-                    {
-                        pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
-                    }
-                    else
-                    {
-                        /* The value could not be written to the task. */
-                        xReturn = pdFAIL;
-                    }
+            case eNoAction:
 
-                    break;
+                /* The task is being notified without its notify value being
+                 * updated. */
+                break;
 
-                case eNoAction:
+            default:
 
-                    /* The task is being notified without its notify value being
-                     * updated. */
-                    break;
+                /* Should not get here if all enums are handled.
+                 * Artificially force an assert by testing a value the
+                 * compiler can't assume is const. */
+                configASSERT( xTickCount == ( TickType_t ) 0 );
+
+                break;
+        }
+
+        *pucOriginalNotifyState = ucOriginalNotifyState;
+
+        return xReturn;
+    }
 
-                default:
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+    BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify,
+                                   UBaseType_t uxIndexToNotify,
+                                   uint32_t ulValue,
+                                   eNotifyAction eAction,
+                                   uint32_t * pulPreviousNotificationValue )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xReturn;
+        uint8_t ucOriginalNotifyState;
 
-                    /* Should not get here if all enums are handled.
-                     * Artificially force an assert by testing a value the
-                     * compiler can't assume is const. */
-                    configASSERT( xTickCount == ( TickType_t ) 0 );
+        configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+        configASSERT( xTaskToNotify );
+        pxTCB = xTaskToNotify;
 
-                    break;
+        taskENTER_CRITICAL();
+        {
+            if( pulPreviousNotificationValue != NULL )
+            {
+                *pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
             }
 
+            xReturn = prvUpdateNotification( pxTCB, uxIndexToNotify, ulValue, eAction, &ucOriginalNotifyState );
+
             traceTASK_NOTIFY( uxIndexToNotify );
 
             /* If the task is in the blocked state specifically to wait for a
@@ -4920,7 +8406,11 @@ TickType_t uxTaskResetEventItemValue( void )
                     }
                 #endif
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                #if ( configNUMBER_OF_CORES == 1 )
+                    if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                #else
+                    if( prvYieldForTask( pxTCB ) != pdFALSE )
+                #endif
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -4955,7 +8445,7 @@ TickType_t uxTaskResetEventItemValue( void )
     {
         TCB_t * pxTCB;
         uint8_t ucOriginalNotifyState;
-        BaseType_t xReturn = pdPASS;
+        BaseType_t xReturn;
         UBaseType_t uxSavedInterruptStatus;
 
         configASSERT( xTaskToNotify );
@@ -4988,51 +8478,7 @@ TickType_t uxTaskResetEventItemValue( void )
                 *pulPreviousNotificationValue = pxTCB->ulNotifiedValue[ uxIndexToNotify ];
             }
 
-            ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
-            pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
-
-            switch( eAction )
-            {
-                case eSetBits:
-                    pxTCB->ulNotifiedValue[ uxIndexToNotify ] |= ulValue;
-                    break;
-
-                case eIncrement:
-                    ( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
-                    break;
-
-                case eSetValueWithOverwrite:
-                    pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
-                    break;
-
-                case eSetValueWithoutOverwrite:
-
-                    if( ucOriginalNotifyState != taskNOTIFICATION_RECEIVED )
-                    {
-                        pxTCB->ulNotifiedValue[ uxIndexToNotify ] = ulValue;
-                    }
-                    else
-                    {
-                        /* The value could not be written to the task. */
-                        xReturn = pdFAIL;
-                    }
-
-                    break;
-
-                case eNoAction:
-
-                    /* The task is being notified without its notify value being
-                     * updated. */
-                    break;
-
-                default:
-
-                    /* Should not get here if all enums are handled.
-                     * Artificially force an assert by testing a value the
-                     * compiler can't assume is const. */
-                    configASSERT( xTickCount == ( TickType_t ) 0 );
-                    break;
-            }
+            xReturn = prvUpdateNotification( pxTCB, uxIndexToNotify, ulValue, eAction, &ucOriginalNotifyState );
 
             traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify );
 
@@ -5052,10 +8498,15 @@ TickType_t uxTaskResetEventItemValue( void )
                 {
                     /* The delayed and ready lists cannot be accessed, so hold
                      * this task pending until the scheduler is resumed. */
+                    taskRECORD_READY_TIME( pxTCB );
                     vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                #if ( configNUMBER_OF_CORES == 1 )
+                    if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                #else
+                    if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( prvYieldForTask( pxTCB ) != pdFALSE ) )
+                #endif
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -5118,12 +8569,9 @@ TickType_t uxTaskResetEventItemValue( void )
 
         uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
         {
-            ucOriginalNotifyState = pxTCB->ucNotifyState[ uxIndexToNotify ];
-            pxTCB->ucNotifyState[ uxIndexToNotify ] = taskNOTIFICATION_RECEIVED;
-
             /* 'Giving' is equivalent to incrementing a count in a counting
              * semaphore. */
-            ( pxTCB->ulNotifiedValue[ uxIndexToNotify ] )++;
+            ( void ) prvUpdateNotification( pxTCB, uxIndexToNotify, 0UL, eIncrement, &ucOriginalNotifyState );
 
             traceTASK_NOTIFY_GIVE_FROM_ISR( uxIndexToNotify );
 
@@ -5143,10 +8591,15 @@ TickType_t uxTaskResetEventItemValue( void )
                 {
                     /* The delayed and ready lists cannot be accessed, so hold
                      * this task pending until the scheduler is resumed. */
+                    taskRECORD_READY_TIME( pxTCB );
                     vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
                 }
 
-                if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+                #if ( configNUMBER_OF_CORES == 1 )
+                    if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                #else
+                    if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( prvYieldForTask( pxTCB ) != pdFALSE ) )
+                #endif
                 {
                     /* The notified task has a priority above the currently
                      * executing task so a yield is required. */
@@ -5172,6 +8625,201 @@ TickType_t uxTaskResetEventItemValue( void )
 #endif /* configUSE_TASK_NOTIFICATIONS */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+    BaseType_t xTaskGenericNotifyMultiple( const TaskHandle_t * pxTasksToNotify,
+                                           UBaseType_t uxTasksToNotify,
+                                           UBaseType_t uxIndexToNotify,
+                                           uint32_t ulValue,
+                                           eNotifyAction eAction )
+    {
+        TCB_t * pxTCB;
+        TaskHandle_t xTaskToNotify;
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xYieldRequired = pdFALSE;
+        UBaseType_t uxTask;
+        uint8_t ucOriginalNotifyState;
+
+        configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+        configASSERT( ( pxTasksToNotify != NULL ) || ( uxTasksToNotify == ( UBaseType_t ) 0U ) );
+
+        taskENTER_CRITICAL();
+        {
+            for( uxTask = ( UBaseType_t ) 0U; uxTask < uxTasksToNotify; uxTask++ )
+            {
+                xTaskToNotify = pxTasksToNotify[ uxTask ];
+                configASSERT( xTaskToNotify );
+                pxTCB = xTaskToNotify;
+
+                if( prvUpdateNotification( pxTCB, uxIndexToNotify, ulValue, eAction, &ucOriginalNotifyState ) != pdPASS )
+                {
+                    xReturn = pdFAIL;
+                }
+
+                traceTASK_NOTIFY( uxIndexToNotify );
+
+                if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
+                {
+                    ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                    prvAddTaskToReadyList( pxTCB );
+
+                    /* The task should not have been on an event list. */
+                    configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+
+                    #if ( configUSE_TICKLESS_IDLE != 0 )
+                        {
+                            /* As in xTaskGenericNotify(), reset the next unblock
+                             * time so a timeout that no longer applies does not
+                             * cut short the next sleep. */
+                            prvResetNextTaskUnblockTime();
+                        }
+                    #endif
+
+                    /* Only note whether a yield is needed, so the calling task
+                     * is not switched out before the other tasks have been
+                     * notified.  With more than one core the other cores are
+                     * interrupted as each task is unblocked, as each task may
+                     * be run by a different core. */
+                    #if ( configNUMBER_OF_CORES == 1 )
+                        if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                    #else
+                        if( prvYieldForTask( pxTCB ) != pdFALSE )
+                    #endif
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xYieldRequired != pdFALSE )
+            {
+                taskYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+    BaseType_t xTaskGenericNotifyMultipleFromISR( const TaskHandle_t * pxTasksToNotify,
+                                                  UBaseType_t uxTasksToNotify,
+                                                  UBaseType_t uxIndexToNotify,
+                                                  uint32_t ulValue,
+                                                  eNotifyAction eAction,
+                                                  BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        TCB_t * pxTCB;
+        TaskHandle_t xTaskToNotify;
+        BaseType_t xReturn = pdPASS;
+        BaseType_t xYieldRequired = pdFALSE;
+        UBaseType_t uxTask;
+        UBaseType_t uxSavedInterruptStatus;
+        uint8_t ucOriginalNotifyState;
+
+        configASSERT( uxIndexToNotify < configTASK_NOTIFICATION_ARRAY_ENTRIES );
+        configASSERT( ( pxTasksToNotify != NULL ) || ( uxTasksToNotify == ( UBaseType_t ) 0U ) );
+
+        /* See the comment on interrupt priorities in
+         * xTaskGenericNotifyFromISR(). */
+        portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+        uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            for( uxTask = ( UBaseType_t ) 0U; uxTask < uxTasksToNotify; uxTask++ )
+            {
+                xTaskToNotify = pxTasksToNotify[ uxTask ];
+                configASSERT( xTaskToNotify );
+                pxTCB = xTaskToNotify;
+
+                if( prvUpdateNotification( pxTCB, uxIndexToNotify, ulValue, eAction, &ucOriginalNotifyState ) != pdPASS )
+                {
+                    xReturn = pdFAIL;
+                }
+
+                traceTASK_NOTIFY_FROM_ISR( uxIndexToNotify );
+
+                if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
+                {
+                    /* The task should not have been on an event list. */
+                    configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+
+                    if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+                    {
+                        ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                        prvAddTaskToReadyList( pxTCB );
+                    }
+                    else
+                    {
+                        /* The delayed and ready lists cannot be accessed, so
+                         * hold this task pending until the scheduler is
+                         * resumed. */
+                        taskRECORD_READY_TIME( pxTCB );
+                        vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+                    }
+
+                    #if ( configNUMBER_OF_CORES == 1 )
+                        if( taskPREEMPTS_CURRENT_TASK( pxTCB ) )
+                    #else
+                        if( ( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE ) && ( prvYieldForTask( pxTCB ) != pdFALSE ) )
+                    #endif
+                    {
+                        xYieldRequired = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+
+            if( xYieldRequired != pdFALSE )
+            {
+                /* One of the notified tasks has a priority above the
+                 * currently executing task so a single yield is required. */
+                if( pxHigherPriorityTaskWoken != NULL )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+
+                /* Mark that a yield is pending in case the user is not using
+                 * the "xHigherPriorityTaskWoken" parameter to an ISR safe
+                 * FreeRTOS function. */
+                xYieldPending = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_TASK_NOTIFICATIONS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TASK_NOTIFICATIONS == 1 )
 
     BaseType_t xTaskGenericNotifyStateClear( TaskHandle_t xTask,
@@ -5236,14 +8884,154 @@ TickType_t uxTaskResetEventItemValue( void )
 
 #if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( INCLUDE_xTaskGetIdleTaskHandle == 1 ) )
 
-    uint32_t ulTaskGetIdleRunTimeCounter( void )
+    configRUN_TIME_COUNTER_TYPE ulTaskGetIdleRunTimeCounter( void )
     {
-        return xIdleTaskHandle->ulRunTimeCounter;
+        #if ( configNUMBER_OF_CORES == 1 )
+            {
+                return xIdleTaskHandle->ulRunTimeCounter;
+            }
+        #else
+            {
+                configRUN_TIME_COUNTER_TYPE ulReturn = 0UL;
+                BaseType_t xCoreID;
+
+                /* The idle tasks are not tied to cores, so their total is
+                 * returned. */
+                for( xCoreID = 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
+                {
+                    ulReturn += xIdleTaskHandles[ xCoreID ]->ulRunTimeCounter;
+                }
+
+                return ulReturn;
+            }
+        #endif /* configNUMBER_OF_CORES */
     }
 
 #endif
 /*-----------------------------------------------------------*/
 
+#if ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) )
+
+    static configRUN_TIME_COUNTER_TYPE prvGetCoreRunTimeCounter( BaseType_t xCoreID,
+                                                                 BaseType_t xIdle )
+    {
+        configRUN_TIME_COUNTER_TYPE ulReturn, ulNow;
+
+        configASSERT( ( xCoreID >= 0 ) && ( xCoreID < ( BaseType_t ) configNUMBER_OF_CORES ) );
+
+        taskENTER_CRITICAL();
+        {
+            ulReturn = ( xIdle != pdFALSE ) ? ulCoreIdleRunTimeCounter[ xCoreID ] : ulCoreRunTimeCounter[ xCoreID ];
+
+            /* The counters are only updated when the core switches task, and
+             * a core can run the same task for a long time, so also count the
+             * time the task running on the core has run for so far. */
+            if( ( pxCurrentTCBs[ xCoreID ] != NULL ) &&
+                ( ( ( pxCurrentTCBs[ xCoreID ]->uxTaskAttributes & taskATTRIBUTE_IS_IDLE ) != 0U ) == ( xIdle != pdFALSE ) ) )
+            {
+                taskREAD_RUN_TIME_COUNTER( ulNow );
+
+                if( ( configRUN_TIME_COUNTER_TYPE ) ( ulNow - ulTaskSwitchedInTime[ xCoreID ] ) <= taskMAX_RUN_TIME_STEP )
+                {
+                    ulReturn += ulNow - ulTaskSwitchedInTime[ xCoreID ];
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return ulReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetCoreRunTimeCounter( BaseType_t xCoreID )
+    {
+        return prvGetCoreRunTimeCounter( xCoreID, pdFALSE );
+    }
+/*-----------------------------------------------------------*/
+
+    configRUN_TIME_COUNTER_TYPE ulTaskGetCoreIdleRunTimeCounter( BaseType_t xCoreID )
+    {
+        return prvGetCoreRunTimeCounter( xCoreID, pdTRUE );
+    }
+
+#endif /* ( ( configGENERATE_RUN_TIME_STATS == 1 ) && ( configNUMBER_OF_CORES > 1 ) ) */
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+    static void prvRecordTaskSwitch( TCB_t * pxOldTCB,
+                                     TCB_t * pxNewTCB,
+                                     configRUN_TIME_COUNTER_TYPE ulNow )
+    {
+        configRUN_TIME_COUNTER_TYPE ulLatency;
+
+        if( pxNewTCB != pxOldTCB )
+        {
+            /* A task that is still in its ready list could have gone on
+             * running. */
+            if( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxOldTCB->uxPriority ] ), &( pxOldTCB->xStateListItem ) ) != pdFALSE )
+            {
+                ( pxOldTCB->ulPreemptions )++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            ( pxNewTCB->ulSwitchesIn )++;
+
+            if( pxNewTCB->xReadyTimeValid != pdFALSE )
+            {
+                pxNewTCB->xReadyTimeValid = pdFALSE;
+                ulLatency = ulNow - pxNewTCB->ulReadyTime;
+
+                /* The ready time can be read on another thread of a simulator
+                 * port than the switch, so the counter can appear to have gone
+                 * backwards. */
+                if( ulLatency > taskMAX_RUN_TIME_STEP )
+                {
+                    ulLatency = 0U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ( pxNewTCB->ulWakeups == 0UL ) || ( ulLatency < pxNewTCB->ulWakeLatencyMin ) )
+                {
+                    pxNewTCB->ulWakeLatencyMin = ( uint32_t ) ulLatency;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                if( ulLatency > pxNewTCB->ulWakeLatencyMax )
+                {
+                    pxNewTCB->ulWakeLatencyMax = ( uint32_t ) ulLatency;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxNewTCB->ulWakeLatencyTotal += ulLatency;
+                ( pxNewTCB->ulWakeups )++;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
+
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely )
 {
@@ -5288,20 +9076,20 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                  * kernel will manage it correctly. */
                 xTimeToWake = xConstTickCount + xTicksToWait;
 
-                /* The list item will be inserted in wake time order. */
+                /* The list item value holds the wake time. */
                 listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
                 if( xTimeToWake < xConstTickCount )
                 {
                     /* Wake time has overflowed.  Place this item in the overflow
                      * list. */
-                    vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+                    taskINSERT_OVERFLOWED_TASK( &( pxCurrentTCB->xStateListItem ) );
                 }
                 else
                 {
                     /* The wake time has not overflowed, so the current block list
                      * is used. */
-                    vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+                    taskINSERT_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 
                     /* If the task entering the blocked state was placed at the
                      * head of the list of blocked tasks then xNextTaskUnblockTime
@@ -5324,18 +9112,18 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
              * will manage it correctly. */
             xTimeToWake = xConstTickCount + xTicksToWait;
 
-            /* The list item will be inserted in wake time order. */
+            /* The list item value holds the wake time. */
             listSET_LIST_ITEM_VALUE( &( pxCurrentTCB->xStateListItem ), xTimeToWake );
 
             if( xTimeToWake < xConstTickCount )
             {
                 /* Wake time has overflowed.  Place this item in the overflow list. */
-                vListInsert( pxOverflowDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+                taskINSERT_OVERFLOWED_TASK( &( pxCurrentTCB->xStateListItem ) );
             }
             else
             {
                 /* The wake time has not overflowed, so the current block list is used. */
-                vListInsert( pxDelayedTaskList, &( pxCurrentTCB->xStateListItem ) );
+                taskINSERT_DELAYED_TASK( &( pxCurrentTCB->xStateListItem ) );
 
                 /* If the task entering the blocked state was placed at the head of the
                  * list of blocked tasks then xNextTaskUnblockTime needs to be updated
@@ -29,6 +29,9 @@
 #ifndef FREERTOS_CONFIG_H
 #define FREERTOS_CONFIG_H
 
+/* Features that only a demo uses are enabled along with the demo. */
+#include "DemoConfig.h"
+
  /*-----------------------------------------------------------
   * Application specific definitions.
   *
@@ -45,16 +48,56 @@
 #define configUSE_IDLE_HOOK						0
 #define configUSE_TICK_HOOK						0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK		0
-#define configTICK_RATE_HZ						( 1000 ) /* In this non-real time simulated environment the tick frequency has to be at least a multiple of the Win32 tick frequency, and therefore very slow. */
-#define configMINIMAL_STACK_SIZE				( ( unsigned short ) 70 ) /* In this simulated case, the stack only has to hold one small structure as the real stack is part of the win32 thread. */
-#define configTOTAL_HEAP_SIZE					( ( size_t ) ( 52 * 1024 ) )
+#define configTICK_RATE_HZ						( 1000 ) /* The simulated tick is generated from absolute deadlines on a high resolution clock.  Ticks the host is too slow to generate on time are delivered late, in a batch, rather than lost. */
+#define configSIMULATOR_USE_FIBERS				0 /* GCC/Posix port only.  1 runs all the tasks on one host thread, each on its own FreeRTOS allocated stack. */
+#if ( configSIMULATOR_USE_FIBERS == 1 )
+	#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 2048 ) /* The task stack is the real stack, and also has to hold the host signal frame of a simulated interrupt and any host library calls. */
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 1024 * 1024 ) )
+#elif defined( _WIN32 )
+	#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 2048 ) /* Each task runs on its stack, which the port allocates from the stack of the host thread that runs it, so it has to hold any host library calls too. */
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 52 * 1024 ) )
+#else
+	#define configMINIMAL_STACK_SIZE			( ( unsigned short ) 2048 ) /* Each task thread runs on the task stack, so it has to hold any host library calls - printf() to an unbuffered stream alone uses over 8KB.  The stacks are mapped by the port, not taken from the heap. */
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 52 * 1024 ) )
+#endif
+#if ( ENABLE_DEMO_DELAY == 1 )
+	#undef configTOTAL_HEAP_SIZE
+	#define configTOTAL_HEAP_SIZE				( ( size_t ) ( 8 * 1024 * 1024 ) ) /* Demo_Delay1 creates 10000 tasks. */
+#endif
 #define configMAX_TASK_NAME_LEN					( 12 )
 #define configUSE_TRACE_FACILITY				1
 #define configUSE_16_BIT_TICKS					0
 #define configIDLE_SHOULD_YIELD					1
+#define configUSE_DELAYED_TASK_WHEEL			0 /* 1 keeps the delayed tasks in a timing wheel, so blocking with a timeout costs the same however many tasks are delayed.  See note 12 in docs/FreeRTOS_Config_Readme.txt. */
+#define configUSE_EDF_SCHEDULING				ENABLE_DEMO_EDF /* 1 lets tasks created by xTaskCreateWithDeadline() be scheduled by earliest deadline first, at priority configEDF_TASK_PRIORITY.  Only on for Demo_Edf1.  See note 13 in docs/FreeRTOS_Config_Readme.txt. */
+#define configEDF_TASK_PRIORITY					( configMAX_PRIORITIES - 2 )
+#define configUSE_TASK_BUDGETS					ENABLE_DEMO_BUDGET /* 1 lets vTaskSetBudget() limit the processor time of a task in each period.  Needs configGENERATE_RUN_TIME_STATS.  Only on for Demo_Budget1.  See note 15 in docs/FreeRTOS_Config_Readme.txt. */
+#define configUSE_TIME_SLICE_QUANTA				ENABLE_DEMO_TIME_SLICE /* 1 lets vTaskSetTimeSliceTicks() give the tasks of a priority a time slice of several ticks, so equal priority CPU bound tasks switch less often.  Only on for Demo_TimeSlice1, as it changes how tasks of equal priority share the processor.  See note 23 in docs/FreeRTOS_Config_Readme.txt. */
+#define configTIME_SLICE_TICKS					1 /* The time slice of every priority until vTaskSetTimeSliceTicks() changes it.  1 switches every tick, as without time slice quanta. */
+#define configUSE_TASK_POOLS					ENABLE_DEMO_POOL /* 1 lets xTaskCreateFromPool() create tasks in the preallocated slots of a pool made by xTaskPoolCreate().  Only on for Demo_Pool1.  See note 18 in docs/FreeRTOS_Config_Readme.txt. */
+#define configUSE_TICKLESS_IDLE					0 /* 1 stops the simulated tick while all the tasks are blocked, so an idle simulator uses almost no host CPU time. */
+#define configSIMULATOR_VIRTUAL_TIME			0 /* 1 runs the tick from virtual time, which jumps to the next unblock time whenever every task is blocked.  Needs configUSE_TICKLESS_IDLE set to 1. */
+#define configSIMULATOR_RECORD_REPLAY			0 /* GCC/Posix port with fibers only.  1 logs every simulated interrupt and context switch to configSIMULATOR_RECORD_REPLAY_FILE, 2 replays a log with the same interleaving. */
+#define configSIMULATOR_KERNEL_INSTANCES		0 /* GCC/Posix port with fibers only.  1 gives every host thread that starts a scheduler a kernel, heap and tick of its own, see xPortCreateKernelInstance().  Needs configUSE_TRACE_FACILITY set to 0. */
+#define configSIMULATOR_INTERRUPT_LINES			128 /* GCC/Posix port only.  The number of simulated interrupts, see vPortSetInterruptHandler(). */
+#define configKERNEL_INTERRUPT_PRIORITY			15 /* GCC/Posix port only.  The lowest simulated interrupt priority (0 is the highest), used by the yield and tick interrupts. */
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY	5 /* GCC/Posix port only.  Simulated interrupts above this priority (0 to 4) are not masked by critical sections, so must not use the API. */
+#define configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS	1 /* 0 models disabled interrupts with a host mutex instead of a lock that only makes a system call when contended. */
+#define configSIMULATOR_THREAD_POOL_SIZE		8 /* Host threads created up front to run tasks.  Deleted tasks return their thread to the pool. */
+#define configNUMBER_OF_CORES					1 /* Simulated cores that run tasks at the same time, each task on its own host thread.  Not available with fibers or tickless idle. */
+#define configUSE_CORE_AFFINITY					( configNUMBER_OF_CORES > 1 ) /* Lets vTaskCoreAffinitySet() restrict a task to some of the cores. */
 #define configUSE_MUTEXES						1
-#define configCHECK_FOR_STACK_OVERFLOW			0
+#if defined( _WIN32 )
+	#define configCHECK_FOR_STACK_OVERFLOW		2 /* The Windows port lets a task that overflows run on into the rest of its host thread's stack, so the overflow is found by checking the end of the stack when the task is switched out.  See note 10 in docs/FreeRTOS_Config_Readme.txt. */
+#else
+	#define configCHECK_FOR_STACK_OVERFLOW		1 /* The GCC/Posix port also traps an overflow the moment it happens, with a guard region below each stack.  See note 10 in docs/FreeRTOS_Config_Readme.txt. */
+#endif
 #define configUSE_RECURSIVE_MUTEXES				1
+#if ( ENABLE_DEMO_MUTEX == 1 )
+	#define configPRIORITY_INHERITANCE_CHAIN_LENGTH	4 /* Demo_Mutex1 shows a priority lent along a chain of three tasks.  See note 21 in docs/FreeRTOS_Config_Readme.txt. */
+#endif
+#define configUSE_MUTEX_PRIORITY_CEILING		ENABLE_DEMO_MUTEX /* 1 adds xSemaphoreCreateMutexWithCeiling(), for mutexes that raise their holder to a fixed ceiling priority instead of using inheritance.  Only on for Demo_Mutex1.  See note 21 in docs/FreeRTOS_Config_Readme.txt. */
+#define configUSE_MULTI_WAIT					ENABLE_DEMO_MULTI_WAIT /* 1 adds xMultiWaitForObjects(), which blocks a task on several queues, event groups, stream buffers and notifications at once.  Only on for Demo_MultiWait1.  See note 22 in docs/FreeRTOS_Config_Readme.txt. */
 #define configQUEUE_REGISTRY_SIZE				20
 #define configUSE_MALLOC_FAILED_HOOK			1
 #define configUSE_APPLICATION_TASK_TAG			1
@@ -73,12 +116,17 @@
 #define configTIMER_QUEUE_LENGTH				20
 #define configTIMER_TASK_STACK_DEPTH			( configMINIMAL_STACK_SIZE * 2 )
 
-#define configMAX_PRIORITIES					( 7 )
+#if ( ENABLE_DEMO_PRIORITY == 1 )
+	#define configMAX_PRIORITIES				( 256 ) /* Demo_Priority1 measures context switches up to the highest priority the ports support.  See note 14 in docs/FreeRTOS_Config_Readme.txt. */
+#else
+	#define configMAX_PRIORITIES				( 7 )
+#endif
 
 /* Run time stats gathering configuration options. */
-unsigned long ulGetRunTimeCounterValue(void); /* Prototype of function that returns run time counter. */
+#define configRUN_TIME_COUNTER_TYPE				uint64_t /* The counter is in 10us units, so would wrap after less than 12 hours in 32 bits.  See note 16 in docs/FreeRTOS_Config_Readme.txt. */
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void); /* Prototype of function that returns run time counter. */
 void vConfigureTimerForRunTimeStats(void);	/* Prototype of function that initialises the run time counter. */
-#define configGENERATE_RUN_TIME_STATS			0
+#define configGENERATE_RUN_TIME_STATS			( ( ENABLE_DEMO_BUDGET == 1 ) || ( ENABLE_DEMO_MONITOR == 1 ) || ( ENABLE_DEMO_NOTIFY == 1 ) ) /* Only on for Demo_Budget1, as task budgets are charged from the run time counter, for Demo_Monitor1, which serialises the run time stats, and for Demo_Notify1, which counts context switches with them. */
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
 #define portGET_RUN_TIME_COUNTER_VALUE() ulGetRunTimeCounterValue()
 
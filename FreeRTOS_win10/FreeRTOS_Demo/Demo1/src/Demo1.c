@@ -222,6 +222,7 @@ static void prvQueueReceiveTask(void* pvParameters)
 			printf("Unexpected message\r\n");
 		}
 
+#ifdef _WIN32
 		/* Reset the timer if a key has been pressed.  The timer will write
 		mainVALUE_SENT_FROM_TIMER to the queue when it expires. */
 		if (_kbhit() != 0)
@@ -232,6 +233,7 @@ static void prvQueueReceiveTask(void* pvParameters)
 			/* Reset the software timer. */
 			xTimerReset(xTimer, portMAX_DELAY);
 		}
+#endif
 	}
 }
 
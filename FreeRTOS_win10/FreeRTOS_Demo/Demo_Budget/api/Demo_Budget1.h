@@ -0,0 +1,6 @@
+#ifndef __DEMO_BUDGET1_H__
+#define __DEMO_BUDGET1_H__
+
+extern void Demo_Budget1(void);
+
+#endif //__DEMO_BUDGET1_H__
@@ -0,0 +1,182 @@
+#include <include.h>
+
+#if (configUSE_TASK_BUDGETS == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The hog task runs above the background task, and the report task that samples them above both. */
+#define budgetBACKGROUND_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define budgetHOG_TASK_PRIORITY				( tskIDLE_PRIORITY + 2 )
+#define budgetREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/*< The hog task may use 30ms of every 100ms.  The run time counter counts 10us units, see FreeRTOS_Stub/Run-time-stats-utils.c. */
+#define budgetPERIOD						pdMS_TO_TICKS( 100UL )
+#define budgetBUDGET						( ( configRUN_TIME_COUNTER_TYPE ) 3000U )
+
+/*< How often the report task samples the two tasks, and how many budget periods each budget action is shown for. */
+#define budgetSAMPLE_PERIOD					pdMS_TO_TICKS( 20UL )
+#define budgetPERIODS_SHOWN					( 2 )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Runs without ever blocking, so it would starve every task below it if it had no budget.
+ */
+static void prvHogTask(void* pvParameters);
+
+/*
+ * Runs without ever blocking below the hog task, so it only runs while the hog task is held back.
+ */
+static void prvBackgroundTask(void* pvParameters);
+
+/*
+ * Gives the hog task a budget with each budget action in turn, then takes it away, and prints the share of the processor each
+ * task got in every sample period.
+ */
+static void prvReportTask(void* pvParameters);
+
+/*
+ * Samples the two tasks every budgetSAMPLE_PERIOD for budgetPERIODS_SHOWN budget periods, and prints what they did.
+ */
+static void prvSample(void);
+
+static TaskHandle_t xHogTask = NULL;
+static TaskHandle_t xBackgroundTask = NULL;
+
+void Demo_Budget1(void)
+{
+	xTaskCreate(prvHogTask, "Hog", configMINIMAL_STACK_SIZE, NULL, budgetHOG_TASK_PRIORITY, &xHogTask);
+	xTaskCreate(prvBackgroundTask, "Background", configMINIMAL_STACK_SIZE, NULL, budgetBACKGROUND_TASK_PRIORITY, &xBackgroundTask);
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, budgetREPORT_TASK_PRIORITY, NULL);
+}
+
+static void prvHogTask(void* pvParameters)
+{
+	volatile uint32_t ulLoops = 0;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulLoops++;
+	}
+}
+
+static void prvBackgroundTask(void* pvParameters)
+{
+	volatile uint32_t ulLoops = 0;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulLoops++;
+	}
+}
+
+static void prvSample(void)
+{
+	TaskStatus_t xHogStatus, xBackgroundStatus;
+	configRUN_TIME_COUNTER_TYPE ulHogBefore, ulBackgroundBefore, ulTimeBefore, ulTimeNow, ulElapsed;
+	TickType_t xStart = xTaskGetTickCount();
+	int iSample;
+
+	vTaskGetInfo(xHogTask, &xHogStatus, pdFALSE, eInvalid);
+	vTaskGetInfo(xBackgroundTask, &xBackgroundStatus, pdFALSE, eInvalid);
+	ulHogBefore = xHogStatus.ulRunTimeCounter;
+	ulBackgroundBefore = xBackgroundStatus.ulRunTimeCounter;
+	ulTimeBefore = portGET_RUN_TIME_COUNTER_VALUE();
+
+	for (iSample = 1; iSample <= (int)((budgetPERIODS_SHOWN * budgetPERIOD) / budgetSAMPLE_PERIOD); iSample++)
+	{
+		vTaskDelayUntil(&xStart, budgetSAMPLE_PERIOD);
+
+		/*< The report task is running, so the hog task is ready, suspended while its budget is used up, or demoted. */
+		vTaskGetInfo(xHogTask, &xHogStatus, pdFALSE, eInvalid);
+		vTaskGetInfo(xBackgroundTask, &xBackgroundStatus, pdFALSE, eInvalid);
+		ulTimeNow = portGET_RUN_TIME_COUNTER_VALUE();
+		ulElapsed = (ulTimeNow > ulTimeBefore) ? (ulTimeNow - ulTimeBefore) : 1;
+
+		/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+		vTaskSuspendAll();
+		printf("%4lu ms : hog %3lu%%, background %3lu%%, hog %s at priority %lu, %lu overruns\n",
+			(unsigned long)((iSample * budgetSAMPLE_PERIOD * 1000UL) / configTICK_RATE_HZ),
+			(unsigned long)(((xHogStatus.ulRunTimeCounter - ulHogBefore) * 100U) / ulElapsed),
+			(unsigned long)(((xBackgroundStatus.ulRunTimeCounter - ulBackgroundBefore) * 100U) / ulElapsed),
+			(xHogStatus.eCurrentState == eSuspended) ? "suspended" : "ready    ",
+			(unsigned long)xHogStatus.uxCurrentPriority, (unsigned long)xHogStatus.uxBudgetOverruns);
+		xTaskResumeAll();
+
+		ulHogBefore = xHogStatus.ulRunTimeCounter;
+		ulBackgroundBefore = xBackgroundStatus.ulRunTimeCounter;
+		ulTimeBefore = ulTimeNow;
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	vTaskSuspendAll();
+	printf("hog task budget of %lu run time counter units every %lu ticks, suspended when it is used up\n",
+		(unsigned long)budgetBUDGET, (unsigned long)budgetPERIOD);
+	xTaskResumeAll();
+
+	vTaskSetBudget(xHogTask, budgetBUDGET, budgetPERIOD, eBudgetSuspend, 0);
+	prvSample();
+
+	vTaskSuspendAll();
+	printf("hog task budget of %lu run time counter units every %lu ticks, demoted to priority %lu when it is used up\n",
+		(unsigned long)budgetBUDGET, (unsigned long)budgetPERIOD, (unsigned long)budgetBACKGROUND_TASK_PRIORITY);
+	xTaskResumeAll();
+
+	/*< Demoted to the priority of the background task, the two take turns until the budget is replenished. */
+	vTaskSetBudget(xHogTask, budgetBUDGET, budgetPERIOD, eBudgetDemote, budgetBACKGROUND_TASK_PRIORITY);
+	prvSample();
+
+	vTaskSuspendAll();
+	printf("hog task with no budget\n");
+	xTaskResumeAll();
+
+	vTaskSetBudget(xHogTask, 0, 0, eBudgetDemote, 0);
+	prvSample();
+
+	/*< Leave the processor to the idle task. */
+	vTaskDelete(xHogTask);
+	vTaskDelete(xBackgroundTask);
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_TASK_BUDGETS */
+
+void Demo_Budget1(void)
+{
+	printf("Demo_Budget1 needs configUSE_TASK_BUDGETS set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_TASK_BUDGETS */
+
+
+/******************************************************************************************************************************************
+* Task budgets
+*
+* 1. vTaskSetBudget() gives a task a budget of processor time, in units of the run time stats counter, for each period of a number of
+*    ticks.  The time the task runs is charged to the budget, and once it is used up the tick switches the task out.
+* 2. With eBudgetSuspend the task does not run at all until the budget is replenished at the start of its next period, and is reported
+*    as suspended.  With eBudgetDemote it drops to the priority given, and returns to its own priority at the start of the next period.
+*    The budget is replenished in full at every period, and overruns are counted in uxBudgetOverruns.
+*
+* Measurement
+*
+* The hog task never blocks, above the background task, which never blocks either.  The report task samples them every
+* budgetSAMPLE_PERIOD for two budget periods, and prints the share of the run time counter each got over the sample, and the state
+* and priority of the hog task.  With a budget the hog task runs for the first 30ms of each period and the background task gets the
+* rest, or with eBudgetDemote shares the rest with the demoted hog task.  With no budget the background task gets nothing.
+*
+* FreeRTOSConfig.h sets configUSE_TASK_BUDGETS and configGENERATE_RUN_TIME_STATS to 1 when ENABLE_DEMO_BUDGET is 1.  The budget is
+* only as fine as the tick, and with a host thread per task the host can take a few percent of each sample.  The demo runs once.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_DELAY1_H__
+#define __DEMO_DELAY1_H__
+
+extern void Demo_Delay1(void);
+
+#endif //__DEMO_DELAY1_H__
@@ -0,0 +1,198 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The report task runs above the delayed tasks, and the probe task that it wakes above both. */
+#define delayDELAYED_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define delayREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define delayPROBE_TASK_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/*< The numbers of delayed tasks measured, see uxTaskCounts[], the largest of which is delayMAX_DELAYED_TASKS. */
+#define delayNUMBER_OF_STEPS				( 4 )
+#define delayMAX_DELAYED_TASKS				( 10000 )
+
+/*< Each delayed task delays for its own time of delayDELAY_BASE to delayDELAY_BASE + delayDELAY_SPREAD ticks, so the wake times
+ * are spread over the ticks, and none of them wakes while it is being measured. */
+#define delayDELAY_BASE						pdMS_TO_TICKS( 600000UL )
+#define delayDELAY_SPREAD					( 1000UL )
+
+/*< The probe task delays for a time in the middle of those of the delayed tasks, so it is placed among them. */
+#define delayPROBE_DELAY					( delayDELAY_BASE + ( delayDELAY_SPREAD / 2UL ) )
+
+/*< How long each number of delayed tasks is measured. */
+#define delayMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Calls vTaskDelay() for its own number of ticks, over and over.
+ */
+static void prvDelayedTask(void* pvParameters);
+
+/*
+ * Calls vTaskDelay() for delayPROBE_DELAY ticks, over and over, and counts how often it was woken.
+ */
+static void prvProbeTask(void* pvParameters);
+
+/*
+ * Creates the delayed tasks for each count in uxTaskCounts[] in turn, and reports what one delay of the probe task costs with
+ * that many tasks delayed.  The measurement is made once, then the tasks of the demo are deleted.
+ */
+static void prvReportTask(void* pvParameters);
+
+/*
+ * Wakes the probe task with xTaskAbortDelay() for delayMEASUREMENT_PERIOD, each wake letting it run and delay again, and returns
+ * the average time of one delay and wake in nanoseconds.
+ */
+static uint32_t prvMeasure(void);
+
+static TaskHandle_t xDelayedTasks[ delayMAX_DELAYED_TASKS ];
+static TaskHandle_t xProbeTask = NULL;
+static UBaseType_t uxDelayedTasksCreated = 0;
+static volatile uint32_t ulProbeDelays = 0;
+
+static const UBaseType_t uxTaskCounts[ delayNUMBER_OF_STEPS ] = { 10, 100, 1000, delayMAX_DELAYED_TASKS };
+
+void Demo_Delay1(void)
+{
+	xTaskCreate(prvProbeTask, "Probe", configMINIMAL_STACK_SIZE, NULL, delayPROBE_TASK_PRIORITY, &xProbeTask);
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, delayREPORT_TASK_PRIORITY, NULL);
+}
+
+static void prvDelayedTask(void* pvParameters)
+{
+	UBaseType_t uxTask = (UBaseType_t)(uintptr_t)pvParameters;
+	const TickType_t xDelay = (TickType_t)(delayDELAY_BASE + (((uint32_t)uxTask * 7919UL) % delayDELAY_SPREAD));
+
+	for (;;)
+	{
+		vTaskDelay(xDelay);
+	}
+}
+
+static void prvProbeTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;)
+	{
+		vTaskDelay((TickType_t)delayPROBE_DELAY);
+		ulProbeDelays++;
+	}
+}
+
+static uint32_t prvMeasure(void)
+{
+	TickType_t xStart, xElapsed;
+	uint32_t ulDelays;
+
+	ulProbeDelays = 0;
+	xStart = xTaskGetTickCount();
+
+	/*< The probe task has the higher priority, so it runs as soon as it is woken, and has delayed again when this returns. */
+	while ((xTaskGetTickCount() - xStart) < delayMEASUREMENT_PERIOD)
+	{
+		xTaskAbortDelay(xProbeTask);
+	}
+
+	ulDelays = ulProbeDelays;
+	xElapsed = xTaskGetTickCount() - xStart;
+
+	return (uint32_t)(((uint64_t)xElapsed * (1000000000ULL / configTICK_RATE_HZ)) / ((ulDelays > 0) ? ulDelays : 1));
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	uint32_t ulBaseNanoseconds, ulNanoseconds;
+	int iStep;
+
+	(void)pvParameters;
+
+	/*< With no delayed tasks one delay and wake costs the two context switches and the list operations alone. */
+	ulBaseNanoseconds = prvMeasure();
+
+	vTaskSuspendAll();
+	printf("delayed tasks kept in %s, %lu ns per delay and wake with none\n",
+		(configUSE_DELAYED_TASK_WHEEL == 1) ? "a timing wheel" : "sorted lists", (unsigned long)ulBaseNanoseconds);
+	xTaskResumeAll();
+
+	for (iStep = 0; iStep < delayNUMBER_OF_STEPS; iStep++)
+	{
+		while (uxDelayedTasksCreated < uxTaskCounts[iStep])
+		{
+			if (xTaskCreate(prvDelayedTask, "Delayed", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)uxDelayedTasksCreated,
+				delayDELAYED_TASK_PRIORITY, &(xDelayedTasks[uxDelayedTasksCreated])) != pdPASS)
+			{
+				break;
+			}
+
+			uxDelayedTasksCreated++;
+		}
+
+		if (uxDelayedTasksCreated < uxTaskCounts[iStep])
+		{
+			vTaskSuspendAll();
+			printf("%5lu delayed tasks : could only create %lu, configTOTAL_HEAP_SIZE is too small\n",
+				(unsigned long)uxTaskCounts[iStep], (unsigned long)uxDelayedTasksCreated);
+			xTaskResumeAll();
+			break;
+		}
+
+		/*< Let every new task run and delay, which they do in the order they were created while the report task is blocked. */
+		while (eTaskGetState(xDelayedTasks[uxDelayedTasksCreated - 1]) != eBlocked)
+		{
+			vTaskDelay(1);
+		}
+
+		ulNanoseconds = prvMeasure();
+
+		/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+		vTaskSuspendAll();
+		printf("%5lu delayed tasks : %7lu ns per delay and wake, %7ld ns more than with none\n",
+			(unsigned long)uxDelayedTasksCreated, (unsigned long)ulNanoseconds, (long)ulNanoseconds - (long)ulBaseNanoseconds);
+		xTaskResumeAll();
+	}
+
+	/*< The measurement is only made once, as the host threads of the tasks it created would stay behind in the next one. */
+	while (uxDelayedTasksCreated > 0)
+	{
+		uxDelayedTasksCreated--;
+		vTaskDelete(xDelayedTasks[uxDelayedTasksCreated]);
+	}
+
+	vTaskDelete(xProbeTask);
+	vTaskDelete(NULL);
+}
+
+
+/******************************************************************************************************************************************
+* Delayed task scaling
+*
+* 1. vTaskDelay(), and every API call that blocks with a timeout, places the calling task on the delayed task list, and the tick
+*    takes it off again when its time is up.  With configUSE_DELAYED_TASK_WHEEL set to 0 the list is kept sorted by wake time, so
+*    placing a task walks past every task that wakes before it, and the cost grows with the number of delayed tasks.
+* 2. With configUSE_DELAYED_TASK_WHEEL set to 1 the delayed tasks are kept in a timing wheel.  A task is placed in the slot of its
+*    wake time in constant time, and the tick only touches the tasks that wake at it, so the cost stays the same however many tasks
+*    are delayed.
+*
+* Measurement
+*
+* For each count in uxTaskCounts[] the report task creates that many delayed tasks, each delaying for its own time of around ten
+* minutes, so they stay delayed while they are measured.  The report task then wakes the probe task with xTaskAbortDelay() over and
+* over for delayMEASUREMENT_PERIOD.  Each time the probe task runs, delays again for a time in the middle of those of the delayed
+* tasks, and the report task runs again, so the time of one round is the time of one delay and wake, averaged over many thousands of
+* them.  The first line is the time with no delayed tasks, and each count prints how much more one delay and wake costs with that
+* many tasks delayed.  With the sorted lists that grows with the count, as the probe task walks past half of the delayed tasks each
+* time it delays; with the wheel it stays at the time with none.
+*
+* Build once with configUSE_DELAYED_TASK_WHEEL set to 0 and once with it set to 1 to compare the two.  The 10000 tasks need a
+* configTOTAL_HEAP_SIZE of several megabytes, which FreeRTOSConfig.h gives when ENABLE_DEMO_DELAY is 1.  Unless
+* configSIMULATOR_USE_FIBERS is 1 (Linux only) every task has a host thread of its own, and each round is two switches between host
+* threads, which are most of the time with none.  A difference of a few percent of that from one count to the next is noise, and
+* with 10000 tasks the host scheduler pays for the thousands of parked host threads whichever way the tasks are kept.  With
+* configSIMULATOR_USE_FIBERS set to 1 the switches are cheap and only the kernel's own difference is left.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_EDF1_H__
+#define __DEMO_EDF1_H__
+
+extern void Demo_Edf1(void);
+
+#endif //__DEMO_EDF1_H__
@@ -0,0 +1,230 @@
+#include <include.h>
+
+#if (configUSE_EDF_SCHEDULING == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The long task does 45 ticks of work every 100 ticks, each job due within 60 ticks of its release. */
+#define edfLONG_PERIOD						pdMS_TO_TICKS( 100UL )
+#define edfLONG_DEADLINE					pdMS_TO_TICKS( 60UL )
+#define edfLONG_WORK						pdMS_TO_TICKS( 45UL )
+
+/*< The short task does 5 ticks of work every 25 ticks, each job due by the release of the next. */
+#define edfSHORT_PERIOD						pdMS_TO_TICKS( 25UL )
+#define edfSHORT_DEADLINE					pdMS_TO_TICKS( 25UL )
+#define edfSHORT_WORK						pdMS_TO_TICKS( 5UL )
+
+/*< How many jobs of the long task are recorded, and as many jobs of the short task as are released in the same time. */
+#define edfLONG_JOBS						( 2 )
+#define edfSHORT_JOBS						( ( edfLONG_JOBS * edfLONG_PERIOD ) / edfSHORT_PERIOD )
+
+/*< The report task runs below the deadline ordered tasks, so it only prints once they have recorded their jobs. */
+#define edfREPORT_TASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Does edfLONG_WORK ticks of work in each job, and records when each job started and finished.
+ */
+static void prvLongTask(void* pvParameters);
+
+/*
+ * Does edfSHORT_WORK ticks of work in each job, and records when each job started and finished, and whether a job of the long task
+ * had started and not finished when it started.
+ */
+static void prvShortTask(void* pvParameters);
+
+/*
+ * Waits for the jobs to be recorded, prints them in the order they were released, then deletes the tasks of the demo.
+ */
+static void prvReportTask(void* pvParameters);
+
+/*
+ * Runs without blocking until the calling task has been running for xTicks ticks, not counting the ticks it was preempted for.
+ * uxWorker is the task's own number, which tells it whether the other task ran in between.
+ */
+static void prvWork(TickType_t xTicks, UBaseType_t uxWorker);
+
+static TaskHandle_t xLongTask = NULL;
+static TaskHandle_t xShortTask = NULL;
+
+/*< Both tasks release their first job when they are created, at xFirstRelease. */
+static TickType_t xFirstRelease = 0;
+
+static volatile TickType_t xLongStart[ edfLONG_JOBS ], xLongEnd[ edfLONG_JOBS ];
+static volatile TickType_t xShortStart[ edfSHORT_JOBS ], xShortEnd[ edfSHORT_JOBS ];
+static volatile BaseType_t xShortPreempted[ edfSHORT_JOBS ];
+static volatile BaseType_t xLongJobRunning = pdFALSE;
+static volatile UBaseType_t uxLastWorker = 0;
+
+void Demo_Edf1(void)
+{
+	xFirstRelease = xTaskGetTickCount();
+
+	xTaskCreateWithDeadline(prvLongTask, "Long", configMINIMAL_STACK_SIZE, NULL, edfLONG_DEADLINE, edfLONG_PERIOD, &xLongTask);
+	xTaskCreateWithDeadline(prvShortTask, "Short", configMINIMAL_STACK_SIZE, NULL, edfSHORT_DEADLINE, edfSHORT_PERIOD, &xShortTask);
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, edfREPORT_TASK_PRIORITY, NULL);
+}
+
+static void prvWork(TickType_t xTicks, UBaseType_t uxWorker)
+{
+	TickType_t xLast = xTaskGetTickCount(), xNow, xStep;
+
+	uxLastWorker = uxWorker;
+
+	while (xTicks > 0)
+	{
+		xNow = xTaskGetTickCount();
+
+		/*< The ticks since the other task ran were its own, so counting starts again from now.  Otherwise the host can deliver
+		   several ticks at once, so they are counted as they pass rather than one by one. */
+		if (uxLastWorker != uxWorker)
+		{
+			uxLastWorker = uxWorker;
+			xLast = xTaskGetTickCount();
+		}
+		else
+		{
+			xStep = xNow - xLast;
+			xTicks -= (xStep < xTicks) ? xStep : xTicks;
+			xLast = xNow;
+		}
+	}
+}
+
+static void prvLongTask(void* pvParameters)
+{
+	int iJob;
+
+	(void)pvParameters;
+
+	for (iJob = 0;; iJob++)
+	{
+		if (iJob < edfLONG_JOBS)
+		{
+			xLongStart[iJob] = xTaskGetTickCount();
+		}
+
+		xLongJobRunning = pdTRUE;
+		prvWork(edfLONG_WORK, 1);
+		xLongJobRunning = pdFALSE;
+
+		if (iJob < edfLONG_JOBS)
+		{
+			xLongEnd[iJob] = xTaskGetTickCount();
+		}
+
+		vTaskWaitForNextPeriod();
+	}
+}
+
+static void prvShortTask(void* pvParameters)
+{
+	int iJob;
+
+	(void)pvParameters;
+
+	for (iJob = 0;; iJob++)
+	{
+		/*< Running while a long job is unfinished means the short job was given the processor ahead of it. */
+		if (iJob < edfSHORT_JOBS)
+		{
+			xShortStart[iJob] = xTaskGetTickCount();
+			xShortPreempted[iJob] = xLongJobRunning;
+		}
+
+		prvWork(edfSHORT_WORK, 2);
+
+		if (iJob < edfSHORT_JOBS)
+		{
+			xShortEnd[iJob] = xTaskGetTickCount();
+		}
+
+		vTaskWaitForNextPeriod();
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	TaskStatus_t xLongStatus, xShortStatus;
+	int iLongJob = 0, iShortJob = 0;
+	TickType_t xRelease;
+
+	(void)pvParameters;
+
+	vTaskDelay((edfLONG_JOBS * edfLONG_PERIOD) + edfLONG_DEADLINE);
+
+	vTaskGetInfo(xLongTask, &xLongStatus, pdFALSE, eInvalid);
+	vTaskGetInfo(xShortTask, &xShortStatus, pdFALSE, eInvalid);
+	vTaskDelete(xLongTask);
+	vTaskDelete(xShortTask);
+
+	/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing.  The jobs are
+	   printed in the order they were released, a long job before a short one released at the same tick. */
+	vTaskSuspendAll();
+
+	while ((iLongJob < edfLONG_JOBS) || (iShortJob < edfSHORT_JOBS))
+	{
+		if ((iLongJob < edfLONG_JOBS) && ((iShortJob >= edfSHORT_JOBS) ||
+			((TickType_t)(iLongJob * edfLONG_PERIOD) <= (TickType_t)(iShortJob * edfSHORT_PERIOD))))
+		{
+			xRelease = (TickType_t)(iLongJob * edfLONG_PERIOD);
+			printf("long  job released at %3lu, deadline %3lu : ran from %3lu to %3lu\n", (unsigned long)xRelease,
+				(unsigned long)(xRelease + edfLONG_DEADLINE), (unsigned long)(xLongStart[iLongJob] - xFirstRelease),
+				(unsigned long)(xLongEnd[iLongJob] - xFirstRelease));
+			iLongJob++;
+		}
+		else
+		{
+			xRelease = (TickType_t)(iShortJob * edfSHORT_PERIOD);
+			printf("short job released at %3lu, deadline %3lu : ran from %3lu to %3lu%s\n", (unsigned long)xRelease,
+				(unsigned long)(xRelease + edfSHORT_DEADLINE), (unsigned long)(xShortStart[iShortJob] - xFirstRelease),
+				(unsigned long)(xShortEnd[iShortJob] - xFirstRelease),
+				(xShortPreempted[iShortJob] != pdFALSE) ? ", preempting the long job" : "");
+			iShortJob++;
+		}
+	}
+
+	printf("deadline misses : long %lu, short %lu\n", (unsigned long)xLongStatus.uxDeadlineMisses,
+		(unsigned long)xShortStatus.uxDeadlineMisses);
+
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_EDF_SCHEDULING */
+
+void Demo_Edf1(void)
+{
+	printf("Demo_Edf1 needs configUSE_EDF_SCHEDULING set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_EDF_SCHEDULING */
+
+
+/******************************************************************************************************************************************
+* Earliest deadline first
+*
+* 1. A task created by xTaskCreateWithDeadline() runs at priority configEDF_TASK_PRIORITY, and releases a job every period, which has
+*    to finish within the task's relative deadline of its release.  The task finishes a job by calling vTaskWaitForNextPeriod(),
+*    which blocks it until its next job is released.
+* 2. Among the ready tasks of that priority the one whose job has the earliest absolute deadline runs.  A task that wakes with a job
+*    due before the job of the running task preempts it at once, and one whose job is due later waits for the running job to finish,
+*    whichever task has the shorter period.
+*
+* Timeline
+*
+* The long task does 45 ticks of work every 100 ticks, due 60 ticks after its release, and the short task 5 ticks every 25, due by
+* its next release.  At 0 the short job is due first, so it runs first.  At 25 the short job is due at 50, before the long job at
+* 60, so it preempts the long job.  At 50 the short job is due at 75, after the long job, so it waits for the long job to finish
+* at 55 and still meets its own deadline.  The report task prints when every job recorded in the first two periods of the long task
+* ran, and the deadline misses of both tasks, of which there should be none.
+*
+* FreeRTOSConfig.h sets configUSE_EDF_SCHEDULING to 1 when ENABLE_DEMO_EDF is 1.  A job can be recorded a tick later than the ideal
+* timeline when the host is slow to deliver a tick.  The demo runs once.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_JOBS1_H__
+#define __DEMO_JOBS1_H__
+
+extern void Demo_Jobs1(void);
+
+#endif //__DEMO_JOBS1_H__
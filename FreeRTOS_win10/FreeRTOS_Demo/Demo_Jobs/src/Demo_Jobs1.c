@@ -0,0 +1,198 @@
+#include <include.h>
+#include <jobs.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The workers of both patterns run at the same priority, below the task that hands out the work and measures it. */
+#define jobsWORKER_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define jobsREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
+
+/*< One worker per simulated core for both patterns. */
+#define jobsNUMBER_OF_WORKERS				( configNUMBER_OF_CORES )
+
+/*< The number of jobs in a batch, which is also the length of the queue and of each deque, so no job has to wait for space. */
+#define jobsJOBS_PER_BATCH					( 256 )
+
+/*< The number of loops of one job, kept small so the cost of handing out the jobs shows, and how long each pattern is measured. */
+#define jobsWORK_UNIT_LOOPS					( 200UL )
+#define jobsMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * One job, which only uses the stack of the calling task.
+ */
+static void prvWorkUnit(void* pvParameters);
+
+/*
+ * A worker of the queue pattern: receives a job from the queue, runs it and counts it.
+ */
+static void prvQueueWorkerTask(void* pvParameters);
+
+/*
+ * The root job of a batch, which submits the rest of the batch as its children.
+ */
+static void prvRootJob(void* pvParameters);
+
+/*
+ * Runs batches with each pattern in turn for jobsMEASUREMENT_PERIOD and reports how many jobs a second each got through.
+ */
+static void prvReportTask(void* pvParameters);
+
+/*< The queue pattern: a queue of jobs, the count of jobs done, and the task to notify when a whole batch is done. */
+static QueueHandle_t xJobQueue = NULL;
+static volatile uint32_t ulQueueJobsDone = 0;
+static TaskHandle_t xReportTask = NULL;
+
+/*< The job system, and the jobs of a batch. */
+static JobSystemHandle_t xJobSystem = NULL;
+static Job_t xRootJob;
+static Job_t xJobs[ jobsJOBS_PER_BATCH ];
+
+void Demo_Jobs1(void)
+{
+	int i;
+
+	xJobQueue = xQueueCreate(jobsJOBS_PER_BATCH, sizeof(Job_t*));
+	configASSERT(xJobQueue);
+
+	for (i = 0; i < jobsNUMBER_OF_WORKERS; i++)
+	{
+		xTaskCreate(prvQueueWorkerTask, "QWorker", configMINIMAL_STACK_SIZE, NULL, jobsWORKER_TASK_PRIORITY, NULL);
+	}
+
+	xJobSystem = xJobSystemCreate(jobsNUMBER_OF_WORKERS, jobsJOBS_PER_BATCH, configMINIMAL_STACK_SIZE, jobsWORKER_TASK_PRIORITY);
+	configASSERT(xJobSystem);
+
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, jobsREPORT_TASK_PRIORITY, &xReportTask);
+}
+
+static void prvWorkUnit(void* pvParameters)
+{
+	volatile uint32_t ulValue = (uint32_t)(uintptr_t)pvParameters;
+	uint32_t i;
+
+	for (i = 0; i < jobsWORK_UNIT_LOOPS; i++)
+	{
+		ulValue = (ulValue * 1103515245UL) + 12345UL;
+	}
+}
+
+static void prvQueueWorkerTask(void* pvParameters)
+{
+	Job_t* pxJob;
+	uint32_t ulDone;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		if (xQueueReceive(xJobQueue, &pxJob, portMAX_DELAY) == pdPASS)
+		{
+			pxJob->pxJobCode(pxJob->pvParameter);
+
+			taskENTER_CRITICAL();
+			ulDone = ++ulQueueJobsDone;
+			taskEXIT_CRITICAL();
+
+			if (ulDone == jobsJOBS_PER_BATCH)
+			{
+				xTaskNotifyGive(xReportTask);
+			}
+		}
+	}
+}
+
+static void prvRootJob(void* pvParameters)
+{
+	int i;
+
+	(void)pvParameters;
+
+	/*< The root job is one of the batch, so it submits the other jobs, which go on the deque of the worker running it. */
+	for (i = 1; i < jobsJOBS_PER_BATCH; i++)
+	{
+		vJobInit(&(xJobs[i]), prvWorkUnit, (void*)(uintptr_t)i, &xRootJob);
+		vJobSubmit(xJobSystem, &(xJobs[i]));
+	}
+
+	prvWorkUnit(NULL);
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	uint32_t ulBatches;
+	TickType_t xStart, xElapsed;
+	Job_t* pxJob;
+	int i, iPattern;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		for (iPattern = 0; iPattern < 2; iPattern++)
+		{
+			ulBatches = 0;
+			xStart = xTaskGetTickCount();
+
+			do
+			{
+				if (iPattern == 0)
+				{
+					/*< One queue send per job, and the workers count the jobs they have done. */
+					ulQueueJobsDone = 0;
+
+					for (i = 0; i < jobsJOBS_PER_BATCH; i++)
+					{
+						vJobInit(&(xJobs[i]), prvWorkUnit, (void*)(uintptr_t)i, NULL);
+						pxJob = &(xJobs[i]);
+						xQueueSend(xJobQueue, &pxJob, portMAX_DELAY);
+					}
+
+					ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+				}
+				else
+				{
+					/*< One root job, whose children are spread over the workers by stealing. */
+					vJobInit(&xRootJob, prvRootJob, NULL, NULL);
+					vJobSubmit(xJobSystem, &xRootJob);
+					vJobWait(xJobSystem, &xRootJob);
+				}
+
+				ulBatches++;
+				xElapsed = xTaskGetTickCount() - xStart;
+			} while (xElapsed < jobsMEASUREMENT_PERIOD);
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			printf("%-12s : %9lu jobs per second on %d core(s)\n", (iPattern == 0) ? "queue" : "job system",
+				(unsigned long)(((uint64_t)ulBatches * jobsJOBS_PER_BATCH * configTICK_RATE_HZ) / ((xElapsed > 0) ? xElapsed : 1)),
+				(int)configNUMBER_OF_CORES);
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Job system
+*
+* 1. A job system (jobs.h) runs small jobs on a fixed set of worker tasks.  Each worker has its own deque of jobs.  A job submitted by a
+*    job goes on the deque of the worker running it, and a worker that runs out of jobs steals the oldest job of another worker.
+* 2. A job can be the child of another job, which then only finishes once all its children have finished.  vJobWait() runs other jobs
+*    while the job being waited for has not finished, and only blocks on a task notification when there are none to run.
+* 3. A worker only gets a notification when it has run out of jobs, so a busy system hands out jobs without any context switch.  With a
+*    single core there is one worker, which runs the jobs one after the other.
+*
+* Patterns
+*
+* 1. queue       : each job is sent to a queue that all the workers receive from, and the worker that finishes the last job of a batch
+*                  notifies the report task.  Every job costs a queue send and a queue receive, and often a context switch.
+* 2. job system  : a root job submits the rest of the batch as its children, and the report task waits for the root job.
+*
+* Each pattern runs batches of jobsJOBS_PER_BATCH jobs for jobsMEASUREMENT_PERIOD, then the report task prints the jobs done per second.
+******************************************************************************************************************************************/
@@ -16,6 +16,66 @@ void RunFreeRTOS_Demo(void)
 	Demo_Timer1();
 #endif
 
+#if (ENABLE_DEMO_YIELD == 1)
+	Demo_Yield1();
+#endif
+
+#if (ENABLE_DEMO_QUEUE == 1)
+	Demo_Queue3();
+#endif
+
+#if (ENABLE_DEMO_TASK_CREATE == 1)
+	Demo_Task3();
+#endif
+
+#if (ENABLE_DEMO_SMP == 1)
+	Demo_Smp1();
+#endif
+
+#if (ENABLE_DEMO_JOBS == 1)
+	Demo_Jobs1();
+#endif
+
+#if (ENABLE_DEMO_TIME_SLICE == 1)
+	Demo_TimeSlice1();
+#endif
+
+#if (ENABLE_DEMO_DELAY == 1)
+	Demo_Delay1();
+#endif
+
+#if (ENABLE_DEMO_PRIORITY == 1)
+	Demo_Priority1();
+#endif
+
+#if (ENABLE_DEMO_MUTEX == 1)
+	Demo_Mutex1();
+#endif
+
+#if (ENABLE_DEMO_BUDGET == 1)
+	Demo_Budget1();
+#endif
+
+#if (ENABLE_DEMO_EDF == 1)
+	Demo_Edf1();
+#endif
+
+#if (ENABLE_DEMO_MONITOR == 1)
+	Demo_Monitor1();
+#endif
+
+#if (ENABLE_DEMO_POOL == 1)
+	Demo_Pool1();
+#endif
+
+#if (ENABLE_DEMO_NOTIFY == 1)
+	Demo_Notify1();
+#endif
+
+#if (ENABLE_DEMO_MULTI_WAIT == 1)
+	Demo_MultiWait1();
+#endif
+
 	/*< Start the scheduler */
 	vTaskStartScheduler();
 
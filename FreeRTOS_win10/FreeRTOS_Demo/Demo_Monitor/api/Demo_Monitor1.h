@@ -0,0 +1,6 @@
+#ifndef __DEMO_MONITOR1_H__
+#define __DEMO_MONITOR1_H__
+
+extern void Demo_Monitor1(void);
+
+#endif //__DEMO_MONITOR1_H__
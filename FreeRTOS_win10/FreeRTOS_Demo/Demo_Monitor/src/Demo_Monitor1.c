@@ -0,0 +1,279 @@
+#include <include.h>
+
+#if (configUSE_TRACE_FACILITY == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The monitor task runs above the workers it reports on. */
+#define monitorWORKER_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define monitorMONITOR_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+/*< The number of worker tasks, and how long they run before the monitor task reports on them. */
+#define monitorNUMBER_OF_WORKERS			( 5 )
+#define monitorSETTLE_TIME					pdMS_TO_TICKS( 1000UL )
+
+/*< The tasks are read a few at a time, and serialised into a buffer only just long enough for the longest record, so each call of
+   xTaskSerialiseNextTaskStates() only fits a few tasks. */
+#define monitorTASKS_PER_READ				( 3 )
+#define monitorBUFFER_LENGTH				tskSERIALISED_TASK_STATUS_MAX_LENGTH
+
+/*< Big enough for the text vTaskList() writes for every task of the demo. */
+#define monitorLIST_BUFFER_LENGTH			( 1024 )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Does a little work, then delays for a time of its own, over and over, so each worker has its own run time and number of wakes.
+ */
+static void prvWorkerTask(void* pvParameters);
+
+/*
+ * Checks that every task read with uxTaskGetNextTaskStates() reads back the same from its serialised form, then lists the tasks
+ * from the serialised form written by xTaskSerialiseNextTaskStates(), a buffer at a time.
+ */
+static void prvMonitorTask(void* pvParameters);
+
+/*
+ * Reads a number written 7 bits at a time, least significant first, with the top bit set in every byte but the last.
+ */
+static const uint8_t* prvReadNumber(const uint8_t* pucNext, uint64_t* pullValue);
+
+/*
+ * Reads the record of one task, as written by xTaskSerialiseTaskStatus(), into pxStatus, and its name into pcName, which is
+ * configMAX_TASK_NAME_LEN + 1 characters long.  Returns a pointer to the byte after the record.
+ */
+static const uint8_t* prvReadTaskStatus(const uint8_t* pucNext, TaskStatus_t* pxStatus, char* pcName);
+
+/*
+ * Returns pdTRUE if every field of the serialised form is the same in the two structures.
+ */
+static BaseType_t prvSameTaskStatus(const TaskStatus_t* pxWritten, const TaskStatus_t* pxRead);
+
+static char cListBuffer[ monitorLIST_BUFFER_LENGTH ];
+
+void Demo_Monitor1(void)
+{
+	UBaseType_t uxWorker;
+
+	for (uxWorker = 0; uxWorker < monitorNUMBER_OF_WORKERS; uxWorker++)
+	{
+		xTaskCreate(prvWorkerTask, "Worker", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)uxWorker, monitorWORKER_TASK_PRIORITY, NULL);
+	}
+
+	xTaskCreate(prvMonitorTask, "Monitor", configMINIMAL_STACK_SIZE * 2, NULL, monitorMONITOR_TASK_PRIORITY, NULL);
+}
+
+static void prvWorkerTask(void* pvParameters)
+{
+	UBaseType_t uxWorker = (UBaseType_t)(uintptr_t)pvParameters;
+	volatile uint32_t ulWork;
+
+	for (;;)
+	{
+		for (ulWork = 0; ulWork < (10000UL * (uxWorker + 1)); ulWork++)
+		{
+		}
+
+		vTaskDelay((TickType_t)(uxWorker + 1));
+	}
+}
+
+static const uint8_t* prvReadNumber(const uint8_t* pucNext, uint64_t* pullValue)
+{
+	uint64_t ullValue = 0;
+	unsigned uShift = 0;
+
+	do
+	{
+		ullValue |= ((uint64_t)(*pucNext & 0x7FU)) << uShift;
+		uShift += 7;
+		pucNext++;
+	} while ((pucNext[-1] & 0x80U) != 0);
+
+	*pullValue = ullValue;
+
+	return pucNext;
+}
+
+static const uint8_t* prvReadTaskStatus(const uint8_t* pucNext, TaskStatus_t* pxStatus, char* pcName)
+{
+	uint64_t ullValue;
+	size_t xNameLength;
+
+	memset(pxStatus, 0, sizeof(TaskStatus_t));
+
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->xTaskNumber = (UBaseType_t)ullValue;
+	pxStatus->eCurrentState = (eTaskState)*pucNext;
+	pucNext++;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->uxCurrentPriority = (UBaseType_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->uxBasePriority = (UBaseType_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->usStackHighWaterMark = (configSTACK_DEPTH_TYPE)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulRunTimeCounter = (configRUN_TIME_COUNTER_TYPE)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulSwitchesIn = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulPreemptions = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulWakeups = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulMinWakeLatency = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulAvgWakeLatency = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->ulMaxWakeLatency = (uint32_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->uxDeadlineMisses = (UBaseType_t)ullValue;
+	pucNext = prvReadNumber(pucNext, &ullValue);
+	pxStatus->uxBudgetOverruns = (UBaseType_t)ullValue;
+
+	xNameLength = *pucNext;
+	pucNext++;
+	memcpy(pcName, pucNext, xNameLength);
+	pcName[xNameLength] = '\0';
+	pxStatus->pcTaskName = pcName;
+
+	return pucNext + xNameLength;
+}
+
+static BaseType_t prvSameTaskStatus(const TaskStatus_t* pxWritten, const TaskStatus_t* pxRead)
+{
+	return ((pxWritten->xTaskNumber == pxRead->xTaskNumber) &&
+		(pxWritten->eCurrentState == pxRead->eCurrentState) &&
+		(pxWritten->uxCurrentPriority == pxRead->uxCurrentPriority) &&
+		(pxWritten->uxBasePriority == pxRead->uxBasePriority) &&
+		(pxWritten->usStackHighWaterMark == pxRead->usStackHighWaterMark) &&
+		(pxWritten->ulRunTimeCounter == pxRead->ulRunTimeCounter) &&
+		(pxWritten->ulSwitchesIn == pxRead->ulSwitchesIn) &&
+		(pxWritten->ulPreemptions == pxRead->ulPreemptions) &&
+		(pxWritten->ulWakeups == pxRead->ulWakeups) &&
+		(pxWritten->ulMinWakeLatency == pxRead->ulMinWakeLatency) &&
+		(pxWritten->ulAvgWakeLatency == pxRead->ulAvgWakeLatency) &&
+		(pxWritten->ulMaxWakeLatency == pxRead->ulMaxWakeLatency) &&
+		(pxWritten->uxDeadlineMisses == pxRead->uxDeadlineMisses) &&
+		(pxWritten->uxBudgetOverruns == pxRead->uxBudgetOverruns) &&
+		(strncmp(pxWritten->pcTaskName, pxRead->pcTaskName, configMAX_TASK_NAME_LEN) == 0)) ? pdTRUE : pdFALSE;
+}
+
+static void prvMonitorTask(void* pvParameters)
+{
+	static const char cStates[] = { 'X', 'R', 'B', 'S', 'D', '?' };
+	TaskStateCursor_t xCursor;
+	TaskStatus_t xWritten[ monitorTASKS_PER_READ ], xRead;
+	uint8_t ucBuffer[ monitorBUFFER_LENGTH ];
+	char cName[ configMAX_TASK_NAME_LEN + 1 ];
+	const uint8_t* pucNext;
+	size_t xLength, xTotalLength = 0;
+	UBaseType_t uxCount, uxTask, uxTasks = 0, uxMismatches = 0, uxReads = 0;
+	TaskHandle_t xLateTask = NULL;
+
+	(void)pvParameters;
+
+	vTaskDelay(monitorSETTLE_TIME);
+
+	/*< Round trip: each task read a few at a time is serialised on its own and read back. */
+	vTaskInitStateCursor(&xCursor);
+
+	while ((uxCount = uxTaskGetNextTaskStates(&xCursor, xWritten, monitorTASKS_PER_READ, pdTRUE)) > 0)
+	{
+		for (uxTask = 0; uxTask < uxCount; uxTask++)
+		{
+			xLength = xTaskSerialiseTaskStatus(&(xWritten[uxTask]), ucBuffer, sizeof(ucBuffer));
+			pucNext = prvReadTaskStatus(ucBuffer, &xRead, cName);
+
+			if ((prvSameTaskStatus(&(xWritten[uxTask]), &xRead) == pdFALSE) || ((size_t)(pucNext - ucBuffer) != xLength))
+			{
+				uxMismatches++;
+			}
+
+			xTotalLength += xLength;
+			uxTasks++;
+		}
+	}
+
+	vTaskSuspendAll();
+	printf("round trip : %lu tasks in %lu bytes, %lu read back differently\n", (unsigned long)uxTasks, (unsigned long)xTotalLength,
+		(unsigned long)uxMismatches);
+	xTaskResumeAll();
+
+	/*< List the tasks from the serialised states, a buffer at a time.  A task created during the walk is visited at the end. */
+	uxTasks = 0;
+	xTotalLength = 0;
+	vTaskInitStateCursor(&xCursor);
+
+	vTaskSuspendAll();
+	printf("name          state priority stack   run time  switches   wakes\n");
+	xTaskResumeAll();
+
+	while ((xLength = xTaskSerialiseNextTaskStates(&xCursor, ucBuffer, sizeof(ucBuffer))) > 0)
+	{
+		uxReads++;
+		xTotalLength += xLength;
+
+		for (pucNext = ucBuffer; pucNext < &(ucBuffer[xLength]); uxTasks++)
+		{
+			pucNext = prvReadTaskStatus(pucNext, &xRead, cName);
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			printf("%-12s    %c   %5lu %6lu %10lu %9lu %7lu\n", cName, cStates[(xRead.eCurrentState <= eDeleted) ? xRead.eCurrentState : 5],
+				(unsigned long)xRead.uxCurrentPriority, (unsigned long)xRead.usStackHighWaterMark, (unsigned long)xRead.ulRunTimeCounter,
+				(unsigned long)xRead.ulSwitchesIn, (unsigned long)xRead.ulWakeups);
+			xTaskResumeAll();
+		}
+
+		if (xLateTask == NULL)
+		{
+			xTaskCreate(prvWorkerTask, "Late", configMINIMAL_STACK_SIZE, NULL, monitorWORKER_TASK_PRIORITY, &xLateTask);
+		}
+	}
+
+	vTaskList(cListBuffer);
+
+	vTaskSuspendAll();
+	printf("%lu tasks in %lu bytes from %lu calls, against %lu characters from vTaskList()\n", (unsigned long)uxTasks,
+		(unsigned long)xTotalLength, (unsigned long)uxReads, (unsigned long)strlen(cListBuffer));
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_TRACE_FACILITY */
+
+void Demo_Monitor1(void)
+{
+	printf("Demo_Monitor1 needs configUSE_TRACE_FACILITY set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_TRACE_FACILITY */
+
+
+/******************************************************************************************************************************************
+* Task state cursor and serialisation
+*
+* 1. uxTaskGetNextTaskStates() visits the tasks in the order they were created, a few at a time, with a TaskStateCursor_t that
+*    vTaskInitStateCursor() starts, so the scheduler only stays suspended while those few are read.  A task created during the walk
+*    is visited at the end, a task deleted before it is reached is skipped, and no task is visited twice.
+* 2. xTaskSerialiseTaskStatus() writes a TaskStatus_t in a compact binary form, each number 7 bits at a time, least significant first,
+*    with the top bit set in every byte but the last (unsigned LEB128), and the name after its length.  xTaskSerialiseNextTaskStates()
+*    writes as many of the tasks the cursor has not visited yet as fit in the buffer.  The format is described in task.h.
+*
+* Measurement
+*
+* After monitorSETTLE_TIME the monitor task reads every task with uxTaskGetNextTaskStates(), monitorTASKS_PER_READ at a time, writes
+* each with xTaskSerialiseTaskStatus() and reads it back with prvReadTaskStatus(), and prints how many tasks did not read back the
+* same, which should be none.  It then lists every task from the records xTaskSerialiseNextTaskStates() writes into a buffer only as
+* long as tskSERIALISED_TASK_STATUS_MAX_LENGTH, so the walk takes several calls, and creates the "Late" task after the first of them,
+* which is listed last.  Last it prints how many bytes that took, against the length of the text of vTaskList().
+*
+* FreeRTOSConfig.h sets configGENERATE_RUN_TIME_STATS to 1 when ENABLE_DEMO_MONITOR is 1, so the run time and switch counts are filled
+* in.  The demo runs once.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_MULTIWAIT1_H__
+#define __DEMO_MULTIWAIT1_H__
+
+extern void Demo_MultiWait1(void);
+
+#endif //__DEMO_MULTIWAIT1_H__
@@ -0,0 +1,263 @@
+#include <include.h>
+#include <event_groups.h>
+#include <stream_buffer.h>
+#include <multiwait.h>
+
+#if (configUSE_MULTI_WAIT == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The gateway task runs above the feeders, so it takes each item as soon as it is sent. */
+#define multiwaitFEEDER_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define multiwaitGATEWAY_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+/*< The number of feeder tasks, and how long they send to the gateway task for. */
+#define multiwaitFEEDERS					( 3 )
+#define multiwaitRUN_TICKS					pdMS_TO_TICKS( 1000UL )
+
+/*< The index of each object in the array the gateway task waits on.  The event bits come last, so they are only returned once every
+   other object is empty. */
+#define multiwaitQUEUE						( 0 )
+#define multiwaitSEMAPHORE					( 1 )
+#define multiwaitSTREAM_BUFFER				( 2 )
+#define multiwaitNOTIFICATION				( 3 )
+#define multiwaitEVENT_BITS					( 4 )
+#define multiwaitOBJECTS					( 5 )
+
+/*< A stream buffer wakes its receiver through notification index 0, so the gateway task is notified on another index. */
+#define multiwaitNOTIFICATION_INDEX			( 1 )
+
+/*< Each feeder sets a bit of its own once it has finished. */
+#define multiwaitALL_FEEDERS_DONE			( ( EventBits_t ) ( ( 1U << multiwaitFEEDERS ) - 1U ) )
+
+#define multiwaitQUEUE_LENGTH				( 8 )
+#define multiwaitSEMAPHORE_MAX_COUNT		( 64 )
+#define multiwaitSTREAM_BUFFER_BYTES		( 64 )
+
+/*< How long the gateway task waits with nothing sent, to show the wait timing out. */
+#define multiwaitTIMEOUT_TICKS				pdMS_TO_TICKS( 10UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Sends to the queue, the semaphore, the stream buffer and the notification of the gateway task in a random order, counting what
+ * was accepted, for multiwaitRUN_TICKS, then sets its bit in the event group.
+ */
+static void prvFeederTask(void* pvParameters);
+
+/*
+ * Shows the wait timing out and the lowest index being returned when two objects are ready, then starts the feeders and takes
+ * everything they send, waiting on all the objects at once, until the event bits show the feeders have finished.
+ */
+static void prvGatewayTask(void* pvParameters);
+
+/*
+ * Takes what the object at xIndex holds, with a block time of 0, and returns how many items that was.
+ */
+static uint32_t prvReceive(BaseType_t xIndex);
+
+static QueueHandle_t xQueue = NULL;
+static SemaphoreHandle_t xSemaphore = NULL;
+static StreamBufferHandle_t xStreamBuffer = NULL;
+static SemaphoreHandle_t xWriterMutex = NULL;
+static EventGroupHandle_t xEventGroup = NULL;
+static TaskHandle_t xGatewayTask = NULL;
+
+static TickType_t xFeedStart = 0;
+static volatile uint32_t ulSent[ multiwaitFEEDERS ][ multiwaitEVENT_BITS ];
+
+void Demo_MultiWait1(void)
+{
+	xQueue = xQueueCreate(multiwaitQUEUE_LENGTH, sizeof(uint32_t));
+	xSemaphore = xSemaphoreCreateCounting(multiwaitSEMAPHORE_MAX_COUNT, 0);
+	xStreamBuffer = xStreamBufferCreate(multiwaitSTREAM_BUFFER_BYTES, 1);
+	xWriterMutex = xSemaphoreCreateMutex();
+	xEventGroup = xEventGroupCreate();
+
+	xTaskCreate(prvGatewayTask, "Gateway", configMINIMAL_STACK_SIZE * 2, NULL, multiwaitGATEWAY_TASK_PRIORITY, &xGatewayTask);
+}
+
+static void prvFeederTask(void* pvParameters)
+{
+	UBaseType_t uxFeeder = (UBaseType_t)(uintptr_t)pvParameters;
+	uint32_t ulRandom = 0x12345678UL + uxFeeder, ulItem = 0;
+	uint8_t ucByte = (uint8_t)uxFeeder;
+
+	while ((TickType_t)(xTaskGetTickCount() - xFeedStart) < multiwaitRUN_TICKS)
+	{
+		ulRandom = (ulRandom * 1103515245UL) + 12345UL;
+
+		switch ((ulRandom >> 16) % multiwaitEVENT_BITS)
+		{
+		case multiwaitQUEUE:
+			ulSent[uxFeeder][multiwaitQUEUE] += (xQueueSend(xQueue, &ulItem, 0) == pdPASS) ? 1 : 0;
+			ulItem++;
+			break;
+
+		case multiwaitSEMAPHORE:
+			ulSent[uxFeeder][multiwaitSEMAPHORE] += (xSemaphoreGive(xSemaphore) == pdPASS) ? 1 : 0;
+			break;
+
+		case multiwaitSTREAM_BUFFER:
+			/*< A stream buffer has a single writer, so the feeders take turns to write to it, which suspending the scheduler would not
+			   ensure with more than one core. */
+			xSemaphoreTake(xWriterMutex, portMAX_DELAY);
+			ulSent[uxFeeder][multiwaitSTREAM_BUFFER] += (uint32_t)xStreamBufferSend(xStreamBuffer, &ucByte, 1, 0);
+			xSemaphoreGive(xWriterMutex);
+			break;
+
+		default:
+			xTaskNotifyGiveIndexed(xGatewayTask, multiwaitNOTIFICATION_INDEX);
+			ulSent[uxFeeder][multiwaitNOTIFICATION]++;
+			break;
+		}
+
+		/*< Let the other feeders send as well, and now and then let the tick through. */
+		vTaskDelay(((ulRandom >> 8) & 0x0FU) == 0 ? 1 : 0);
+	}
+
+	xEventGroupSetBits(xEventGroup, (EventBits_t)(1U << uxFeeder));
+	vTaskDelete(NULL);
+}
+
+static uint32_t prvReceive(BaseType_t xIndex)
+{
+	uint8_t ucBytes[ multiwaitSTREAM_BUFFER_BYTES ];
+	uint32_t ulItem, ulReceived = 0;
+
+	switch (xIndex)
+	{
+	case multiwaitQUEUE:
+		ulReceived = (xQueueReceive(xQueue, &ulItem, 0) == pdPASS) ? 1 : 0;
+		break;
+
+	case multiwaitSEMAPHORE:
+		ulReceived = (xSemaphoreTake(xSemaphore, 0) == pdPASS) ? 1 : 0;
+		break;
+
+	case multiwaitSTREAM_BUFFER:
+		ulReceived = (uint32_t)xStreamBufferReceive(xStreamBuffer, ucBytes, sizeof(ucBytes), 0);
+		break;
+
+	case multiwaitNOTIFICATION:
+		ulReceived = ulTaskNotifyTakeIndexed(multiwaitNOTIFICATION_INDEX, pdTRUE, 0);
+		break;
+
+	default:
+		break;
+	}
+
+	return ulReceived;
+}
+
+static void prvGatewayTask(void* pvParameters)
+{
+	static const char* const pcNames[ multiwaitEVENT_BITS ] = { "queue", "semaphore", "stream buffer", "notification" };
+	MultiWaitObject_t xObjects[ multiwaitOBJECTS ];
+	uint32_t ulReceived[ multiwaitEVENT_BITS ] = { 0 }, ulWakes = 0, ulSentTotal, ulItem = 0;
+	BaseType_t xIndex, xTimedOut, xFirstReady;
+	TickType_t xWaited;
+	UBaseType_t uxFeeder;
+	int iObject;
+
+	(void)pvParameters;
+
+	vMultiWaitInitQueue(&(xObjects[multiwaitQUEUE]), xQueue);
+	vMultiWaitInitQueue(&(xObjects[multiwaitSEMAPHORE]), xSemaphore);
+	vMultiWaitInitStreamBuffer(&(xObjects[multiwaitSTREAM_BUFFER]), xStreamBuffer);
+	vMultiWaitInitNotification(&(xObjects[multiwaitNOTIFICATION]), multiwaitNOTIFICATION_INDEX);
+	vMultiWaitInitEventBits(&(xObjects[multiwaitEVENT_BITS]), xEventGroup, multiwaitALL_FEEDERS_DONE, pdTRUE);
+
+	/*< Nothing has been sent yet, so the wait times out. */
+	xWaited = xTaskGetTickCount();
+	xTimedOut = xMultiWaitForObjects(xObjects, multiwaitOBJECTS, multiwaitTIMEOUT_TICKS);
+	xWaited = xTaskGetTickCount() - xWaited;
+
+	/*< The semaphore is given before the queue is written to, but the queue comes first in the array. */
+	xSemaphoreGive(xSemaphore);
+	xQueueSend(xQueue, &ulItem, 0);
+	xFirstReady = xMultiWaitForObjects(xObjects, multiwaitOBJECTS, 0);
+	prvReceive(multiwaitQUEUE);
+	prvReceive(multiwaitSEMAPHORE);
+
+	/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+	vTaskSuspendAll();
+	printf("nothing sent : %s after %lu ticks\n", (xTimedOut == multiwaitTIMED_OUT) ? "timed out" : "did not time out",
+		(unsigned long)xWaited);
+	printf("semaphore given, then queue written : returned %ld, the %s\n", (long)xFirstReady,
+		((xFirstReady >= 0) && (xFirstReady < multiwaitEVENT_BITS)) ? pcNames[xFirstReady] : "event bits");
+	xTaskResumeAll();
+
+	/*< Take everything the feeders send until they have all finished.  The event bits are last in the array, so by the time they are
+	   returned every other object is empty. */
+	xFeedStart = xTaskGetTickCount();
+
+	for (uxFeeder = 0; uxFeeder < multiwaitFEEDERS; uxFeeder++)
+	{
+		xTaskCreate(prvFeederTask, "Feeder", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)uxFeeder, multiwaitFEEDER_TASK_PRIORITY, NULL);
+	}
+
+	while ((xIndex = xMultiWaitForObjects(xObjects, multiwaitOBJECTS, portMAX_DELAY)) != multiwaitEVENT_BITS)
+	{
+		if ((xIndex >= 0) && (xIndex < multiwaitEVENT_BITS))
+		{
+			ulReceived[xIndex] += prvReceive(xIndex);
+		}
+
+		ulWakes++;
+	}
+
+	vTaskSuspendAll();
+	printf("%lu feeders for %lu ticks, woken %lu times :\n", (unsigned long)multiwaitFEEDERS, (unsigned long)multiwaitRUN_TICKS,
+		(unsigned long)ulWakes);
+
+	for (iObject = 0; iObject < multiwaitEVENT_BITS; iObject++)
+	{
+		ulSentTotal = 0;
+
+		for (uxFeeder = 0; uxFeeder < multiwaitFEEDERS; uxFeeder++)
+		{
+			ulSentTotal += ulSent[uxFeeder][iObject];
+		}
+
+		printf("  %-13s : %6lu sent, %6lu received\n", pcNames[iObject], (unsigned long)ulSentTotal, (unsigned long)ulReceived[iObject]);
+	}
+
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_MULTI_WAIT */
+
+void Demo_MultiWait1(void)
+{
+	printf("Demo_MultiWait1 needs configUSE_MULTI_WAIT set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_MULTI_WAIT */
+
+
+/******************************************************************************************************************************************
+* Waiting on several kernel objects at once
+*
+* 1. xMultiWaitForObjects() blocks a task on an array of queues or semaphores, event group bits, stream or message buffers and
+*    notification indexes, and returns the index of the first that is ready, the lowest if several are, or multiwaitTIMED_OUT.
+* 2. The wait takes nothing from the object.  The task reads it afterwards with a block time of 0, and clears event bits itself.  A
+*    stream buffer wakes the task through notification index 0, so the task waits for its own notifications on another index.
+*
+* Measurement
+*
+* The gateway task first waits with nothing sent, which times out, then gives the semaphore and writes to the queue before waiting,
+* which returns the queue as it is first in the array.  It then starts multiwaitFEEDERS feeder tasks below it, which send to the
+* queue, the semaphore, the stream buffer and the gateway's notification in a random order for multiwaitRUN_TICKS, and set a bit each
+* in the event group when they finish.  The gateway task waits on all five objects, takes what the one returned holds, and stops when
+* the event bits are returned, which as they are last only happens once the other objects are empty.  It prints how many items were
+* sent to each object and how many it received, which should be the same.
+*
+* FreeRTOSConfig.h sets configUSE_MULTI_WAIT to 1 when ENABLE_DEMO_MULTI_WAIT is 1.  The demo runs once.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_MUTEX1_H__
+#define __DEMO_MUTEX1_H__
+
+extern void Demo_Mutex1(void);
+
+#endif //__DEMO_MUTEX1_H__
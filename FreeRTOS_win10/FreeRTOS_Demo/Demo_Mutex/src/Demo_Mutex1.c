@@ -0,0 +1,245 @@
+#include <include.h>
+
+#if (configUSE_MUTEX_PRIORITY_CEILING == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The low, middle and high priority tasks form the chain, and the busy task runs between the middle and high ones.  The control
+   task that starts each step runs above them all. */
+#define mutexLOW_TASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define mutexMIDDLE_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
+#define mutexBUSY_TASK_PRIORITY				( tskIDLE_PRIORITY + 3 )
+#define mutexHIGH_TASK_PRIORITY				( tskIDLE_PRIORITY + 4 )
+#define mutexCONTROL_TASK_PRIORITY			( tskIDLE_PRIORITY + 5 )
+
+/*< The ceiling of xCeilingMutex is the priority of the highest task that takes it. */
+#define mutexCEILING_PRIORITY				mutexHIGH_TASK_PRIORITY
+
+/*< What the control task tells the low priority task to do. */
+#define mutexTAKE_CHAINED_MUTEX				( 1UL )
+#define mutexTAKE_CEILING_MUTEX				( 2UL )
+
+/*< How long the low priority task holds a mutex for, and how long the busy task runs for, from when each is started. */
+#define mutexHOLD_TICKS						pdMS_TO_TICKS( 10UL )
+#define mutexBUSY_TICKS						pdMS_TO_TICKS( 200UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Takes xChainedMutexA or xCeilingMutex, as the control task tells it, and holds it for mutexHOLD_TICKS without blocking.
+ */
+static void prvLowTask(void* pvParameters);
+
+/*
+ * Takes xChainedMutexB, then blocks on xChainedMutexA, which the low priority task holds, so it is the middle of the chain.
+ */
+static void prvMiddleTask(void* pvParameters);
+
+/*
+ * Blocks on xChainedMutexB, which the middle priority task holds, and records how long it waited for it.
+ */
+static void prvHighTask(void* pvParameters);
+
+/*
+ * Runs without blocking for mutexBUSY_TICKS, above the low and middle priority tasks unless they inherit a higher priority.
+ */
+static void prvBusyTask(void* pvParameters);
+
+/*
+ * Starts the other tasks in turn, once for the chain and once for the ceiling, and reports what happened.
+ */
+static void prvControlTask(void* pvParameters);
+
+/*
+ * Runs without blocking until the tick count reaches xEndTick.
+ */
+static void prvSpinUntil(TickType_t xEndTick);
+
+static SemaphoreHandle_t xChainedMutexA = NULL;
+static SemaphoreHandle_t xChainedMutexB = NULL;
+static SemaphoreHandle_t xCeilingMutex = NULL;
+
+static TaskHandle_t xLowTask = NULL;
+static TaskHandle_t xMiddleTask = NULL;
+static TaskHandle_t xHighTask = NULL;
+static TaskHandle_t xBusyTask = NULL;
+
+static volatile TickType_t xHoldEndTick = 0;
+static volatile TickType_t xHighWaitTicks = 0;
+static volatile UBaseType_t uxPriorityWhileHeld = 0;
+static volatile UBaseType_t uxPriorityAfterGive = 0;
+static volatile BaseType_t xBusyRanWhileHeld = pdFALSE;
+static volatile BaseType_t xBusyRunning = pdFALSE;
+
+void Demo_Mutex1(void)
+{
+	xChainedMutexA = xSemaphoreCreateMutex();
+	xChainedMutexB = xSemaphoreCreateMutex();
+	xCeilingMutex = xSemaphoreCreateMutexWithCeiling(mutexCEILING_PRIORITY);
+
+	xTaskCreate(prvLowTask, "Low", configMINIMAL_STACK_SIZE, NULL, mutexLOW_TASK_PRIORITY, &xLowTask);
+	xTaskCreate(prvMiddleTask, "Middle", configMINIMAL_STACK_SIZE, NULL, mutexMIDDLE_TASK_PRIORITY, &xMiddleTask);
+	xTaskCreate(prvBusyTask, "Busy", configMINIMAL_STACK_SIZE, NULL, mutexBUSY_TASK_PRIORITY, &xBusyTask);
+	xTaskCreate(prvHighTask, "High", configMINIMAL_STACK_SIZE, NULL, mutexHIGH_TASK_PRIORITY, &xHighTask);
+	xTaskCreate(prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, mutexCONTROL_TASK_PRIORITY, NULL);
+}
+
+static void prvSpinUntil(TickType_t xEndTick)
+{
+	/*< The end is never more than mutexBUSY_TICKS away, so a larger difference means it has passed. */
+	while ((TickType_t)(xEndTick - xTaskGetTickCount()) <= mutexBUSY_TICKS)
+	{
+	}
+}
+
+static void prvLowTask(void* pvParameters)
+{
+	uint32_t ulCommand;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		xTaskNotifyWait(0, 0xffffffffUL, &ulCommand, portMAX_DELAY);
+
+		if (ulCommand == mutexTAKE_CHAINED_MUTEX)
+		{
+			xSemaphoreTake(xChainedMutexA, portMAX_DELAY);
+			prvSpinUntil(xHoldEndTick);
+			xSemaphoreGive(xChainedMutexA);
+		}
+		else
+		{
+			/*< Taking the mutex raises this task to the ceiling at once, so the busy task it wakes can't run until it is given. */
+			xSemaphoreTake(xCeilingMutex, portMAX_DELAY);
+			uxPriorityWhileHeld = uxTaskPriorityGet(NULL);
+			xTaskNotifyGive(xBusyTask);
+			prvSpinUntil(xHoldEndTick);
+			xBusyRanWhileHeld = xBusyRunning;
+			xSemaphoreGive(xCeilingMutex);
+			uxPriorityAfterGive = uxTaskPriorityGet(NULL);
+		}
+	}
+}
+
+static void prvMiddleTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		xSemaphoreTake(xChainedMutexB, portMAX_DELAY);
+		xSemaphoreTake(xChainedMutexA, portMAX_DELAY);
+		xSemaphoreGive(xChainedMutexA);
+		xSemaphoreGive(xChainedMutexB);
+	}
+}
+
+static void prvHighTask(void* pvParameters)
+{
+	TickType_t xStart;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		xStart = xTaskGetTickCount();
+		xSemaphoreTake(xChainedMutexB, portMAX_DELAY);
+		xHighWaitTicks = xTaskGetTickCount() - xStart;
+		xSemaphoreGive(xChainedMutexB);
+	}
+}
+
+static void prvBusyTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		xBusyRunning = pdTRUE;
+		prvSpinUntil(xTaskGetTickCount() + mutexBUSY_TICKS);
+		xBusyRunning = pdFALSE;
+	}
+}
+
+static void prvControlTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	/*< The low priority task takes mutex A, the middle priority task takes mutex B and blocks on A, and the busy task starts, so the
+	   low priority task is left holding A below the busy task.  Then the high priority task blocks on B. */
+	xHoldEndTick = xTaskGetTickCount() + mutexHOLD_TICKS;
+	xTaskNotify(xLowTask, mutexTAKE_CHAINED_MUTEX, eSetValueWithOverwrite);
+	vTaskDelay(2);
+	xTaskNotifyGive(xMiddleTask);
+	vTaskDelay(2);
+	xTaskNotifyGive(xBusyTask);
+	vTaskDelay(2);
+	xTaskNotifyGive(xHighTask);
+
+	/*< Wait for the busy task as well, so it is not running when the ceiling is shown. */
+	vTaskDelay(mutexBUSY_TICKS + mutexHOLD_TICKS);
+
+	vTaskSuspendAll();
+	printf("chain length %lu : the high priority task waited %lu ticks for mutex B, the busy task runs for %lu\n",
+		(unsigned long)configPRIORITY_INHERITANCE_CHAIN_LENGTH, (unsigned long)xHighWaitTicks, (unsigned long)mutexBUSY_TICKS);
+	xTaskResumeAll();
+
+	/*< The low priority task takes the ceiling mutex and wakes the busy task while it holds it. */
+	xHoldEndTick = xTaskGetTickCount() + mutexHOLD_TICKS;
+	xTaskNotify(xLowTask, mutexTAKE_CEILING_MUTEX, eSetValueWithOverwrite);
+	vTaskDelay(mutexBUSY_TICKS + (2 * mutexHOLD_TICKS));
+
+	vTaskSuspendAll();
+	printf("ceiling %lu : the low priority task ran at %lu while holding the mutex and at %lu after, the busy task %s while it was held\n",
+		(unsigned long)mutexCEILING_PRIORITY, (unsigned long)uxPriorityWhileHeld, (unsigned long)uxPriorityAfterGive,
+		(xBusyRanWhileHeld != pdFALSE) ? "ran" : "did not run");
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_MUTEX_PRIORITY_CEILING */
+
+void Demo_Mutex1(void)
+{
+	printf("Demo_Mutex1 needs configUSE_MUTEX_PRIORITY_CEILING set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_MUTEX_PRIORITY_CEILING */
+
+
+/******************************************************************************************************************************************
+* Chained priority inheritance and priority ceilings
+*
+* 1. A task that blocks on a mutex lends its priority to the holder, so the holder can't be held up by tasks of a priority between
+*    the two.  With configPRIORITY_INHERITANCE_CHAIN_LENGTH above 1 the priority is also lent on to the holder of a mutex the holder
+*    is itself blocked on, and so on along the chain, up to that many tasks.
+* 2. A mutex created by xSemaphoreCreateMutexWithCeiling() raises the task that takes it to the ceiling priority straight away,
+*    rather than when another task blocks on it, and the task returns to its own priority once it holds no mutexes.  The ceiling
+*    must be at least the priority of every task that takes the mutex, which xSemaphoreTake() asserts.
+*
+* Chain
+*
+* The low priority task holds mutex A, the middle priority task holds mutex B and is blocked on A, and the busy task runs above both
+* of them for mutexBUSY_TICKS.  Then the high priority task blocks on B.  With a chain length of 1 only the middle priority task
+* inherits its priority, which does nothing while it is blocked, so the low priority task waits behind the busy task and the high
+* priority task waits for about mutexBUSY_TICKS.  With a longer chain the low priority task inherits the priority as well, finishes
+* with A within mutexHOLD_TICKS of taking it, and the high priority task gets B a few ticks after it blocked.
+*
+* Ceiling
+*
+* The low priority task takes the ceiling mutex, which raises it to the ceiling, and wakes the busy task while it holds the mutex.
+* The busy task is below the ceiling, so it only runs once the mutex has been given back and the low priority task has dropped to
+* its own priority.
+*
+* FreeRTOSConfig.h sets configUSE_MUTEX_PRIORITY_CEILING to 1 and configPRIORITY_INHERITANCE_CHAIN_LENGTH to 4 when
+* ENABLE_DEMO_MUTEX is 1.  Build again with a chain length of 1 to compare the two.  The demo runs once.
+******************************************************************************************************************************************/
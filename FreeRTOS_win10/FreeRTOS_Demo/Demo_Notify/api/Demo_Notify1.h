@@ -0,0 +1,6 @@
+#ifndef __DEMO_NOTIFY1_H__
+#define __DEMO_NOTIFY1_H__
+
+extern void Demo_Notify1(void);
+
+#endif //__DEMO_NOTIFY1_H__
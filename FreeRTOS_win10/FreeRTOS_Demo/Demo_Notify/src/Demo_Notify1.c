@@ -0,0 +1,207 @@
+#include <include.h>
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The consumers run above the producer, so each one notified preempts it unless the notifications are batched. */
+#define notifyPRODUCER_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define notifyCONSUMER_TASK_PRIORITY		( tskIDLE_PRIORITY + 2 )
+
+/*< How many consumers are notified by each broadcast, and how many broadcasts each way of notifying them is measured over. */
+#define notifyCONSUMERS						( 20 )
+#define notifyROUNDS						( 100UL )
+
+/*< The consumers wait on an index of their own, so the notifications don't mix with any sent on index 0. */
+#define notifyINDEX							( 1 )
+
+/*< The value sent to every consumer with xTaskNotifyMultipleIndexed(), and the one already pending for the first consumer. */
+#define notifyBROADCAST_VALUE				( 42UL )
+#define notifyPENDING_VALUE					( 7UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Waits for a notification on notifyINDEX, and records its value and when it ran.
+ */
+static void prvConsumerTask(void* pvParameters);
+
+/*
+ * Broadcasts to the consumers with a loop of xTaskNotifyGiveIndexed() and then with xTaskNotifyGiveMultipleIndexed(), and prints the
+ * context switches and time each took, then shows xTaskNotifyMultipleIndexed() failing for a consumer with a value still pending.
+ */
+static void prvProducerTask(void* pvParameters);
+
+/*
+ * Gives every consumer a notification notifyROUNDS times, in a single call if xBatched is pdTRUE, and prints the context switches per
+ * broadcast and the average time until every consumer had run.
+ */
+static void prvBroadcast(BaseType_t xBatched);
+
+/*
+ * Returns how many times the producer and the consumers have been switched in, between them.
+ */
+static uint32_t prvCountSwitches(void);
+
+static TaskHandle_t xProducerTask = NULL;
+static TaskHandle_t xConsumerTasks[ notifyCONSUMERS ];
+
+static volatile uint32_t ulReceived[ notifyCONSUMERS ];
+static volatile configRUN_TIME_COUNTER_TYPE ulRanAt[ notifyCONSUMERS ];
+
+void Demo_Notify1(void)
+{
+	UBaseType_t uxConsumer;
+
+	for (uxConsumer = 0; uxConsumer < notifyCONSUMERS; uxConsumer++)
+	{
+		xTaskCreate(prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)uxConsumer, notifyCONSUMER_TASK_PRIORITY,
+			&(xConsumerTasks[uxConsumer]));
+	}
+
+	xTaskCreate(prvProducerTask, "Producer", configMINIMAL_STACK_SIZE * 2, NULL, notifyPRODUCER_TASK_PRIORITY, &xProducerTask);
+}
+
+static void prvConsumerTask(void* pvParameters)
+{
+	UBaseType_t uxConsumer = (UBaseType_t)(uintptr_t)pvParameters;
+	uint32_t ulValue;
+
+	for (;;)
+	{
+		xTaskNotifyWaitIndexed(notifyINDEX, 0, 0xffffffffUL, &ulValue, portMAX_DELAY);
+		ulRanAt[uxConsumer] = portGET_RUN_TIME_COUNTER_VALUE();
+		ulReceived[uxConsumer] = ulValue;
+	}
+}
+
+static uint32_t prvCountSwitches(void)
+{
+	TaskStatus_t xStatus;
+	uint32_t ulSwitches;
+	UBaseType_t uxConsumer;
+
+	vTaskGetInfo(xProducerTask, &xStatus, pdFALSE, eInvalid);
+	ulSwitches = xStatus.ulSwitchesIn;
+
+	for (uxConsumer = 0; uxConsumer < notifyCONSUMERS; uxConsumer++)
+	{
+		vTaskGetInfo(xConsumerTasks[uxConsumer], &xStatus, pdFALSE, eInvalid);
+		ulSwitches += xStatus.ulSwitchesIn;
+	}
+
+	return ulSwitches;
+}
+
+static void prvBroadcast(BaseType_t xBatched)
+{
+	configRUN_TIME_COUNTER_TYPE ulStart, ulLatest, ulTotal = 0;
+	uint32_t ulSwitches, ulRound;
+	UBaseType_t uxConsumer;
+
+	ulSwitches = prvCountSwitches();
+
+	for (ulRound = 0; ulRound < notifyROUNDS; ulRound++)
+	{
+		ulStart = portGET_RUN_TIME_COUNTER_VALUE();
+
+		if (xBatched != pdFALSE)
+		{
+			xTaskNotifyGiveMultipleIndexed(xConsumerTasks, notifyCONSUMERS, notifyINDEX);
+		}
+		else
+		{
+			for (uxConsumer = 0; uxConsumer < notifyCONSUMERS; uxConsumer++)
+			{
+				xTaskNotifyGiveIndexed(xConsumerTasks[uxConsumer], notifyINDEX);
+			}
+		}
+
+		/*< The consumers are above the producer, so every one of them has run by the time it gets here. */
+		ulLatest = ulStart;
+
+		for (uxConsumer = 0; uxConsumer < notifyCONSUMERS; uxConsumer++)
+		{
+			ulLatest = (ulRanAt[uxConsumer] > ulLatest) ? ulRanAt[uxConsumer] : ulLatest;
+		}
+
+		ulTotal += ulLatest - ulStart;
+	}
+
+	ulSwitches = prvCountSwitches() - ulSwitches;
+
+	/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing.  The run time
+	   counter counts 10us units. */
+	vTaskSuspendAll();
+	printf("%-32s : %3lu context switches per broadcast, all %lu consumers had run after %lu us\n",
+		(xBatched != pdFALSE) ? "xTaskNotifyGiveMultipleIndexed()" : "loop of xTaskNotifyGiveIndexed()",
+		(unsigned long)(ulSwitches / notifyROUNDS), (unsigned long)notifyCONSUMERS, (unsigned long)((ulTotal * 10U) / notifyROUNDS));
+	xTaskResumeAll();
+}
+
+static void prvProducerTask(void* pvParameters)
+{
+	BaseType_t xResult;
+	UBaseType_t uxConsumer, uxBroadcastValues = 0;
+
+	(void)pvParameters;
+
+	prvBroadcast(pdFALSE);
+	prvBroadcast(pdTRUE);
+
+	/*< With the scheduler suspended the first consumer can't run to take the value sent to it alone, so it is still pending when the
+	   broadcast is sent, which can't overwrite it.  Every other consumer still gets the broadcast. */
+	vTaskSuspendAll();
+	xTaskNotifyIndexed(xConsumerTasks[0], notifyINDEX, notifyPENDING_VALUE, eSetValueWithOverwrite);
+	xResult = xTaskNotifyMultipleIndexed(xConsumerTasks, notifyCONSUMERS, notifyINDEX, notifyBROADCAST_VALUE, eSetValueWithoutOverwrite);
+	xTaskResumeAll();
+
+	for (uxConsumer = 0; uxConsumer < notifyCONSUMERS; uxConsumer++)
+	{
+		uxBroadcastValues += (ulReceived[uxConsumer] == notifyBROADCAST_VALUE) ? 1 : 0;
+	}
+
+	vTaskSuspendAll();
+	printf("xTaskNotifyMultipleIndexed() without overwrite returned %s : the first consumer got %lu, %lu others got %lu\n",
+		(xResult == pdPASS) ? "pdPASS" : "pdFAIL", (unsigned long)ulReceived[0], (unsigned long)uxBroadcastValues,
+		(unsigned long)notifyBROADCAST_VALUE);
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configGENERATE_RUN_TIME_STATS */
+
+void Demo_Notify1(void)
+{
+	printf("Demo_Notify1 needs configGENERATE_RUN_TIME_STATS set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+
+/******************************************************************************************************************************************
+* Notifying several tasks in one call
+*
+* 1. xTaskNotifyGiveMultipleIndexed() and xTaskNotifyMultipleIndexed() notify every task in an array, on one index, in a single
+*    critical section, and only decide whether to switch to a task they unblocked once the last has been notified.  A loop of
+*    xTaskNotifyGiveIndexed() switches to each task of a higher priority as soon as it is notified, and back, before the next.
+* 2. With eSetValueWithoutOverwrite a task that still has a value pending keeps it, the call returns pdFAIL, and every other task in
+*    the array is notified all the same.
+*
+* Measurement
+*
+* notifyCONSUMERS consumers wait on notification index notifyINDEX above the producer.  The producer gives them all a notification
+* notifyROUNDS times with a loop of xTaskNotifyGiveIndexed(), then as often with xTaskNotifyGiveMultipleIndexed(), and prints the
+* context switches of each broadcast, counted from ulSwitchesIn, and the average time from the start of the broadcast until the last
+* consumer ran: about 40 switches for the loop, two for each consumer, against 21.  Last it sends the first consumer a value on its
+* own and then the broadcast without overwrite, with the scheduler suspended, so only the first consumer keeps its own value.
+*
+* FreeRTOSConfig.h sets configGENERATE_RUN_TIME_STATS to 1 when ENABLE_DEMO_NOTIFY is 1, for the switch counts and the run time
+* counter.  The times are in 10us steps, and with a host thread per task a context switch costs the host much more than with fibers.
+* The demo runs once.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_POOL1_H__
+#define __DEMO_POOL1_H__
+
+extern void Demo_Pool1(void);
+
+#endif //__DEMO_POOL1_H__
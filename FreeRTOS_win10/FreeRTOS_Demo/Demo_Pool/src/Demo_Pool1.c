@@ -0,0 +1,208 @@
+#include <include.h>
+
+#if (configUSE_TASK_POOLS == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The tasks created from the pool run below the control task, so they only run when it blocks. */
+#define poolTASK_PRIORITY					( tskIDLE_PRIORITY + 1 )
+#define poolCONTROL_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
+
+/*< The pool has two slots, each with a stack of the usual depth. */
+#define poolSLOTS							( 2 )
+#define poolSTACK_DEPTH						configMINIMAL_STACK_SIZE
+
+/*< How many bytes of its stack the deep task writes to. */
+#define poolDEEP_BYTES						( 4096 )
+
+/*< How many tasks are created and deleted to time the pool against xTaskCreate(). */
+#define poolREPEATS							( 10000UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Writes poolDEEP_BYTES of its stack, then blocks until it is deleted.
+ */
+static void prvDeepTask(void* pvParameters);
+
+/*
+ * Blocks until it is deleted.
+ */
+static void prvWaitingTask(void* pvParameters);
+
+/*
+ * Deletes itself, so its slot goes back to the pool once the idle task has cleaned it up.
+ */
+static void prvSelfDeletingTask(void* pvParameters);
+
+/*
+ * Fills the pool, deletes a task to reuse its slot, then times creating and deleting tasks from the pool and with xTaskCreate().
+ */
+static void prvControlTask(void* pvParameters);
+
+/*
+ * Creates and deletes poolREPEATS tasks, from xFromPool or with xTaskCreate() if xFromPool is NULL, and returns how many ticks it
+ * took.  The tasks are below the calling task, so they never run.
+ */
+static TickType_t prvTimeCreateDelete(TaskPoolHandle_t xFromPool);
+
+static TaskPoolHandle_t xPool = NULL;
+
+void Demo_Pool1(void)
+{
+	xPool = xTaskPoolCreate(poolSLOTS, poolSTACK_DEPTH);
+
+	xTaskCreate(prvControlTask, "Control", configMINIMAL_STACK_SIZE * 2, NULL, poolCONTROL_TASK_PRIORITY, NULL);
+}
+
+static void prvDeepTask(void* pvParameters)
+{
+	volatile uint8_t ucDeep[ poolDEEP_BYTES ];
+	size_t x;
+
+	(void)pvParameters;
+
+	for (x = 0; x < poolDEEP_BYTES; x++)
+	{
+		ucDeep[x] = (uint8_t)x;
+	}
+
+	vTaskSuspend(NULL);
+}
+
+static void prvWaitingTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	vTaskSuspend(NULL);
+}
+
+static void prvSelfDeletingTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	vTaskDelete(NULL);
+}
+
+static TickType_t prvTimeCreateDelete(TaskPoolHandle_t xFromPool)
+{
+	TaskHandle_t xTask;
+	TickType_t xStart;
+	uint32_t ulRepeat;
+
+	/*< Start at a tick boundary, so the count is not a tick short. */
+	vTaskDelay(1);
+	xStart = xTaskGetTickCount();
+
+	for (ulRepeat = 0; ulRepeat < poolREPEATS; ulRepeat++)
+	{
+		if (xFromPool != NULL)
+		{
+			xTaskCreateFromPool(xFromPool, prvWaitingTask, "Timed", NULL, poolTASK_PRIORITY, &xTask);
+		}
+		else
+		{
+			xTaskCreate(prvWaitingTask, "Timed", poolSTACK_DEPTH, NULL, poolTASK_PRIORITY, &xTask);
+		}
+
+		vTaskDelete(xTask);
+	}
+
+	return xTaskGetTickCount() - xStart;
+}
+
+static void prvControlTask(void* pvParameters)
+{
+	TaskHandle_t xDeepTask = NULL, xWaitingTask = NULL, xFreshTask = NULL, xRefusedTask = NULL;
+	UBaseType_t uxDeepHighWaterMark, uxFreshHighWaterMark;
+	BaseType_t xRefused;
+	TickType_t xPoolTicks, xHeapTicks;
+
+	(void)pvParameters;
+
+	/*< Fill the pool, and let the deep task run, so its stack is used. */
+	xTaskCreateFromPool(xPool, prvDeepTask, "Deep", NULL, poolTASK_PRIORITY, &xDeepTask);
+	xTaskCreateFromPool(xPool, prvWaitingTask, "Waiting", NULL, poolTASK_PRIORITY, &xWaitingTask);
+	vTaskDelay(2);
+
+	xRefused = xTaskCreateFromPool(xPool, prvWaitingTask, "Refused", NULL, poolTASK_PRIORITY, &xRefusedTask);
+	uxDeepHighWaterMark = uxTaskGetStackHighWaterMark(xDeepTask);
+
+	/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+	vTaskSuspendAll();
+	printf("pool of %lu slots full : %lu free, a third task %s, the deep task has %lu words of stack left\n", (unsigned long)poolSLOTS,
+		(unsigned long)uxTaskPoolGetFreeSlots(xPool), (xRefused == errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY) ? "was refused" : "was created",
+		(unsigned long)uxDeepHighWaterMark);
+	xTaskResumeAll();
+
+	/*< Deleting another task cleans it up at once, so its slot is free straight away, and is the one the next task is given. */
+	vTaskDelete(xDeepTask);
+
+	vTaskSuspendAll();
+	printf("deep task deleted : %lu free\n", (unsigned long)uxTaskPoolGetFreeSlots(xPool));
+	xTaskResumeAll();
+
+	xTaskCreateFromPool(xPool, prvWaitingTask, "Fresh", NULL, poolTASK_PRIORITY, &xFreshTask);
+	uxFreshHighWaterMark = uxTaskGetStackHighWaterMark(xFreshTask);
+
+	vTaskSuspendAll();
+	printf("fresh task created %s the deep task, with %lu words of stack left before it has run\n",
+		(xFreshTask == xDeepTask) ? "in the slot of" : "in another slot than", (unsigned long)uxFreshHighWaterMark);
+	xTaskResumeAll();
+
+	/*< A task that deletes itself is cleaned up by the idle task, so its slot is only free once the idle task has run. */
+	vTaskDelete(xFreshTask);
+	xTaskCreateFromPool(xPool, prvSelfDeletingTask, "Self", NULL, poolTASK_PRIORITY, NULL);
+	vTaskDelay(2);
+
+	vTaskSuspendAll();
+	printf("self deleting task gone : %lu free\n", (unsigned long)uxTaskPoolGetFreeSlots(xPool));
+	xTaskResumeAll();
+
+	vTaskDelete(xWaitingTask);
+
+	xPoolTicks = prvTimeCreateDelete(xPool);
+	xHeapTicks = prvTimeCreateDelete(NULL);
+
+	vTaskSuspendAll();
+	printf("create and delete %lu tasks : %lu ticks from the pool, %lu ticks with xTaskCreate()\n", (unsigned long)poolREPEATS,
+		(unsigned long)xPoolTicks, (unsigned long)xHeapTicks);
+	xTaskResumeAll();
+
+	vTaskDelete(NULL);
+}
+
+#else /* configUSE_TASK_POOLS */
+
+void Demo_Pool1(void)
+{
+	printf("Demo_Pool1 needs configUSE_TASK_POOLS set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_TASK_POOLS */
+
+
+/******************************************************************************************************************************************
+* Task pools
+*
+* 1. xTaskPoolCreate() allocates a number of slots up front, each a TCB and a stack of the same depth, and fills each stack with
+*    tskSTACK_FILL_BYTE.  xTaskCreateFromPool() takes the slot at the head of the pool's free list, without calling pvPortMalloc() or
+*    filling the stack, or returns errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY when every slot is in use.
+* 2. Deleting a task from a pool puts its slot at the end of the free list, rather than freeing the memory, once the task is cleaned
+*    up: at once when another task deletes it, or by the idle task when it deletes itself.  Only the part of the stack the task used
+*    is filled again then, so the high water mark of the next task in the slot starts from the full stack.
+*
+* Measurement
+*
+* The control task fills a pool of two slots, one with a task that has used poolDEEP_BYTES of its stack, and shows a third task is
+* refused.  It deletes the deep task and creates another, which gets the same slot, and with the whole stack free again.  A task that
+* deletes itself only gives its slot back after the idle task has run.  Last the control task creates and deletes poolREPEATS tasks
+* that never run, from the pool and then with xTaskCreate(), and prints how many ticks each took.
+*
+* FreeRTOSConfig.h sets configUSE_TASK_POOLS to 1 when ENABLE_DEMO_POOL is 1.  With a host thread for each task the port's own cost
+* of creating and deleting a task can outweigh the heap, so the difference is clearest with fibers.  The demo runs once.
+******************************************************************************************************************************************/
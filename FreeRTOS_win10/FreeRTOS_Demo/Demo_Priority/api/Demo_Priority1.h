@@ -0,0 +1,6 @@
+#ifndef __DEMO_PRIORITY1_H__
+#define __DEMO_PRIORITY1_H__
+
+extern void Demo_Priority1(void);
+
+#endif //__DEMO_PRIORITY1_H__
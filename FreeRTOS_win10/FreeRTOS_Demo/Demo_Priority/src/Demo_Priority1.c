@@ -0,0 +1,121 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The task that wakes the other and measures runs just above the idle task, so each switch back to it has to find the lowest
+   ready priority in use below the woken task. */
+#define prioSWEEP_TASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+
+/*< The numbers of priorities measured, see uxPriorityCounts[], and how long each is measured. */
+#define prioNUMBER_OF_STEPS					( 4 )
+#define prioMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Waits for a notification over and over, so each notification switches to it and back.  There is one for each count in
+ * uxPriorityCounts[], at the top priority of the count.
+ */
+static void prvWokenTask(void* pvParameters);
+
+/*
+ * Notifies the woken task of each count in uxPriorityCounts[] in turn for prioMEASUREMENT_PERIOD, and reports the cost of one
+ * context switch.
+ */
+static void prvSweepTask(void* pvParameters);
+
+static TaskHandle_t xWokenTasks[ prioNUMBER_OF_STEPS ];
+
+static const UBaseType_t uxPriorityCounts[ prioNUMBER_OF_STEPS ] = { 8, 32, 64, 256 };
+
+void Demo_Priority1(void)
+{
+	int iStep;
+
+	/*< Only the counts this build has priorities for are measured. */
+	for (iStep = 0; (iStep < prioNUMBER_OF_STEPS) && (uxPriorityCounts[iStep] <= (UBaseType_t)configMAX_PRIORITIES); iStep++)
+	{
+		xTaskCreate(prvWokenTask, "Woken", configMINIMAL_STACK_SIZE, NULL, uxPriorityCounts[iStep] - 1, &(xWokenTasks[iStep]));
+	}
+
+	xTaskCreate(prvSweepTask, "Sweep", configMINIMAL_STACK_SIZE * 2, (void*)(uintptr_t)iStep, prioSWEEP_TASK_PRIORITY, NULL);
+}
+
+static void prvWokenTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+	}
+}
+
+static void prvSweepTask(void* pvParameters)
+{
+	uint32_t ulNotifications;
+	TickType_t xStart, xElapsed;
+	uint64_t ullNanoseconds;
+	int iStep, iSteps = (int)(uintptr_t)pvParameters;
+
+	vTaskSuspendAll();
+	printf("configMAX_PRIORITIES %lu, %s task selection\n", (unsigned long)configMAX_PRIORITIES,
+		(configUSE_PORT_OPTIMISED_TASK_SELECTION == 1) ? "port optimised" : "generic");
+	xTaskResumeAll();
+
+	for (;;)
+	{
+		for (iStep = 0; iStep < iSteps; iStep++)
+		{
+			ulNotifications = 0;
+			xStart = xTaskGetTickCount();
+
+			do
+			{
+				xTaskNotifyGive(xWokenTasks[iStep]);
+				ulNotifications++;
+				xElapsed = xTaskGetTickCount() - xStart;
+			} while (xElapsed < prioMEASUREMENT_PERIOD);
+
+			/*< Each notification switches to the woken task and back again. */
+			ullNanoseconds = ((uint64_t)xElapsed * 1000000000ULL) / configTICK_RATE_HZ;
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			printf("top priority %3lu : %10lu switches per second, %6lu ns each\n", (unsigned long)(uxPriorityCounts[iStep] - 1),
+				(unsigned long)(((uint64_t)ulNotifications * 2ULL * 1000000000ULL) / ullNanoseconds),
+				(unsigned long)(ullNanoseconds / ((uint64_t)ulNotifications * 2ULL)));
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Priority count and task selection
+*
+* 1. Each context switch selects the highest priority ready task.  With configUSE_PORT_OPTIMISED_TASK_SELECTION set to 0 the kernel
+*    walks down the ready lists from the highest priority that has been ready, one priority at a time, until it finds one that is
+*    not empty, so a switch costs more the further apart the ready priorities are.
+* 2. With configUSE_PORT_OPTIMISED_TASK_SELECTION set to 1 the port keeps a bit per priority that has a ready task, and finds the
+*    highest with a bit scan.  Above 32 priorities the bits are kept in a word per group of 32 priorities plus a summary word with a
+*    bit per group, so the highest is found with two bit scans, however many priorities there are (see note 14 in
+*    docs/FreeRTOS_Config_Readme.txt).
+*
+* Measurement
+*
+* The sweep task runs just above the idle task and notifies a woken task over and over.  For each count in uxPriorityCounts[]
+* that is no more than configMAX_PRIORITIES it notifies a woken task at the top priority of that count, so every notification
+* switches up to it, and every time it blocks again the switch back has to find the sweep task far below.  After
+* prioMEASUREMENT_PERIOD the sweep task prints the switches per second and the average time of one, which includes the
+* notification.
+*
+* FreeRTOSConfig.h sets configMAX_PRIORITIES to 256 when ENABLE_DEMO_PRIORITY is 1, so every count is measured, with the two level
+* bit map.  Build once with configUSE_PORT_OPTIMISED_TASK_SELECTION set to 1 and once set to 0 to compare the two, and with a
+* configMAX_PRIORITIES of 32 or less to measure the single level bit map.  Unless configSIMULATOR_USE_FIBERS is 1 (Linux only)
+* each switch is also a switch between host threads, which costs far more than selecting the task.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_QUEUE3_H__
+#define __DEMO_QUEUE3_H__
+
+extern void Demo_Queue3(void);
+
+#endif //__DEMO_QUEUE3_H__
@@ -0,0 +1,220 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The workloads run at a low priority, and the task that measures them at a higher priority so it always gets to run. */
+#define queueWORKLOAD_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define queueREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/*< How long each workload runs for each time it is measured. */
+#define queueMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*< The length of the queue used by the producer/consumer workload. */
+#define queueQUEUE_LENGTH					( 16 )
+
+/*< The number of workloads, see xWorkloads[]. */
+#define queueNUMBER_OF_WORKLOADS			( 2 )
+
+/*********************************************************************************************************************************
+ *                                                     Type definitions
+ *********************************************************************************************************************************/
+
+typedef struct
+{
+	const char *pcName;
+
+	/*< The tasks of the workload, which are only resumed while the workload is being measured.  Unused entries are NULL. */
+	TaskHandle_t xTasks[ 2 ];
+
+	/*< Incremented for each item that is received from the queue. */
+	volatile uint32_t ulItems;
+} Workload_t;
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * One task that sends an item to an empty queue then receives it again, without blocking.  Every iteration is a send and a
+ * receive that each enter and exit a critical section twice, and never switch task, so it measures the cost of the queue API
+ * itself - which in the simulator ports is mostly the cost of the critical sections.
+ */
+static void prvSendReceiveTask(void* pvParameters);
+
+/*
+ * A producer and a consumer of the same priority.  The producer sends until the queue is full and blocks, then the consumer
+ * receives until the queue is empty and blocks, so most items are passed without a task switch, as in a typical buffered
+ * design.
+ */
+static void prvProducerTask(void* pvParameters);
+static void prvConsumerTask(void* pvParameters);
+
+/*
+ * Runs each workload in turn for queueMEASUREMENT_PERIOD and reports the number of items passed through the queue.
+ */
+static void prvReportTask(void* pvParameters);
+
+static QueueHandle_t xLoopbackQueue = NULL, xProducerQueue = NULL;
+
+static Workload_t xWorkloads[ queueNUMBER_OF_WORKLOADS ] =
+{
+	{ "send/receive",          { NULL, NULL }, 0 },
+	{ "producer/consumer",     { NULL, NULL }, 0 }
+};
+
+void Demo_Queue3(void)
+{
+	xLoopbackQueue = xQueueCreate(1, sizeof(uint32_t));
+	xProducerQueue = xQueueCreate(queueQUEUE_LENGTH, sizeof(uint32_t));
+
+	if ((xLoopbackQueue != NULL) && (xProducerQueue != NULL))
+	{
+		xTaskCreate(prvSendReceiveTask, "SendRecv", configMINIMAL_STACK_SIZE, &(xWorkloads[0]), queueWORKLOAD_TASK_PRIORITY, &(xWorkloads[0].xTasks[0]));
+		xTaskCreate(prvProducerTask, "Producer", configMINIMAL_STACK_SIZE, &(xWorkloads[1]), queueWORKLOAD_TASK_PRIORITY, &(xWorkloads[1].xTasks[0]));
+		xTaskCreate(prvConsumerTask, "Consumer", configMINIMAL_STACK_SIZE, &(xWorkloads[1]), queueWORKLOAD_TASK_PRIORITY, &(xWorkloads[1].xTasks[1]));
+		xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, queueREPORT_TASK_PRIORITY, NULL);
+	}
+}
+
+static void prvSendReceiveTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	uint32_t ulValue = 0;
+
+	for (;;)
+	{
+		xQueueSend(xLoopbackQueue, &ulValue, 0);
+
+		if (xQueueReceive(xLoopbackQueue, &ulValue, 0) == pdPASS)
+		{
+			pxWorkload->ulItems++;
+		}
+	}
+}
+
+static void prvProducerTask(void* pvParameters)
+{
+	uint32_t ulValue = 0;
+
+	(void)pvParameters;
+
+	for (;;)
+	{
+		xQueueSend(xProducerQueue, &ulValue, portMAX_DELAY);
+		ulValue++;
+	}
+}
+
+static void prvConsumerTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	uint32_t ulValue;
+
+	for (;;)
+	{
+		if (xQueueReceive(xProducerQueue, &ulValue, portMAX_DELAY) == pdPASS)
+		{
+			pxWorkload->ulItems++;
+		}
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	Workload_t* pxWorkload;
+	uint32_t ulItems;
+	TickType_t xStart, xElapsed;
+	uint64_t ullNanoseconds;
+	int i, j;
+
+	(void)pvParameters;
+
+	/*< Only the workload being measured runs, so the workloads do not share the processor with each other. */
+	for (i = 0; i < queueNUMBER_OF_WORKLOADS; i++)
+	{
+		for (j = 0; j < 2; j++)
+		{
+			if (xWorkloads[i].xTasks[j] != NULL)
+			{
+				vTaskSuspend(xWorkloads[i].xTasks[j]);
+			}
+		}
+	}
+
+	vTaskSuspendAll();
+#if (configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1)
+	printf("Critical sections use the lightweight lock (configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 1)\n");
+#else
+	printf("Critical sections use a host mutex (configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS == 0)\n");
+#endif
+	xTaskResumeAll();
+
+	for (;;)
+	{
+		for (i = 0; i < queueNUMBER_OF_WORKLOADS; i++)
+		{
+			pxWorkload = &(xWorkloads[i]);
+			pxWorkload->ulItems = 0;
+			xStart = xTaskGetTickCount();
+
+			for (j = 0; j < 2; j++)
+			{
+				if (pxWorkload->xTasks[j] != NULL)
+				{
+					vTaskResume(pxWorkload->xTasks[j]);
+				}
+			}
+
+			vTaskDelay(queueMEASUREMENT_PERIOD);
+
+			for (j = 0; j < 2; j++)
+			{
+				if (pxWorkload->xTasks[j] != NULL)
+				{
+					vTaskSuspend(pxWorkload->xTasks[j]);
+				}
+			}
+
+			ulItems = pxWorkload->ulItems;
+			xElapsed = xTaskGetTickCount() - xStart;
+			ullNanoseconds = ((uint64_t)xElapsed * 1000000000ULL) / configTICK_RATE_HZ;
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			if (ulItems > 0)
+			{
+				printf("%-20s : %10lu items per second, %6lu ns each\n", pxWorkload->pcName,
+					(unsigned long)((ulItems * 1000000000ULL) / ullNanoseconds), (unsigned long)(ullNanoseconds / ulItems));
+			}
+			else
+			{
+				printf("%-20s : did not run\n", pxWorkload->pcName);
+			}
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Queue throughput
+*
+* 1. Every queue send and receive enters and exits a critical section at least once, so in the simulator ports - where a critical
+*    section is a host lock, not a single instruction - their cost dominates the cost of passing an item through a queue.
+* 2. With configSIMULATOR_LIGHTWEIGHT_CRITICAL_SECTIONS set to 1 the lock that models (simulated) interrupts being disabled is taken
+*    and released with an atomic operation when no other thread holds it, which is nearly always.  Only a thread that finds the lock
+*    held makes a system call, to wait for it.  Set it to 0 in FreeRTOSConfig.h to use a host mutex, which costs a system call on
+*    every entry and exit on Windows, and compare the numbers printed by this demo.
+* 3. With configSIMULATOR_USE_FIBERS set to 1 (Linux only) there is only one host thread, and critical sections use neither.
+*
+* Workloads
+*
+* 1. send/receive         : one task sends an item to a queue and receives it again, never blocking.  No task switches.
+* 2. producer/consumer    : two tasks of the same priority pass items through a queue of queueQUEUE_LENGTH items.  A task switch
+*                           happens each time the queue becomes full or empty.
+*
+* Each workload runs alone for queueMEASUREMENT_PERIOD, then the report task prints the number of items passed through the queue per
+* second and the average time of one item.
+******************************************************************************************************************************************/
@@ -0,0 +1,6 @@
+#ifndef __DEMO_SMP1_H__
+#define __DEMO_SMP1_H__
+
+extern void Demo_Smp1(void);
+
+#endif //__DEMO_SMP1_H__
@@ -0,0 +1,246 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The workers never block, so they run at a priority above the idle tasks, which then only run on the cores the workers leave
+    free.  The task that measures them runs at a higher priority so it always gets to run. */
+#define smpWORKER_TASK_PRIORITY				( tskIDLE_PRIORITY + 1 )
+#define smpREPORT_TASK_PRIORITY				( tskIDLE_PRIORITY + 3 )
+
+/*< Each workload has one worker per simulated core. */
+#define smpWORKERS_PER_WORKLOAD				( configNUMBER_OF_CORES )
+
+/*< The number of loops of a unit of work, and how long each workload runs for each time it is measured. */
+#define smpWORK_UNIT_LOOPS					( 1000UL )
+#define smpMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*< The number of workloads, see xWorkloads[]. */
+#define smpNUMBER_OF_WORKLOADS				( 3 )
+
+/*********************************************************************************************************************************
+ *                                                     Type definitions
+ *********************************************************************************************************************************/
+
+typedef struct
+{
+	const char *pcName;
+
+	/*< The function of the workers. */
+	TaskFunction_t pxWorker;
+
+	/*< Bit n set allows the workers to run on core n. */
+	UBaseType_t uxCoreAffinity;
+
+	/*< The workers, which are only resumed while the workload is being measured. */
+	TaskHandle_t xWorkers[ smpWORKERS_PER_WORKLOAD ];
+
+	/*< Incremented each time a worker has done a unit of work. */
+	volatile uint32_t ulUnits;
+} Workload_t;
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Does units of work that share nothing with the other workers, only counting them in a critical section now and then.
+ */
+static void prvIndependentTask(void* pvParameters);
+
+/*
+ * Does each unit of work inside a critical section, so only one worker at a time can make progress.
+ */
+static void prvCriticalSectionTask(void* pvParameters);
+
+/*
+ * One unit of work, which only uses the stack of the calling task.
+ */
+static uint32_t prvWorkUnit(uint32_t ulSeed);
+
+/*
+ * Runs each workload in turn for smpMEASUREMENT_PERIOD and reports how much work it got done.
+ */
+static void prvReportTask(void* pvParameters);
+
+static Workload_t xWorkloads[ smpNUMBER_OF_WORKLOADS ] =
+{
+	{ "independent",       prvIndependentTask,     ( UBaseType_t ) -1, { NULL }, 0 },
+	{ "critical section",  prvCriticalSectionTask, ( UBaseType_t ) -1, { NULL }, 0 },
+	{ "pinned to core 0",  prvIndependentTask,     ( UBaseType_t ) 1,  { NULL }, 0 }
+};
+
+void Demo_Smp1(void)
+{
+	Workload_t* pxWorkload;
+	int i, j;
+
+	for (i = 0; i < smpNUMBER_OF_WORKLOADS; i++)
+	{
+		pxWorkload = &(xWorkloads[i]);
+
+		for (j = 0; j < smpWORKERS_PER_WORKLOAD; j++)
+		{
+			xTaskCreate(pxWorkload->pxWorker, "Worker", configMINIMAL_STACK_SIZE, pxWorkload, smpWORKER_TASK_PRIORITY, &(pxWorkload->xWorkers[j]));
+
+			#if (configUSE_CORE_AFFINITY == 1)
+			{
+				vTaskCoreAffinitySet(pxWorkload->xWorkers[j], pxWorkload->uxCoreAffinity);
+			}
+			#endif
+		}
+	}
+
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, smpREPORT_TASK_PRIORITY, NULL);
+}
+
+static uint32_t prvWorkUnit(uint32_t ulSeed)
+{
+	volatile uint32_t ulValue = ulSeed;
+	uint32_t i;
+
+	for (i = 0; i < smpWORK_UNIT_LOOPS; i++)
+	{
+		ulValue = (ulValue * 1103515245UL) + 12345UL;
+	}
+
+	return ulValue;
+}
+
+static void prvIndependentTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	uint32_t ulSeed = 0, ulUnits = 0;
+
+	for (;;)
+	{
+		ulSeed = prvWorkUnit(ulSeed);
+		ulUnits++;
+
+		/*< Counting each unit in the shared counter would make the workers contend for it, so count them in batches. */
+		if (ulUnits == 100UL)
+		{
+			taskENTER_CRITICAL();
+			pxWorkload->ulUnits += ulUnits;
+			taskEXIT_CRITICAL();
+			ulUnits = 0;
+		}
+	}
+}
+
+static void prvCriticalSectionTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	uint32_t ulSeed = 0;
+
+	for (;;)
+	{
+		taskENTER_CRITICAL();
+		ulSeed = prvWorkUnit(ulSeed);
+		pxWorkload->ulUnits++;
+		taskEXIT_CRITICAL();
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	Workload_t* pxWorkload;
+	uint32_t ulUnits;
+	TickType_t xStart, xElapsed;
+	int i, j;
+#if (configNUMBER_OF_CORES > 1) && (configGENERATE_RUN_TIME_STATS == 1)
+	uint32_t ulBusy[ configNUMBER_OF_CORES ], ulIdle[ configNUMBER_OF_CORES ];
+	uint32_t ulBusyDelta, ulIdleDelta;
+	BaseType_t xCore;
+#endif
+
+	(void)pvParameters;
+
+	/*< Only the workload being measured runs, so the workloads do not share the cores with each other. */
+	for (i = 0; i < smpNUMBER_OF_WORKLOADS; i++)
+	{
+		for (j = 0; j < smpWORKERS_PER_WORKLOAD; j++)
+		{
+			vTaskSuspend(xWorkloads[i].xWorkers[j]);
+		}
+	}
+
+	for (;;)
+	{
+		for (i = 0; i < smpNUMBER_OF_WORKLOADS; i++)
+		{
+			pxWorkload = &(xWorkloads[i]);
+			pxWorkload->ulUnits = 0;
+
+			#if (configNUMBER_OF_CORES > 1) && (configGENERATE_RUN_TIME_STATS == 1)
+			{
+				for (xCore = 0; xCore < configNUMBER_OF_CORES; xCore++)
+				{
+					ulBusy[xCore] = ulTaskGetCoreRunTimeCounter(xCore);
+					ulIdle[xCore] = ulTaskGetCoreIdleRunTimeCounter(xCore);
+				}
+			}
+			#endif
+
+			xStart = xTaskGetTickCount();
+
+			for (j = 0; j < smpWORKERS_PER_WORKLOAD; j++)
+			{
+				vTaskResume(pxWorkload->xWorkers[j]);
+			}
+
+			vTaskDelay(smpMEASUREMENT_PERIOD);
+
+			for (j = 0; j < smpWORKERS_PER_WORKLOAD; j++)
+			{
+				vTaskSuspend(pxWorkload->xWorkers[j]);
+			}
+
+			ulUnits = pxWorkload->ulUnits;
+			xElapsed = xTaskGetTickCount() - xStart;
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			printf("%-18s : %9lu units per second on %d core(s)\n", pxWorkload->pcName,
+				(unsigned long)(((uint64_t)ulUnits * configTICK_RATE_HZ) / ((xElapsed > 0) ? xElapsed : 1)), (int)configNUMBER_OF_CORES);
+
+			#if (configNUMBER_OF_CORES > 1) && (configGENERATE_RUN_TIME_STATS == 1)
+			{
+				for (xCore = 0; xCore < configNUMBER_OF_CORES; xCore++)
+				{
+					ulBusyDelta = ulTaskGetCoreRunTimeCounter(xCore) - ulBusy[xCore];
+					ulIdleDelta = ulTaskGetCoreIdleRunTimeCounter(xCore) - ulIdle[xCore];
+					printf("    core %d : %3lu%% busy\n", (int)xCore,
+						(unsigned long)(((uint64_t)ulBusyDelta * 100ULL) / (((uint64_t)ulBusyDelta + ulIdleDelta) > 0 ? ((uint64_t)ulBusyDelta + ulIdleDelta) : 1ULL)));
+				}
+			}
+			#endif
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Simulated multi-core
+*
+* 1. With configNUMBER_OF_CORES greater than 1 the kernel keeps a running task for each core, and the port runs the task of each core on
+*    its own host thread at the same time as the others.  A host with fewer processors than simulated cores still runs the tasks of all
+*    the cores, just not all at once.
+* 2. Only one core at a time can be inside the kernel.  A critical section takes a lock shared by all the cores as well as masking the
+*    (simulated) interrupts of the calling core, so code that only runs in critical sections cannot go any faster on more cores.
+* 3. A task can be restricted to some of the cores with vTaskCoreAffinitySet().  The scheduler picks the highest priority ready task
+*    that is allowed to run on a core, so a core can run a lower priority task than one that is waiting for a different core.
+* 4. Simulated interrupts, including the tick, are taken by core 0.  A context switch of another core is requested with an inter core
+*    interrupt, which the simulated interrupt thread handles on behalf of that core.
+*
+* Workloads
+*
+* 1. independent       : one worker per core, each working on its own data, so the work done should grow with the number of cores.
+* 2. critical section  : the same work done inside critical sections, so it cannot grow with the number of cores.
+* 3. pinned to core 0  : the independent workers all restricted to core 0, so they share one core whatever the number of cores.
+*
+* Each workload runs alone for smpMEASUREMENT_PERIOD, then the report task prints the units of work done per second.  With
+* configGENERATE_RUN_TIME_STATS set to 1 it also prints how busy each core was, from ulTaskGetCoreRunTimeCounter().
+******************************************************************************************************************************************/
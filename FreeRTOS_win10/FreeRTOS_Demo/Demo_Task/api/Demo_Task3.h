@@ -0,0 +1,6 @@
+#ifndef __DEMO_TASK3_H__
+#define __DEMO_TASK3_H__
+
+extern void Demo_Task3(void);
+
+#endif //__DEMO_TASK3_H__
@@ -219,7 +219,8 @@ static void  prvInitialiseHeap(void)
  *
  * Architecture Optimized method
  * The architecture optimized method uses a small amount of assembler code. and is faster than the generic code. The
- * configMAX_PRIORITIES setting does not affect the worst case execution time. and configMAX_PRIORITIES cannot be greater than 32
+ * configMAX_PRIORITIES setting does not affect the worst case execution time. and configMAX_PRIORITIES cannot be greater than 256
+ * (above 32 the ports keep the ready priorities in two levels of bit maps, see note 14 in docs/FreeRTOS_Config_Readme.txt)
  * This method will be used if configUSE_PORT_OPTIMISED_TASK_SELECTION is set to 1 in FreeRTOSConfig.h
  *
  * Not all FreeRTOS ports provide an architure optimized method.
@@ -0,0 +1,210 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The tasks that create and delete tasks run at the idle priority, so the idle task gets to free the memory of the tasks that
+    delete themselves each time they yield.  The task that measures them runs at a higher priority so it always gets to run. */
+#define taskCREATOR_TASK_PRIORITY			( tskIDLE_PRIORITY )
+#define taskSELF_DELETE_TASK_PRIORITY		( tskIDLE_PRIORITY + 1 )
+#define taskREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/*< How long each workload runs for each time it is measured. */
+#define taskMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*< The number of workloads, see xWorkloads[]. */
+#define taskNUMBER_OF_WORKLOADS				( 3 )
+
+/*********************************************************************************************************************************
+ *                                                     Type definitions
+ *********************************************************************************************************************************/
+
+typedef struct
+{
+	const char *pcName;
+
+	/*< The task that creates and deletes tasks, which is only resumed while the workload is being measured. */
+	TaskHandle_t xCreator;
+
+	/*< Incremented each time a task has been created and deleted. */
+	volatile uint32_t ulTasks;
+} Workload_t;
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Creates a task of a higher priority, which runs straight away and deletes itself.
+ */
+static void prvCreateSelfDeletingTask(void* pvParameters);
+static void prvSelfDeletingTask(void* pvParameters);
+
+/*
+ * Creates a task of the same priority and deletes it before it has run.
+ */
+static void prvCreateAndDeleteTask(void* pvParameters);
+
+/*
+ * Creates a task of the same priority, yields so it runs until it yields back, then deletes it.
+ */
+static void prvCreateRunAndDeleteTask(void* pvParameters);
+static void prvYieldingTask(void* pvParameters);
+
+/*
+ * Runs each workload in turn for taskMEASUREMENT_PERIOD and reports the cost of creating and deleting one task.
+ */
+static void prvReportTask(void* pvParameters);
+
+static Workload_t xWorkloads[ taskNUMBER_OF_WORKLOADS ] =
+{
+	{ "create, self delete",     NULL, 0 },
+	{ "create, delete",          NULL, 0 },
+	{ "create, run, delete",     NULL, 0 }
+};
+
+void Demo_Task3(void)
+{
+	xTaskCreate(prvCreateSelfDeletingTask, "Creator1", configMINIMAL_STACK_SIZE, &(xWorkloads[0]), taskCREATOR_TASK_PRIORITY, &(xWorkloads[0].xCreator));
+	xTaskCreate(prvCreateAndDeleteTask, "Creator2", configMINIMAL_STACK_SIZE, &(xWorkloads[1]), taskCREATOR_TASK_PRIORITY, &(xWorkloads[1].xCreator));
+	xTaskCreate(prvCreateRunAndDeleteTask, "Creator3", configMINIMAL_STACK_SIZE, &(xWorkloads[2]), taskCREATOR_TASK_PRIORITY, &(xWorkloads[2].xCreator));
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, taskREPORT_TASK_PRIORITY, NULL);
+}
+
+static void prvCreateSelfDeletingTask(void* pvParameters)
+{
+	for (;;)
+	{
+		xTaskCreate(prvSelfDeletingTask, "Worker", configMINIMAL_STACK_SIZE, pvParameters, taskSELF_DELETE_TASK_PRIORITY, NULL);
+
+		/*< Let the idle task free the memory of the task that deleted itself. */
+		taskYIELD();
+	}
+}
+
+static void prvSelfDeletingTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+
+	pxWorkload->ulTasks++;
+	vTaskDelete(NULL);
+}
+
+static void prvCreateAndDeleteTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	TaskHandle_t xTask;
+
+	for (;;)
+	{
+		if (xTaskCreate(prvYieldingTask, "Worker", configMINIMAL_STACK_SIZE, NULL, taskCREATOR_TASK_PRIORITY, &xTask) == pdPASS)
+		{
+			vTaskDelete(xTask);
+			pxWorkload->ulTasks++;
+		}
+	}
+}
+
+static void prvCreateRunAndDeleteTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+	TaskHandle_t xTask;
+
+	for (;;)
+	{
+		if (xTaskCreate(prvYieldingTask, "Worker", configMINIMAL_STACK_SIZE, NULL, taskCREATOR_TASK_PRIORITY, &xTask) == pdPASS)
+		{
+			/*< The new task runs until it yields back - the idle task may run in between. */
+			taskYIELD();
+			vTaskDelete(xTask);
+			pxWorkload->ulTasks++;
+		}
+	}
+}
+
+static void prvYieldingTask(void* pvParameters)
+{
+	(void)pvParameters;
+
+	for (;;)
+	{
+		taskYIELD();
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	Workload_t* pxWorkload;
+	uint32_t ulTasks;
+	TickType_t xStart, xElapsed;
+	uint64_t ullNanoseconds;
+	int i;
+
+	(void)pvParameters;
+
+	/*< Only the workload being measured runs, so the workloads do not share the processor with each other. */
+	for (i = 0; i < taskNUMBER_OF_WORKLOADS; i++)
+	{
+		vTaskSuspend(xWorkloads[i].xCreator);
+	}
+
+	for (;;)
+	{
+		for (i = 0; i < taskNUMBER_OF_WORKLOADS; i++)
+		{
+			pxWorkload = &(xWorkloads[i]);
+			pxWorkload->ulTasks = 0;
+			xStart = xTaskGetTickCount();
+
+			vTaskResume(pxWorkload->xCreator);
+			vTaskDelay(taskMEASUREMENT_PERIOD);
+			vTaskSuspend(pxWorkload->xCreator);
+
+			ulTasks = pxWorkload->ulTasks;
+			xElapsed = xTaskGetTickCount() - xStart;
+			ullNanoseconds = ((uint64_t)xElapsed * 1000000000ULL) / configTICK_RATE_HZ;
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			if (ulTasks > 0)
+			{
+				printf("%-20s : %8lu per second, %6lu ns each, %3lu host threads, %6lu bytes free\n", pxWorkload->pcName,
+					(unsigned long)((ulTasks * 1000000000ULL) / ullNanoseconds), (unsigned long)(ullNanoseconds / ulTasks),
+					(unsigned long)ulPortGetHostThreadCount(), (unsigned long)xPortGetFreeHeapSize());
+			}
+			else
+			{
+				printf("%-20s : did not run\n", pxWorkload->pcName);
+			}
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Creating and deleting tasks
+*
+* 1. In the simulator ports every task is executed by a host thread.  Creating a host thread for each task, and terminating it when the
+*    task is deleted, is slow, and TerminateThread() never frees the stack of the thread it terminates.
+* 2. Instead the ports keep a pool of parked host threads, created the first time a task is created (configSIMULATOR_THREAD_POOL_SIZE
+*    of them).  xTaskCreate() gives the new task a parked thread, and the thread goes back to the pool when the task is deleted, from
+*    wherever it was waiting - so a deleted task never leaves a thread or a thread stack behind.  The pool only grows when more tasks
+*    exist at once than ever before, which the "host threads" column shows: it stays at the pool size on one simulated core.  With
+*    more cores a task can be created on one core before the thread of a task that deleted itself on another is back in the pool.
+*    On Windows a task's stack is part of its thread's stack, so the thread of a task that deleted itself only goes back to the pool
+*    when the idle task frees the task's memory, and until then counts as a task that still exists - the column can go one above the
+*    pool size there when the report task suspends a creating task before the idle task has run.
+* 3. The memory of a task that deletes itself is freed by the idle task, so the idle task must get to run.  The creating tasks here run
+*    at the idle priority and yield, so the free heap stays the same.
+*
+* Workloads
+*
+* 1. create, self delete  : the new task has a higher priority, so runs as soon as it is created, then deletes itself.
+* 2. create, delete       : the new task is deleted before it has ever run.
+* 3. create, run, delete  : the new task runs until it yields, then is deleted by the task that created it.
+*
+* Each workload runs alone for taskMEASUREMENT_PERIOD, then the report task prints the number of tasks created and deleted per second and
+* the average time of one.  With configSIMULATOR_USE_FIBERS set to 1 (Linux only) tasks do not have host threads at all.
+******************************************************************************************************************************************/
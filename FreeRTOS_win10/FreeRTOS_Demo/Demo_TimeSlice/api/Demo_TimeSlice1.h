@@ -0,0 +1,6 @@
+#ifndef __DEMO_TIMESLICE1_H__
+#define __DEMO_TIMESLICE1_H__
+
+extern void Demo_TimeSlice1(void);
+
+#endif //__DEMO_TIMESLICE1_H__
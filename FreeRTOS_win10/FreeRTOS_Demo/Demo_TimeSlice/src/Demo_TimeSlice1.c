@@ -0,0 +1,179 @@
+#include <include.h>
+
+#if (configUSE_TIME_SLICE_QUANTA == 1)
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The batch tasks share a priority, below the task that sets the time slice and measures them. */
+#define sliceBATCH_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define sliceREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 2 )
+
+/*< More batch tasks than there are cores, so the batch tasks always have to share the processor. */
+#define sliceNUMBER_OF_BATCH_TASKS			( configNUMBER_OF_CORES + 2 )
+
+/*< The words each batch task works through on every pass, and how long each time slice is measured. */
+#define sliceWORDS_PER_PASS					( 16 * 1024 )
+#define sliceMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*< The number of time slices measured, see xTimeSlices[]. */
+#define sliceNUMBER_OF_TIME_SLICES			( 4 )
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * A CPU bound task that makes pass after pass over its own buffer, and counts the passes.
+ */
+static void prvBatchTask(void* pvParameters);
+
+/*
+ * Measures the batch tasks with each time slice in turn for sliceMEASUREMENT_PERIOD and reports how many passes a second they got
+ * through.
+ */
+static void prvReportTask(void* pvParameters);
+
+/*< The buffer each batch task works on, so a task that is switched in finds less of its own data in the host caches. */
+static uint32_t ulBuffers[ sliceNUMBER_OF_BATCH_TASKS ][ sliceWORDS_PER_PASS ];
+
+static TaskHandle_t xBatchTasks[ sliceNUMBER_OF_BATCH_TASKS ];
+
+/*< Each batch task counts its own passes, and the passes it finished after a pass of a different task, so no count is lost when a
+   time slice ends in the middle of an increment. */
+static volatile uint32_t ulPasses[ sliceNUMBER_OF_BATCH_TASKS ];
+static volatile uint32_t ulTaskChanges[ sliceNUMBER_OF_BATCH_TASKS ];
+static volatile UBaseType_t uxLastBatchTask = 0;
+
+static const TickType_t xTimeSlices[ sliceNUMBER_OF_TIME_SLICES ] = { 1, 5, 20, 100 };
+
+void Demo_TimeSlice1(void)
+{
+	UBaseType_t i;
+
+	for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+	{
+		xTaskCreate(prvBatchTask, "Batch", configMINIMAL_STACK_SIZE, (void*)(uintptr_t)i, sliceBATCH_TASK_PRIORITY, &(xBatchTasks[i]));
+	}
+
+	xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, sliceREPORT_TASK_PRIORITY, NULL);
+}
+
+static void prvBatchTask(void* pvParameters)
+{
+	UBaseType_t uxTask = (UBaseType_t)(uintptr_t)pvParameters;
+	uint32_t* pulBuffer = ulBuffers[uxTask];
+	uint32_t ulValue = (uint32_t)uxTask;
+	uint32_t i;
+
+	for (;;)
+	{
+		for (i = 0; i < sliceWORDS_PER_PASS; i++)
+		{
+			ulValue = (ulValue * 1103515245UL) + 12345UL + pulBuffer[i];
+			pulBuffer[i] = ulValue;
+		}
+
+		ulPasses[uxTask]++;
+
+		if (uxLastBatchTask != uxTask)
+		{
+			uxLastBatchTask = uxTask;
+			ulTaskChanges[uxTask]++;
+		}
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	uint32_t ulTotalPasses, ulChanges;
+	TickType_t xStart, xElapsed;
+	int i, iSlice;
+
+	(void)pvParameters;
+
+	/*< The batch tasks only run while they are being measured. */
+	for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+	{
+		vTaskSuspend(xBatchTasks[i]);
+	}
+
+	for (;;)
+	{
+		for (iSlice = 0; iSlice < sliceNUMBER_OF_TIME_SLICES; iSlice++)
+		{
+			vTaskSetTimeSliceTicks(sliceBATCH_TASK_PRIORITY, xTimeSlices[iSlice]);
+
+			for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+			{
+				ulPasses[i] = 0;
+				ulTaskChanges[i] = 0;
+			}
+
+			xStart = xTaskGetTickCount();
+
+			for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+			{
+				vTaskResume(xBatchTasks[i]);
+			}
+
+			vTaskDelay(sliceMEASUREMENT_PERIOD);
+
+			for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+			{
+				vTaskSuspend(xBatchTasks[i]);
+			}
+
+			xElapsed = xTaskGetTickCount() - xStart;
+			ulTotalPasses = 0;
+			ulChanges = 0;
+
+			for (i = 0; i < sliceNUMBER_OF_BATCH_TASKS; i++)
+			{
+				ulTotalPasses += ulPasses[i];
+				ulChanges += ulTaskChanges[i];
+			}
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			printf("time slice %3lu ticks : %8lu passes per second, %6lu task changes per second\n", (unsigned long)xTimeSlices[iSlice],
+				(unsigned long)(((uint64_t)ulTotalPasses * configTICK_RATE_HZ) / ((xElapsed > 0) ? xElapsed : 1)),
+				(unsigned long)(((uint64_t)ulChanges * configTICK_RATE_HZ) / ((xElapsed > 0) ? xElapsed : 1)));
+			xTaskResumeAll();
+		}
+
+		/*< Leave the priority with the time slice it started with. */
+		vTaskSetTimeSliceTicks(sliceBATCH_TASK_PRIORITY, 0);
+	}
+}
+
+#else /* configUSE_TIME_SLICE_QUANTA */
+
+void Demo_TimeSlice1(void)
+{
+	printf("Demo_TimeSlice1 needs configUSE_TIME_SLICE_QUANTA set to 1 in FreeRTOSConfig.h\n");
+}
+
+#endif /* configUSE_TIME_SLICE_QUANTA */
+
+
+/******************************************************************************************************************************************
+* Time slice quanta
+*
+* 1. With configUSE_TIME_SLICING the tick interrupt switches between the ready tasks of the highest ready priority, so CPU bound tasks
+*    of the same priority take turns of one tick each.  Every turn costs a context switch, and the task that is switched in finds the
+*    caches full of the data of the task before it.
+* 2. With configUSE_TIME_SLICE_QUANTA set to 1, vTaskSetTimeSliceTicks() gives the tasks of a priority a longer time slice, so each
+*    task keeps the processor for that many ticks before the tick switches to the next one.  A task still gives up the processor at
+*    once when it blocks or a task of a higher priority becomes ready, so a long time slice only delays the other tasks of the same
+*    priority.
+* 3. xTaskYieldIfPeerReady() yields to another ready task of the same priority only if there is one, so a task can offer a turn
+*    between two pieces of work without the cost of a context switch when it is alone.
+*
+* Measurement
+*
+* sliceNUMBER_OF_BATCH_TASKS tasks of the same priority each make pass after pass over their own buffer.  For each time slice in
+* xTimeSlices[] the report task lets them run for sliceMEASUREMENT_PERIOD, then prints the passes per second they got through between
+* them and how often a pass was finished by a different task than the one before.
+******************************************************************************************************************************************/
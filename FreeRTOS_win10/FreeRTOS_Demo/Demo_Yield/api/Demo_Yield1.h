@@ -0,0 +1,6 @@
+#ifndef __DEMO_YIELD1_H__
+#define __DEMO_YIELD1_H__
+
+extern void Demo_Yield1(void);
+
+#endif //__DEMO_YIELD1_H__
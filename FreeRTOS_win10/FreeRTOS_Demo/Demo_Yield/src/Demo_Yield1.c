@@ -0,0 +1,194 @@
+#include <include.h>
+
+/*********************************************************************************************************************************
+ *                                                     Macro definitions
+ *********************************************************************************************************************************/
+
+/*< The workloads run at a low priority, and the task that measures them at a higher priority so it always gets to run. */
+#define yieldWORKLOAD_TASK_PRIORITY			( tskIDLE_PRIORITY + 1 )
+#define yieldREPORT_TASK_PRIORITY			( tskIDLE_PRIORITY + 3 )
+
+/*< How long each workload runs for each time it is measured. */
+#define yieldMEASUREMENT_PERIOD				pdMS_TO_TICKS( 2000UL )
+
+/*< The number of workloads, see xWorkloads[]. */
+#define yieldNUMBER_OF_WORKLOADS			( 2 )
+
+/*********************************************************************************************************************************
+ *                                                     Type definitions
+ *********************************************************************************************************************************/
+
+typedef struct
+{
+	const char *pcName;
+
+	/*< Each workload is a pair of tasks, which are only resumed while the workload is being measured. */
+	TaskHandle_t xTasks[ 2 ];
+
+	/*< Incremented by the tasks on each iteration of the workload. */
+	volatile uint32_t ulYields;
+} Workload_t;
+
+/*********************************************************************************************************************************
+ *                                                     Static declarations
+ *********************************************************************************************************************************/
+
+/*
+ * Two tasks of the same priority that do nothing but call taskYIELD(), so every iteration is one yield.
+ */
+static void prvYieldTask(void* pvParameters);
+
+/*
+ * Two tasks that pass a token back and forth using a pair of binary semaphores.  Each task blocks on one semaphore then gives
+ * the other, so every iteration blocks the task that gives, unblocks the task that takes, and yields to it - the path every
+ * blocking API call takes.
+ */
+static void prvPingTask(void* pvParameters);
+static void prvPongTask(void* pvParameters);
+
+/*
+ * Runs each workload in turn for yieldMEASUREMENT_PERIOD and reports the cost of one iteration.
+ */
+static void prvReportTask(void* pvParameters);
+
+static SemaphoreHandle_t xPing = NULL, xPong = NULL;
+
+static Workload_t xWorkloads[ yieldNUMBER_OF_WORKLOADS ] =
+{
+	{ "taskYIELD()",           { NULL, NULL }, 0 },
+	{ "semaphore ping-pong",   { NULL, NULL }, 0 }
+};
+
+void Demo_Yield1(void)
+{
+	xPing = xSemaphoreCreateBinary();
+	xPong = xSemaphoreCreateBinary();
+
+	if ((xPing != NULL) && (xPong != NULL))
+	{
+		xTaskCreate(prvYieldTask, "Yield1", configMINIMAL_STACK_SIZE, &(xWorkloads[0]), yieldWORKLOAD_TASK_PRIORITY, &(xWorkloads[0].xTasks[0]));
+		xTaskCreate(prvYieldTask, "Yield2", configMINIMAL_STACK_SIZE, &(xWorkloads[0]), yieldWORKLOAD_TASK_PRIORITY, &(xWorkloads[0].xTasks[1]));
+		xTaskCreate(prvPingTask, "Ping", configMINIMAL_STACK_SIZE, &(xWorkloads[1]), yieldWORKLOAD_TASK_PRIORITY, &(xWorkloads[1].xTasks[0]));
+		xTaskCreate(prvPongTask, "Pong", configMINIMAL_STACK_SIZE, &(xWorkloads[1]), yieldWORKLOAD_TASK_PRIORITY, &(xWorkloads[1].xTasks[1]));
+		xTaskCreate(prvReportTask, "Report", configMINIMAL_STACK_SIZE * 2, NULL, yieldREPORT_TASK_PRIORITY, NULL);
+
+		/*< The token starts with the ping task. */
+		xSemaphoreGive(xPing);
+	}
+}
+
+static void prvYieldTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+
+	for (;;)
+	{
+		pxWorkload->ulYields++;
+		taskYIELD();
+	}
+}
+
+static void prvPingTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+
+	for (;;)
+	{
+		xSemaphoreTake(xPing, portMAX_DELAY);
+		pxWorkload->ulYields++;
+		xSemaphoreGive(xPong);
+	}
+}
+
+static void prvPongTask(void* pvParameters)
+{
+	Workload_t* pxWorkload = (Workload_t*)pvParameters;
+
+	for (;;)
+	{
+		xSemaphoreTake(xPong, portMAX_DELAY);
+		pxWorkload->ulYields++;
+		xSemaphoreGive(xPing);
+	}
+}
+
+static void prvReportTask(void* pvParameters)
+{
+	Workload_t* pxWorkload;
+	uint32_t ulYields;
+	TickType_t xStart, xElapsed;
+	uint64_t ullNanoseconds;
+	int i, j;
+
+	(void)pvParameters;
+
+	/*< Only the workload being measured runs, so the workloads do not share the processor with each other. */
+	for (i = 0; i < yieldNUMBER_OF_WORKLOADS; i++)
+	{
+		vTaskSuspend(xWorkloads[i].xTasks[0]);
+		vTaskSuspend(xWorkloads[i].xTasks[1]);
+	}
+
+	for (;;)
+	{
+		for (i = 0; i < yieldNUMBER_OF_WORKLOADS; i++)
+		{
+			pxWorkload = &(xWorkloads[i]);
+			pxWorkload->ulYields = 0;
+			xStart = xTaskGetTickCount();
+
+			for (j = 0; j < 2; j++)
+			{
+				vTaskResume(pxWorkload->xTasks[j]);
+			}
+
+			vTaskDelay(yieldMEASUREMENT_PERIOD);
+
+			for (j = 0; j < 2; j++)
+			{
+				vTaskSuspend(pxWorkload->xTasks[j]);
+			}
+
+			ulYields = pxWorkload->ulYields;
+			xElapsed = xTaskGetTickCount() - xStart;
+			ullNanoseconds = ((uint64_t)xElapsed * 1000000000ULL) / configTICK_RATE_HZ;
+
+			/*< An interrupt can switch a task out in the middle of a C library call, so don't let it happen while printing. */
+			vTaskSuspendAll();
+			if (ulYields > 0)
+			{
+				printf("%-20s : %10lu per second, %6lu ns each\n", pxWorkload->pcName,
+					(unsigned long)((ulYields * 1000000000ULL) / ullNanoseconds), (unsigned long)(ullNanoseconds / ulYields));
+			}
+			else
+			{
+				printf("%-20s : did not run\n", pxWorkload->pcName);
+			}
+			xTaskResumeAll();
+		}
+	}
+}
+
+
+/******************************************************************************************************************************************
+* Yield cost
+*
+* 1. portYIELD() raises the simulated yield interrupt.  Every blocking API call goes through it - xQueueReceive(), xSemaphoreTake(),
+*    vTaskDelay() and so on all yield when the calling task blocks, and the giving side yields when it unblocks a higher or equal
+*    priority task.  The cost of a yield therefore bounds how many blocking operations the simulator can do per second.
+* 2. In the simulator ports a yield is much more expensive than on a real target.  Unless configSIMULATOR_USE_FIBERS is 1 (Linux only)
+*    every task runs in its own host thread, so one yield hands the processor from the task thread to the simulated interrupt
+*    thread and from there to the thread of the next task.
+* 3. Pending a simulated interrupt does not take the mutex that models (simulated) interrupts being disabled - the interrupt is set
+*    pending with an atomic OR and the simulated interrupt thread is woken with one event.  The mutex is only held by a task in a
+*    critical section and by the simulated interrupt thread while it processes interrupts.
+*
+* Workloads
+*
+* 1. taskYIELD()          : two tasks of the same priority yield to each other.  One yield per iteration.
+* 2. semaphore ping-pong  : two tasks pass a token with two binary semaphores.  One iteration blocks one task, unblocks the other and
+*                           switches to it.
+*
+* Each workload runs alone for yieldMEASUREMENT_PERIOD, then the report task prints the number of iterations per second and the
+* average time of one iteration.
+******************************************************************************************************************************************/
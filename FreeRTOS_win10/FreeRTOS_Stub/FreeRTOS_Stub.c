@@ -1,4 +1,5 @@
 #include <include.h>
+#include <errno.h>
 
 #define mainCREATE_SIMPLE_BLINKY_DEMO_ONLY	1
 
@@ -88,9 +89,11 @@ void vApplicationStackOverflowHook(TaskHandle_t pxTask, char* pcTaskName)
 
 	/* Run time stack overflow checking is performed if
 	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook
-	function is called if a stack overflow is detected.  This function is
-	provided as an example only as stack overflow checking does not function
-	when running the FreeRTOS Windows port. */
+	function is called if a stack overflow is detected.  The Windows port lets
+	a task that overflows run on into the rest of its host thread's stack, so
+	there the overflow is found when the task is switched out.  The GCC/Posix
+	port calls this hook as soon as a task writes to the guard region below
+	its stack. */
 	vAssertCalled(__LINE__, __FILE__);
 }
 
@@ -168,7 +171,11 @@ void vAssertCalled(unsigned long ulLine, const char* const pcFileName)
 	(void)ulLine;
 	(void)pcFileName;
 
+#ifdef _WIN32
 	printf("ASSERT! Line %ld, file %s, GetLastError() %ld\r\n", ulLine, pcFileName, GetLastError());
+#else
+	printf("ASSERT! Line %ld, file %s, errno %d\r\n", ulLine, pcFileName, errno);
+#endif
 
 	taskENTER_CRITICAL();
 	{
@@ -181,18 +188,30 @@ void vAssertCalled(unsigned long ulLine, const char* const pcFileName)
 				vTraceStop();
 				prvSaveTraceFile();
 			}
+
+#if (configSIMULATOR_RECORD_REPLAY == 1)
+			/* Complete the record/replay log, so the run can be replayed up to the assertion. */
+			vPortFlushRecording();
+#endif
 		}
 
+#ifdef _WIN32
 		/* Cause debugger break point if being debugged. */
 		__debugbreak();
+#endif
 
 		/* You can step out of this function to debug the assertion by using
 		the debugger to set ulSetToNonZeroInDebuggerToContinue to a non-zero
 		value. */
 		while (ulSetToNonZeroInDebuggerToContinue == 0)
 		{
+#ifdef _WIN32
 			__asm { NOP };
 			__asm { NOP };
+#else
+			__asm volatile("NOP");
+			__asm volatile("NOP");
+#endif
 		}
 	}
 	taskEXIT_CRITICAL();
@@ -200,9 +219,15 @@ void vAssertCalled(unsigned long ulLine, const char* const pcFileName)
 
 static void prvSaveTraceFile(void)
 {
+#if (configUSE_TRACE_FACILITY == 1)
+	/* Without the trace facility there is no recorder, so nothing to save. */
 	FILE* pxOutputFile;
 
+#ifdef _WIN32
 	fopen_s(&pxOutputFile, "Trace.dump", "wb");
+#else
+	pxOutputFile = fopen("Trace.dump", "wb");
+#endif
 
 	if (pxOutputFile != NULL)
 	{
@@ -214,4 +239,5 @@ static void prvSaveTraceFile(void)
 	{
 		printf("\r\nFailed to create trace dump file\r\n");
 	}
+#endif
 }
@@ -33,19 +33,86 @@
   * real time, therefore the run time counter values have no real meaningful
   * units.
   *
-  * Also note that it is assumed this demo is going to be used for short periods
-  * of time only, and therefore timer overflows are not handled.
+  * The counter is returned as configRUN_TIME_COUNTER_TYPE, so when that is a 64
+  * bit type the counter does not overflow however long the demo runs.
  */
 
  /* FreeRTOS includes. */
 #include <FreeRTOS.h>
 
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+#if ( configSIMULATOR_VIRTUAL_TIME == 1 )
+
+/* With virtual time the counter is the virtual time kept by the port, so trace
+timestamps and run time stats are as repeatable as the run itself.  Virtual
+time only moves on while every task is blocked, so it is all counted as the
+run time of the idle task. */
+void vConfigureTimerForRunTimeStats(void)
+{
+}
+/*-----------------------------------------------------------*/
+
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void)
+{
+	/* The virtual time is in nanoseconds, so is scaled by 10000 to get 1/100ths
+	of a millisecond, as the host clock is. */
+	return (configRUN_TIME_COUNTER_TYPE)(ullPortGetVirtualTime() / 10000ULL);
+}
+/*-----------------------------------------------------------*/
+
+#else
+
 /* Variables used in the creation of the run time stats time base.  Run time
 stats record how much time each task spends in the Running state. */
 static long long llInitialRunTimeCounterValue = 0LL, llTicksPerHundedthMillisecond = 0LL;
 
 /*-----------------------------------------------------------*/
 
+#ifndef _WIN32
+
+/* On Linux/POSIX hosts CLOCK_MONOTONIC takes the place of the Windows
+performance counter.  It counts in nanoseconds, so the counter value is scaled
+by 10000 to get 1/100ths of a millisecond. */
+static long long prvReadMonotonicClock(void)
+{
+	struct timespec xNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &xNow);
+
+	return ((long long)xNow.tv_sec * 1000000000LL) + (long long)xNow.tv_nsec;
+}
+
+void vConfigureTimerForRunTimeStats(void)
+{
+	llTicksPerHundedthMillisecond = 10000LL;
+	llInitialRunTimeCounterValue = prvReadMonotonicClock();
+}
+/*-----------------------------------------------------------*/
+
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void)
+{
+	configRUN_TIME_COUNTER_TYPE ulReturn;
+
+	if (llTicksPerHundedthMillisecond == 0)
+	{
+		/* The trace macros are probably calling this function before the
+		scheduler has been started. */
+		ulReturn = 0;
+	}
+	else
+	{
+		ulReturn = (configRUN_TIME_COUNTER_TYPE)((prvReadMonotonicClock() - llInitialRunTimeCounterValue) / llTicksPerHundedthMillisecond);
+	}
+
+	return ulReturn;
+}
+/*-----------------------------------------------------------*/
+
+#else
+
 void vConfigureTimerForRunTimeStats(void)
 {
 	LARGE_INTEGER liPerformanceCounterFrequency, liInitialRunTimeValue;
@@ -72,10 +139,10 @@ void vConfigureTimerForRunTimeStats(void)
 }
 /*-----------------------------------------------------------*/
 
-unsigned long ulGetRunTimeCounterValue(void)
+configRUN_TIME_COUNTER_TYPE ulGetRunTimeCounterValue(void)
 {
 	LARGE_INTEGER liCurrentCount;
-	unsigned long ulReturn;
+	configRUN_TIME_COUNTER_TYPE ulReturn;
 
 	/* What is the performance counter value now? */
 	QueryPerformanceCounter(&liCurrentCount);
@@ -91,9 +158,13 @@ unsigned long ulGetRunTimeCounterValue(void)
 	}
 	else
 	{
-		ulReturn = (unsigned long)((liCurrentCount.QuadPart - llInitialRunTimeCounterValue) / llTicksPerHundedthMillisecond);
+		ulReturn = (configRUN_TIME_COUNTER_TYPE)((liCurrentCount.QuadPart - llInitialRunTimeCounterValue) / llTicksPerHundedthMillisecond);
 	}
 
 	return ulReturn;
 }
 /*-----------------------------------------------------------*/
+
+#endif /* _WIN32 */
+
+#endif /* configSIMULATOR_VIRTUAL_TIME */
@@ -8,5 +8,20 @@
 #define ENABLE_DEMO_1                   0
 #define ENABLE_DEMO_TASK                0
 #define ENABLE_DEMO_TIMER               1
+#define ENABLE_DEMO_YIELD               0
+#define ENABLE_DEMO_QUEUE               0
+#define ENABLE_DEMO_TASK_CREATE         0
+#define ENABLE_DEMO_SMP                 0
+#define ENABLE_DEMO_JOBS                0
+#define ENABLE_DEMO_TIME_SLICE          0
+#define ENABLE_DEMO_DELAY               0
+#define ENABLE_DEMO_PRIORITY            0
+#define ENABLE_DEMO_MUTEX               0
+#define ENABLE_DEMO_BUDGET              0
+#define ENABLE_DEMO_EDF                 0
+#define ENABLE_DEMO_MONITOR             0
+#define ENABLE_DEMO_POOL                0
+#define ENABLE_DEMO_NOTIFY              0
+#define ENABLE_DEMO_MULTI_WAIT          0
 
 #endif //__DEMOCONFIG_H__
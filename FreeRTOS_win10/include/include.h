@@ -4,11 +4,13 @@
 /*< Standard libraries */
 #include <stdio.h>
 #include <stdlib.h>
-#include <conio.h>
 #include <string.h>
 #include <stdint.h>
 
+#ifdef _WIN32
+#include <conio.h>
 #include <intrin.h>
+#endif
 
 /*< FreeRTOS header files */
 #include <FreeRTOS.h>
@@ -21,11 +23,26 @@
 #include "FreeRTOS_Demo/Demo_Main/api/Demo_main.h"
 #include "FreeRTOS_Demo/Demo_Task/api/Demo_Task1.h"
 #include "FreeRTOS_Demo/Demo_Task/api/Demo_Task2.h"
+#include "FreeRTOS_Demo/Demo_Task/api/Demo_Task3.h"
 #include "FreeRTOS_Demo/Demo_Heap/api/Demo_Heap1.h"
 #include "FreeRTOS_Demo/Demo_Heap/api/Demo_Heap2.h"
 #include "FreeRTOS_Demo/Demo_Queue/api/Demo_Queue1.h"
 #include "FreeRTOS_Demo/Demo_Queue/api/Demo_Queue2.h"
+#include "FreeRTOS_Demo/Demo_Queue/api/Demo_Queue3.h"
 #include "FreeRTOS_Demo/Demo_Timer/api/Demo_Timer1.h"
+#include "FreeRTOS_Demo/Demo_Yield/api/Demo_Yield1.h"
+#include "FreeRTOS_Demo/Demo_Smp/api/Demo_Smp1.h"
+#include "FreeRTOS_Demo/Demo_Jobs/api/Demo_Jobs1.h"
+#include "FreeRTOS_Demo/Demo_TimeSlice/api/Demo_TimeSlice1.h"
+#include "FreeRTOS_Demo/Demo_Delay/api/Demo_Delay1.h"
+#include "FreeRTOS_Demo/Demo_Priority/api/Demo_Priority1.h"
+#include "FreeRTOS_Demo/Demo_Mutex/api/Demo_Mutex1.h"
+#include "FreeRTOS_Demo/Demo_Budget/api/Demo_Budget1.h"
+#include "FreeRTOS_Demo/Demo_Edf/api/Demo_Edf1.h"
+#include "FreeRTOS_Demo/Demo_Monitor/api/Demo_Monitor1.h"
+#include "FreeRTOS_Demo/Demo_Pool/api/Demo_Pool1.h"
+#include "FreeRTOS_Demo/Demo_Notify/api/Demo_Notify1.h"
+#include "FreeRTOS_Demo/Demo_MultiWait/api/Demo_MultiWait1.h"
 #include "FreeRTOS_Demo/Demo1/api/Demo1.h"
 
 #endif //__INCLUDE_H__